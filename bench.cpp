@@ -0,0 +1,576 @@
+/*
+ * bench: multithreaded throughput benchmark of the buffer manager. Runs a
+ * mix of getPage/releasePage pairs that hit, miss, or miss and dirty the
+ * page, from 1 to 64 threads, and prints ops/sec, the scaling over one
+ * thread and latency percentiles for each thread count, optionally also as
+ * CSV for tracking regressions.
+ *
+ *   ./bench -p Clock -m sharded -t 1,2,4,8 -w 90:8:2 -d 2 -o bench.csv
+ *
+ * With -g the pairs follow a pattern of bm_workload.h instead of the mix,
+ * over the same pages, each thread drawing its own accesses from it:
+ *
+ *   ./bench -p Sieve -g zipf:0.99 -r 10 -t 1,4
+ *
+ * The global mode latches one BufferManager with one mutex. The sharded mode
+ * latches each shard of a PartitionedBufferManager with its own mutex, so
+ * hits of different shards run at the same time. The DiskManager the shards
+ * share is not safe for concurrent calls, so a miss also takes one I/O mutex
+ * for as long as it may read the page or write back a victim.
+ */
+
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+#include "swatdb_types.h"
+#include "swatdb_exceptions.h"
+#include "diskmgr.h"
+#include "bufmgr.h"
+#include "bm_partitioned.h"
+#include "bm_latency.h"
+#include "bm_workload.h"
+#include "page.h"
+#include "catalog.h"
+#include "file.h"
+
+/*
+ * Thread counts run when -t is not given.
+ */
+static const std::uint32_t DEFAULT_THREADS[] = {1, 2, 4, 8, 16, 32, 64};
+
+/*
+ * Name of the relation file the benchmark pages are allocated in.
+ */
+static const char BENCH_FILE[] = "bench.rel";
+
+/*
+ * Kinds of operations of the mix, indexing BenchConfig::mix.
+ */
+enum BenchOp {
+  OpHit,      // getPage/releasePage of a page of the hot set
+  OpMiss,     // getPage/releasePage of a page of the cold set
+  OpDirty,    // the same, releasing the page dirty
+  BENCH_NUM_OPS
+};
+
+/*
+ * What to run.
+ */
+struct BenchConfig {
+  PolicyType rep_type;                 // replacement policy
+  bool sharded;                     // PartitionedBufferManager, latch a shard
+  std::uint32_t num_shards;         // shards of the sharded mode
+  std::uint32_t mix[BENCH_NUM_OPS]; // percent of each kind of operation
+  std::uint32_t cold_factor;        // cold set size, in buffer pools
+  double seconds;                   // time each thread count runs for
+  std::string pattern;              // -g workload, or empty for the mix
+  WorkloadConfig workload;          // the parsed pattern
+};
+
+/*
+ * What a thread count did.
+ */
+struct BenchResult {
+  std::uint32_t threads;
+  std::uint64_t ops;                // pairs done
+  double seconds;                   // time they took
+  BufferStats stats;                // counters of the buffer manager
+  std::uint64_t pin_waits;          // pairs turned away, every frame pinned
+  LatencyHistogram latency;         // time of each pair, latch wait included
+};
+
+
+/*
+ * Runs the benchmark on one buffer manager, over a file of hot and cold
+ * pages allocated once.
+ */
+class Bench {
+
+  public:
+
+    /*
+     * Creates the buffer manager of config, allocates its pages on disk and
+     * reads the hot set in.
+     */
+    Bench(const BenchConfig &config) : config(config){
+      this->catalog = new Catalog();
+      this->disk_mgr = new DiskManager(this->catalog);
+      this->file_id = this->catalog->addEntry(BENCH_FILE, nullptr, nullptr,
+          nullptr, HeapFileT, INVALID_FILE_ID, BENCH_FILE);
+      this->disk_mgr->createFile(this->file_id);
+
+      std::uint32_t frames = BUF_SIZE;
+      if( config.sharded ){
+        this->shards.reset(new PartitionedBufferManager(this->disk_mgr,
+            config.rep_type, config.num_shards));
+        this->latches = std::vector<std::mutex>(config.num_shards);
+        frames *= config.num_shards;
+      }
+      else{
+        this->single.reset(new BufferManager(this->disk_mgr,
+            config.rep_type));
+        this->latches = std::vector<std::mutex>(1);
+      }
+
+      // a quarter of the pool is hot, so that it stays resident under the
+      // misses of the cold set
+      std::uint32_t num_hot = frames / 4 > 0 ? frames / 4 : 1;
+      std::uint32_t num_cold = config.cold_factor * frames;
+      for( std::uint32_t i = 0; i < num_hot + num_cold; i++ ){
+        PageId page_id = this->disk_mgr->allocatePage(this->file_id);
+        (i < num_hot ? this->hot : this->cold).push_back(page_id);
+      }
+      for( PageId page_id : this->hot ){
+        _get(page_id);
+        _release(page_id, false);
+      }
+      if( !config.pattern.empty() ){
+        this->workload.reset(new Workload(config.workload,
+            {this->hot, this->cold}));
+      }
+    }
+
+    /*
+     * Writes back the dirty pages and removes the file.
+     */
+    ~Bench(){
+      this->shards.reset();
+      this->single.reset();
+      delete this->disk_mgr;
+      delete this->catalog;
+      std::remove(BENCH_FILE);
+    }
+
+    /*
+     * Runs the mix from threads threads for config.seconds, and returns what
+     * they did.
+     */
+    BenchResult run(std::uint32_t threads){
+      std::vector<std::thread> workers;
+      std::vector<std::uint64_t> ops(threads, 0);
+      std::vector<std::uint64_t> pin_waits(threads, 0);
+      std::vector<LatencyHistogram> latency(threads);
+      std::atomic<std::uint32_t> ready(0);
+      std::atomic<bool> go(false);
+      std::atomic<bool> stop(false);
+
+      BufferStats before = _stats();
+      for( std::uint32_t t = 0; t < threads; t++ ){
+        workers.push_back(std::thread([&, t](){
+          // xorshift32, seeded per thread; counts are kept in locals, so
+          // that threads share no cache line until they are done
+          std::uint32_t seed = 2463534242u + 7919 * t;
+          std::uint64_t done = 0, turned_away = 0;
+          std::unique_ptr<Workload> pattern;
+          if( workload != nullptr ){
+            pattern.reset(new Workload(*workload));
+            pattern->reseed(config.workload.seed + t);
+          }
+          ready++;
+          while( !go.load() ){
+            std::this_thread::yield();
+          }
+          while( !stop.load(std::memory_order_relaxed) ){
+            PageId page_id;
+            bool dirty;
+            if( pattern != nullptr ){
+              WorkloadAccess access = pattern->next();
+              page_id = access.page_id;
+              dirty = access.write;
+            }
+            else{
+              seed ^= seed << 13;
+              seed ^= seed >> 17;
+              seed ^= seed << 5;
+              BenchOp op = _pick(seed % 100);
+              std::vector<PageId> &set = op == OpHit ? hot : cold;
+              page_id = set[(seed >> 7) % set.size()];
+              dirty = op == OpDirty;
+            }
+
+            std::uint64_t start = bm_cycles();
+            try{
+              // two threads may pin the same page, so it is not written
+              // to; releasing it dirty is what makes it written back
+              _get(page_id);
+              _release(page_id, dirty);
+            }catch (InsufficientSpaceBufMgr &e){
+              turned_away++;
+              continue;
+            }
+            latency[t].record(bm_cycles() - start);
+            done++;
+          }
+          ops[t] = done;
+          pin_waits[t] = turned_away;
+        }));
+      }
+      while( ready.load() < threads ){
+        std::this_thread::yield();
+      }
+
+      std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+      go.store(true);
+      std::this_thread::sleep_for(
+          std::chrono::duration<double>(config.seconds));
+      stop.store(true);
+      for( std::thread &worker : workers ){
+        worker.join();
+      }
+      std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+      BenchResult result;
+      result.threads = threads;
+      result.ops = 0;
+      result.pin_waits = 0;
+      result.seconds = elapsed.count();
+      for( std::uint32_t t = 0; t < threads; t++ ){
+        result.ops += ops[t];
+        result.pin_waits += pin_waits[t];
+        result.latency.merge(latency[t]);
+      }
+      result.stats = _stats();
+      bm_sub_stats(&result.stats, before);
+      return result;
+    }
+
+  private:
+
+    BenchConfig config;
+    Catalog *catalog;
+    DiskManager *disk_mgr;
+    FileId file_id;
+
+    /*
+     * The buffer manager, one of them, and the latches of its shards, or
+     * of the whole of it.
+     */
+    std::unique_ptr<BufferManager> single;
+    std::unique_ptr<PartitionedBufferManager> shards;
+    std::vector<std::mutex> latches;
+
+    /*
+     * Serializes the calls of the shards to the DiskManager, always taken
+     * after the latch of a shard.
+     */
+    std::mutex io_latch;
+
+    /*
+     * Pages hits and misses are drawn from.
+     */
+    std::vector<PageId> hot;
+    std::vector<PageId> cold;
+
+    /*
+     * The pattern of -g over the hot and the cold pages, copied by each
+     * thread, or nullptr for the mix.
+     */
+    std::unique_ptr<Workload> workload;
+
+    /*
+     * Returns the kind of operation of a draw in [0, 100).
+     */
+    BenchOp _pick(std::uint32_t draw){
+      if( draw < config.mix[OpHit] ){
+        return OpHit;
+      }
+      if( draw < config.mix[OpHit] + config.mix[OpMiss] ){
+        return OpMiss;
+      }
+      return OpDirty;
+    }
+
+    /*
+     * Returns the latch of the page.
+     */
+    std::mutex &_latch(PageId page_id){
+      return config.sharded ? latches[shards->getShard(page_id)] : latches[0];
+    }
+
+    /*
+     * getPage under the latch of the page, and under io_latch too if it
+     * misses in a shard.
+     */
+    Page *_get(PageId page_id){
+      std::lock_guard<std::mutex> guard(_latch(page_id));
+      if( !config.sharded ){
+        return single->getPage(page_id);
+      }
+      if( shards->isResident(page_id) ){
+        return shards->getPage(page_id);
+      }
+      std::lock_guard<std::mutex> io(io_latch);
+      return shards->getPage(page_id);
+    }
+
+    /*
+     * releasePage under the latch of the page.
+     */
+    void _release(PageId page_id, bool dirty){
+      std::lock_guard<std::mutex> guard(_latch(page_id));
+      if( config.sharded ){
+        shards->releasePage(page_id, dirty);
+      }
+      else{
+        single->releasePage(page_id, dirty);
+      }
+    }
+
+    /*
+     * Returns the counters of the buffer manager.
+     */
+    BufferStats _stats(){
+      return config.sharded ? shards->getBufferStats() :
+                              single->getBufferStats();
+    }
+};
+
+
+/*
+ * Prints usage
+ */
+void usage(){
+  std::cout << "Usage: ./bench [-p <policy>] [-m global|sharded] " <<
+      "[-s <shards>] [-t <threads>]\n" <<
+      "               [-w <hit:miss:dirty>] [-c <cold>] [-d <seconds>] " <<
+      "[-o <csv_file>]\n" <<
+      "               [-g <workload>] [-r <write_pct>] -h help\n";
+  std::cout << "  -p  replacement policy, default Clock\n";
+  std::cout << "  -m  global: one BufferManager behind one mutex, the " <<
+      "default;\n      sharded: a PartitionedBufferManager, a mutex per " <<
+      "shard\n";
+  std::cout << "  -s  shards of the sharded mode, default 16\n";
+  std::cout << "  -t  comma separated thread counts, default " <<
+      "1,2,4,8,16,32,64\n";
+  std::cout << "  -w  percent of pairs that hit, miss, and miss and dirty " <<
+      "the page,\n      default 90:8:2\n";
+  std::cout << "  -c  size of the cold set, in buffer pools, default 2\n";
+  std::cout << "  -d  seconds each thread count runs, default 2\n";
+  std::cout << "  -o  also write the results as CSV to csv_file\n";
+  std::cout << "  -g  run a workload instead of the mix, over the hot then " <<
+      "the cold pages:\n      uniform, zipf[:theta], hotspot[:hot:prob], " <<
+      "latest[:theta],\n      scan[:fraction:length] or loop\n";
+  std::cout << "  -r  percent of the accesses of -g that dirty the page, " <<
+      "default 0" << std::endl;
+}
+
+/*
+ * Splits a list separated by sep.
+ */
+std::vector<std::string> split(const std::string &list, char sep){
+  std::vector<std::string> items;
+  std::stringstream in(list);
+  std::string item;
+  while (std::getline(in, item, sep)){
+    if (!item.empty()){
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+/*
+ * Returns the PolicyType named name, or INVALID_REP_TYPE.
+ */
+PolicyType parsePolicy(const std::string &name){
+  for (PolicyType i = 0; i <= LruKT; i++){
+    if (i != INVALID_REP_TYPE && bm_rep_str(i) == name){
+      return i;
+    }
+  }
+  return INVALID_REP_TYPE;
+}
+
+/*
+ * Prints the header of the results table.
+ */
+void printHeader(const BenchConfig &config){
+  std::cout << "Policy " << bm_rep_str(config.rep_type) << ", " <<
+      (config.sharded ? "sharded, " + std::to_string(config.num_shards) +
+       " shards" : std::string("global latch"));
+  if (config.pattern.empty()){
+    std::cout << ", mix " << config.mix[OpHit] << ":" << config.mix[OpMiss] <<
+        ":" << config.mix[OpDirty] << " hit:miss:dirty" << std::endl;
+  }
+  else{
+    std::cout << ", workload " << config.pattern << ", " <<
+        100 * config.workload.write_fraction << "% writes" << std::endl;
+  }
+  std::cout << std::setw(8) << "threads" << std::setw(14) << "ops/sec" <<
+      std::setw(9) << "scaling" << std::setw(10) << "hit rate" <<
+      std::setw(12) << "dirty evict" << std::setw(11) << "pin waits" <<
+      std::setw(10) << "p50 ns" << std::setw(10) << "p99 ns" <<
+      std::setw(10) << "p999 ns" << std::endl;
+}
+
+/*
+ * Prints a row of the results table. base is the ops/sec of the first
+ * thread count, which scaling is relative to.
+ */
+void printResult(const BenchResult &result, double base){
+  double rate = result.ops / result.seconds;
+  std::uint64_t lookups = result.stats.hits + result.stats.misses;
+  std::ios_base::fmtflags flags = std::cout.flags();
+  std::cout << std::fixed << std::setprecision(0) << std::setw(8) <<
+      result.threads << std::setw(14) << rate << std::setprecision(2) <<
+      std::setw(9) << rate / base << std::setprecision(4) << std::setw(10) <<
+      (lookups > 0 ? (double)result.stats.hits / lookups : 0) <<
+      std::setw(12) << result.stats.dirty_evictions << std::setw(11) <<
+      result.pin_waits << std::setprecision(0) << std::setw(10) <<
+      result.latency.percentileNs(0.5) << std::setw(10) <<
+      result.latency.percentileNs(0.99) << std::setw(10) <<
+      result.latency.percentileNs(0.999) << std::endl;
+  std::cout.flags(flags);
+}
+
+/*
+ * Writes the results as CSV, one row per thread count, to path.
+ */
+bool writeCsv(const std::string &path, const BenchConfig &config,
+              const std::vector<BenchResult> &results){
+  std::ofstream out(path);
+  out << std::fixed << std::setprecision(3);
+  out << "policy,mode,shards,hit_pct,miss_pct,dirty_pct,workload,write_pct," <<
+      "threads,seconds,ops,ops_per_sec,scaling,hits,misses,dirty_evictions," <<
+      "pin_waits,p50_ns,p99_ns,p999_ns,max_ns\n";
+  for (const BenchResult &result : results){
+    double rate = result.ops / result.seconds;
+    out << bm_rep_str(config.rep_type) << "," <<
+        (config.sharded ? "sharded" : "global") << "," <<
+        (config.sharded ? config.num_shards : 1) << "," <<
+        config.mix[OpHit] << "," << config.mix[OpMiss] << "," <<
+        config.mix[OpDirty] << "," <<
+        (config.pattern.empty() ? "mix" : config.pattern) << "," <<
+        100 * config.workload.write_fraction << "," << result.threads << "," <<
+        result.seconds << "," << result.ops << "," << rate << "," <<
+        rate / (results[0].ops / results[0].seconds) << "," <<
+        result.stats.hits << "," << result.stats.misses << "," <<
+        result.stats.dirty_evictions << "," << result.pin_waits << "," <<
+        result.latency.percentileNs(0.5) << "," <<
+        result.latency.percentileNs(0.99) << "," <<
+        result.latency.percentileNs(0.999) << "," <<
+        result.latency.maxNs() << "\n";
+  }
+  out.close();
+  return !out.fail();
+}
+
+/*
+ * Parses the options, runs every thread count and prints the results.
+ */
+int main(int argc, char** argv){
+  BenchConfig config = {ClockT, false, 16, {90, 8, 2}, 2, 2.0, "",
+      bm_default_workload(WorkloadUniform)};
+  double write_pct = -1;
+  std::vector<std::uint32_t> thread_counts(std::begin(DEFAULT_THREADS),
+      std::end(DEFAULT_THREADS));
+  std::string csv_path;
+  std::vector<std::string> mix;
+  std::string mode;
+  int c;
+
+  while ((c = getopt (argc, argv, "hp:m:s:t:w:c:d:o:g:r:")) != -1){
+    switch(c) {
+      case 'h': usage();
+                exit(1);
+      case 'p': config.rep_type = parsePolicy(optarg);
+                if (config.rep_type == INVALID_REP_TYPE){
+                  std::cerr << "unknown policy: " << optarg << std::endl;
+                  exit(1);
+                }
+                break;
+      case 'm': mode = optarg;
+                if (mode != "global" && mode != "sharded"){
+                  std::cerr << "unknown mode: " << mode << std::endl;
+                  exit(1);
+                }
+                config.sharded = mode == "sharded";
+                break;
+      case 's': config.num_shards = atoi(optarg);
+                break;
+      case 't': thread_counts.clear();
+                for (std::string &count : split(optarg, ',')){
+                  thread_counts.push_back(atoi(count.c_str()));
+                  if (thread_counts.back() == 0){
+                    std::cerr << "bad thread count: " << count << std::endl;
+                    exit(1);
+                  }
+                }
+                break;
+      case 'w': mix = split(optarg, ':');
+                if (mix.size() != BENCH_NUM_OPS){
+                  std::cerr << "bad mix: " << optarg << std::endl;
+                  exit(1);
+                }
+                for (std::uint32_t i = 0; i < BENCH_NUM_OPS; i++){
+                  config.mix[i] = atoi(mix[i].c_str());
+                }
+                if (config.mix[OpHit] + config.mix[OpMiss] +
+                    config.mix[OpDirty] != 100){
+                  std::cerr << "mix must add up to 100: " << optarg <<
+                      std::endl;
+                  exit(1);
+                }
+                break;
+      case 'c': config.cold_factor = atoi(optarg);
+                break;
+      case 'd': config.seconds = atof(optarg);
+                break;
+      case 'o': csv_path = optarg;
+                break;
+      case 'g': config.pattern = optarg;
+                if (!bm_parse_workload(config.pattern, &config.workload)){
+                  std::cerr << "unknown workload: " << optarg << std::endl;
+                  exit(1);
+                }
+                break;
+      case 'r': write_pct = atof(optarg);
+                break;
+      default: usage();
+               exit(1);
+    }
+  }
+  if (config.num_shards == 0 || config.cold_factor == 0 ||
+      config.seconds <= 0 || thread_counts.empty() ||
+      (write_pct >= 0 && config.pattern.empty())){
+    usage();
+    exit(1);
+  }
+  if (write_pct >= 0){
+    config.workload.write_fraction = write_pct / 100;
+  }
+
+  std::vector<BenchResult> results;
+  try{
+    Bench bench(config);
+    printHeader(config);
+    for (std::uint32_t threads : thread_counts){
+      results.push_back(bench.run(threads));
+      printResult(results.back(),
+          results[0].ops / results[0].seconds);
+    }
+  }catch (SwatDBException &e){
+    std::cerr << "benchmark failed: " << e.what() << std::endl;
+    exit(1);
+  }
+
+  if (!csv_path.empty() && !writeCsv(csv_path, config, results)){
+    std::cerr << "cannot write " << csv_path << std::endl;
+    exit(1);
+  }
+  return 0;
+}
@@ -0,0 +1,132 @@
+#ifndef _SWATDB_BM_BITMAP_H_
+#define  _SWATDB_BM_BITMAP_H_
+
+/**
+ * \file bm_bitmap.h: fixed size bitmap over the frames of the buffer pool
+ */
+
+#include <cstdint>
+#include <cstring>
+
+#include "swatdb_types.h"
+
+
+/**
+ * Number of bits held in one word of a FrameBitmap.
+ */
+static const std::uint32_t BM_WORD_BITS = 64;
+
+/**
+ * Number of words needed to hold one bit for every frame of the buffer pool.
+ */
+static const std::uint32_t BM_WORDS = (BUF_SIZE + BM_WORD_BITS - 1) /
+                                      BM_WORD_BITS;
+
+/**
+ * FrameBitmap Class.
+ * Stores one bit per Frame of the buffer pool, packed into 64-bit words so
+ * that replacement policies can examine 64 frames with a single load and find
+ * the next interesting frame with a count-trailing-zeros instruction instead
+ * of visiting frames one at a time. Bits past BUF_SIZE in the last word are
+ * always zero.
+ */
+class FrameBitmap {
+
+  public:
+
+    /**
+     * @brief Constructor. All bits are cleared.
+     */
+    FrameBitmap(){
+      this->clearAll();
+    }
+
+    /**
+     * @brief Clears every bit in the bitmap.
+     */
+    void clearAll(){
+      std::memset(this->bits, 0, sizeof(this->bits));
+    }
+
+    /**
+     * @brief Sets the bit of the given frame.
+     */
+    void set(FrameId frame_id){
+      this->bits[frame_id / BM_WORD_BITS] |= _bit(frame_id);
+    }
+
+    /**
+     * @brief Clears the bit of the given frame.
+     */
+    void clear(FrameId frame_id){
+      this->bits[frame_id / BM_WORD_BITS] &= ~_bit(frame_id);
+    }
+
+    /**
+     * @brief Returns true if the bit of the given frame is set.
+     */
+    bool test(FrameId frame_id) const {
+      return (this->bits[frame_id / BM_WORD_BITS] & _bit(frame_id)) != 0;
+    }
+
+    /**
+     * @brief Returns the number of set bits.
+     */
+    std::uint32_t count() const {
+      std::uint32_t total = 0;
+      for(std::uint32_t w = 0; w < BM_WORDS; w++){
+        total += __builtin_popcountll(this->bits[w]);
+      }
+      return total;
+    }
+
+    /**
+     * @brief Returns the first frame at or after start, wrapping around the
+     *        end of the buffer pool, whose bit is clear.
+     *
+     * @return FrameId of the frame found, or BUF_SIZE if every bit is set.
+     */
+    FrameId findNextClear(FrameId start) const {
+      std::uint32_t w = start / BM_WORD_BITS;
+      std::uint64_t clear = ~this->bits[w] & wordMask(w) &
+                            (~0ULL << (start % BM_WORD_BITS));
+      for(std::uint32_t i = 0; i <= BM_WORDS; i++){
+        if(clear != 0){
+          return w * BM_WORD_BITS + __builtin_ctzll(clear);
+        }
+        w = (w + 1) % BM_WORDS;
+        clear = ~this->bits[w] & wordMask(w);
+      }
+      return BUF_SIZE;
+    }
+
+    /**
+     * @brief Returns the mask of bits of word w that correspond to frames of
+     *        the buffer pool. All bits are valid except in the last word when
+     *        BUF_SIZE is not a multiple of 64.
+     */
+    static std::uint64_t wordMask(std::uint32_t w){
+      std::uint32_t tail = BUF_SIZE % BM_WORD_BITS;
+      if(w == BM_WORDS - 1 && tail != 0){
+        return (1ULL << tail) - 1;
+      }
+      return ~0ULL;
+    }
+
+    /**
+     * Packed bits, bit i of word w belongs to frame w * 64 + i. Public so that
+     * policies can scan and update whole words at a time.
+     */
+    std::uint64_t bits[BM_WORDS];
+
+  private:
+
+    /**
+     * @brief Returns the single-bit mask of a frame within its word.
+     */
+    static std::uint64_t _bit(FrameId frame_id){
+      return 1ULL << (frame_id % BM_WORD_BITS);
+    }
+};
+
+#endif
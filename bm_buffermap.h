@@ -5,6 +5,7 @@
  * \file bm_buffermap.h
  */
 
+#include <cstdint>
 #include <utility>
 #include <unordered_map>
 
@@ -20,6 +21,25 @@ struct BufHash{
   }
 };
 
+/**
+ * @brief Returns a well mixed 64-bit hash of both fields of the PageId, the
+ *        splitmix64 finalizer, so that consecutive pages of a file get
+ *        unrelated hashes. Shared by the TinyLFU sketch, the shards of
+ *        PartitionedBufferManager and the SHARDS sample of the miss ratio
+ *        curve.
+ *
+ * @param seed Users that take the same bits of the hash pass different
+ *        seeds, so that their choices are independent.
+ */
+inline std::uint64_t bm_hash64(PageId page_id, std::uint64_t seed = 0){
+  std::uint64_t x = ((std::uint64_t)page_id.file_id << 32) ^
+                    (std::uint64_t)page_id.page_num;
+  x += 0x9e3779b97f4a7c15ULL * (seed + 1);
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
 /**
  * BufferMap is a wrapper class for std::unordered_map<PageId, FrameId> that
  * maps PageIds to a Frame index in the buffer pool. Has different method names
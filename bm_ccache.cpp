@@ -0,0 +1,362 @@
+/**
+ * @file bm_ccache.cpp
+ * @author Nikoloz Khmaladze & Omar Ebied
+ * @date 2025-02-09
+ *
+ * Implementation of the CompressedCache class and its compressor.
+ * The compressor is a small LZ77 coder in the style of the LZ4 block
+ * format, written here so that the buffer manager links with no library
+ * beyond SwatDB. It finds matches with a single hash table of the last
+ * position of every 4-byte sequence, which is fast and does well on the
+ * repeated fields and zero padding of database pages.
+ */
+
+#include <iostream>
+#include <cstring>
+#include <iterator>
+
+#include "bm_ccache.h"
+#include "page.h"
+
+/**
+ * Shortest match, and length of the sequences hashed to find matches.
+ */
+static const std::size_t LZ_MIN_MATCH = 4;
+
+/**
+ * Longest distance back a match may start.
+ */
+static const std::size_t LZ_MAX_OFFSET = 65535;
+
+/**
+ * Number of bits of the hash of a 4-byte sequence.
+ */
+static const int LZ_HASH_BITS = 12;
+
+/**
+ * @brief Returns the 4 bytes at p as an integer.
+ */
+static std::uint32_t load32(const char *p){
+  std::uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+/**
+ * @brief Writes a length that did not fit in its 4 bits of the token, as
+ *    bytes of 255 followed by the rest.
+ *
+ * @return false if dst is full.
+ */
+static bool putLength(std::size_t len, char **dst, char *end){
+  while( len >= 255 ){
+    if( *dst == end ){
+      return false;
+    }
+    *(*dst)++ = (char)255;
+    len -= 255;
+  }
+  if( *dst == end ){
+    return false;
+  }
+  *(*dst)++ = (char)len;
+  return true;
+}
+
+/**
+ * @brief Reads a length written by putLength and adds it to len.
+ *
+ * @return false if src ends first.
+ */
+static bool getLength(std::size_t *len, const unsigned char **src,
+    const unsigned char *end){
+  unsigned char b;
+  do{
+    if( *src == end ){
+      return false;
+    }
+    b = *(*src)++;
+    *len += b;
+  }while( b == 255 );
+  return true;
+}
+
+/**
+ * @brief Writes one sequence: a token, the literals, and the match unless
+ *    match_len is 0, which ends the block.
+ *
+ * @return false if dst is full.
+ */
+static bool putSequence(const char *literals, std::size_t lit_len,
+    std::size_t offset, std::size_t match_len, char **dst, char *end){
+  std::size_t lit_code = lit_len < 15 ? lit_len : 15;
+  std::size_t match_code = 0;
+  if( match_len > 0 ){
+    match_code = match_len - LZ_MIN_MATCH < 15 ?
+                 match_len - LZ_MIN_MATCH : 15;
+  }
+
+  if( *dst == end ){
+    return false;
+  }
+  *(*dst)++ = (char)((lit_code << 4) | match_code);
+  if( lit_code == 15 && !putLength(lit_len - 15, dst, end) ){
+    return false;
+  }
+  if( (std::size_t)(end - *dst) < lit_len ){
+    return false;
+  }
+  std::memcpy(*dst, literals, lit_len);
+  *dst += lit_len;
+
+  if( match_len == 0 ){
+    return true;
+  }
+  if( end - *dst < 2 ){
+    return false;
+  }
+  *(*dst)++ = (char)(offset & 0xff);
+  *(*dst)++ = (char)(offset >> 8);
+  if( match_code == 15 &&
+      !putLength(match_len - LZ_MIN_MATCH - 15, dst, end) ){
+    return false;
+  }
+  return true;
+}
+
+
+/**
+ * @brief Compresses size bytes of src into dst with an LZ77 compressor in
+ *    the style of the LZ4 block format: sequences of literals followed by a
+ *    match of at least 4 bytes within the last 64 KB. The last sequence has
+ *    literals only.
+ *
+ * @param src Bytes to compress.
+ * @param size Number of bytes of src.
+ * @param dst Buffer for the compressed bytes.
+ * @param capacity Number of bytes of dst.
+ * @return Number of compressed bytes, or 0 if they do not fit in capacity.
+ */
+std::size_t bm_lz_compress(const char *src, std::size_t size, char *dst,
+    std::size_t capacity){
+  std::uint32_t table[1 << LZ_HASH_BITS] = {0};
+  char *out = dst;
+  char *end = dst + capacity;
+  std::size_t anchor = 0;
+  std::size_t pos = 0;
+
+  while( pos + LZ_MIN_MATCH <= size ){
+    std::uint32_t seq = load32(src + pos);
+    std::uint32_t hash = (seq * 2654435761u) >> (32 - LZ_HASH_BITS);
+    std::size_t cand = table[hash];
+    table[hash] = pos;
+
+    // an empty slot holds 0, which is only used if its bytes match
+    if( cand >= pos || pos - cand > LZ_MAX_OFFSET ||
+        load32(src + cand) != seq ){
+      pos++;
+      continue;
+    }
+
+    std::size_t len = LZ_MIN_MATCH;
+    while( pos + len < size && src[cand + len] == src[pos + len] ){
+      len++;
+    }
+    if( !putSequence(src + anchor, pos - anchor, pos - cand, len, &out,
+                     end) ){
+      return 0;
+    }
+    pos += len;
+    anchor = pos;
+  }
+
+  if( !putSequence(src + anchor, size - anchor, 0, 0, &out, end) ){
+    return 0;
+  }
+  return out - dst;
+}
+
+
+/**
+ * @brief Decompresses size bytes of src, compressed by bm_lz_compress, into
+ *    exactly dst_size bytes of dst. Every length and offset is checked, so
+ *    corrupt input never reads or writes out of bounds, and the block must
+ *    end with the literals-only sequence.
+ *
+ * @return false if src is not a valid compressed block of dst_size bytes.
+ */
+bool bm_lz_decompress(const char *src, std::size_t size, char *dst,
+    std::size_t dst_size){
+  const unsigned char *in = (const unsigned char*)src;
+  const unsigned char *in_end = in + size;
+  std::size_t out = 0;
+
+  while( in < in_end ){
+    unsigned char token = *in++;
+
+    std::size_t lit_len = token >> 4;
+    if( lit_len == 15 && !getLength(&lit_len, &in, in_end) ){
+      return false;
+    }
+    if( (std::size_t)(in_end - in) < lit_len || dst_size - out < lit_len ){
+      return false;
+    }
+    std::memcpy(dst + out, in, lit_len);
+    in += lit_len;
+    out += lit_len;
+
+    // the last sequence has no match
+    if( in == in_end ){
+      return out == dst_size;
+    }
+
+    if( in_end - in < 2 ){
+      return false;
+    }
+    std::size_t offset = in[0] | (in[1] << 8);
+    in += 2;
+    std::size_t match_len = (token & 0xf);
+    if( match_len == 15 && !getLength(&match_len, &in, in_end) ){
+      return false;
+    }
+    match_len += LZ_MIN_MATCH;
+    if( offset == 0 || offset > out || dst_size - out < match_len ){
+      return false;
+    }
+    // byte by byte: the match may overlap the bytes it produces
+    for( std::size_t i = 0; i < match_len; i++ ){
+      dst[out + i] = dst[out - offset + i];
+    }
+    out += match_len;
+  }
+  // a block cut after a match
+  return false;
+}
+
+
+/**
+ * @brief CompressedCache constructor.
+ *
+ * @param budget Number of bytes the cache may hold, counting
+ *    BM_CCACHE_OVERHEAD bytes of bookkeeping per page.
+ */
+CompressedCache::CompressedCache(std::size_t budget)
+  : scratch(PAGE_SIZE){
+  this->budget = budget;
+  std::memset(&this->stats, 0, sizeof(this->stats));
+}
+
+/**
+ * @brief Compresses and stores the page, replacing an older copy.
+ *
+ * @pre page holds the page of page_id as it is on disk.
+ * @post The page is stored unless it does not compress to 7/8 of PAGE_SIZE
+ *    or is larger than the budget. Pages stored longest ago are dropped
+ *    until the cache is within its budget.
+ */
+void CompressedCache::insert(PageId page_id, Page *page){
+  remove(page_id);
+
+  std::size_t size = bm_lz_compress(page->getData(), PAGE_SIZE,
+                                    scratch.data(), PAGE_SIZE / 8 * 7);
+  std::size_t cost = size + BM_CCACHE_OVERHEAD;
+  if( size == 0 || cost > budget ){
+    stats.rejects++;
+    return;
+  }
+
+  while( stats.used_bytes + cost > budget ){
+    _erase(entries.find(order.front()));
+    stats.evictions++;
+  }
+
+  Entry &entry = entries[page_id];
+  entry.data.assign(scratch.data(), scratch.data() + size);
+  entry.order = order.insert(order.end(), page_id);
+  stats.used_bytes += cost;
+  stats.entries++;
+  stats.inserts++;
+  stats.raw_bytes += PAGE_SIZE;
+  stats.stored_bytes += size;
+}
+
+/**
+ * @brief Decompresses the page into page and drops it from the cache.
+ *
+ * @return true if the page was in the cache.
+ */
+bool CompressedCache::fetch(PageId page_id, Page *page){
+  auto it = entries.find(page_id);
+  if( it == entries.end() ){
+    stats.misses++;
+    return false;
+  }
+
+  bool valid = bm_lz_decompress(it->second.data.data(),
+                                it->second.data.size(), page->getData(),
+                                PAGE_SIZE);
+  _erase(it);
+  if( !valid ){
+    stats.misses++;
+    return false;
+  }
+  stats.hits++;
+  return true;
+}
+
+/**
+ * @brief Drops the page from the cache, if it is there.
+ */
+void CompressedCache::remove(PageId page_id){
+  auto it = entries.find(page_id);
+  if( it != entries.end() ){
+    _erase(it);
+  }
+}
+
+/**
+ * @brief Drops every page of the file from the cache.
+ */
+void CompressedCache::removeFile(FileId file_id){
+  for( auto it = entries.begin(); it != entries.end(); ){
+    auto next = std::next(it);
+    if( it->first.file_id == file_id ){
+      _erase(it);
+    }
+    it = next;
+  }
+}
+
+/**
+ * @brief Returns the counters of the cache.
+ */
+CompressedCacheStats CompressedCache::getStats(){
+  return this->stats;
+}
+
+/**
+ * @brief Prints the hit rate, compression ratio and use of the budget.
+ */
+void CompressedCache::printStats(){
+  std::uint64_t fetches = stats.hits + stats.misses;
+  std::cout << "Compressed cache: " << stats.hits << " of " << fetches
+    << " misses served";
+  if( stats.stored_bytes > 0 ){
+    std::cout << ", compression ratio "
+      << (double)stats.raw_bytes / stats.stored_bytes;
+  }
+  std::cout << ", " << stats.rejects << " pages rejected, "
+    << stats.evictions << " evicted, " << stats.entries << " pages in "
+    << stats.used_bytes << " of " << budget << " bytes" << std::endl;
+}
+
+/**
+ * @brief Drops the entry of the page from the cache.
+ */
+void CompressedCache::_erase(
+    std::unordered_map<PageId, Entry, BufHash>::iterator it){
+  stats.used_bytes -= it->second.data.size() + BM_CCACHE_OVERHEAD;
+  stats.entries--;
+  order.erase(it->second.order);
+  entries.erase(it);
+}
@@ -0,0 +1,168 @@
+#ifndef _SWATDB_BM_CCACHE_H_
+#define  _SWATDB_BM_CCACHE_H_
+
+/**
+ * \file bm_ccache.h: CompressedCache class: second level cache of compressed
+ * pages evicted from the buffer pool, and the compressor it is built on
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "swatdb_types.h"
+#include "bm_buffermap.h"   // BufHash
+
+class Page;
+
+
+/**
+ * @brief Compresses size bytes of src into dst with an LZ77 compressor in
+ *        the style of the LZ4 block format: sequences of literals followed
+ *        by a match of at least 4 bytes within the last 64 KB.
+ *
+ * @param src Bytes to compress.
+ * @param size Number of bytes of src.
+ * @param dst Buffer for the compressed bytes.
+ * @param capacity Number of bytes of dst.
+ * @return Number of compressed bytes, or 0 if they do not fit in capacity.
+ */
+std::size_t bm_lz_compress(const char *src, std::size_t size, char *dst,
+                           std::size_t capacity);
+
+/**
+ * @brief Decompresses size bytes of src, compressed by bm_lz_compress, into
+ *        exactly dst_size bytes of dst.
+ *
+ * @return false if src is not a valid compressed block of dst_size bytes.
+ */
+bool bm_lz_decompress(const char *src, std::size_t size, char *dst,
+                      std::size_t dst_size);
+
+
+/**
+ * Counters of a CompressedCache.
+ */
+struct CompressedCacheStats {
+  std::uint64_t hits;          // fetches that found the page
+  std::uint64_t misses;        // fetches that did not
+  std::uint64_t inserts;       // pages stored
+  std::uint64_t rejects;       // pages that did not compress well enough
+  std::uint64_t evictions;     // pages dropped to stay within the budget
+  std::uint64_t raw_bytes;     // bytes of the pages stored, uncompressed
+  std::uint64_t stored_bytes;  // bytes of the pages stored, compressed
+  std::size_t used_bytes;      // bytes held now, with per-entry overhead
+  std::size_t entries;         // pages held now
+};
+
+
+/**
+ * SwatDB CompressedCache Class.
+ * Holds pages evicted from the buffer pool, compressed, within a budget of
+ * bytes, so that a miss in the buffer pool on a recently evicted page is
+ * served by decompressing it instead of reading it from disk. Only pages
+ * that are on disk as they are stored, clean or just written back, are put
+ * in it. The cache is exclusive: a page fetched from it leaves it, and is
+ * put back when it is evicted again, so no page is both in the buffer pool
+ * and here. Pages that compress to more than 7/8 of PAGE_SIZE are not
+ * stored. When the budget is exceeded, the pages stored longest ago are
+ * dropped first.
+ */
+class CompressedCache {
+
+  public:
+
+    /**
+     * @brief CompressedCache constructor.
+     *
+     * @param budget Number of bytes the cache may hold, counting
+     *    BM_CCACHE_OVERHEAD bytes of bookkeeping per page.
+     */
+    CompressedCache(std::size_t budget);
+
+    /**
+     * @brief Compresses and stores the page, replacing an older copy.
+     *
+     * @pre page holds the page of page_id as it is on disk.
+     * @post The page is stored unless it does not compress well enough or
+     *       is larger than the budget. Pages stored longest ago are dropped
+     *       until the cache is within its budget.
+     */
+    void insert(PageId page_id, Page *page);
+
+    /**
+     * @brief Decompresses the page into page and drops it from the cache.
+     *
+     * @return true if the page was in the cache.
+     */
+    bool fetch(PageId page_id, Page *page);
+
+    /**
+     * @brief Drops the page from the cache, if it is there.
+     */
+    void remove(PageId page_id);
+
+    /**
+     * @brief Drops every page of the file from the cache.
+     */
+    void removeFile(FileId file_id);
+
+    /**
+     * @brief Returns the counters of the cache.
+     */
+    CompressedCacheStats getStats();
+
+    /**
+     * @brief Prints the hit rate, compression ratio and use of the budget.
+     */
+    void printStats();
+
+    /**
+     * Bytes of bookkeeping counted for every page held.
+     */
+    static const std::size_t BM_CCACHE_OVERHEAD = 64;
+
+  private:
+
+    /**
+     * A compressed page, and its place in the insertion order.
+     */
+    struct Entry {
+      std::vector<char> data;
+      std::list<PageId>::iterator order;
+    };
+
+    /**
+     * Maps the PageIds of the pages held to their compressed bytes.
+     */
+    std::unordered_map<PageId, Entry, BufHash> entries;
+
+    /**
+     * PageIds of the pages held, stored longest ago first.
+     */
+    std::list<PageId> order;
+
+    /**
+     * Buffer a page is compressed into before it is stored.
+     */
+    std::vector<char> scratch;
+
+    /**
+     * Number of bytes the cache may hold.
+     */
+    std::size_t budget;
+
+    /**
+     * Counters, used_bytes and entries included.
+     */
+    CompressedCacheStats stats;
+
+    /**
+     * @brief Drops the entry of the page from the cache.
+     */
+    void _erase(std::unordered_map<PageId, Entry, BufHash>::iterator it);
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef _SWATDB_BM_EXCEPTIONS_H_
+#define  _SWATDB_BM_EXCEPTIONS_H_
+
+/**
+ * \file bm_exceptions.h: exceptions of the buffer manager that are not about
+ * a page or the replacement policy, in the style of swatdb_exceptions.h
+ */
+
+#include <string>
+
+#include "swatdb_types.h"
+#include "swatdb_exceptions.h"
+
+
+/**
+ * Exception thrown when an argument is out of its range, like a buffer pool
+ * split into 0 shards.
+ */
+class InvalidArgumentBufMgr: public SwatDBException {
+
+  public:
+
+    InvalidArgumentBufMgr(){}
+
+    virtual const char* what() const noexcept {
+      return "BufferManager: invalid argument";
+    }
+};
+
+
+/**
+ * Exception thrown when a Unix file the buffer manager opens on its own, a
+ * mapped file or a file it writes, cannot be opened, read, written or
+ * mapped.
+ */
+class IOErrorBufMgr: public SwatDBException {
+
+  public:
+
+    IOErrorBufMgr(const std::string &path){
+      this->path = path;
+    }
+
+    virtual const char* what() const noexcept {
+      return "BufferManager: I/O error";
+    }
+
+    /**
+     * Path of the file.
+     */
+    std::string path;
+};
+
+
+/**
+ * Exception thrown when a page of a file that is mapped, and so read-only,
+ * would be allocated or written.
+ */
+class ReadOnlyFileBufMgr: public SwatDBException {
+
+  public:
+
+    ReadOnlyFileBufMgr(FileId file_id){
+      this->file_id = file_id;
+    }
+
+    virtual const char* what() const noexcept {
+      return "BufferManager: file is read-only";
+    }
+
+    /**
+     * FileId of the file.
+     */
+    FileId file_id;
+};
+
+#endif
@@ -24,8 +24,16 @@ class Frame {
    *  (getters/setters alone won't do it)
    */
   friend class BufferManager;
+  template <class Policy> friend class BasicBufferManager;
+  template <class Policy> friend class ReplaySimulator;
   friend class ReplacementPolicy;
   friend class Clock;
+  friend class GClock;
+  friend class ClockPro;
+  friend class Lirs;
+  friend class Sieve;
+  friend class S3Fifo;
+  friend class PerFile;
   friend class Random;
 
 
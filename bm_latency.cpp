@@ -0,0 +1,226 @@
+/**
+ * @file bm_latency.cpp
+ * @author Nikoloz Khmaladze & Omar Ebied
+ * @date 2025-02-09
+ *
+ * Implementation of the LatencyHistogram class.
+ * Latencies are recorded in cycles, which cost a single instruction to read
+ * on x86, and only turned into nanoseconds when a percentile is asked for,
+ * with a rate measured once against the steady clock.
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+#include "bm_latency.h"
+
+/**
+ * How long bm_cycles_per_ns counts cycles against the steady clock.
+ */
+static const std::chrono::microseconds BM_LATENCY_CALIBRATION(2000);
+
+
+/**
+ * @brief Returns the name of a LatencyKind, as printed with its histogram.
+ */
+const char *bm_latency_str(LatencyKind kind){
+  switch( kind ){
+    case LatGetHit:
+      return "getPage hit";
+    case LatGetMiss:
+      return "getPage miss";
+    case LatReplace:
+      return "replace";
+    case LatRead:
+      return "readPage";
+    case LatWrite:
+      return "writePage";
+    default:
+      return "unknown";
+  }
+}
+
+/**
+ * @brief Measures the number of bm_cycles per nanosecond, by counting
+ *    cycles for BM_LATENCY_CALIBRATION of the steady clock.
+ */
+static double _calibrate(){
+  std::chrono::steady_clock::time_point start_time, end_time;
+  std::uint64_t start_cycles, end_cycles;
+
+  start_time = std::chrono::steady_clock::now();
+  start_cycles = bm_cycles();
+  do{
+    end_time = std::chrono::steady_clock::now();
+    end_cycles = bm_cycles();
+  } while( end_time - start_time < BM_LATENCY_CALIBRATION );
+
+  double ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      end_time - start_time).count();
+  return (end_cycles - start_cycles) / ns;
+}
+
+/**
+ * @brief Returns the number of bm_cycles per nanosecond, measured against
+ *    the steady clock on the first call.
+ */
+double bm_cycles_per_ns(){
+  static const double cycles_per_ns = _calibrate();
+  return cycles_per_ns;
+}
+
+
+/**
+ * @brief LatencyHistogram constructor. The histogram is empty.
+ */
+LatencyHistogram::LatencyHistogram(){
+  for( std::uint32_t i = 0; i < BM_LATENCY_BUCKETS; i++ ){
+    this->counts[i].store(0, std::memory_order_relaxed);
+  }
+  this->total.store(0, std::memory_order_relaxed);
+  this->max_cycles.store(0, std::memory_order_relaxed);
+  this->sum_cycles.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Copies the counts of another histogram.
+ */
+LatencyHistogram::LatencyHistogram(const LatencyHistogram &other)
+  : LatencyHistogram(){
+  merge(other);
+}
+
+LatencyHistogram& LatencyHistogram::operator=(const LatencyHistogram &other){
+  if( this != &other ){
+    for( std::uint32_t i = 0; i < BM_LATENCY_BUCKETS; i++ ){
+      this->counts[i].store(other.counts[i].load(std::memory_order_relaxed),
+                            std::memory_order_relaxed);
+    }
+    this->total.store(other.total.load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+    this->max_cycles.store(other.max_cycles.load(std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+    this->sum_cycles.store(other.sum_cycles.load(std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+  }
+  return *this;
+}
+
+/**
+ * @brief Adds the counts of another histogram to this one.
+ */
+void LatencyHistogram::merge(const LatencyHistogram &other){
+  std::uint64_t merged = 0;
+  for( std::uint32_t i = 0; i < BM_LATENCY_BUCKETS; i++ ){
+    std::uint64_t n = other.counts[i].load(std::memory_order_relaxed);
+    this->counts[i].store(this->counts[i].load(std::memory_order_relaxed) + n,
+                          std::memory_order_relaxed);
+    merged += n;
+  }
+  // the total of a histogram being recorded into may lag its buckets, so
+  // the buckets copied are counted instead
+  this->total.store(this->total.load(std::memory_order_relaxed) + merged,
+                    std::memory_order_relaxed);
+  std::uint64_t other_max = other.max_cycles.load(std::memory_order_relaxed);
+  if( other_max > this->max_cycles.load(std::memory_order_relaxed) ){
+    this->max_cycles.store(other_max, std::memory_order_relaxed);
+  }
+  this->sum_cycles.store(this->sum_cycles.load(std::memory_order_relaxed) +
+                         other.sum_cycles.load(std::memory_order_relaxed),
+                         std::memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the number of latencies recorded.
+ */
+std::uint64_t LatencyHistogram::count() const{
+  return this->total.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the latency, in cycles, that a fraction q of the recorded
+ *    latencies are at most, rounded up to the top of its bucket, or 0 if
+ *    nothing was recorded.
+ *
+ * @param q Fraction between 0 and 1, e.g. 0.99 for the 99th percentile.
+ */
+std::uint64_t LatencyHistogram::percentile(double q) const{
+  std::uint64_t n = count();
+  if( n == 0 ){
+    return 0;
+  }
+
+  // rank of the latency asked for, counting from 1
+  std::uint64_t rank = (std::uint64_t)(q * n + 0.5);
+  if( rank < 1 ){
+    rank = 1;
+  }
+  std::uint64_t max = this->max_cycles.load(std::memory_order_relaxed);
+  std::uint64_t seen = 0;
+  for( std::uint32_t i = 0; i < BM_LATENCY_BUCKETS; i++ ){
+    seen += this->counts[i].load(std::memory_order_relaxed);
+    if( seen >= rank ){
+      std::uint64_t top = _top(i);
+      return top < max ? top : max;
+    }
+  }
+  return max;
+}
+
+/**
+ * @brief Returns percentile(q) in nanoseconds.
+ */
+double LatencyHistogram::percentileNs(double q) const{
+  return percentile(q) / bm_cycles_per_ns();
+}
+
+/**
+ * @brief Returns the largest latency recorded, in nanoseconds.
+ */
+double LatencyHistogram::maxNs() const{
+  return this->max_cycles.load(std::memory_order_relaxed) /
+         bm_cycles_per_ns();
+}
+
+/**
+ * @brief Returns the sum of the latencies recorded, in cycles.
+ */
+std::uint64_t LatencyHistogram::sum() const{
+  return this->sum_cycles.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Returns sum() in nanoseconds.
+ */
+double LatencyHistogram::sumNs() const{
+  return sum() / bm_cycles_per_ns();
+}
+
+/**
+ * @brief Prints the count, p50, p99, p999 and max of the histogram, in
+ *    nanoseconds, after the given name.
+ */
+void LatencyHistogram::print(const char *name) const{
+  std::ios_base::fmtflags flags = std::cout.flags();
+  std::streamsize precision = std::cout.precision();
+  std::cout << std::fixed << std::setprecision(0) << name << ": " << count()
+    << " sampled, p50 " << percentileNs(0.5) << " ns, p99 "
+    << percentileNs(0.99) << " ns, p999 " << percentileNs(0.999)
+    << " ns, max " << maxNs() << " ns" << std::endl;
+  std::cout.flags(flags);
+  std::cout.precision(precision);
+}
+
+/**
+ * @brief Returns the largest latency of a bucket.
+ */
+std::uint64_t LatencyHistogram::_top(std::uint32_t bucket){
+  if( bucket < BM_LATENCY_SUB_BUCKETS ){
+    return bucket;
+  }
+  std::uint32_t shift = bucket / BM_LATENCY_SUB_BUCKETS - 1;
+  std::uint64_t sub = bucket % BM_LATENCY_SUB_BUCKETS;
+  // the top bucket reaches 2^64 - 1, which the shift below wraps to
+  return ((BM_LATENCY_SUB_BUCKETS + sub + 1) << shift) - 1;
+}
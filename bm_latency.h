@@ -0,0 +1,195 @@
+#ifndef _SWATDB_BM_LATENCY_H_
+#define  _SWATDB_BM_LATENCY_H_
+
+/**
+ * \file bm_latency.h: LatencyHistogram class: log-bucketed histogram of
+ * operation latencies, and the cycle counter they are measured with
+ */
+
+#include <atomic>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+
+/**
+ * The operations of a buffer manager whose latency is recorded.
+ */
+enum LatencyKind {
+  LatGetHit,    // getPage of a resident page
+  LatGetMiss,   // getPage that reads the page in
+  LatReplace,   // the replacement policy choosing a frame
+  LatRead,      // readPage of the DiskManager
+  LatWrite,     // writePage of the DiskManager
+  BM_NUM_LATENCIES
+};
+
+/**
+ * @brief Returns the name of a LatencyKind, as printed with its histogram.
+ */
+const char *bm_latency_str(LatencyKind kind);
+
+/**
+ * Number of bits of a latency kept below its highest set bit: every power of
+ * two is split into 2^BM_LATENCY_SUB_BITS buckets, so a recorded latency is
+ * known within 1/16 of its value.
+ */
+static const std::uint32_t BM_LATENCY_SUB_BITS = 4;
+static const std::uint32_t BM_LATENCY_SUB_BUCKETS = 1 << BM_LATENCY_SUB_BITS;
+
+/**
+ * Number of buckets of a histogram, enough for any 64-bit latency.
+ */
+static const std::uint32_t BM_LATENCY_BUCKETS =
+  (64 - BM_LATENCY_SUB_BITS + 1) * BM_LATENCY_SUB_BUCKETS;
+
+
+/**
+ * @brief Returns a fast, monotonic count of cycles: the time stamp counter
+ *        on x86, whose rate is constant on every CPU of the last decade, and
+ *        nanoseconds of the steady clock elsewhere.
+ */
+inline std::uint64_t bm_cycles(){
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ * @brief Returns the number of bm_cycles per nanosecond, measured against
+ *        the steady clock on the first call.
+ */
+double bm_cycles_per_ns();
+
+
+/**
+ * SwatDB LatencyHistogram Class.
+ * Histogram of latencies in bm_cycles, bucketed like an HDR histogram:
+ * latencies below 16 cycles have a bucket each, and every power of two
+ * above is split into 16 linear buckets, so percentiles are exact within
+ * 1/16 over the whole 64-bit range with a fixed set of buckets. Recording
+ * is a bucket index computation and relaxed atomic adds, so the histogram
+ * may be copied from any thread while latencies are recorded.
+ */
+class LatencyHistogram {
+
+  public:
+
+    /**
+     * @brief LatencyHistogram constructor. The histogram is empty.
+     */
+    LatencyHistogram();
+
+    /**
+     * @brief Copies the counts of another histogram.
+     */
+    LatencyHistogram(const LatencyHistogram &other);
+    LatencyHistogram& operator=(const LatencyHistogram &other);
+
+    /**
+     * @brief Records a latency of the given number of cycles.
+     */
+    void record(std::uint64_t cycles){
+      this->counts[_bucket(cycles)].fetch_add(1, std::memory_order_relaxed);
+      this->total.fetch_add(1, std::memory_order_relaxed);
+      this->sum_cycles.fetch_add(cycles, std::memory_order_relaxed);
+      std::uint64_t max = this->max_cycles.load(std::memory_order_relaxed);
+      while( cycles > max &&
+             !this->max_cycles.compare_exchange_weak(max, cycles,
+                 std::memory_order_relaxed) ){
+      }
+    }
+
+    /**
+     * @brief Adds the counts of another histogram to this one.
+     */
+    void merge(const LatencyHistogram &other);
+
+    /**
+     * @brief Returns the number of latencies recorded.
+     */
+    std::uint64_t count() const;
+
+    /**
+     * @brief Returns the latency, in cycles, that a fraction q of the
+     *        recorded latencies are at most, rounded up to the top of its
+     *        bucket, or 0 if nothing was recorded.
+     *
+     * @param q Fraction between 0 and 1, e.g. 0.99 for the 99th percentile.
+     */
+    std::uint64_t percentile(double q) const;
+
+    /**
+     * @brief Returns percentile(q) in nanoseconds.
+     */
+    double percentileNs(double q) const;
+
+    /**
+     * @brief Returns the largest latency recorded, in nanoseconds.
+     */
+    double maxNs() const;
+
+    /**
+     * @brief Returns the sum of the latencies recorded, in cycles.
+     */
+    std::uint64_t sum() const;
+
+    /**
+     * @brief Returns sum() in nanoseconds.
+     */
+    double sumNs() const;
+
+    /**
+     * @brief Prints the count, p50, p99, p999 and max of the histogram, in
+     *        nanoseconds, after the given name.
+     */
+    void print(const char *name) const;
+
+  private:
+
+    /**
+     * Number of latencies recorded in each bucket.
+     */
+    std::atomic<std::uint64_t> counts[BM_LATENCY_BUCKETS];
+
+    /**
+     * Number of latencies recorded.
+     */
+    std::atomic<std::uint64_t> total;
+
+    /**
+     * Largest latency recorded, in cycles.
+     */
+    std::atomic<std::uint64_t> max_cycles;
+
+    /**
+     * Sum of the latencies recorded, in cycles.
+     */
+    std::atomic<std::uint64_t> sum_cycles;
+
+    /**
+     * @brief Returns the bucket of a latency.
+     */
+    static std::uint32_t _bucket(std::uint64_t cycles){
+      if( cycles < BM_LATENCY_SUB_BUCKETS ){
+        return cycles;
+      }
+      std::uint32_t shift = 63 - __builtin_clzll(cycles) - BM_LATENCY_SUB_BITS;
+      return (shift + 1) * BM_LATENCY_SUB_BUCKETS +
+             ((cycles >> shift) & (BM_LATENCY_SUB_BUCKETS - 1));
+    }
+
+    /**
+     * @brief Returns the largest latency of a bucket.
+     */
+    static std::uint64_t _top(std::uint32_t bucket);
+};
+
+#endif
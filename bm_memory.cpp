@@ -0,0 +1,189 @@
+/**
+ * @file bm_memory.cpp
+ * @author Nikoloz Khmaladze & Omar Ebied
+ * @date 2025-02-09
+ *
+ * Implementation of the allocation of buffer pool memory.
+ * The memory is mapped with mmap so that it can be placed on huge pages and
+ * bound to a NUMA node with the mbind system call before it is first
+ * touched. mbind is called directly, so no NUMA library is needed, and
+ * every step that the system does not support falls back to the next one.
+ */
+
+#include <cstdint>
+#include <fstream>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "bm_memory.h"
+
+/**
+ * mbind mode that places memory on the given node while it has free memory
+ * and elsewhere after that (MPOL_PREFERRED of numaif.h).
+ */
+static const int BM_MPOL_PREFERRED = 1;
+
+/**
+ * @brief Returns size rounded up to a multiple of unit.
+ */
+static std::size_t roundUp(std::size_t size, std::size_t unit){
+  return (size + unit - 1) / unit * unit;
+}
+
+/**
+ * @brief Returns the printable name of a PoolMemory.
+ */
+std::string bm_pool_mem_str(PoolMemory memory){
+  switch(memory){
+    case HeapPool:
+      return "heap";
+    case BasePagePool:
+      return "base pages";
+    case TransparentPool:
+      return "transparent huge pages";
+    case HugeTlbPool:
+      return "hugetlb pages";
+  }
+  return "unknown";
+}
+
+#ifdef __linux__
+/**
+ * @brief Makes untouched memory prefer the given NUMA node. Does nothing if
+ *    node is -1, and leaves the memory where first touch puts it if the
+ *    node does not exist or the system has no NUMA support.
+ */
+static void bindToNode(void *mem, std::size_t size, int node){
+  if( node >= 0 && node < (int)(8 * sizeof(unsigned long)) - 1 ){
+    unsigned long node_mask = 1UL << node;
+    syscall(SYS_mbind, mem, size, BM_MPOL_PREFERRED, &node_mask,
+            8 * sizeof(node_mask), 0);
+  }
+}
+
+/**
+ * @brief Returns true if the kernel backs memory advised with MADV_HUGEPAGE
+ *    with transparent huge pages.
+ */
+static bool transparentHugePages(){
+  std::ifstream enabled("/sys/kernel/mm/transparent_hugepage/enabled");
+  std::string modes;
+  if( !std::getline(enabled, modes) ){
+    return false;
+  }
+  return modes.find("[never]") == std::string::npos;
+}
+
+/**
+ * @brief Maps size bytes, a multiple of BM_HUGE_PAGE_SIZE, aligned to
+ *    BM_HUGE_PAGE_SIZE, so that every huge page of the range can be backed
+ *    by a transparent huge page.
+ *
+ * @return Pointer to the memory, or MAP_FAILED.
+ */
+static void* mapAligned(std::size_t size){
+  // map one huge page more than needed and unmap the ends around the
+  // aligned range
+  void *mem = mmap(nullptr, size + BM_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if( mem == MAP_FAILED ){
+    return MAP_FAILED;
+  }
+  std::uintptr_t start = (std::uintptr_t)mem;
+  std::uintptr_t aligned = roundUp(start, BM_HUGE_PAGE_SIZE);
+  if( aligned > start ){
+    munmap(mem, aligned - start);
+  }
+  std::size_t tail = start + BM_HUGE_PAGE_SIZE - aligned;
+  if( tail > 0 ){
+    munmap((void*)(aligned + size), tail);
+  }
+  return (void*)aligned;
+}
+#endif
+
+/**
+ * @brief Maps size bytes of page aligned memory for a buffer pool. If
+ *    huge_pages is true, tries huge pages reserved with MAP_HUGETLB first,
+ *    then memory aligned to huge pages and advised with MADV_HUGEPAGE, then
+ *    base pages. If node is not -1, the memory prefers the given NUMA node;
+ *    if the node does not exist or the system has no NUMA support, it is
+ *    placed as usual.
+ *
+ * @param size Number of bytes.
+ * @param node NUMA node, or -1.
+ * @param huge_pages true to try huge pages.
+ * @param memory Set to the kind of memory obtained.
+ * @return Pointer to the memory, to be freed with bm_pool_free.
+ *
+ * @throw std::bad_alloc If the memory cannot be mapped.
+ */
+void* bm_pool_alloc(std::size_t size, int node, bool huge_pages,
+    PoolMemory *memory){
+#ifdef __linux__
+  void *mem;
+  if( huge_pages ){
+    std::size_t huge_size = roundUp(size, BM_HUGE_PAGE_SIZE);
+
+    // fails unless huge pages were reserved, e.g. in vm.nr_hugepages
+    mem = mmap(nullptr, huge_size, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if( mem != MAP_FAILED ){
+      bindToNode(mem, huge_size, node);
+      *memory = HugeTlbPool;
+      return mem;
+    }
+
+    if( transparentHugePages() ){
+      mem = mapAligned(huge_size);
+      if( mem != MAP_FAILED ){
+        if( madvise(mem, huge_size, MADV_HUGEPAGE) == 0 ){
+          bindToNode(mem, huge_size, node);
+          *memory = TransparentPool;
+          return mem;
+        }
+        munmap(mem, huge_size);
+      }
+    }
+  }
+
+  mem = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if( mem == MAP_FAILED ){
+    throw std::bad_alloc();
+  }
+  bindToNode(mem, size, node);
+  *memory = BasePagePool;
+  return mem;
+#else
+  (void)node;
+  (void)huge_pages;
+  *memory = HeapPool;
+  return ::operator new(size);
+#endif
+}
+
+/**
+ * @brief Unmaps memory returned by bm_pool_alloc with the same size, and the
+ *    kind of memory it reported.
+ */
+void bm_pool_free(void *mem, std::size_t size, PoolMemory memory){
+#ifdef __linux__
+  if( memory == HugeTlbPool || memory == TransparentPool ){
+    munmap(mem, roundUp(size, BM_HUGE_PAGE_SIZE));
+    return;
+  }
+  if( memory == BasePagePool ){
+    munmap(mem, size);
+    return;
+  }
+#endif
+  (void)size;
+  (void)memory;
+  ::operator delete(mem);
+}
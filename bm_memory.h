@@ -0,0 +1,58 @@
+#ifndef _SWATDB_BM_MEMORY_H_
+#define  _SWATDB_BM_MEMORY_H_
+
+/**
+ * \file bm_memory.h: allocation of the memory of the buffer pool, on a NUMA
+ * node and on huge pages
+ */
+
+#include <cstddef>
+#include <string>
+
+
+/**
+ * Size of a huge page, to which huge page mappings are rounded and aligned.
+ */
+static const std::size_t BM_HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+/**
+ * Kind of memory the buffer pool was placed in.
+ */
+enum PoolMemory {
+  HeapPool,          // allocated with new
+  BasePagePool,      // mapped on base pages
+  TransparentPool,   // mapped and advised to use transparent huge pages
+  HugeTlbPool        // mapped on huge pages reserved with MAP_HUGETLB
+};
+
+/**
+ * @brief Returns the printable name of a PoolMemory.
+ */
+std::string bm_pool_mem_str(PoolMemory memory);
+
+/**
+ * @brief Maps size bytes of page aligned memory for a buffer pool. If
+ *        huge_pages is true, tries huge pages reserved with MAP_HUGETLB
+ *        first, then memory aligned to huge pages and advised with
+ *        MADV_HUGEPAGE, then base pages. If node is not -1, the memory
+ *        prefers the given NUMA node; if the node does not exist or the
+ *        system has no NUMA support, it is placed as usual.
+ *
+ * @param size Number of bytes.
+ * @param node NUMA node, or -1.
+ * @param huge_pages true to try huge pages.
+ * @param memory Set to the kind of memory obtained.
+ * @return Pointer to the memory, to be freed with bm_pool_free.
+ *
+ * @throw std::bad_alloc If the memory cannot be mapped.
+ */
+void* bm_pool_alloc(std::size_t size, int node, bool huge_pages,
+                    PoolMemory *memory);
+
+/**
+ * @brief Unmaps memory returned by bm_pool_alloc with the same size, and the
+ *        kind of memory it reported.
+ */
+void bm_pool_free(void *mem, std::size_t size, PoolMemory memory);
+
+#endif
@@ -0,0 +1,157 @@
+/**
+ * @file bm_metrics.cpp
+ * @author Nikoloz Khmaladze & Omar Ebied
+ * @date 2025-02-09
+ *
+ * Renders the metrics of a buffer manager in the Prometheus text exposition
+ * format. The counters and histograms are read from snapshots and copies, so
+ * the cost of a scrape is that of getBufferState, one pass over the frame
+ * table, and a few kilobytes of text: cheap enough to be done every second.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "bm_metrics.h"
+#include "bufmgr.h"
+#include "swatdb_exceptions.h"
+#include "bm_exceptions.h"
+
+/**
+ * Value of the op label of the latency summary of each LatencyKind.
+ */
+static const char *BM_METRICS_OPS[BM_NUM_LATENCIES] = {
+  "get_hit", "get_miss", "replace", "read", "write"
+};
+
+/**
+ * Quantiles of the latency summaries.
+ */
+static const double BM_METRICS_QUANTILES[] = {0.5, 0.99, 0.999};
+
+
+/**
+ * @brief Writes the HELP and TYPE lines of a metric.
+ */
+static void _header(std::ostringstream &out, const char *name,
+                    const char *type, const char *help){
+  out << "# HELP swatdb_buffer_" << name << " " << help << "\n";
+  out << "# TYPE swatdb_buffer_" << name << " " << type << "\n";
+}
+
+/**
+ * @brief Writes a metric with a single sample. Counters are written as
+ *    integers, so that large ones keep every digit.
+ */
+template <class T>
+static void _metric(std::ostringstream &out, const char *name,
+                    const char *type, const char *help, T value){
+  _header(out, name, type, help);
+  out << "swatdb_buffer_" << name << " " << value << "\n";
+}
+
+
+/**
+ * @brief Renders the state of the buffer pool, the statistics of its
+ *    replacement policy, its hit, miss, eviction and I/O counters and the
+ *    latency histograms that have samples in the Prometheus text exposition
+ *    format, version 0.0.4.
+ *
+ * @param state State of the buffer pool.
+ * @param stats Counters of the buffer pool.
+ * @param latency Latency histograms, indexed by LatencyKind.
+ * @return The metrics, one sample per line.
+ */
+std::string bm_metrics_text(const BufferState &state,
+                            const BufferStats &stats,
+                            const LatencyHistogram *latency){
+  std::ostringstream out;
+  out.precision(9);
+
+  _metric(out, "frames", "gauge", "Frames of the buffer pool.", state.total);
+  _header(out, "pages", "gauge", "Pages of the buffer pool by state.");
+  out << "swatdb_buffer_pages{state=\"valid\"} " << state.valid << "\n";
+  out << "swatdb_buffer_pages{state=\"pinned\"} " << state.pinned << "\n";
+  out << "swatdb_buffer_pages{state=\"unpinned\"} " << state.unpinned << "\n";
+  out << "swatdb_buffer_pages{state=\"dirty\"} " << state.dirty << "\n";
+
+  const BufferState::ReplacementStats &rep = state.replace_stats;
+  _header(out, "replacement_calls_total", "counter",
+          "Calls to the replacement policy.");
+  out << "swatdb_buffer_replacement_calls_total{policy=\""
+    << bm_rep_str(rep.rep_type) << "\"} " << rep.rep_calls << "\n";
+  _metric(out, "page_requests_total", "counter",
+          "getPage and allocatePage calls.", rep.new_page_calls);
+  _metric(out, "replacement_frames_checked", "gauge",
+          "Average frames checked by the replacement policy per call.",
+          rep.avg_frames_checked);
+  _metric(out, "ref_bit_pages", "gauge",
+          "Pages with their reference bit set.", rep.ref_bit);
+
+  _metric(out, "hits_total", "counter",
+          "getPage calls that found the page resident.", stats.hits);
+  _metric(out, "misses_total", "counter",
+          "getPage calls that read the page in.", stats.misses);
+  _header(out, "evictions_total", "counter",
+          "Pages removed from the buffer pool.");
+  out << "swatdb_buffer_evictions_total{kind=\"clean\"} "
+    << stats.clean_evictions << "\n";
+  out << "swatdb_buffer_evictions_total{kind=\"dirty\"} "
+    << stats.dirty_evictions << "\n";
+  _metric(out, "reads_total", "counter",
+          "Pages read through the DiskManager.", stats.reads);
+  _metric(out, "writes_total", "counter",
+          "Pages written through the DiskManager.", stats.writes);
+  _metric(out, "read_bytes_total", "counter",
+          "Bytes read through the DiskManager.", stats.bytes_read);
+  _metric(out, "written_bytes_total", "counter",
+          "Bytes written through the DiskManager.", stats.bytes_written);
+  _metric(out, "pin_waits_total", "counter",
+          "Calls turned away because every page was pinned.",
+          stats.pin_waits);
+
+  bool header = false;
+  for( std::uint32_t i = 0; i < BM_NUM_LATENCIES; i++ ){
+    if( latency[i].count() == 0 ){
+      continue;
+    }
+    if( !header ){
+      _header(out, "latency_seconds", "summary",
+              "Latency of sampled buffer manager operations.");
+      header = true;
+    }
+    for( double q : BM_METRICS_QUANTILES ){
+      out << "swatdb_buffer_latency_seconds{op=\"" << BM_METRICS_OPS[i]
+        << "\",quantile=\"" << q << "\"} "
+        << latency[i].percentileNs(q) * 1e-9 << "\n";
+    }
+    out << "swatdb_buffer_latency_seconds_sum{op=\"" << BM_METRICS_OPS[i]
+      << "\"} " << latency[i].sumNs() * 1e-9 << "\n";
+    out << "swatdb_buffer_latency_seconds_count{op=\"" << BM_METRICS_OPS[i]
+      << "\"} " << latency[i].count() << "\n";
+  }
+
+  return out.str();
+}
+
+/**
+ * @brief Writes metrics rendered by bm_metrics_text to a file. The file is
+ *    written aside and renamed, so a scraper reading it never sees half of
+ *    it.
+ *
+ * @param path Path of the metrics file.
+ * @param text The metrics.
+ *
+ * @throw IOErrorBufMgr If the file cannot be written.
+ */
+void bm_write_metrics(const std::string &path, const std::string &text){
+  std::string tmp_path = path + ".tmp";
+  std::ofstream out(tmp_path);
+  out << text;
+  out.close();
+  if( !out || std::rename(tmp_path.c_str(), path.c_str()) != 0 ){
+    std::remove(tmp_path.c_str());
+    throw IOErrorBufMgr(path);
+  }
+}
@@ -0,0 +1,47 @@
+#ifndef _SWATDB_BM_METRICS_H_
+#define  _SWATDB_BM_METRICS_H_
+
+/**
+ * \file bm_metrics.h: renders the state, counters and latency histograms of
+ * a buffer manager in the Prometheus text exposition format
+ */
+
+#include <string>
+
+#include "bm_stats.h"       // BufferStats
+#include "bm_latency.h"     // LatencyHistogram
+
+struct BufferState;
+
+
+/**
+ * @brief Renders the state of the buffer pool, the statistics of its
+ *        replacement policy, its hit, miss, eviction and I/O counters and
+ *        the latency histograms that have samples in the Prometheus text
+ *        exposition format, version 0.0.4. Every metric is prefixed with
+ *        swatdb_buffer_. Counters end in _total, and latencies are
+ *        summaries in seconds with quantiles 0.5, 0.99 and 0.999, a
+ *        _sum and a _count.
+ *
+ * @param state State of the buffer pool.
+ * @param stats Counters of the buffer pool.
+ * @param latency Latency histograms, indexed by LatencyKind.
+ * @return The metrics, one sample per line.
+ */
+std::string bm_metrics_text(const BufferState &state,
+                            const BufferStats &stats,
+                            const LatencyHistogram *latency);
+
+/**
+ * @brief Writes metrics rendered by bm_metrics_text to a file. The file is
+ *        written aside and renamed, so a scraper reading it, e.g. the
+ *        textfile collector of the node exporter, never sees half of it.
+ *
+ * @param path Path of the metrics file, e.g. ending in .prom.
+ * @param text The metrics.
+ *
+ * @throw IOErrorBufMgr If the file cannot be written.
+ */
+void bm_write_metrics(const std::string &path, const std::string &text);
+
+#endif
@@ -0,0 +1,515 @@
+/**
+ * @file bm_mmap.cpp
+ * @author Nikoloz Khmaladze & Omar Ebied
+ * @date 2025-02-09
+ *
+ * Implementation of the MappedFiles class.
+ * Pages of a mapped file are read in place in a read-only MAP_SHARED mapping
+ * of its Unix file. The buffer manager decides which of them stay in memory
+ * with madvise, and never copies them into the buffer pool.
+ */
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "bm_mmap.h"
+#include "swatdb_exceptions.h"
+#include "bm_exceptions.h"
+#include "diskmgr.h"
+#include "page.h"
+
+
+/**
+ * @brief MappedFiles constructor.
+ *
+ * @param disk_mgr A pointer to SwatDB's DiskManager object.
+ *    (DiskManager*).
+ * @param max_resident Number of unpinned pages kept mapped in.
+ */
+MappedFiles::MappedFiles(DiskManager *disk_mgr, std::uint32_t max_resident){
+  this->disk_mgr = disk_mgr;
+  this->max_resident = max_resident;
+  this->resident = 0;
+  this->clock = 0;
+  this->sys_page = sysconf(_SC_PAGESIZE);
+}
+
+/**
+ * @brief MappedFiles destructor.
+ *
+ * @post Every file is unmapped.
+ */
+MappedFiles::~MappedFiles(){
+  for( auto &entry : files ){
+    _unmapRange(entry.second);
+    close(entry.second.fd);
+  }
+}
+
+/**
+ * @brief Maps the Unix file of the given FileId, read-only. Pages are taken
+ *    to be stored contiguously at the end of the file, and the first and the
+ *    last BM_MMAP_CHECK_PAGES pages the DiskManager can read are compared
+ *    with the mapping.
+ *
+ * @pre None of the file's pages are in the buffer pool.
+ * @post Pages of the file are served from the mapping.
+ *
+ * @param file_id FileId of the file.
+ * @param path Path of the Unix file of file_id.
+ *
+ * @throw IOErrorBufMgr If the file cannot be opened or mapped, or its layout
+ *    does not match the pages read by the DiskManager.
+ */
+void MappedFiles::map(FileId file_id, const std::string &path){
+  if( contains(file_id) ){
+    return;
+  }
+
+  MappedFile file;
+  file.fd = open(path.c_str(), O_RDONLY);
+  if( file.fd < 0 ){
+    throw IOErrorBufMgr(path);
+  }
+
+  struct stat st;
+  file.capacity = disk_mgr->getCapacity(file_id);
+  std::size_t data_size = (std::size_t)file.capacity * PAGE_SIZE;
+  if( fstat(file.fd, &st) != 0 || (std::size_t)st.st_size < data_size ){
+    close(file.fd);
+    throw IOErrorBufMgr(path);
+  }
+  file.offset = st.st_size - data_size;
+  file.max_pages = 2 * file.capacity > BM_MMAP_MIN_PAGES ?
+                   2 * file.capacity : BM_MMAP_MIN_PAGES;
+  file.pinned = 0;
+  file.base = _mapRange(file, file.max_pages);
+  if( file.base == nullptr ){
+    close(file.fd);
+    throw IOErrorBufMgr(path);
+  }
+
+  // a page the DiskManager reads differently means the layout is not the
+  // one inferred; a header or trailer of another size shifts the pages at
+  // either end
+  bool matches = true;
+  for( PageNum i = 0; i < file.capacity && matches; i++ ){
+    if( i == BM_MMAP_CHECK_PAGES && file.capacity > 2 * BM_MMAP_CHECK_PAGES ){
+      i = file.capacity - BM_MMAP_CHECK_PAGES;
+    }
+    matches = _check(file, PageId{file_id, i});
+  }
+  if( !matches ){
+    _unmapRange(file);
+    close(file.fd);
+    throw IOErrorBufMgr(path);
+  }
+
+  files.emplace(file_id, std::move(file));
+}
+
+/**
+ * @brief Unmaps the file.
+ *
+ * @throw PagePinnedBufMgr If a page of the file is pinned. The file stays
+ *    mapped.
+ */
+void MappedFiles::unmap(FileId file_id){
+  auto it = files.find(file_id);
+  if( it == files.end() ){
+    return;
+  }
+  MappedFile &file = it->second;
+
+  for( auto &entry : file.pages ){
+    if( entry.second.pin_count > 0 ){
+      throw PagePinnedBufMgr(PageId{file_id, entry.first});
+    }
+  }
+  for( auto &entry : file.pages ){
+    if( entry.second.resident ){
+      resident--;
+    }
+  }
+
+  _unmapRange(file);
+  close(file.fd);
+  // entries of the file left in cold are stale: their file is not found
+  files.erase(it);
+}
+
+/**
+ * @brief Returns true if the file of the given FileId is mapped.
+ */
+bool MappedFiles::contains(FileId file_id){
+  return files.find(file_id) != files.end();
+}
+
+/**
+ * @brief Drops the page from the mapping and deallocates it on disk.
+ *
+ * @throw PagePinnedBufMgr If the Page is pinned.
+ * @throw InvalidPageNumDiskMgr If page_id.page_num is invalid.
+ */
+void MappedFiles::deallocatePage(PageId page_id){
+  MappedFile &file = _file(page_id.file_id, page_id);
+
+  auto it = file.pages.find(page_id.page_num);
+  if( it != file.pages.end() ){
+    if( it->second.pin_count > 0 ){
+      throw PagePinnedBufMgr(page_id);
+    }
+    if( it->second.resident ){
+      _drop(file, page_id.page_num, it->second);
+    }
+  }
+
+  disk_mgr->deallocatePage(page_id);
+  if( it != file.pages.end() ){
+    file.pages.erase(it);
+  }
+  file.freed.insert(page_id.page_num);
+}
+
+/**
+ * @brief Pins the page and returns a read-only pointer to its data in the
+ *    mapping. A page not pinned before is checked against the capacity of the file, which is
+ *    asked of the DiskManager again only when the page lies beyond the
+ *    capacity seen last.
+ *
+ * @throw InvalidPageIdBufMgr If the page is not in the file or was
+ *    deallocated through this buffer manager.
+ * @throw InsufficientSpaceBufMgr If the page lies beyond the reserved
+ *    address space while pages of the file are pinned.
+ */
+const char* MappedFiles::getPage(PageId page_id, AccessHint hint){
+  MappedFile &file = _file(page_id.file_id, page_id);
+
+  if( file.pages.find(page_id.page_num) == file.pages.end() ){
+    if( page_id.page_num >= file.capacity ){
+      file.capacity = disk_mgr->getCapacity(page_id.file_id);
+    }
+    if( page_id.page_num >= file.capacity ||
+        file.freed.count(page_id.page_num) > 0 ){
+      throw InvalidPageIdBufMgr(page_id);
+    }
+    _reserve(file, page_id.page_num);
+  }
+  return _pin(file, page_id, hint);
+}
+
+/**
+ * @brief Unpins the page. At pin count 0 a page released with OnceHint is
+ *    dropped from memory right away, any other page becomes the most
+ *    recently unpinned one.
+ *
+ * @param page_id PageId of the Page to be released.
+ * @param dirty true if the caller modified the Page.
+ * @param hint How the page will be accessed. NoHint keeps the hint given to
+ *    getPage.
+ *
+ * @throw ReadOnlyFileBufMgr If dirty is true: the mapping is read-only. The
+ *    page is unpinned first, as for any other release.
+ * @throw PageNotPinnedBufMgr If Page is not pinned.
+ * @throw PageNotFoundBufMgr If the page was never pinned.
+ */
+void MappedFiles::releasePage(PageId page_id, bool dirty, AccessHint hint){
+  MappedFile &file = _file(page_id.file_id, page_id);
+  MappedPage &page = _page(page_id);
+
+  if( page.pin_count == 0 ){
+    throw PageNotPinnedBufMgr(page_id);
+  }
+  page.pin_count--;
+
+  if( hint == NoHint ){
+    hint = page.hint;
+  }
+  if( page.pin_count > 0 ){
+    page.hint = hint;
+  }
+  else{
+    file.pinned--;
+    page.hint = NoHint;
+    resident++;
+    if( hint == OnceHint ){
+      _drop(file, page_id.page_num, page);
+    }
+    else{
+      page.stamp = ++clock;
+      cold.push_back(std::make_pair(page_id, page.stamp));
+      _trim();
+    }
+  }
+
+  // the pin is given up either way, so that a refused write leaks no pin
+  if( dirty ){
+    throw ReadOnlyFileBufMgr(page_id.file_id);
+  }
+}
+
+/**
+ * @brief Does nothing: pages of a mapped file are never dirty, their writes
+ *    going through the DiskManager.
+ *
+ * @throw PageNotFoundBufMgr If the page was never pinned.
+ */
+void MappedFiles::flushPage(PageId page_id){
+  _page(page_id);
+}
+
+/**
+ * @brief Returns true if the page is mapped in.
+ */
+bool MappedFiles::isResident(PageId page_id){
+  auto file = files.find(page_id.file_id);
+  if( file == files.end() ){
+    return false;
+  }
+  auto page = file->second.pages.find(page_id.page_num);
+  return page != file->second.pages.end() && page->second.resident;
+}
+
+/**
+ * @brief Returns the number of pages of the file in its capacity that the
+ *    kernel holds in memory, sampled with mincore, or 0 if the file is not
+ *    mapped. A page counts if its first byte is in memory.
+ */
+std::uint32_t MappedFiles::sampleResident(FileId file_id){
+  auto it = files.find(file_id);
+  if( it == files.end() || it->second.capacity == 0 ){
+    return 0;
+  }
+  MappedFile &file = it->second;
+  std::uint32_t count = 0;
+  std::size_t end = file.offset + (std::size_t)file.capacity * PAGE_SIZE;
+  std::size_t num_sys = (end + sys_page - 1) / sys_page;
+  unsigned char *vec = new unsigned char[num_sys];
+  if( mincore(file.base, num_sys * sys_page, vec) == 0 ){
+    for( PageNum i = 0; i < file.capacity; i++ ){
+      std::size_t first = (file.offset + (std::size_t)i * PAGE_SIZE) /
+                          sys_page;
+      count += vec[first] & 1;
+    }
+  }
+  delete[] vec;
+  return count;
+}
+
+/**
+ * @brief Returns the mapped file of file_id.
+ *
+ * @throw PageNotFoundBufMgr with page_id If the file is not mapped.
+ */
+MappedFiles::MappedFile& MappedFiles::_file(FileId file_id, PageId page_id){
+  auto it = files.find(file_id);
+  if( it == files.end() ){
+    throw PageNotFoundBufMgr(page_id);
+  }
+  return it->second;
+}
+
+/**
+ * @brief Returns the state of a page that has been pinned.
+ *
+ * @throw PageNotFoundBufMgr If the page was never pinned.
+ */
+MappedFiles::MappedPage& MappedFiles::_page(PageId page_id){
+  MappedFile &file = _file(page_id.file_id, page_id);
+  auto it = file.pages.find(page_id.page_num);
+  if( it == file.pages.end() ){
+    throw PageNotFoundBufMgr(page_id);
+  }
+  return it->second;
+}
+
+/**
+ * @brief Returns the address of a page in the mapping.
+ */
+char* MappedFiles::_address(MappedFile &file, PageNum page_num){
+  return file.base + file.offset + (std::size_t)page_num * PAGE_SIZE;
+}
+
+/**
+ * @brief Calls madvise on the system pages a page lies in. A system page
+ *    shared with a neighbouring page is only faulted in again by it.
+ */
+void MappedFiles::_advise(MappedFile &file, PageNum page_num, int advice){
+  std::uintptr_t start = (std::uintptr_t)_address(file, page_num);
+  std::uintptr_t aligned = start / sys_page * sys_page;
+  madvise((void*)aligned, start + PAGE_SIZE - aligned, advice);
+}
+
+/**
+ * @brief Unmaps a page and drops it from the page cache. MADV_DONTNEED only
+ *    unmaps the page of a shared mapping, the page cache keeping it, so the
+ *    same system pages are dropped with POSIX_FADV_DONTNEED too. The kernel
+ *    keeps those still mapped by a pinned neighbouring page.
+ */
+void MappedFiles::_evict(MappedFile &file, PageNum page_num){
+  std::size_t start = file.offset + (std::size_t)page_num * PAGE_SIZE;
+  std::size_t aligned = start / sys_page * sys_page;
+  _advise(file, page_num, MADV_DONTNEED);
+  posix_fadvise(file.fd, aligned, start + PAGE_SIZE - aligned,
+                POSIX_FADV_DONTNEED);
+}
+
+/**
+ * @brief Returns true if the page reads the same through the DiskManager as
+ *    in the mapping, or cannot be read by it. The page is dropped from
+ *    memory again.
+ */
+bool MappedFiles::_check(MappedFile &file, PageId page_id){
+  Page check;
+  try{
+    disk_mgr->readPage(page_id, &check);
+  }catch (InvalidPageNumDiskMgr &e){
+    return true;
+  }
+  bool matches = std::memcmp(check.getData(), _address(file, page_id.page_num),
+                             PAGE_SIZE) == 0;
+  _evict(file, page_id.page_num);
+  return matches;
+}
+
+/**
+ * @brief Maps max_pages pages of the file, after its offset. Kernel
+ *    readahead is turned off, pages are prefetched one at a time when they
+ *    are pinned. Address space past the end of the file is reserved for the
+ *    pages allocated later.
+ *
+ * @return Start of the mapping, or nullptr if it failed.
+ */
+char* MappedFiles::_mapRange(MappedFile &file, std::uint32_t max_pages){
+  std::size_t length = file.offset + (std::size_t)max_pages * PAGE_SIZE;
+  void *mem = mmap(nullptr, length, PROT_READ, MAP_SHARED, file.fd, 0);
+  if( mem == MAP_FAILED ){
+    return nullptr;
+  }
+  madvise(mem, length, MADV_RANDOM);
+  return (char*)mem;
+}
+
+/**
+ * @brief Unmaps the mapping of the file.
+ */
+void MappedFiles::_unmapRange(MappedFile &file){
+  munmap(file.base, file.offset + (std::size_t)file.max_pages * PAGE_SIZE);
+}
+
+/**
+ * @brief Makes the mapping large enough for page_num, remapping it if no
+ *    page of the file is pinned. Remapping drops every page of the file from
+ *    memory.
+ *
+ * @throw InsufficientSpaceBufMgr If the mapping is too small and a page of
+ *    the file is pinned, or a larger mapping cannot be made.
+ */
+void MappedFiles::_reserve(MappedFile &file, PageNum page_num){
+  if( page_num < file.max_pages ){
+    return;
+  }
+  // pinned pages must not move
+  if( file.pinned > 0 ){
+    throw InsufficientSpaceBufMgr();
+  }
+
+  std::uint32_t max_pages = 2 * page_num > 2 * file.max_pages ?
+                            2 * page_num : 2 * file.max_pages;
+  char *base = _mapRange(file, max_pages);
+  if( base == nullptr ){
+    throw InsufficientSpaceBufMgr();
+  }
+  _unmapRange(file);
+  file.base = base;
+  file.max_pages = max_pages;
+
+  for( auto &entry : file.pages ){
+    if( entry.second.resident ){
+      entry.second.resident = false;
+      resident--;
+    }
+  }
+}
+
+/**
+ * @brief Pins a page that is known to be in the file and within the
+ *    mapping, prefetching it if it is not mapped in.
+ */
+const char* MappedFiles::_pin(MappedFile &file, PageId page_id,
+    AccessHint hint){
+  MappedPage &page = file.pages[page_id.page_num];
+
+  if( page.pin_count == 0 ){
+    if( page.resident ){
+      resident--;
+    }
+    else{
+      _advise(file, page_id.page_num, MADV_WILLNEED);
+      page.resident = true;
+    }
+    file.pinned++;
+  }
+  page.pin_count++;
+  // NoHint keeps the hint of an earlier pinner, as in releasePage
+  if( hint != NoHint ){
+    page.hint = hint;
+  }
+  return _address(file, page_id.page_num);
+}
+
+/**
+ * @brief Drops an unpinned page from memory. Its data stays in the file,
+ *    and the next getPage reads it in again.
+ */
+void MappedFiles::_drop(MappedFile &file, PageNum page_num,
+    MappedPage &page){
+  _evict(file, page_num);
+  page.resident = false;
+  page.stamp = 0;
+  resident--;
+}
+
+/**
+ * @brief Drops the least recently unpinned pages while more than
+ *    max_resident unpinned pages are mapped in, and discards stale entries
+ *    of cold once they outnumber the live ones.
+ */
+void MappedFiles::_trim(){
+  while( resident > max_resident && !cold.empty() ){
+    std::pair<PageId, std::uint64_t> entry = cold.front();
+    cold.pop_front();
+
+    auto file = files.find(entry.first.file_id);
+    if( file == files.end() ){
+      continue;
+    }
+    auto page = file->second.pages.find(entry.first.page_num);
+    if( page == file->second.pages.end() ||
+        page->second.stamp != entry.second || page->second.pin_count > 0 ||
+        !page->second.resident ){
+      continue;
+    }
+    _drop(file->second, entry.first.page_num, page->second);
+  }
+
+  if( cold.size() > 2 * (std::size_t)max_resident + 16 ){
+    std::deque<std::pair<PageId, std::uint64_t>> live;
+    for( auto &entry : cold ){
+      auto file = files.find(entry.first.file_id);
+      if( file == files.end() ){
+        continue;
+      }
+      auto page = file->second.pages.find(entry.first.page_num);
+      if( page != file->second.pages.end() &&
+          page->second.stamp == entry.second ){
+        live.push_back(entry);
+      }
+    }
+    cold.swap(live);
+  }
+}
@@ -0,0 +1,299 @@
+#ifndef _SWATDB_BM_MMAP_H_
+#define  _SWATDB_BM_MMAP_H_
+
+/**
+ * \file bm_mmap.h: MappedFiles class: files whose pages are served straight
+ * from a read-only shared memory mapping of their Unix file
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "swatdb_types.h"
+#include "bufmgr.h"         // AccessHint
+
+class DiskManager;
+
+
+/**
+ * Smallest number of pages the mapping of a file reserves address space for.
+ * The reservation is twice the capacity of the file if that is larger, and
+ * is only ever backed by memory for the pages that are accessed.
+ */
+static const std::uint32_t BM_MMAP_MIN_PAGES = 1 << 16;
+
+/**
+ * Number of pages at the start and at the end of a file that are compared
+ * with what the DiskManager reads when the file is mapped.
+ */
+static const std::uint32_t BM_MMAP_CHECK_PAGES = 4;
+
+
+/**
+ * SwatDB MappedFiles Class.
+ * Serves the pages of mapped files from a read-only MAP_SHARED mapping of
+ * their Unix file instead of copying them into frames of the buffer pool.
+ * getPage returns a read-only pointer into the mapping, so a page is read by
+ * the kernel into the page cache and accessed in place.
+ *
+ * The DiskManager does not expose where a page lives in its Unix file, so
+ * the layout is inferred when a file is mapped: pages are taken to be stored
+ * contiguously in page number order at the end of the file, after a header
+ * of whatever size is left over. The inference is checked against the first
+ * and the last BM_MMAP_CHECK_PAGES pages read through the DiskManager, and
+ * the file is not mapped if they differ. As the inference can still be
+ * wrong for the pages in between, the mapping is PROT_READ and every write
+ * of a mapped file goes through the DiskManager: pages cannot be allocated,
+ * set dirty or released dirty while the file is mapped. The DiskManager
+ * must read the file without buffering of its own, so that the mapping sees
+ * the pages it writes.
+ *
+ * Pin counts are kept per page, with the exceptions of the buffer pool.
+ * Residency is controlled by the buffer manager rather than left to the
+ * kernel: kernel readahead is turned off for the mapping, a page is
+ * prefetched with MADV_WILLNEED when it is pinned, and at most max_resident
+ * unpinned pages stay mapped in, the least recently unpinned one being
+ * unmapped with MADV_DONTNEED and dropped from the page cache with
+ * POSIX_FADV_DONTNEED, as MADV_DONTNEED alone frees nothing on a shared
+ * mapping. mincore reports how many pages the kernel actually holds.
+ */
+class MappedFiles {
+
+  public:
+
+    /**
+     * @brief MappedFiles constructor.
+     *
+     * @param disk_mgr A pointer to SwatDB's DiskManager object.
+     *    (DiskManager*).
+     * @param max_resident Number of unpinned pages kept mapped in.
+     */
+    MappedFiles(DiskManager *disk_mgr, std::uint32_t max_resident);
+
+    /**
+     * @brief MappedFiles destructor.
+     *
+     * @post Every file is unmapped.
+     */
+    ~MappedFiles();
+
+    /**
+     * @brief Maps the Unix file of the given FileId, read-only.
+     *
+     * @pre None of the file's pages are in the buffer pool.
+     * @post Pages of the file are served from the mapping.
+     *
+     * @param file_id FileId of the file.
+     * @param path Path of the Unix file of file_id.
+     *
+     * @throw IOErrorBufMgr If the file cannot be opened or mapped, or its
+     *        layout does not match the pages read by the DiskManager.
+     */
+    void map(FileId file_id, const std::string &path);
+
+    /**
+     * @brief Unmaps the file.
+     *
+     * @throw PagePinnedBufMgr If a page of the file is pinned. The file
+     *        stays mapped.
+     */
+    void unmap(FileId file_id);
+
+    /**
+     * @brief Returns true if the file of the given FileId is mapped.
+     */
+    bool contains(FileId file_id);
+
+    /**
+     * @brief Drops the page from the mapping and deallocates it on disk.
+     *
+     * @throw PagePinnedBufMgr If the Page is pinned.
+     */
+    void deallocatePage(PageId page_id);
+
+    /**
+     * @brief Pins the page and returns a read-only pointer to its data in
+     *        the mapping.
+     *
+     * @throw InvalidPageIdBufMgr If the page is not in the file or was
+     *        deallocated through this buffer manager.
+     * @throw InsufficientSpaceBufMgr If the page lies beyond the reserved
+     *        address space while pages of the file are pinned.
+     */
+    const char* getPage(PageId page_id, AccessHint hint);
+
+    /**
+     * @brief Unpins the page. At pin count 0 a page released with OnceHint
+     *        is dropped from memory right away, any other page becomes the
+     *        most recently unpinned one.
+     *
+     * @throw ReadOnlyFileBufMgr If dirty is true, after the page is
+     *        unpinned.
+     * @throw PageNotPinnedBufMgr If Page is not pinned.
+     * @throw PageNotFoundBufMgr If the page was never pinned.
+     */
+    void releasePage(PageId page_id, bool dirty, AccessHint hint);
+
+    /**
+     * @brief Does nothing: pages of a mapped file are never dirty.
+     *
+     * @throw PageNotFoundBufMgr If the page was never pinned.
+     */
+    void flushPage(PageId page_id);
+
+    /**
+     * @brief Returns true if the page is mapped in.
+     */
+    bool isResident(PageId page_id);
+
+    /**
+     * @brief Returns the number of pages of the file in its capacity that
+     *        the kernel holds in memory, sampled with mincore, or 0 if the
+     *        file is not mapped.
+     */
+    std::uint32_t sampleResident(FileId file_id);
+
+  private:
+
+    /**
+     * State of a page of a mapped file that has been pinned.
+     */
+    struct MappedPage {
+      std::uint32_t pin_count;  // number of getPage calls not yet released
+      bool resident;            // mapped in, counted in resident
+      AccessHint hint;          // hint of the last getPage while pinned
+      std::uint64_t stamp;      // stamp of its entry in cold while unpinned
+    };
+
+    /**
+     * A mapped file.
+     */
+    struct MappedFile {
+      int fd;                   // Unix file descriptor
+      char *base;               // start of the mapping
+      std::size_t offset;       // offset of page 0 in the file
+      std::uint32_t max_pages;  // pages the mapping has address space for
+      std::uint32_t capacity;   // capacity of the file on disk when checked
+      std::uint32_t pinned;     // number of pages with pin count > 0
+      std::unordered_map<PageNum, MappedPage> pages;
+      std::unordered_set<PageNum> freed;  // deallocated while mapped
+    };
+
+    /**
+     * The mapped files.
+     */
+    std::unordered_map<FileId, MappedFile> files;
+
+    /**
+     * Unpinned pages in the order they were unpinned, each with the stamp of
+     * its unpin. An entry whose stamp differs from the stamp of its page is
+     * stale, the page having been pinned or dropped since.
+     */
+    std::deque<std::pair<PageId, std::uint64_t>> cold;
+
+    /**
+     * Stamp of the last unpin.
+     */
+    std::uint64_t clock;
+
+    /**
+     * Number of unpinned pages that are mapped in.
+     */
+    std::uint32_t resident;
+
+    /**
+     * Number of unpinned pages kept mapped in.
+     */
+    std::uint32_t max_resident;
+
+    /**
+     * Size of a page of the system, to which madvise and mincore
+     * ranges are aligned.
+     */
+    std::size_t sys_page;
+
+    /**
+     * Pointer to SwatDB's DiskManager. Used for checking the layout of the
+     * file and deallocating pages.
+     */
+    DiskManager* disk_mgr;
+
+    /**
+     * @brief Returns the mapped file of file_id.
+     *
+     * @throw PageNotFoundBufMgr with page_id If the file is not mapped.
+     */
+    MappedFile& _file(FileId file_id, PageId page_id);
+
+    /**
+     * @brief Returns the state of a page that has been pinned.
+     *
+     * @throw PageNotFoundBufMgr If the page was never pinned.
+     */
+    MappedPage& _page(PageId page_id);
+
+    /**
+     * @brief Returns the address of a page in the mapping.
+     */
+    char* _address(MappedFile &file, PageNum page_num);
+
+    /**
+     * @brief Calls madvise on the system pages a page lies in.
+     */
+    void _advise(MappedFile &file, PageNum page_num, int advice);
+
+    /**
+     * @brief Unmaps a page and drops it from the page cache.
+     */
+    void _evict(MappedFile &file, PageNum page_num);
+
+    /**
+     * @brief Returns true if the page reads the same through the
+     *        DiskManager as in the mapping, or cannot be read by it.
+     */
+    bool _check(MappedFile &file, PageId page_id);
+
+    /**
+     * @brief Maps max_pages pages of the file, after its offset.
+     *
+     * @return Start of the mapping, or nullptr if it failed.
+     */
+    char* _mapRange(MappedFile &file, std::uint32_t max_pages);
+
+    /**
+     * @brief Unmaps the mapping of the file.
+     */
+    void _unmapRange(MappedFile &file);
+
+    /**
+     * @brief Makes the mapping large enough for page_num, remapping it if no
+     *        page of the file is pinned.
+     *
+     * @throw InsufficientSpaceBufMgr If the mapping is too small and a page
+     *        of the file is pinned.
+     */
+    void _reserve(MappedFile &file, PageNum page_num);
+
+    /**
+     * @brief Pins a page that is known to be in the file.
+     */
+    const char* _pin(MappedFile &file, PageId page_id, AccessHint hint);
+
+    /**
+     * @brief Drops an unpinned page from memory.
+     */
+    void _drop(MappedFile &file, PageNum page_num, MappedPage &page);
+
+    /**
+     * @brief Drops the least recently unpinned pages while more than
+     *        max_resident unpinned pages are mapped in.
+     */
+    void _trim();
+};
+
+#endif
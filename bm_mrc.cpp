@@ -0,0 +1,204 @@
+/**
+ * @file bm_mrc.cpp
+ * @author Nikoloz Khmaladze & Omar Ebied
+ * @date 2025-02-09
+ *
+ * Implementation of the MissRatioEstimator class.
+ * The reuse distance of a sampled access is the number of tracked pages last
+ * accessed after the page was, counted in a Fenwick tree over the stamps of
+ * the last accesses, so each sampled access costs O(log max_samples) on top
+ * of a hash table lookup.
+ */
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+#include "bm_mrc.h"
+
+
+/**
+ * @brief Adds curve to total, for buffer managers made of several
+ *    BufferManagers, each a separate pool: sizes are summed and hit rates
+ *    are weighted by the accesses of each.
+ */
+void bm_add_mrc(MissRatioCurve *total, const MissRatioCurve &curve){
+  std::uint64_t accesses = total->accesses + curve.accesses;
+  for( std::uint32_t i = 0; i < BM_MRC_POINTS; i++ ){
+    if( accesses > 0 ){
+      total->hit_rates[i] = (total->hit_rates[i] * total->accesses +
+          curve.hit_rates[i] * curve.accesses) / accesses;
+    }
+    total->sizes[i] += curve.sizes[i];
+  }
+  if( total->samples + curve.samples > 0 ){
+    total->rate = (total->rate * total->samples + curve.rate * curve.samples) /
+      (total->samples + curve.samples);
+  }
+  total->accesses = accesses;
+  total->samples += curve.samples;
+}
+
+/**
+ * @brief Prints the predicted hit rate at every size of curve.
+ */
+void bm_print_mrc(const MissRatioCurve &curve){
+  std::ios_base::fmtflags flags = std::cout.flags();
+  std::streamsize precision = std::cout.precision();
+
+  std::cout << "Miss ratio curve: " << curve.samples << " of " <<
+    curve.accesses << " accesses sampled, sampling rate " << curve.rate <<
+    std::endl;
+  std::cout << std::fixed << std::setprecision(4);
+  for( std::uint32_t i = 0; i < BM_MRC_POINTS; i++ ){
+    std::cout << "  " << std::setw(10) << curve.sizes[i] << " frames (" <<
+      std::setprecision(1) << BM_MRC_SCALES[i] << "x): predicted hit rate " <<
+      std::setprecision(4) << curve.hit_rates[i] << std::endl;
+  }
+
+  std::cout.flags(flags);
+  std::cout.precision(precision);
+}
+
+
+/**
+ * @brief MissRatioEstimator constructor. Samples every page until
+ *    max_samples of them are tracked.
+ *
+ * @param capacity Number of frames of the buffer pool.
+ * @param max_samples Largest number of pages tracked.
+ */
+MissRatioEstimator::MissRatioEstimator(std::uint32_t capacity,
+    std::uint32_t max_samples){
+  this->capacity = capacity;
+  this->max_samples = max_samples;
+  this->threshold = 1u << HASH_BITS;
+  this->accesses = 0;
+  this->samples = 0;
+  this->bucket_width = std::max(1u, capacity / BUCKETS_PER_POOL);
+  std::uint64_t largest = BM_MRC_SCALES[BM_MRC_POINTS - 1] * capacity;
+  this->histogram.assign(
+      (largest + this->bucket_width - 1) / this->bucket_width, 0.0);
+  this->total_weight = 0;
+  this->stamps.assign(2 * max_samples + 1, 0);
+  this->next_stamp = 0;
+}
+
+/**
+ * @brief Returns the predicted hit rates at BM_MRC_SCALES times the
+ *    capacity. A pool of size frames hits the accesses of reuse distance
+ *    below size. As in SHARDS_adj, the difference between the accesses seen
+ *    and the weight of the samples, the error of the sample on the hottest
+ *    pages, is counted as accesses of distance 0.
+ */
+MissRatioCurve MissRatioEstimator::getCurve(){
+  MissRatioCurve curve;
+  curve.accesses = accesses;
+  curve.samples = samples;
+  curve.rate = (double)threshold / (1u << HASH_BITS);
+
+  double total = total_weight;
+  double hits = 0;
+  if( samples > 0 ){
+    hits = accesses - total_weight;
+    total = accesses;
+  }
+  std::size_t bucket = 0;
+  for( std::uint32_t i = 0; i < BM_MRC_POINTS; i++ ){
+    curve.sizes[i] = BM_MRC_SCALES[i] * capacity;
+    while( bucket < histogram.size() &&
+           (bucket + 1) * bucket_width <= curve.sizes[i] ){
+      hits += histogram[bucket++];
+    }
+    double hit_rate = total > 0 ? hits / total : 0;
+    curve.hit_rates[i] = std::min(1.0, std::max(0.0, hit_rate));
+  }
+  return curve;
+}
+
+/**
+ * @brief Records an access to a sampled page: measures its reuse distance,
+ *    stamps it, and drops pages if too many are tracked.
+ */
+void MissRatioEstimator::_sample(PageId page_id, std::uint32_t hash){
+  if( next_stamp == stamps.size() - 1 ){
+    _compact();
+  }
+  samples++;
+  double weight = (double)(1u << HASH_BITS) / threshold;
+  total_weight += weight;
+
+  auto it = last_access.find(page_id);
+  if( it != last_access.end() ){
+    // tracked pages stamped after this one, scaled to every page
+    std::uint32_t distance = last_access.size() - _countBelow(it->second + 1);
+    std::size_t bucket = distance * weight / bucket_width;
+    if( bucket < histogram.size() ){
+      histogram[bucket] += weight;
+    }
+    _addStamp(it->second, -1);
+  }
+  else{
+    it = last_access.emplace(page_id, 0).first;
+    by_hash.emplace(hash, page_id);
+  }
+  it->second = next_stamp;
+  _addStamp(next_stamp++, 1);
+
+  if( last_access.size() <= max_samples ){
+    return;
+  }
+  // stop sampling the largest hash, and drop every page at or above it
+  threshold = std::prev(by_hash.end())->first;
+  while( !by_hash.empty() && std::prev(by_hash.end())->first >= threshold ){
+    auto top = std::prev(by_hash.end());
+    auto dropped = last_access.find(top->second);
+    _addStamp(dropped->second, -1);
+    last_access.erase(dropped);
+    by_hash.erase(top);
+  }
+}
+
+/**
+ * @brief Renumbers the stamps of the tracked pages from 0, in order.
+ */
+void MissRatioEstimator::_compact(){
+  std::vector<std::pair<std::uint32_t, PageId>> order;
+  order.reserve(last_access.size());
+  for( auto &entry : last_access ){
+    order.emplace_back(entry.second, entry.first);
+  }
+  std::sort(order.begin(), order.end(),
+      [](const std::pair<std::uint32_t, PageId> &a,
+         const std::pair<std::uint32_t, PageId> &b){
+        return a.first < b.first;
+      });
+
+  std::fill(stamps.begin(), stamps.end(), 0);
+  next_stamp = 0;
+  for( auto &entry : order ){
+    last_access[entry.second] = next_stamp;
+    _addStamp(next_stamp++, 1);
+  }
+}
+
+/**
+ * @brief Adds delta at stamp in the Fenwick tree.
+ */
+void MissRatioEstimator::_addStamp(std::uint32_t stamp, int delta){
+  for( std::uint32_t i = stamp + 1; i < stamps.size(); i += i & -i ){
+    stamps[i] += delta;
+  }
+}
+
+/**
+ * @brief Returns the number of tracked pages last accessed at stamps below
+ *    stamp.
+ */
+std::uint32_t MissRatioEstimator::_countBelow(std::uint32_t stamp){
+  std::uint32_t count = 0;
+  for( std::uint32_t i = stamp; i > 0; i -= i & -i ){
+    count += stamps[i];
+  }
+  return count;
+}
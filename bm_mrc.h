@@ -0,0 +1,207 @@
+#ifndef _SWATDB_BM_MRC_H_
+#define  _SWATDB_BM_MRC_H_
+
+/**
+ * \file bm_mrc.h: MissRatioEstimator class: online estimate of the hit rate
+ * the buffer pool would have at other sizes, by SHARDS sampling of the
+ * reuse distances of getPage calls
+ */
+
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "swatdb_types.h"
+#include "bm_buffermap.h"   // BufHash
+
+
+/**
+ * Number of buffer pool sizes a MissRatioCurve predicts the hit rate of, and
+ * those sizes as multiples of the size of the buffer pool.
+ */
+static const std::uint32_t BM_MRC_POINTS = 4;
+static const double BM_MRC_SCALES[BM_MRC_POINTS] = {0.5, 1, 2, 4};
+
+/**
+ * Largest number of sampled pages a MissRatioEstimator tracks at once. Bounds
+ * its memory to a few hundred KB, whatever the number of pages accessed.
+ */
+static const std::uint32_t BM_MRC_MAX_SAMPLES = 8192;
+
+/**
+ * Predicted hit rates of a buffer manager at BM_MRC_SCALES times its size.
+ */
+struct MissRatioCurve {
+  std::uint64_t accesses;                 // getPage calls seen
+  std::uint64_t samples;                  // of them, sampled
+  double rate;                            // current sampling rate
+  std::uint32_t sizes[BM_MRC_POINTS];     // buffer pool sizes, in frames
+  double hit_rates[BM_MRC_POINTS];        // predicted hit rate at each size
+};
+
+/**
+ * @brief Adds curve to total, for buffer managers made of several
+ *        BufferManagers, each a separate pool: sizes are summed and hit
+ *        rates are weighted by the accesses of each.
+ */
+void bm_add_mrc(MissRatioCurve *total, const MissRatioCurve &curve);
+
+/**
+ * @brief Prints the predicted hit rate at every size of curve.
+ */
+void bm_print_mrc(const MissRatioCurve &curve);
+
+
+/**
+ * SwatDB MissRatioEstimator Class.
+ * Estimates the miss ratio curve of a buffer pool online with SHARDS
+ * (Waldspurger et al., FAST '15). A page is sampled if a hash of its PageId
+ * is below a threshold, so every access to a sampled page is seen and the
+ * sample is a spatially uniform subset of the pages. The reuse distance of
+ * an access, the number of distinct pages accessed since the last access to
+ * the same page, is measured among the sampled pages and divided by the
+ * sampling rate. An LRU pool of C frames hits exactly the accesses whose
+ * reuse distance is below C, so a histogram of the scaled distances gives
+ * the hit rate at every size. The policies of this buffer manager approximate
+ * LRU, so its curve is the prediction.
+ *
+ * The number of pages tracked is bounded by max_samples: when it is
+ * exceeded, the tracked page of the largest hash is dropped and the
+ * threshold is lowered to it (fixed-size SHARDS). Each sample is weighted by
+ * the inverse of the rate it was taken at, so the histogram counts accesses
+ * whatever the rate was. Accesses not sampled cost a hash and a compare.
+ */
+class MissRatioEstimator {
+
+  public:
+
+    /**
+     * @brief MissRatioEstimator constructor. Samples every page until
+     *        max_samples of them are tracked.
+     *
+     * @param capacity Number of frames of the buffer pool.
+     * @param max_samples Largest number of pages tracked.
+     */
+    MissRatioEstimator(std::uint32_t capacity,
+                       std::uint32_t max_samples = BM_MRC_MAX_SAMPLES);
+
+    /**
+     * @brief Records one getPage call for the page.
+     */
+    void recordAccess(PageId page_id){
+      this->accesses++;
+      std::uint32_t hash = _hash(page_id);
+      if( hash < this->threshold ){
+        _sample(page_id, hash);
+      }
+    }
+
+    /**
+     * @brief Returns the predicted hit rates at BM_MRC_SCALES times the
+     *        capacity.
+     */
+    MissRatioCurve getCurve();
+
+  private:
+
+    /**
+     * Hashes are HASH_BITS wide, so the sampling rate is threshold /
+     * 2^HASH_BITS.
+     */
+    static const std::uint32_t HASH_BITS = 24;
+
+    /**
+     * Number of histogram buckets per capacity of frames.
+     */
+    static const std::uint32_t BUCKETS_PER_POOL = 64;
+
+    /**
+     * Number of frames of the buffer pool.
+     */
+    std::uint32_t capacity;
+
+    /**
+     * Largest number of pages tracked.
+     */
+    std::uint32_t max_samples;
+
+    /**
+     * Pages whose hash is below threshold are sampled.
+     */
+    std::uint32_t threshold;
+
+    /**
+     * Number of getPage calls and number of them sampled.
+     */
+    std::uint64_t accesses;
+    std::uint64_t samples;
+
+    /**
+     * Reuse distances covered by a bucket of the histogram.
+     */
+    std::uint32_t bucket_width;
+
+    /**
+     * Weight of the sampled accesses by scaled reuse distance, in buckets of
+     * bucket_width, up to BM_MRC_SCALES[BM_MRC_POINTS - 1] * capacity. The
+     * accesses of larger distances, and first accesses, are only in
+     * total_weight.
+     */
+    std::vector<double> histogram;
+    double total_weight;
+
+    /**
+     * Stamp of the last access to each tracked page. Stamps are handed out
+     * in order, one per sampled access.
+     */
+    std::unordered_map<PageId, std::uint32_t, BufHash> last_access;
+
+    /**
+     * Tracked pages ordered by hash, to find the one to drop.
+     */
+    std::multimap<std::uint32_t, PageId> by_hash;
+
+    /**
+     * Fenwick tree over stamps, 1 at the stamp of the last access of each
+     * tracked page, so the number of distinct pages accessed after a stamp
+     * is a range sum. Holds 2 * max_samples stamps, renumbered when they run
+     * out.
+     */
+    std::vector<std::uint32_t> stamps;
+    std::uint32_t next_stamp;
+
+    /**
+     * @brief Returns the HASH_BITS bit hash of the page that decides whether
+     *        it is sampled.
+     */
+    static std::uint32_t _hash(PageId page_id){
+      // the top bits are kept, so the sample is independent of the low
+      // bits PartitionedBufferManager shards by
+      return (std::uint32_t)(bm_hash64(page_id) >> (64 - HASH_BITS));
+    }
+
+    /**
+     * @brief Records an access to a sampled page: measures its reuse
+     *        distance, stamps it, and drops pages if too many are tracked.
+     */
+    void _sample(PageId page_id, std::uint32_t hash);
+
+    /**
+     * @brief Renumbers the stamps of the tracked pages from 0, in order.
+     */
+    void _compact();
+
+    /**
+     * @brief Adds delta at stamp in the Fenwick tree.
+     */
+    void _addStamp(std::uint32_t stamp, int delta);
+
+    /**
+     * @brief Returns the number of tracked pages last accessed at stamps
+     *        below stamp.
+     */
+    std::uint32_t _countBelow(std::uint32_t stamp);
+};
+
+#endif
@@ -0,0 +1,671 @@
+/**
+ * @file bm_numa.cpp
+ * @author Nikoloz Khmaladze & Omar Ebied
+ * @date 2025-02-09
+ *
+ * Implementation of the NumaBufferManager class and the NUMA topology
+ * helpers. The helpers read sysfs and call the getcpu system call directly,
+ * so that no NUMA library is needed to build or run, and fall back to a
+ * single node when that fails or the system is not Linux.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdlib>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "bm_numa.h"
+#include "bm_metrics.h"
+#include "diskmgr.h"
+#include "swatdb_exceptions.h"
+
+/**
+ * @brief Returns the number of NUMA nodes of the system, 1 if the system has
+ *    no NUMA support.
+ */
+std::uint32_t bm_numa_num_nodes(){
+  // a list of ranges like "0-1" or "0,2-3": one more than the highest node
+  std::ifstream online("/sys/devices/system/node/online");
+  std::string ranges;
+  if( !(online >> ranges) ){
+    return 1;
+  }
+  std::size_t last = ranges.find_last_of(",-");
+  std::uint32_t highest = std::strtoul(
+      ranges.c_str() + (last == std::string::npos ? 0 : last + 1), nullptr,
+      10);
+  return highest + 1;
+}
+
+/**
+ * @brief Returns the NUMA node of the CPU the calling thread runs on, 0 if
+ *    the system has no NUMA support.
+ */
+std::uint32_t bm_numa_current_node(){
+#ifdef __linux__
+  unsigned cpu, node;
+  if( syscall(SYS_getcpu, &cpu, &node, nullptr) == 0 ){
+    return node;
+  }
+#endif
+  return 0;
+}
+
+
+/**
+ * @brief NumaBufferManager constructor. Creates a BufferManager with the
+ *    replacement policy of the given type on every node.
+ *
+ * @pre disk_mgr points to an initialized DiskManager object.
+ * @post Every node is initialized with an empty buffer pool in its own
+ *    memory, and every counter is 0.
+ *
+ * @param disk_mgr A pointer to SwatDB's DiskManager object.
+ *    (DiskManager*).
+ * @param rep_type Replacement policy type of every node.
+ * @param num_nodes Number of nodes, or 0 to use the nodes of the system.
+ * @param huge_pages true to place the buffer pool of every node on huge
+ *    pages.
+ *
+ * @throw InvalidPolicyBufMgr If the replacement policy type is invalid.
+ */
+NumaBufferManager::NumaBufferManager(DiskManager *disk_mgr, PolicyType rep_type,
+    std::uint32_t num_nodes, bool huge_pages){
+
+  if( num_nodes == 0 ){
+    num_nodes = bm_numa_num_nodes();
+  }
+  this->disk_mgr = disk_mgr;
+  this->nodes.reserve(num_nodes);
+  try{
+    for( std::uint32_t i = 0; i < num_nodes; i++ ){
+      this->nodes.push_back(new BufferManager(disk_mgr, rep_type, i,
+                                             huge_pages));
+    }
+  }
+  catch(InvalidPolicyBufMgr&){
+    for( BufferManager *node : this->nodes ){
+      delete node;
+    }
+    throw;
+  }
+  this->node_latches = std::vector<std::mutex>(num_nodes);
+  this->sweep_min = 2 * (num_nodes * BUF_SIZE / DIRECTORY_PARTITIONS + 1);
+  for( DirectoryPartition &partition : this->directory ){
+    partition.sweep_at = this->sweep_min;
+  }
+  this->stats = std::vector<NodeCounters>(num_nodes);
+  for( NodeCounters &counters : this->stats ){
+    counters.local_hits.store(0, std::memory_order_relaxed);
+    counters.remote_hits.store(0, std::memory_order_relaxed);
+    counters.local_loads.store(0, std::memory_order_relaxed);
+    counters.remote_loads.store(0, std::memory_order_relaxed);
+  }
+}
+
+/**
+ * @brief NumaBufferManager destructor.
+ *
+ * @pre None.
+ * @post Every valid and dirty Page of every node is written to disk.
+ */
+NumaBufferManager::~NumaBufferManager(){
+  for( BufferManager *node : this->nodes ){
+    delete node;
+  }
+}
+
+/**
+ * @brief Allocates a Page for the file of given FileId, on disk and in the
+ *    node of the calling thread, or the next node with an unpinned frame.
+ *    The page is entered in the directory after it is allocated, so it must
+ *    not be used by another thread before this call returns it.
+ * @see BufferManager::allocatePage()
+ *
+ * @throw InsufficientSpaceBufMgr If every node is full of pinned pages.
+ */
+std::pair<Page*, PageId> NumaBufferManager::allocatePage(FileId file_id){
+  std::uint32_t local = this->getCurrentNode();
+  std::uint32_t num_nodes = this->nodes.size();
+  std::pair<Page*, PageId> page;
+  std::uint32_t node = local;
+
+  {
+    std::lock_guard<std::mutex> disk_guard(this->disk_latch);
+    for( std::uint32_t i = 0; i < num_nodes; i++ ){
+      node = (local + i) % num_nodes;
+      try{
+        // allocatePage checks for an unpinned frame before it allocates the
+        // page on disk, so a full node can be retried on the next
+        std::lock_guard<std::mutex> node_guard(this->node_latches[node]);
+        page = this->nodes[node]->allocatePage(file_id);
+        break;
+      }
+      catch(InsufficientSpaceBufMgr&){
+        if( i == num_nodes - 1 ){
+          throw;
+        }
+      }
+    }
+  }
+  this->_count(node, local, true);
+
+  // the page is pinned, so it stays on node until the entry is made
+  DirectoryPartition &partition = this->_partition(page.second);
+  std::lock_guard<std::mutex> directory_guard(partition.latch);
+  partition.owner[page.second] = node;
+  return page;
+}
+
+/**
+ * @brief Gets Page by page_id from the node it is resident on, or reads it
+ *    into the node of the calling thread, or the next node with an unpinned
+ *    frame.
+ * @see BufferManager::getPage()
+ *
+ * @throw InsufficientSpaceBufMgr If every node is full of pinned pages.
+ */
+Page* NumaBufferManager::getPage(PageId page_id, AccessHint hint){
+  std::uint32_t local = this->getCurrentNode();
+  std::uint32_t num_nodes = this->nodes.size();
+  DirectoryPartition &partition = this->_partition(page_id);
+  std::lock_guard<std::mutex> directory_guard(partition.latch);
+
+  auto owner = partition.owner.find(page_id);
+  if( owner != partition.owner.end() ){
+    std::uint32_t node = owner->second;
+    std::lock_guard<std::mutex> node_guard(this->node_latches[node]);
+    if( this->nodes[node]->isResident(page_id) ){
+      Page *page = this->nodes[node]->getPage(page_id, hint);
+      this->_count(node, local, false);
+      return page;
+    }
+  }
+
+  // the latch of the partition keeps other threads from reading the page
+  // into another node meanwhile
+  std::lock_guard<std::mutex> disk_guard(this->disk_latch);
+  for( std::uint32_t i = 0; i < num_nodes; i++ ){
+    std::uint32_t node = (local + i) % num_nodes;
+    try{
+      Page *page;
+      {
+        std::lock_guard<std::mutex> node_guard(this->node_latches[node]);
+        page = this->nodes[node]->getPage(page_id, hint);
+      }
+      this->_count(node, local, true);
+      partition.owner[page_id] = node;
+      if( partition.owner.size() >= partition.sweep_at ){
+        this->_sweep(partition);
+      }
+      return page;
+    }
+    catch(InsufficientSpaceBufMgr&){
+      if( i == num_nodes - 1 ){
+        throw;
+      }
+    }
+  }
+  throw InsufficientSpaceBufMgr();
+}
+
+/**
+ * @brief Removes the Page of the given PageId from the node it is resident
+ *    on, and deallocates the Page from disk.
+ * @see BufferManager::deallocatePage()
+ */
+void NumaBufferManager::deallocatePage(PageId page_id){
+  DirectoryPartition &partition = this->_partition(page_id);
+  std::lock_guard<std::mutex> directory_guard(partition.latch);
+  std::uint32_t node = this->_homeNode(partition, page_id);
+  std::lock_guard<std::mutex> disk_guard(this->disk_latch);
+  std::lock_guard<std::mutex> node_guard(this->node_latches[node]);
+
+  this->nodes[node]->deallocatePage(page_id);
+  partition.owner.erase(page_id);
+}
+
+/**
+ * @brief Unpins a Page in the node it is resident on.
+ * @see BufferManager::releasePage()
+ */
+void NumaBufferManager::releasePage(PageId page_id, bool dirty,
+    AccessHint hint){
+  DirectoryPartition &partition = this->_partition(page_id);
+  std::lock_guard<std::mutex> directory_guard(partition.latch);
+  std::uint32_t node = this->_homeNode(partition, page_id);
+  std::lock_guard<std::mutex> node_guard(this->node_latches[node]);
+
+  this->nodes[node]->releasePage(page_id, dirty, hint);
+}
+
+/**
+ * @brief Set the Page of the given PageId dirty.
+ * @see BufferManager::setDirty()
+ */
+void NumaBufferManager::setDirty(PageId page_id){
+  DirectoryPartition &partition = this->_partition(page_id);
+  std::lock_guard<std::mutex> directory_guard(partition.latch);
+  std::uint32_t node = this->_homeNode(partition, page_id);
+  std::lock_guard<std::mutex> node_guard(this->node_latches[node]);
+
+  this->nodes[node]->setDirty(page_id);
+}
+
+/**
+ * @brief Flushes the Page of the given PageId to disk.
+ * @see BufferManager::flushPage()
+ */
+void NumaBufferManager::flushPage(PageId page_id){
+  DirectoryPartition &partition = this->_partition(page_id);
+  std::lock_guard<std::mutex> directory_guard(partition.latch);
+  std::uint32_t node = this->_homeNode(partition, page_id);
+  std::lock_guard<std::mutex> disk_guard(this->disk_latch);
+  std::lock_guard<std::mutex> node_guard(this->node_latches[node]);
+
+  this->nodes[node]->flushPage(page_id);
+}
+
+/**
+ * @brief Calls createFile() method on the DiskManager to create new Unix
+ *    file that corresponds to the given FileId.
+ *
+ * @param file_id FileId of the file to be created.
+ *
+ * @see DiskManager::createFile()
+ */
+void NumaBufferManager::createFile(FileId file_id){
+  std::lock_guard<std::mutex> disk_guard(this->disk_latch);
+  this->disk_mgr->createFile(file_id);
+}
+
+/**
+ * @brief Evicts the file's pages from every node, then removes the file
+ *    from disk.
+ *
+ * @pre A valid FileId is given as a parameter. None of the file's pages are
+ *    pinned in any node.
+ * @post None of the file's pages are in the buffer pool and the file is
+ *    removed from disk via DiskManager->removeFile(). If a page of the file
+ *    is pinned, the file stays on disk and the pages of the nodes checked
+ *    before are written to it and evicted.
+ *
+ * @param file_id FileId of the file to be removed.
+ *
+ * @throw PagePinnedBufMgr If there are pinned pages of file_id.
+ */
+void NumaBufferManager::removeFile(FileId file_id){
+  {
+    std::lock_guard<std::mutex> disk_guard(this->disk_latch);
+    for( std::uint32_t i = 0; i < this->nodes.size(); i++ ){
+      std::lock_guard<std::mutex> node_guard(this->node_latches[i]);
+      this->nodes[i]->evictFile(file_id);
+    }
+    this->disk_mgr->removeFile(file_id);
+  }
+
+  // the entries of the file's pages are stale now, drop them
+  for( DirectoryPartition &partition : this->directory ){
+    std::lock_guard<std::mutex> directory_guard(partition.latch);
+    for( auto it = partition.owner.begin(); it != partition.owner.end(); ){
+      if( it->first.file_id == file_id ){
+        it = partition.owner.erase(it);
+      }
+      else{
+        it++;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Turns the TinyLFU admission filter of every node on or off.
+ * @see BufferManager::setAdmission()
+ */
+void NumaBufferManager::setAdmission(bool enabled){
+  for( std::uint32_t i = 0; i < this->nodes.size(); i++ ){
+    std::lock_guard<std::mutex> node_guard(this->node_latches[i]);
+    this->nodes[i]->setAdmission(enabled);
+  }
+}
+
+/**
+ * @brief Times one in every `every` operations of each kind into the latency
+ *    histograms of every node.
+ * @see BufferManager::setLatencySampling()
+ */
+void NumaBufferManager::setLatencySampling(std::uint32_t every){
+  for( std::uint32_t i = 0; i < this->nodes.size(); i++ ){
+    std::lock_guard<std::mutex> node_guard(this->node_latches[i]);
+    this->nodes[i]->setLatencySampling(every);
+  }
+}
+
+/**
+ * @brief Records the page accesses of every node to tracer, or stops
+ *    recording if it is nullptr. The events carry the recording thread, so
+ *    the trace shows the accesses of every node as the threads made them.
+ * @see BufferManager::setTracer()
+ */
+void NumaBufferManager::setTracer(TraceRecorder *tracer){
+  for( std::uint32_t i = 0; i < this->nodes.size(); i++ ){
+    std::lock_guard<std::mutex> node_guard(this->node_latches[i]);
+    this->nodes[i]->setTracer(tracer);
+  }
+}
+
+/**
+ * @brief Turns the SHARDS estimate of the miss ratio curve of every node on
+ *    or off.
+ * @see BufferManager::setMissRatioCurve()
+ */
+void NumaBufferManager::setMissRatioCurve(bool enabled){
+  for( std::uint32_t i = 0; i < this->nodes.size(); i++ ){
+    std::lock_guard<std::mutex> node_guard(this->node_latches[i]);
+    this->nodes[i]->setMissRatioCurve(enabled);
+  }
+}
+
+/**
+ * @brief Chooses the replacement policy used for the pages of the given
+ *    file in every node.
+ * @see BufferManager::setFilePolicy()
+ */
+void NumaBufferManager::setFilePolicy(FileId file_id, PolicyType rep_type){
+  for( std::uint32_t i = 0; i < this->nodes.size(); i++ ){
+    std::lock_guard<std::mutex> node_guard(this->node_latches[i]);
+    this->nodes[i]->setFilePolicy(file_id, rep_type);
+  }
+}
+
+/**
+ * @brief Returns the number of nodes.
+ */
+std::uint32_t NumaBufferManager::getNumNodes(){
+  return this->nodes.size();
+}
+
+/**
+ * @brief Returns the node of the calling thread.
+ */
+std::uint32_t NumaBufferManager::getCurrentNode(){
+  return bm_numa_current_node() % this->nodes.size();
+}
+
+/**
+ * @brief Returns the counters of the given node. Takes no latch; the
+ *    counters are read one at a time, so they may miss an access counted
+ *    meanwhile.
+ */
+NumaNodeStats NumaBufferManager::getNodeStats(std::uint32_t node){
+  NodeCounters &counters = this->stats.at(node);
+  return NumaNodeStats{counters.local_hits.load(std::memory_order_relaxed),
+                       counters.remote_hits.load(std::memory_order_relaxed),
+                       counters.local_loads.load(std::memory_order_relaxed),
+                       counters.remote_loads.load(std::memory_order_relaxed)};
+}
+
+/**
+ * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+ *    Returns the state of the whole buffer pool, summed over the nodes.
+ * @see bm_add_state()
+ */
+BufferState NumaBufferManager::getBufferState(){
+  BufferState total;
+  for( std::uint32_t i = 0; i < this->nodes.size(); i++ ){
+    std::lock_guard<std::mutex> node_guard(this->node_latches[i]);
+    if( i == 0 ){
+      total = this->nodes[i]->getBufferState();
+    }
+    else{
+      bm_add_state(&total, this->nodes[i]->getBufferState());
+    }
+  }
+  return total;
+}
+
+/**
+ * @brief Returns the hit, miss, eviction and I/O counters of the whole buffer
+ *    pool, summed over the nodes.
+ */
+BufferStats NumaBufferManager::getBufferStats(){
+  BufferStats total;
+  for( std::uint32_t i = 0; i < this->nodes.size(); i++ ){
+    std::lock_guard<std::mutex> node_guard(this->node_latches[i]);
+    if( i == 0 ){
+      total = this->nodes[i]->getBufferStats();
+    }
+    else{
+      bm_add_stats(&total, this->nodes[i]->getBufferStats());
+    }
+  }
+  return total;
+}
+
+/**
+ * @brief Returns the latency histogram of the given kind of operation of the
+ *    whole buffer pool, merged over the nodes.
+ */
+LatencyHistogram NumaBufferManager::getLatency(LatencyKind kind){
+  LatencyHistogram total;
+  for( std::uint32_t i = 0; i < this->nodes.size(); i++ ){
+    std::lock_guard<std::mutex> node_guard(this->node_latches[i]);
+    if( i == 0 ){
+      total = this->nodes[i]->getLatency(kind);
+    }
+    else{
+      total.merge(this->nodes[i]->getLatency(kind));
+    }
+  }
+  return total;
+}
+
+/**
+ * @brief Returns the predicted hit rates of the whole buffer pool at 0.5, 1,
+ *    2 and 4 times its size, from the estimates of the nodes weighted by
+ *    their accesses.
+ */
+MissRatioCurve NumaBufferManager::getMissRatioCurve(){
+  MissRatioCurve total;
+  for( std::uint32_t i = 0; i < this->nodes.size(); i++ ){
+    std::lock_guard<std::mutex> node_guard(this->node_latches[i]);
+    if( i == 0 ){
+      total = this->nodes[i]->getMissRatioCurve();
+    }
+    else{
+      bm_add_mrc(&total, this->nodes[i]->getMissRatioCurve());
+    }
+  }
+  return total;
+}
+
+/**
+ * @brief Renders the state, counters and latency percentiles of the whole
+ *    buffer pool, summed over the nodes, in the Prometheus text exposition
+ *    format.
+ * @see bm_metrics_text()
+ */
+std::string NumaBufferManager::getMetrics(){
+  LatencyHistogram latency[BM_NUM_LATENCIES];
+  for( std::uint32_t i = 0; i < BM_NUM_LATENCIES; i++ ){
+    latency[i] = getLatency((LatencyKind)i);
+  }
+  return bm_metrics_text(getBufferState(), getBufferStats(), latency);
+}
+
+/**
+ * @brief Writes getMetrics to a file, written aside and renamed.
+ *
+ * @param path Path of the metrics file.
+ *
+ * @throw IOErrorBufMgr If the file cannot be written.
+ */
+void NumaBufferManager::writeMetrics(const std::string &path){
+  bm_write_metrics(path, getMetrics());
+}
+
+/**
+ * @brief Return the amount of unpinned pages in every node.
+ */
+std::uint32_t NumaBufferManager::getNumUnpinned(){
+  std::uint32_t unpinned = 0;
+  for( std::uint32_t i = 0; i < this->nodes.size(); i++ ){
+    std::lock_guard<std::mutex> node_guard(this->node_latches[i]);
+    unpinned += this->nodes[i]->getNumUnpinned();
+  }
+  return unpinned;
+}
+
+/**
+ * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+ *    Prints frame state of every frame of every node.
+ */
+void NumaBufferManager::printAllFrames(){
+  for( std::uint32_t i = 0; i < this->nodes.size(); i++ ){
+    std::lock_guard<std::mutex> node_guard(this->node_latches[i]);
+    std::cout << "Node " << i << ": \n";
+    this->nodes[i]->printAllFrames();
+  }
+}
+
+/**
+ * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+ *    Prints frame state of every valid frame of every node.
+ */
+void NumaBufferManager::printValidFrames(){
+  for( std::uint32_t i = 0; i < this->nodes.size(); i++ ){
+    std::lock_guard<std::mutex> node_guard(this->node_latches[i]);
+    std::cout << "Node " << i << ": \n";
+    this->nodes[i]->printValidFrames();
+  }
+}
+
+/**
+ * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+ *    Prints frame state of given FrameId. Frames are numbered across the
+ *    nodes, frame_id / BUF_SIZE is the node.
+ */
+void NumaBufferManager::printFrame(FrameId frame_id){
+  std::lock_guard<std::mutex> node_guard(
+      this->node_latches[frame_id / BUF_SIZE]);
+  this->nodes[frame_id / BUF_SIZE]->printFrame(frame_id % BUF_SIZE);
+}
+
+/**
+ * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+ *    Prints frame state of given PageId in the node it is resident on.
+ */
+void NumaBufferManager::printPage(PageId page_id){
+  DirectoryPartition &partition = this->_partition(page_id);
+  std::lock_guard<std::mutex> directory_guard(partition.latch);
+  std::uint32_t node = this->_homeNode(partition, page_id);
+  std::lock_guard<std::mutex> node_guard(this->node_latches[node]);
+  std::cout << "Node: " << node << ", ";
+  this->nodes[node]->printPage(page_id);
+}
+
+/**
+ * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+ *    Prints the state of the whole buffer pool.
+ */
+void NumaBufferManager::printBufferState(){
+  BufferState cur_buf = this->getBufferState();
+
+  std::cout << "Number of nodes: " << this->nodes.size() << std::endl;
+  std::cout << "Total number of pages: " << cur_buf.total << std::endl;
+  std::cout << "Number of valid pages: " << cur_buf.valid << std::endl;
+  std::cout << "Number of pinned pages: " << cur_buf.pinned << std::endl;
+  std::cout << "Number of unpinned pages: " << cur_buf.unpinned << std::endl;
+  std::cout << "Number of dirty pages: " << cur_buf.dirty <<std::endl;
+  std::cout << "Replacement Policy: " <<
+    bm_rep_str(cur_buf.replace_stats.rep_type) << std::endl;
+  std::cout << "Number of calls to replacement policy: " <<
+    cur_buf.replace_stats.rep_calls << std::endl;
+  std::cout << "Average frames checked per call: " <<
+    cur_buf.replace_stats.avg_frames_checked << std::endl;
+  std::cout << "Number of pages with ref bit set: " <<
+    cur_buf.replace_stats.ref_bit << std::endl;
+  bm_print_stats(this->getBufferStats());
+}
+
+/**
+ * @brief This method is for performance tests.
+ *    Prints the replacement statistics and the counters of every node.
+ */
+void NumaBufferManager::printReplacementStats(){
+  for( std::uint32_t i = 0; i < this->nodes.size(); i++ ){
+    NumaNodeStats node_stats = this->getNodeStats(i);
+    std::cout << "Node " << i << ": local hits: " <<
+      node_stats.local_hits << ", remote hits: " <<
+      node_stats.remote_hits << ", local loads: " <<
+      node_stats.local_loads << ", remote loads: " <<
+      node_stats.remote_loads << std::endl;
+    std::lock_guard<std::mutex> node_guard(this->node_latches[i]);
+    this->nodes[i]->printReplacementStats();
+  }
+}
+
+/**
+ * @brief Counts a hit, or a load if load is true, on node for a thread of
+ *    the node local.
+ */
+void NumaBufferManager::_count(std::uint32_t node, std::uint32_t local,
+    bool load){
+  NodeCounters &counters = this->stats[node];
+  if( load ){
+    (node == local ? counters.local_loads : counters.remote_loads)
+      .fetch_add(1, std::memory_order_relaxed);
+  }
+  else{
+    (node == local ? counters.local_hits : counters.remote_hits)
+      .fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+/**
+ * @brief Returns the directory partition of the page.
+ */
+NumaBufferManager::DirectoryPartition &NumaBufferManager::_partition(
+    PageId page_id){
+  return this->directory[bm_hash64(page_id, DIRECTORY_SEED) %
+                         DIRECTORY_PARTITIONS];
+}
+
+/**
+ * @brief Returns the node the page was last read into, or the node of the
+ *    calling thread if it was never read in, so that the BufferManager of
+ *    that node reports the error. The caller holds the latch of the
+ *    partition.
+ */
+std::uint32_t NumaBufferManager::_homeNode(DirectoryPartition &partition,
+    PageId page_id){
+  // a pinned page cannot be evicted, so its entry names the node it is on
+  auto owner = partition.owner.find(page_id);
+  return owner != partition.owner.end() ? owner->second :
+                                          this->getCurrentNode();
+}
+
+/**
+ * @brief Drops the entries of the pages of the partition that are no longer
+ *    resident on their node. The caller holds the latch of the partition.
+ */
+void NumaBufferManager::_sweep(DirectoryPartition &partition){
+  for( auto it = partition.owner.begin(); it != partition.owner.end(); ){
+    std::lock_guard<std::mutex> node_guard(this->node_latches[it->second]);
+    if( !this->nodes[it->second]->isResident(it->first) ){
+      it = partition.owner.erase(it);
+    }
+    else{
+      it++;
+    }
+  }
+  // sweeping again only once the partition doubles keeps the sweeps
+  // amortized to a constant per page read in
+  partition.sweep_at = std::max(2 * partition.owner.size(), this->sweep_min);
+}
@@ -0,0 +1,400 @@
+#ifndef _SWATDB_BM_NUMA_H_
+#define  _SWATDB_BM_NUMA_H_
+
+/**
+ * \file bm_numa.h: NumaBufferManager class: one buffer pool per NUMA node,
+ * and the NUMA topology helpers it is built on
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "swatdb_types.h"
+#include "bufmgr.h"
+#include "bm_buffermap.h"
+
+class DiskManager;
+
+
+/**
+ * @brief Returns the number of NUMA nodes of the system, 1 if the system has
+ *        no NUMA support.
+ */
+std::uint32_t bm_numa_num_nodes();
+
+/**
+ * @brief Returns the NUMA node of the CPU the calling thread runs on, 0 if
+ *        the system has no NUMA support.
+ */
+std::uint32_t bm_numa_current_node();
+
+
+/**
+ * Counters of the accesses served by the frames of one NUMA node, as
+ * returned by NumaBufferManager::getNodeStats.
+ */
+struct NumaNodeStats {
+
+  /**
+   * getPage calls that found the page resident on the node of the calling
+   * thread.
+   */
+  std::uint64_t local_hits;
+
+  /**
+   * getPage calls that found the page resident on this node from a thread
+   * of another node.
+   */
+  std::uint64_t remote_hits;
+
+  /**
+   * Pages read in or allocated on this node for a thread of this node.
+   */
+  std::uint64_t local_loads;
+
+  /**
+   * Pages read in or allocated on this node for a thread of another node,
+   * whose own node was full of pinned pages.
+   */
+  std::uint64_t remote_loads;
+};
+
+
+/**
+ * SwatDB NumaBufferManager Class.
+ * Splits the buffer pool into one BufferManager per NUMA node, whose frames
+ * are placed in the memory of that node, so that a page read in by a thread
+ * is read into memory local to it. A page lives in one node at a time: a
+ * getPage that finds it resident on any node pins it there, and a miss reads
+ * it into the node of the calling thread, or into the next node with an
+ * unpinned frame if that node is full of pinned pages. Every node holds
+ * BUF_SIZE frames. On a system without NUMA support, or with a single node,
+ * there is one node, and it behaves as a BufferManager. Every method has the
+ * contract of the BufferManager method of the same name.
+ *
+ * The manager latches itself, and may be used from several threads. A
+ * directory, partitioned by a hash of the PageId, records the node every page
+ * was last read into, so a page operation latches the directory partition of
+ * the page and the one node the page is on, and never probes the others.
+ * Pages of different partitions on different nodes are served in parallel.
+ * The nodes share one DiskManager, which does not promise to be safe for
+ * concurrent calls, so a miss, allocatePage, deallocatePage, flushPage and
+ * the file operations also hold a latch over the DiskManager. The counters of
+ * the nodes are atomic, so getNodeStats may be called at any time.
+ */
+class NumaBufferManager {
+
+  public:
+
+    /**
+     * @brief NumaBufferManager constructor. Creates a BufferManager with the
+     *        replacement policy of the given type on every node.
+     *
+     * @pre disk_mgr points to an initialized DiskManager object.
+     * @post Every node is initialized with an empty buffer pool in its own
+     *       memory, and every counter is 0.
+     *
+     * @param disk_mgr A pointer to SwatDB's DiskManager object.
+     *    (DiskManager*).
+     * @param rep_type Replacement policy type of every node.
+     * @param num_nodes Number of nodes, or 0 to use the nodes of the system.
+     * @param huge_pages true to place the buffer pool of every node on huge
+     *    pages.
+     *
+     * @throw InvalidPolicyBufMgr If the replacement policy type is invalid.
+     */
+    NumaBufferManager(DiskManager *disk_mgr, PolicyType rep_type,
+                      std::uint32_t num_nodes = 0, bool huge_pages = false);
+
+    /**
+     * @brief NumaBufferManager destructor.
+     *
+     * @pre None.
+     * @post Every valid and dirty Page of every node is written to disk.
+     */
+    ~NumaBufferManager();
+
+    /**
+     * @brief Allocates a Page for the file of given FileId, on disk and in
+     *        the node of the calling thread, or the next node with an
+     *        unpinned frame. The page is entered in the directory after it
+     *        is allocated, so it must not be used by another thread before
+     *        this call returns it.
+     * @see BufferManager::allocatePage()
+     *
+     * @throw InsufficientSpaceBufMgr If every node is full of pinned pages.
+     */
+    std::pair<Page*,PageId> allocatePage(FileId file_id);
+
+    /**
+     * @brief Gets Page by page_id from the node it is resident on, or reads
+     *        it into the node of the calling thread, or the next node with
+     *        an unpinned frame.
+     * @see BufferManager::getPage()
+     *
+     * @throw InsufficientSpaceBufMgr If every node is full of pinned pages.
+     */
+    Page* getPage(PageId page_id, AccessHint hint = NoHint);
+
+    /**
+     * Page operations, forwarded to the node the page is resident on.
+     * @see BufferManager
+     */
+    void deallocatePage(PageId page_id);
+    void releasePage(PageId page_id, bool dirty, AccessHint hint = NoHint);
+    void setDirty(PageId page_id);
+    void flushPage(PageId page_id);
+
+    /**
+     * @brief Calls createFile() method on the DiskManager to create new Unix
+     *        file that corresponds to the given FileId.
+     *
+     * @param file_id FileId of the file to be created.
+     *
+     * @see DiskManager::createFile()
+     */
+    void createFile(FileId file_id);
+
+    /**
+     * @brief Evicts the file's pages from every node, then removes the file
+     *        from disk.
+     *
+     * @pre A valid FileId is given as a parameter. None of the file's pages
+     *      are pinned in any node.
+     * @post None of the file's pages are in the buffer pool and the file is
+     *       removed from disk via DiskManager->removeFile(). If a page of the
+     *       file is pinned, the file stays on disk and the pages of the
+     *       nodes checked before are written to it and evicted.
+     *
+     * @param file_id FileId of the file to be removed.
+     *
+     * @throw PagePinnedBufMgr If there are pinned pages of file_id.
+     */
+    void removeFile(FileId file_id);
+
+    /**
+     * Configuration, applied to every node.
+     * @see BufferManager
+     */
+    void setAdmission(bool enabled);
+    void setLatencySampling(std::uint32_t every);
+    void setTracer(TraceRecorder *tracer);
+    void setMissRatioCurve(bool enabled);
+    void setFilePolicy(FileId file_id, PolicyType rep_type);
+
+    /**
+     * @brief Returns the number of nodes.
+     */
+    std::uint32_t getNumNodes();
+
+    /**
+     * @brief Returns the node of the calling thread.
+     */
+    std::uint32_t getCurrentNode();
+
+    /**
+     * @brief Returns the counters of the given node.
+     */
+    NumaNodeStats getNodeStats(std::uint32_t node);
+
+    /**
+     * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+     *        Returns the state of the whole buffer pool, summed over the
+     *        nodes.
+     * @see bm_add_state()
+     */
+    BufferState getBufferState();
+
+    /**
+     * @brief Returns the hit, miss, eviction and I/O counters of the whole
+     *        buffer pool, summed over the nodes.
+     * @see bm_add_stats()
+     */
+    BufferStats getBufferStats();
+
+    /**
+     * @brief Returns the latency histogram of the given kind of operation
+     *        of the whole buffer pool, merged over the nodes.
+     * @see BufferManager::getLatency()
+     */
+    LatencyHistogram getLatency(LatencyKind kind);
+
+    /**
+     * @brief Returns the predicted hit rates of the whole buffer pool at
+     *        0.5, 1, 2 and 4 times its size, from the estimates of the
+     *        nodes weighted by their accesses. A page accessed from several
+     *        nodes over time is sampled by each of them, so the prediction
+     *        is coarser than for a BufferManager.
+     * @see bm_add_mrc()
+     */
+    MissRatioCurve getMissRatioCurve();
+
+    /**
+     * @brief Renders the state, counters and latency percentiles of the
+     *        whole buffer pool, summed over the nodes, in the Prometheus
+     *        text exposition format.
+     * @see BufferManager::getMetrics()
+     */
+    std::string getMetrics();
+
+    /**
+     * @brief Writes getMetrics to a file, written aside and renamed.
+     *
+     * @throw IOErrorBufMgr If the file cannot be written.
+     */
+    void writeMetrics(const std::string &path);
+
+    /**
+     * @brief Return the amount of unpinned pages in every node.
+     */
+    std::uint32_t getNumUnpinned();
+
+    /**
+     * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+     *        Prints Frame state of every Frame of every node.
+     */
+    void printAllFrames();
+
+    /**
+     * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+     *        Prints Frame state of every valid Frame of every node.
+     */
+    void printValidFrames();
+
+    /**
+     * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+     *        Prints Frame state of given FrameId. Frames are numbered across
+     *        the nodes, frame_id / BUF_SIZE is the node.
+     */
+    void printFrame(FrameId frame_id);
+
+    /**
+     * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+     *        Prints Frame state of given PageId in the node it is resident
+     *        on.
+     */
+    void printPage(PageId page_id);
+
+    /**
+     * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+     *        Prints the state of the whole buffer pool.
+     */
+    void printBufferState();
+
+    /**
+     * @brief This method is for performance tests.
+     *        Prints the replacement statistics and the counters of every
+     *        node.
+     */
+    void printReplacementStats();
+
+  private:
+
+    /**
+     * The buffer pool of every node, in the memory of that node.
+     */
+    std::vector<BufferManager*> nodes;
+
+    /**
+     * Parallel vector to nodes of the latch of every node, held over every
+     * call to its BufferManager.
+     */
+    std::vector<std::mutex> node_latches;
+
+    /**
+     * Latch over the DiskManager, held over every call that may read or
+     * write a page or change the files. Taken after the latch of a
+     * directory partition and before the latch of a node.
+     */
+    std::mutex disk_latch;
+
+    /**
+     * Number of partitions of the directory.
+     */
+    static const std::uint32_t DIRECTORY_PARTITIONS = 64;
+
+    /**
+     * Seed of the hash that picks the directory partition of a page.
+     */
+    static const std::uint64_t DIRECTORY_SEED = 2;
+
+    /**
+     * One partition of the directory, each on its own cache line. Its latch
+     * is held over every operation on a page of the partition, so a page is
+     * never read into two nodes at once, and is taken before the latches of
+     * the nodes. owner maps a page to the node it was last read into. An
+     * evicted page keeps its entry, so an entry is only trusted once the node
+     * confirms the page is resident; once a partition grows to sweep_at
+     * entries, the entries of evicted pages are dropped.
+     */
+    struct alignas(64) DirectoryPartition {
+      std::mutex latch;
+      std::unordered_map<PageId, std::uint32_t, BufHash> owner;
+      std::size_t sweep_at;
+    };
+
+    /**
+     * The partitions of the directory.
+     */
+    DirectoryPartition directory[DIRECTORY_PARTITIONS];
+
+    /**
+     * Number of entries a partition may hold after a sweep before it is
+     * swept again, twice its share of the frames of every node.
+     */
+    std::size_t sweep_min;
+
+    /**
+     * Counters of one node, bumped with relaxed atomic adds, each on its own
+     * cache line.
+     */
+    struct alignas(64) NodeCounters {
+      std::atomic<std::uint64_t> local_hits;
+      std::atomic<std::uint64_t> remote_hits;
+      std::atomic<std::uint64_t> local_loads;
+      std::atomic<std::uint64_t> remote_loads;
+    };
+
+    /**
+     * Parallel vector to nodes of the counters of every node.
+     */
+    std::vector<NodeCounters> stats;
+
+    /**
+     * Pointer to SwatDB's DiskManager. Used for creating and removing files.
+     */
+    DiskManager* disk_mgr;
+
+    /**
+     * @brief Counts a hit, or a load if load is true, on node for a thread
+     *        of the node local.
+     */
+    void _count(std::uint32_t node, std::uint32_t local, bool load);
+
+    /**
+     * @brief Returns the directory partition of the page.
+     */
+    DirectoryPartition &_partition(PageId page_id);
+
+    /**
+     * @brief Returns the node the page was last read into, or the node of
+     *        the calling thread if it was never read in, so that the
+     *        BufferManager of that node reports the error. The caller holds
+     *        the latch of the partition.
+     */
+    std::uint32_t _homeNode(DirectoryPartition &partition, PageId page_id);
+
+    /**
+     * @brief Drops the entries of the pages of the partition that are no
+     *        longer resident on their node. The caller holds the latch of
+     *        the partition.
+     */
+    void _sweep(DirectoryPartition &partition);
+};
+
+#endif
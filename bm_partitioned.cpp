@@ -0,0 +1,450 @@
+/**
+ * @file bm_partitioned.cpp
+ * @author Nikoloz Khmaladze & Omar Ebied
+ * @date 2025-02-09
+ *
+ * Implementation of the PartitionedBufferManager class.
+ * This file implements a buffer pool split into independent BufferManager
+ * shards. Every page operation is routed to the home shard of its PageId,
+ * chosen by hash, and file and configuration operations are applied to every
+ * shard.
+ */
+
+#include <iostream>
+
+#include "bm_partitioned.h"
+#include "bm_buffermap.h"
+#include "bm_metrics.h"
+#include "diskmgr.h"
+#include "swatdb_exceptions.h"
+#include "bm_exceptions.h"
+
+/**
+ * @brief PartitionedBufferManager constructor. Creates num_shards
+ *    BufferManagers with the replacement policy of the given type.
+ *
+ * @pre disk_mgr points to an initialized DiskManager object.
+ * @post Every shard is initialized with an empty buffer pool.
+ *
+ * @param disk_mgr A pointer to SwatDB's DiskManager object.
+ *    (DiskManager*).
+ * @param rep_type Replacement policy type of every shard.
+ * @param num_shards Number of shards.
+ * @param huge_pages true to place the buffer pool of every shard on huge
+ *    pages.
+ *
+ * @throw InvalidPolicyBufMgr If the replacement policy type is invalid.
+ * @throw InvalidArgumentBufMgr If num_shards is 0.
+ */
+PartitionedBufferManager::PartitionedBufferManager(DiskManager *disk_mgr,
+    PolicyType rep_type, std::uint32_t num_shards, bool huge_pages){
+
+  if( num_shards == 0 ){
+    throw InvalidArgumentBufMgr();
+  }
+  this->disk_mgr = disk_mgr;
+  this->shards.reserve(num_shards);
+  try{
+    for( std::uint32_t i = 0; i < num_shards; i++ ){
+      this->shards.push_back(new BufferManager(disk_mgr, rep_type, -1,
+                                               huge_pages));
+    }
+  }
+  catch(InvalidPolicyBufMgr&){
+    for( BufferManager *shard : this->shards ){
+      delete shard;
+    }
+    throw;
+  }
+}
+
+/**
+ * @brief PartitionedBufferManager destructor.
+ *
+ * @pre None.
+ * @post Every valid and dirty Page in every shard is written to disk.
+ */
+PartitionedBufferManager::~PartitionedBufferManager(){
+  for( BufferManager *shard : this->shards ){
+    delete shard;
+  }
+}
+
+/**
+ * @brief Allocates a Page for the file of given FileId on disk, and pins it
+ *    in its home shard.
+ *
+ * @pre A valid FileId is provided and there is a free Page on disk or there
+ *    is enough space in Unix file. The home shard of the new Page has free
+ *    space or a Page which can be evicted.
+ * @post The Page is allocated on disk and pinned in its home shard, and a
+ *    pair of a pointer to it and its PageId is returned. If the home shard
+ *    is full of pinned pages, the Page is deallocated from disk again.
+ *
+ * @param file_id A FileId to which a Page should be allocated.
+ * @return std::pair of Page* and PageId of the allocated Page.
+ *
+ * @throw InsufficientSpaceBufMgr If there is not enough space in the home
+ *    shard.
+ * @throw InvalidFileIdDiskMgr If file_id not valid.
+ * @throw InsufficientSpaceDiskMgr If there is not enough space in the Unix
+ *    file.
+ */
+std::pair<Page*, PageId> PartitionedBufferManager::allocatePage(
+    FileId file_id){
+
+  // the home shard is only known once the disk has chosen the PageId, so
+  // the page is allocated first and then installed in its shard, which
+  // does not read it back
+  PageId page_id = this->disk_mgr->allocatePage(file_id);
+  Page *page;
+  try{
+    page = this->shards[this->getShard(page_id)]->installPage(page_id);
+  }
+  catch(InsufficientSpaceBufMgr&){
+    this->disk_mgr->deallocatePage(page_id);
+    throw;
+  }
+  return std::pair<Page*, PageId>(page, page_id);
+}
+
+/**
+ * @brief Removes the Page of the given PageId from its home shard, and
+ *    deallocates the Page from disk.
+ * @see BufferManager::deallocatePage()
+ */
+void PartitionedBufferManager::deallocatePage(PageId page_id){
+  this->shards[this->getShard(page_id)]->deallocatePage(page_id);
+}
+
+/**
+ * @brief Gets Page by page_id from its home shard, pins the Page, and
+ *    returns a pointer to it.
+ * @see BufferManager::getPage()
+ */
+Page* PartitionedBufferManager::getPage(PageId page_id, AccessHint hint){
+  return this->shards[this->getShard(page_id)]->getPage(page_id, hint);
+}
+
+/**
+ * @brief Unpins a Page in its home shard.
+ * @see BufferManager::releasePage()
+ */
+void PartitionedBufferManager::releasePage(PageId page_id, bool dirty,
+    AccessHint hint){
+  this->shards[this->getShard(page_id)]->releasePage(page_id, dirty, hint);
+}
+
+/**
+ * @brief Set the Page of the given PageId dirty.
+ * @see BufferManager::setDirty()
+ */
+void PartitionedBufferManager::setDirty(PageId page_id){
+  this->shards[this->getShard(page_id)]->setDirty(page_id);
+}
+
+/**
+ * @brief Flushes the Page of the given PageId to disk.
+ * @see BufferManager::flushPage()
+ */
+void PartitionedBufferManager::flushPage(PageId page_id){
+  this->shards[this->getShard(page_id)]->flushPage(page_id);
+}
+
+/**
+ * @brief Returns true if the Page of the given PageId is resident in its
+ *    home shard.
+ * @see BufferManager::isResident()
+ */
+bool PartitionedBufferManager::isResident(PageId page_id){
+  return this->shards[this->getShard(page_id)]->isResident(page_id);
+}
+
+/**
+ * @brief Calls createFile() method on the DiskManager to create new Unix
+ *    file that corresponds to the given FileId.
+ *
+ * @param file_id FileId of the file to be created.
+ *
+ * @see DiskManager::createFile()
+ */
+void PartitionedBufferManager::createFile(FileId file_id){
+  this->disk_mgr->createFile(file_id);
+}
+
+/**
+ * @brief Evicts the file's pages from every shard, then removes the file
+ *    from disk.
+ *
+ * @pre A valid FileId is given as a parameter. None of the file's pages are
+ *    pinned in any shard.
+ * @post None of the file's pages are in the buffer pool and the file is
+ *    removed from disk via DiskManager->removeFile(). If a page of the file
+ *    is pinned, the file stays on disk and the pages of the shards checked
+ *    before are written to it and evicted.
+ *
+ * @param file_id FileId of the file to be removed.
+ *
+ * @throw PagePinnedBufMgr If there are pinned pages of file_id.
+ *
+ * @see DiskManager::removeFile()
+ */
+void PartitionedBufferManager::removeFile(FileId file_id){
+  // BufferManager::removeFile would remove the file from disk while other
+  // shards may still hold dirty pages of it
+  for( BufferManager *shard : this->shards ){
+    shard->evictFile(file_id);
+  }
+  this->disk_mgr->removeFile(file_id);
+}
+
+/**
+ * @brief Turns the TinyLFU admission filter of every shard on or off.
+ * @see BufferManager::setAdmission()
+ */
+void PartitionedBufferManager::setAdmission(bool enabled){
+  for( BufferManager *shard : this->shards ){
+    shard->setAdmission(enabled);
+  }
+}
+
+/**
+ * @brief Times one in every `every` operations of each kind into the latency
+ *    histograms of every shard.
+ * @see BufferManager::setLatencySampling()
+ */
+void PartitionedBufferManager::setLatencySampling(std::uint32_t every){
+  for( BufferManager *shard : this->shards ){
+    shard->setLatencySampling(every);
+  }
+}
+
+/**
+ * @brief Records the page accesses of every shard to tracer, or stops
+ *    recording if it is nullptr. The events carry the recording thread, so
+ *    the trace shows the accesses of every shard as the threads made them.
+ * @see BufferManager::setTracer()
+ */
+void PartitionedBufferManager::setTracer(TraceRecorder *tracer){
+  for( BufferManager *shard : this->shards ){
+    shard->setTracer(tracer);
+  }
+}
+
+/**
+ * @brief Turns the SHARDS estimate of the miss ratio curve of every shard on
+ *    or off.
+ * @see BufferManager::setMissRatioCurve()
+ */
+void PartitionedBufferManager::setMissRatioCurve(bool enabled){
+  for( BufferManager *shard : this->shards ){
+    shard->setMissRatioCurve(enabled);
+  }
+}
+
+/**
+ * @brief Turns the compressed cache of every shard on or off, splitting the
+ *    budget evenly between the shards. A page only ever lives in its home
+ *    shard, so it is only ever in the cache of that shard.
+ * @see BufferManager::setCompressedCache()
+ */
+void PartitionedBufferManager::setCompressedCache(std::size_t budget){
+  for( BufferManager *shard : this->shards ){
+    shard->setCompressedCache(budget / this->shards.size());
+  }
+}
+
+/**
+ * @brief Chooses the replacement policy used for the pages of the given
+ *    file in every shard.
+ * @see BufferManager::setFilePolicy()
+ */
+void PartitionedBufferManager::setFilePolicy(FileId file_id,
+    PolicyType rep_type){
+  for( BufferManager *shard : this->shards ){
+    shard->setFilePolicy(file_id, rep_type);
+  }
+}
+
+/**
+ * @brief Returns the number of shards.
+ */
+std::uint32_t PartitionedBufferManager::getNumShards(){
+  return this->shards.size();
+}
+
+/**
+ * @brief Returns the index of the home shard of the page.
+ */
+std::uint32_t PartitionedBufferManager::getShard(PageId page_id){
+  // consecutive pages of a scan are spread over the shards; the TinyLFU
+  // sketch of each shard salts its hash, so sharing these low bits does not
+  // crowd a shard's pages into a fraction of its counters
+  return bm_hash64(page_id) % this->shards.size();
+}
+
+/**
+ * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+ *    Returns the state of the whole buffer pool. Page counts and
+ *    replacement calls are summed over the shards, avg_frames_checked is
+ *    weighted by the replacement calls of each shard, and clock_hand is the
+ *    one of the first shard.
+ * @see BufferState
+ */
+BufferState PartitionedBufferManager::getBufferState(){
+  BufferState total = this->shards[0]->getBufferState();
+  for( std::uint32_t i = 1; i < this->shards.size(); i++ ){
+    bm_add_state(&total, this->shards[i]->getBufferState());
+  }
+  return total;
+}
+
+/**
+ * @brief Returns the hit, miss, eviction and I/O counters of the whole buffer
+ *    pool, summed over the shards.
+ */
+BufferStats PartitionedBufferManager::getBufferStats(){
+  BufferStats total = this->shards[0]->getBufferStats();
+  for( std::uint32_t i = 1; i < this->shards.size(); i++ ){
+    bm_add_stats(&total, this->shards[i]->getBufferStats());
+  }
+  return total;
+}
+
+/**
+ * @brief Returns the latency histogram of the given kind of operation of the
+ *    whole buffer pool, merged over the shards.
+ */
+LatencyHistogram PartitionedBufferManager::getLatency(LatencyKind kind){
+  LatencyHistogram total = this->shards[0]->getLatency(kind);
+  for( std::uint32_t i = 1; i < this->shards.size(); i++ ){
+    total.merge(this->shards[i]->getLatency(kind));
+  }
+  return total;
+}
+
+/**
+ * @brief Returns the predicted hit rates of the whole buffer pool at 0.5, 1,
+ *    2 and 4 times its size, from the estimates of the shards weighted by
+ *    their accesses.
+ */
+MissRatioCurve PartitionedBufferManager::getMissRatioCurve(){
+  MissRatioCurve total = this->shards[0]->getMissRatioCurve();
+  for( std::uint32_t i = 1; i < this->shards.size(); i++ ){
+    bm_add_mrc(&total, this->shards[i]->getMissRatioCurve());
+  }
+  return total;
+}
+
+/**
+ * @brief Renders the state, counters and latency percentiles of the whole
+ *    buffer pool, summed over the shards, in the Prometheus text exposition
+ *    format.
+ * @see bm_metrics_text()
+ */
+std::string PartitionedBufferManager::getMetrics(){
+  LatencyHistogram latency[BM_NUM_LATENCIES];
+  for( std::uint32_t i = 0; i < BM_NUM_LATENCIES; i++ ){
+    latency[i] = getLatency((LatencyKind)i);
+  }
+  return bm_metrics_text(getBufferState(), getBufferStats(), latency);
+}
+
+/**
+ * @brief Writes getMetrics to a file, written aside and renamed.
+ *
+ * @param path Path of the metrics file.
+ *
+ * @throw IOErrorBufMgr If the file cannot be written.
+ */
+void PartitionedBufferManager::writeMetrics(const std::string &path){
+  bm_write_metrics(path, getMetrics());
+}
+
+/**
+ * @brief Return the amount of unpinned pages in every shard.
+ */
+std::uint32_t PartitionedBufferManager::getNumUnpinned(){
+  std::uint32_t unpinned = 0;
+  for( BufferManager *shard : this->shards ){
+    unpinned += shard->getNumUnpinned();
+  }
+  return unpinned;
+}
+
+/**
+ * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+ *    Prints frame state of every frame of every shard.
+ */
+void PartitionedBufferManager::printAllFrames(){
+  for( std::uint32_t i = 0; i < this->shards.size(); i++ ){
+    std::cout << "Shard " << i << ": \n";
+    this->shards[i]->printAllFrames();
+  }
+}
+
+/**
+ * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+ *    Prints frame state of every valid frame of every shard.
+ */
+void PartitionedBufferManager::printValidFrames(){
+  for( std::uint32_t i = 0; i < this->shards.size(); i++ ){
+    std::cout << "Shard " << i << ": \n";
+    this->shards[i]->printValidFrames();
+  }
+}
+
+/**
+ * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+ *    Prints frame state of given FrameId. Frames are numbered across the
+ *    shards, frame_id / BUF_SIZE is the shard.
+ */
+void PartitionedBufferManager::printFrame(FrameId frame_id){
+  this->shards[frame_id / BUF_SIZE]->printFrame(frame_id % BUF_SIZE);
+}
+
+/**
+ * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+ *    Prints frame state of given PageId in its home shard.
+ */
+void PartitionedBufferManager::printPage(PageId page_id){
+  std::uint32_t shard = this->getShard(page_id);
+  std::cout << "Shard: " << shard << ", ";
+  this->shards[shard]->printPage(page_id);
+}
+
+/**
+ * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+ *    Prints the state of the whole buffer pool.
+ * @see getBufferState()
+ */
+void PartitionedBufferManager::printBufferState(){
+  BufferState cur_buf = this->getBufferState();
+
+  std::cout << "Number of shards: " << this->shards.size() << std::endl;
+  std::cout << "Total number of pages: " << cur_buf.total << std::endl;
+  std::cout << "Number of valid pages: " << cur_buf.valid << std::endl;
+  std::cout << "Number of pinned pages: " << cur_buf.pinned << std::endl;
+  std::cout << "Number of unpinned pages: " << cur_buf.unpinned << std::endl;
+  std::cout << "Number of dirty pages: " << cur_buf.dirty <<std::endl;
+  std::cout << "Replacement Policy: " <<
+    bm_rep_str(cur_buf.replace_stats.rep_type) << std::endl;
+  std::cout << "Number of calls to replacement policy: " <<
+    cur_buf.replace_stats.rep_calls << std::endl;
+  std::cout << "Average frames checked per call: " <<
+    cur_buf.replace_stats.avg_frames_checked << std::endl;
+  std::cout << "Number of pages with ref bit set: " <<
+    cur_buf.replace_stats.ref_bit << std::endl;
+  bm_print_stats(this->getBufferStats());
+}
+
+/**
+ * @brief This method is for performance tests.
+ *    Prints the replacement statistics of every shard.
+ */
+void PartitionedBufferManager::printReplacementStats(){
+  for( std::uint32_t i = 0; i < this->shards.size(); i++ ){
+    std::cout << "Shard " << i << ": \n";
+    this->shards[i]->printReplacementStats();
+  }
+}
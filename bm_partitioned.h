@@ -0,0 +1,267 @@
+#ifndef _SWATDB_BM_PARTITIONED_H_
+#define  _SWATDB_BM_PARTITIONED_H_
+
+/**
+ * \file bm_partitioned.h: PartitionedBufferManager class: buffer pool split
+ * into independent BufferManager instances by PageId hash
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "swatdb_types.h"
+#include "bufmgr.h"
+
+class DiskManager;
+
+
+/**
+ * SwatDB PartitionedBufferManager Class.
+ * Splits the buffer pool into num_shards independent BufferManager instances,
+ * each with its own frames, BufferMap and replacement policy, like the
+ * buffer pool instances of InnoDB. A page only ever lives in its home shard,
+ * chosen by a hash of its PageId, so operations on pages of different shards
+ * never touch the same clock hand or page table, and a caller can latch each
+ * shard separately. Every shard holds BUF_SIZE frames, so the pool holds
+ * num_shards * BUF_SIZE pages. Every method has the contract of the
+ * BufferManager method of the same name, applied to the home shard of the
+ * page, or to every shard for file and configuration operations.
+ *
+ * The shards share one DiskManager, which does not promise to be safe for
+ * concurrent calls. A caller latching the shards separately must also
+ * serialize the calls that may reach it: getPage of a page that is not
+ * resident, which reads it and may write back a victim, and allocatePage,
+ * deallocatePage, flushPage and the file operations.
+ */
+class PartitionedBufferManager {
+
+  public:
+
+    /**
+     * @brief PartitionedBufferManager constructor. Creates num_shards
+     *        BufferManagers with the replacement policy of the given type.
+     *
+     * @pre disk_mgr points to an initialized DiskManager object.
+     * @post Every shard is initialized with an empty buffer pool.
+     *
+     * @param disk_mgr A pointer to SwatDB's DiskManager object.
+     *    (DiskManager*).
+     * @param rep_type Replacement policy type of every shard.
+     * @param num_shards Number of shards.
+     * @param huge_pages true to place the buffer pool of every shard on huge
+     *    pages.
+     *
+     * @throw InvalidPolicyBufMgr If the replacement policy type is invalid.
+     * @throw InvalidArgumentBufMgr If num_shards is 0.
+     */
+    PartitionedBufferManager(DiskManager *disk_mgr, PolicyType rep_type,
+                             std::uint32_t num_shards,
+                             bool huge_pages = false);
+
+    /**
+     * @brief PartitionedBufferManager destructor.
+     *
+     * @pre None.
+     * @post Every valid and dirty Page in every shard is written to disk.
+     */
+    ~PartitionedBufferManager();
+
+    /**
+     * @brief Allocates a Page for the file of given FileId on disk, and pins
+     *        it in its home shard.
+     *
+     * @pre A valid FileId is provided and there is a free Page on disk or
+     *      there is enough space in Unix file. The home shard of the new
+     *      Page has free space or a Page which can be evicted.
+     * @post The Page is allocated on disk and pinned in its home shard, and
+     *       a pair of a pointer to it and its PageId is returned. If the home
+     *       shard is full of pinned pages, the Page is deallocated from disk
+     *       again.
+     *
+     * @param file_id A FileId to which a Page should be allocated.
+     * @return std::pair of Page* and PageId of the allocated Page.
+     *
+     * @throw InsufficientSpaceBufMgr If there is not enough space in the
+     *        home shard.
+     * @throw InvalidFileIdDiskMgr If file_id not valid.
+     * @throw InsufficientSpaceDiskMgr If there is not enough space in the
+     *        Unix file.
+     */
+    std::pair<Page*,PageId> allocatePage(FileId file_id);
+
+    /**
+     * Page operations, forwarded to the home shard of page_id.
+     * @see BufferManager
+     */
+    void deallocatePage(PageId page_id);
+    Page* getPage(PageId page_id, AccessHint hint = NoHint);
+    void releasePage(PageId page_id, bool dirty, AccessHint hint = NoHint);
+    void setDirty(PageId page_id);
+    void flushPage(PageId page_id);
+    bool isResident(PageId page_id);
+
+    /**
+     * @brief Calls createFile() method on the DiskManager to create new Unix
+     *        file that corresponds to the given FileId.
+     *
+     * @param file_id FileId of the file to be created.
+     *
+     * @see DiskManager::createFile()
+     */
+    void createFile(FileId file_id);
+
+    /**
+     * @brief Evicts the file's pages from every shard, then removes the file
+     *        from disk.
+     *
+     * @pre A valid FileId is given as a parameter. None of the file's pages
+     *      are pinned in any shard.
+     * @post None of the file's pages are in the buffer pool and the file is
+     *       removed from disk via DiskManager->removeFile(). If a page of the
+     *       file is pinned, the file stays on disk and the pages of the
+     *       shards checked before are written to it and evicted.
+     *
+     * @param file_id FileId of the file to be removed.
+     *
+     * @throw PagePinnedBufMgr If there are pinned pages of file_id.
+     *
+     * @see DiskManager::removeFile()
+     */
+    void removeFile(FileId file_id);
+
+    /**
+     * Configuration, applied to every shard.
+     * @see BufferManager
+     */
+    void setAdmission(bool enabled);
+    void setLatencySampling(std::uint32_t every);
+    void setTracer(TraceRecorder *tracer);
+    void setMissRatioCurve(bool enabled);
+    void setFilePolicy(FileId file_id, PolicyType rep_type);
+
+    /**
+     * @brief Turns the compressed cache of every shard on, each with an
+     *        equal share of budget, or off if budget is 0.
+     * @see BufferManager::setCompressedCache()
+     */
+    void setCompressedCache(std::size_t budget);
+
+    /**
+     * @brief Returns the number of shards.
+     */
+    std::uint32_t getNumShards();
+
+    /**
+     * @brief Returns the index of the home shard of the page.
+     */
+    std::uint32_t getShard(PageId page_id);
+
+    /**
+     * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+     *        Returns the state of the whole buffer pool. Page counts and
+     *        replacement calls are summed over the shards, avg_frames_checked
+     *        is weighted by the replacement calls of each shard, and
+     *        clock_hand is the one of the first shard.
+     * @see BufferState
+     */
+    BufferState getBufferState();
+
+    /**
+     * @brief Returns the hit, miss, eviction and I/O counters of the whole
+     *        buffer pool, summed over the shards.
+     * @see bm_add_stats()
+     */
+    BufferStats getBufferStats();
+
+    /**
+     * @brief Returns the latency histogram of the given kind of operation
+     *        of the whole buffer pool, merged over the shards.
+     * @see BufferManager::getLatency()
+     */
+    LatencyHistogram getLatency(LatencyKind kind);
+
+    /**
+     * @brief Returns the predicted hit rates of the whole buffer pool at
+     *        0.5, 1, 2 and 4 times its size. Each shard is a separate pool
+     *        that grows with the whole, so the hit rates of the shards are
+     *        weighted by their accesses.
+     * @see bm_add_mrc()
+     */
+    MissRatioCurve getMissRatioCurve();
+
+    /**
+     * @brief Renders the state, counters and latency percentiles of the
+     *        whole buffer pool, summed over the shards, in the Prometheus
+     *        text exposition format.
+     * @see BufferManager::getMetrics()
+     */
+    std::string getMetrics();
+
+    /**
+     * @brief Writes getMetrics to a file, written aside and renamed.
+     *
+     * @throw IOErrorBufMgr If the file cannot be written.
+     */
+    void writeMetrics(const std::string &path);
+
+    /**
+     * @brief Return the amount of unpinned pages in every shard.
+     */
+    std::uint32_t getNumUnpinned();
+
+    /**
+     * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+     *        Prints Frame state of every Frame of every shard.
+     */
+    void printAllFrames();
+
+    /**
+     * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+     *        Prints Frame state of every valid Frame of every shard.
+     */
+    void printValidFrames();
+
+    /**
+     * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+     *        Prints Frame state of given FrameId. Frames are numbered across
+     *        the shards, frame_id / BUF_SIZE is the shard.
+     */
+    void printFrame(FrameId frame_id);
+
+    /**
+     * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+     *        Prints Frame state of given PageId in its home shard.
+     */
+    void printPage(PageId page_id);
+
+    /**
+     * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+     *        Prints the state of the whole buffer pool.
+     * @see getBufferState()
+     */
+    void printBufferState();
+
+    /**
+     * @brief This method is for performance tests.
+     *        Prints the replacement statistics of every shard.
+     */
+    void printReplacementStats();
+
+  private:
+
+    /**
+     * The shards. shards[getShard(page_id)] is the only one that may hold
+     * page_id.
+     */
+    std::vector<BufferManager*> shards;
+
+    /**
+     * Pointer to SwatDB's DiskManager. Used for allocating pages before they
+     * are placed in their home shard.
+     */
+    DiskManager* disk_mgr;
+};
+
+#endif
@@ -3,18 +3,22 @@
  * @author Nikoloz Khmaladze & Omar Ebied
  * @date 2025-02-09
  * 
- * Implementation of the Clock and Random replacement
- * policies.
- * This file contains the implementations of the Clock and Random page
- * replacement policies, which are used by the BufferManager to decide which
- * pages to evict from the buffer pool when it's full.  It defines the
+ * Implementation of the Clock, GClock, ClockPro, LIRS, SIEVE, S3-FIFO,
+ * PerFile and Random replacement policies.
+ * This file contains the implementations of the Clock, GClock, ClockPro, LIRS,
+ * SIEVE, S3-FIFO, PerFile and Random page replacement policies, which are used by the BufferManager to
+ * decide which pages to evict from the buffer pool when it's full.  It defines the
  * methods for these policies, including how they track page usage and
  * select victims for replacement.
  */
 
 #include <utility>
 #include <iostream>
+#include <iterator>
 #include <deque>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 #include "bufmgr.h"
 #include "swatdb_exceptions.h"
 #include "file.h"
@@ -30,7 +34,8 @@
 /**
  * @brief Clock constructor. Initializes pointer to buffer manager's
  *    frame_table, creates the free list, sets clock_hand, rep_calls,
- *    and avg_frames_checked to 0, and sets all ref_bits to false.
+ *    and avg_frames_checked to 0, and sets all ref_bits and pinned bits to
+ *    false.
  *
  * @pre BufferManager constructor is being called, frame_table parameter
  *    points to an initialized frame_table object.
@@ -46,11 +51,11 @@ Clock::Clock(Frame *frame_table){
   this->_createFree();
   this->clock_hand = 0;
   this->rep_calls = 0;
+  this->new_page_calls = 0;
   this->avg_frames_checked = 0.0;
 
-  for( uint32_t i = 0; i < BUF_SIZE; i++ ){
-    this->ref_table[i] = false;
-  }
+  this->ref_bits.clearAll();
+  this->pin_bits.clearAll();
 }
 
 
@@ -72,7 +77,10 @@ Clock::~Clock(){}
  *    replacement and is returned. If there is a Page that is valid, and is not
  *    referenced, it is selected for eviction and FrameId is returned. In the
  *    process of performing the replacement algorithm, ref_bit of some
- *    valid pages that are not pinned may be set to false.
+ *    valid pages that are not pinned may be set to false. The hand moves a
+ *    word of the bitmaps at a time: the first unpinned, unreferenced frame in
+ *    the word is found with a count-trailing-zeros, and the ref_bits of every
+ *    unpinned frame swept past are cleared with a single mask.
  *
  * @return FrameID of the frame that is eligible for replacement in the
  *    buffer pool.
@@ -88,33 +96,78 @@ FrameId Clock::replace(){
   }
 
   uint32_t frames_checked = 0;
-  
+  uint32_t start_hand = this->clock_hand;
+  bool found_unpinned = false;
+
   while(true){
-    Frame &frame = this->frame_table[this->clock_hand];
+    uint32_t word = this->clock_hand / BM_WORD_BITS;
+    uint32_t offset = this->clock_hand % BM_WORD_BITS;
 
-    // had to check for pinned pages FIRST
-    if(frame.pin_count > 0){
-      this->_advanceClock();
-      frames_checked++;
-      continue; //don't consider for replacement
-    }
-    
-    // now we can consider for replacement (only valid frames for replacement)
-    if (frame.valid){ 
-      if(this->ref_table[this->clock_hand]){
-        this->ref_table[this->clock_hand] = false;
-        this->_advanceClock();
+#ifdef __AVX2__
+    // sweep 256 frames with one compare when none of them can be replaced
+    if(offset == 0 && (word + 4) * BM_WORD_BITS <= BUF_SIZE){
+      __m256i pinned = _mm256_loadu_si256(
+          (const __m256i *) &this->pin_bits.bits[word]);
+      __m256i refs = _mm256_loadu_si256(
+          (const __m256i *) &this->ref_bits.bits[word]);
+      __m256i ones = _mm256_set1_epi64x(-1);
+      // candidates are the bits set in neither pinned nor refs
+      if(_mm256_testc_si256(_mm256_or_si256(pinned, refs), ones)){
+        if(!_mm256_testc_si256(pinned, ones)){
+          found_unpinned = true;
+        }
+        _mm256_storeu_si256((__m256i *) &this->ref_bits.bits[word],
+            _mm256_and_si256(refs, pinned));
+        frames_checked += 4 * BM_WORD_BITS;
+        this->clock_hand = ((word + 4) * BM_WORD_BITS) % BUF_SIZE;
+        if(frames_checked >= BUF_SIZE && !found_unpinned){
+          this->clock_hand = start_hand;
+          throw InsufficientSpaceBufMgr();
+        }
+        continue;
       }
-      else{
+    }
+#endif
+
+    uint64_t range = FrameBitmap::wordMask(word) & (~0ULL << offset);
+    uint64_t unpinned = ~this->pin_bits.bits[word] & range;
+    uint64_t candidates = unpinned & ~this->ref_bits.bits[word];
+
+    if(unpinned != 0){
+      found_unpinned = true;
+    }
+
+    if(candidates != 0){
+      uint32_t bit = __builtin_ctzll(candidates);
+      FrameId victim = word * BM_WORD_BITS + bit;
+
+      // clear ref_bits of the unpinned frames the hand passes on its way
+      this->ref_bits.bits[word] &= ~(unpinned & ((1ULL << bit) - 1));
+      frames_checked += bit - offset;
+      this->clock_hand = victim;
+      this->_advanceClock();
+
+      // only valid frames are replaced, invalid ones are on the free list
+      if(this->frame_table[victim].valid){
         this->rep_calls++;
         this->avg_frames_checked = (((this->avg_frames_checked) * (this->rep_calls-1)) + frames_checked) / ((this->rep_calls)+1);
-        FrameId tempclock = this->clock_hand;
-        this->_advanceClock();
-        return tempclock;
+        return victim;
       }
+      frames_checked++;
+    }
+    else{
+      // nothing replaceable in the rest of this word: clear all its ref_bits
+      this->ref_bits.bits[word] &= ~unpinned;
+      frames_checked += __builtin_popcountll(range);
+      this->clock_hand = (word + 1 == BM_WORDS) ? 0 :
+                         (word + 1) * BM_WORD_BITS;
     }
 
-    if (frames_checked >= BUF_SIZE) {
+    // one full sweep without an unpinned frame means everything is pinned;
+    // after two sweeps every unpinned frame must have been seen unreferenced
+    if((frames_checked >= BUF_SIZE && !found_unpinned) ||
+        frames_checked > 2 * BUF_SIZE + BM_WORD_BITS){
+        this->clock_hand = start_hand;
         throw InsufficientSpaceBufMgr();
     }
   }
@@ -122,33 +175,24 @@ FrameId Clock::replace(){
 
 
 /**
- * @brief Frame is being pinned with pin count going from 0 to 1. Clock
- * policy has nothing to do here, but an empty method must exist for 
- * BufferManager to call.
+ * @brief Undoes the replacement of the frame replace() just returned: the
+ *    clock_hand is back on it, so the sweep resumes there. Its ref_bit is
+ *    still clear.
  *
- * @pre A page in the buffer pool has been pinned, and the pin count of that
- *    frame has increased from 0 to 1.
+ * @pre frame_id was just returned by replace() and holds a valid, unpinned
+ *    page. No other policy method was called since.
  *
- * @post Nothing.
+ * @post clock_hand is frame_id.
  *
- * @param FrameId frame_id of the frame being unpinned.
+ * @param FrameId frame_id of the frame to reinstate.
  */
-void Clock::pin(FrameId frame_id){}
+void Clock::reinstate(FrameId frame_id){
+  this->clock_hand = frame_id;
+}
+
+
 
 
-/**
- * @brief Frame is being unpinned with pin count going from 1 to 0. Set the
- * ref_bit associated with this frame_id to true.
- *
- * @pre A page in the buffer pool has been unpinned from pin count 1 to 0.
- *
- * @post Ref_bit of frame_id is set to true.
- *
- * @param FrameId frame_id of the frame being unpinned.
- */
-void Clock::unpin(FrameId frame_id){
-  this->ref_table[frame_id] = true;
-}
 
 /**
  * @brief Updates the struct of replacement policy statistics within the
@@ -163,21 +207,52 @@ void Clock::getRepStats(struct BufferState::ReplacementStats *rep_stats){
   rep_stats->rep_calls = this->rep_calls;
   rep_stats->avg_frames_checked = this->avg_frames_checked;
   rep_stats->new_page_calls = this->new_page_calls;
-  rep_stats->ref_bit = 0;
-  // loop through ref_table to get total ref_bits set to true
-  for(FrameId i = 0; i < BUF_SIZE; i++){
-    if (this->ref_table[i]){
-      rep_stats->ref_bit ++;
+  rep_stats->ref_bit = this->ref_bits.count();
+  rep_stats->clock_hand = this->clock_hand;
+}
+
+
+/**
+ * @brief Places a frame that was just unpinned according to how its page
+ *    will be accessed. SequentialHint clears its ref_bit so the hand replaces
+ *    it on its next pass. KeepHotHint leaves the ref_bit set by unpin: Clock
+ *    keeps a single bit of history.
+ *
+ * @pre The pin count of frame_id has just dropped to 0.
+ * @post The ref_bit of frame_id reflects the hint.
+ */
+void Clock::hint(FrameId frame_id, AccessHint hint){
+  if(hint == SequentialHint){
+    this->ref_bits.clear(frame_id);
+  }
+}
+
+
+/**
+ * @brief Appends the valid frames to ranked, the one the hand would
+ *    replace last first: frames with the ref_bit set before the others,
+ *    each group from just behind the hand backwards, since the hand reaches
+ *    the frames just ahead of it first.
+ *
+ * @post The policy state is unchanged.
+ */
+void Clock::rankFrames(std::vector<FrameId> *ranked){
+  for(std::uint32_t pass = 0; pass < 2; pass++){
+    for(std::uint32_t i = 1; i <= BUF_SIZE; i++){
+      FrameId frame_id = (this->clock_hand + BUF_SIZE - i) % BUF_SIZE;
+      if(this->frame_table[frame_id].valid &&
+         this->ref_bits.test(frame_id) == (pass == 0)){
+        ranked->push_back(frame_id);
+      }
     }
   }
-  rep_stats->clock_hand = this->clock_hand;
 }
 
 
 /**
  * @brief The frame is invalidated in the buffer manager, and is
  *    added to the free list of frames in the replacement policy. Ref_bit
- *    associated with this frame is set to false.
+ *    and pinned bit associated with this frame are set to false.
  *
  * @pre A page in the buffer pool has been deallocated.
  *
@@ -188,7 +263,8 @@ void Clock::getRepStats(struct BufferState::ReplacementStats *rep_stats){
  */
 void Clock::freeFrame(FrameId frame_id){
   this->free.push(frame_id);
-  this->ref_table[frame_id] = false;
+  this->ref_bits.clear(frame_id);
+  this->pin_bits.clear(frame_id);
 }
 
 
@@ -198,7 +274,7 @@ void Clock::freeFrame(FrameId frame_id){
  */
 void Clock::printFrame(FrameId frame_id){  
   std::cout << ", " <<
-  "ref_bit: " << this->ref_table[frame_id] << std::endl;
+  "ref_bit: " << this->ref_bits.test(frame_id) << std::endl;
 }
 
 
@@ -207,15 +283,9 @@ void Clock::printFrame(FrameId frame_id){
  *    how many frames have ref_bit set.
  */
 void Clock::printStats(){
-  int ref_bit_count = 0;
+  int ref_bit_count = this->ref_bits.count();
   double pct_replace = 0;
 
-  for(FrameId i = 0; i < BUF_SIZE; i++){
-    if (this->ref_table[i]){
-      ref_bit_count ++;
-    }
-  }
-
   if(this->new_page_calls != 0) {  // don't divide by 0
     pct_replace = 100* (double)this->rep_calls / this->new_page_calls;
   } 
@@ -248,36 +318,276 @@ void Clock::_advanceClock(){
  * @brief Derived class from pure virtual function that returns replacement
  * policy type specific to this derived class.
  *
- * @return RepType ClockT.
+ * @return PolicyType ClockT.
  *
  */
-RepType Clock::_getType(){
+PolicyType Clock::_getType(){
   return ClockT;
 }
 
 
 
 /**
- * @brief Random constructor. Initializes pointer to buffer manager's
+ * @brief GClock constructor. Initializes the Clock state and sets every
+ *    usage count to 0.
+ *
+ * @pre BufferManager constructor is being called, frame_table parameter
+ *    points to an initialized frame_table object. max_weight is at least 1
+ *    and at most 255.
+ *
+ * @post A GClock object will be initialized with member variables
+ *    initialized.
+ *
+ * @param Frame *frame_table, pointer to frame_table array of BufferManager.
+ * @param max_weight cap of the usage count of each frame.
+ */
+GClock::GClock(Frame *frame_table, std::uint32_t max_weight)
+  : Clock(frame_table){
+
+  if(max_weight < 1){
+    max_weight = 1;
+  }
+  if(max_weight > 255){
+    max_weight = 255;
+  }
+  this->max_weight = max_weight;
+
+  for(FrameId i = 0; i < BUF_SIZE; i++){
+    this->usage[i] = 0;
+  }
+}
+
+
+/**
+* @brief Empty Destructor. 
+*/
+GClock::~GClock(){}
+
+
+/**
+ * @brief Method that implements the generalized clock replacement policy.
+ *
+ * @pre The replacement policy has been invoked. The buffer manager is
+ *    attempting to add a frame to the buffer pool. The buffer map is
+ *    locked.
+ *
+ * @post If there is a free (invalid) frame, that FrameID is chosen for
+ *    replacement and is returned. Else, the clock hand skips pinned frames
+ *    and decrements the usage count of every unpinned frame it sweeps past,
+ *    until it finds a valid unpinned frame whose usage count is already 0,
+ *    which is returned.
+ *
+ * @return FrameID of the frame that is eligible for replacement in the
+ *    buffer pool.
+ *
+ * @throw InsufficientSpaceBufMgr if all pages in the buffer pool are
+ *    pinned.
+ */
+FrameId GClock::replace(){
+  if( !this->free.empty() ){
+     FrameId frontID = this->free.front();
+     this->free.pop();
+     return frontID;
+  }
+
+  uint32_t frames_checked = 0;
+
+  while(true){
+    // skip runs of pinned frames a word at a time
+    FrameId next = this->pin_bits.findNextClear(this->clock_hand);
+    if(next == BUF_SIZE){
+      throw InsufficientSpaceBufMgr();
+    }
+    frames_checked += (next + BUF_SIZE - this->clock_hand) % BUF_SIZE;
+    this->clock_hand = next;
+
+    if(this->frame_table[next].valid){
+      if(this->usage[next] > 0){
+        this->usage[next]--;
+        if(this->usage[next] == 0){
+          this->ref_bits.clear(next);
+        }
+      }
+      else{
+        this->rep_calls++;
+        this->avg_frames_checked = (((this->avg_frames_checked) * (this->rep_calls-1)) + frames_checked) / ((this->rep_calls)+1);
+        this->_advanceClock();
+        return next;
+      }
+    }
+    this->_advanceClock();
+    frames_checked++;
+
+    // every unpinned frame reaches 0 within max_weight sweeps, so only a
+    // pool of unpinned invalid frames can get here
+    if(frames_checked > (this->max_weight + 2) * BUF_SIZE){
+      throw InsufficientSpaceBufMgr();
+    }
+  }
+}
+
+
+/**
+ * @brief Frame is being unpinned with pin count going from 1 to 0.
+ *    Increments the usage count of the frame, up to max_weight.
+ *
+ * @pre A page in the buffer pool has been unpinned from pin count 1 to 0.
+ *
+ * @post Usage count of frame_id is incremented unless it is max_weight.
+ *    ref_bit of frame_id is set, pinned bit is cleared.
+ *
+ * @param FrameId frame_id of the frame being unpinned.
+ */
+void GClock::unpin(FrameId frame_id){
+  Clock::unpin(frame_id);
+  if(this->usage[frame_id] < this->max_weight){
+    this->usage[frame_id]++;
+  }
+}
+
+
+/**
+ * @brief Places a frame that was just unpinned according to how its page
+ *    will be accessed. SequentialHint drops its usage count to 0,
+ *    KeepHotHint raises it to max_weight.
+ *
+ * @pre The pin count of frame_id has just dropped to 0.
+ * @post The usage count of frame_id reflects the hint.
+ */
+void GClock::hint(FrameId frame_id, AccessHint hint){
+  if(hint == SequentialHint){
+    this->usage[frame_id] = 0;
+    this->ref_bits.clear(frame_id);
+  }
+  else if(hint == KeepHotHint){
+    this->usage[frame_id] = this->max_weight;
+    this->ref_bits.set(frame_id);
+  }
+}
+
+
+/**
+ * @brief Appends the valid frames to ranked, the one the hand would
+ *    replace last first: by usage count, highest first, and in the order of
+ *    Clock::rankFrames among frames of the same count.
+ *
+ * @post The policy state is unchanged.
+ */
+void GClock::rankFrames(std::vector<FrameId> *ranked){
+  std::vector<FrameId> by_clock;
+  Clock::rankFrames(&by_clock);
+  for(int weight = this->max_weight; weight >= 0; weight--){
+    for(FrameId frame_id : by_clock){
+      if(this->usage[frame_id] == weight){
+        ranked->push_back(frame_id);
+      }
+    }
+  }
+}
+
+
+/**
+ * @brief The frame is invalidated in the buffer manager, and is
+ *    added to the free list of frames in the replacement policy. The
+ *    usage count of the frame is reset to 0.
+ *
+ * @pre A page in the buffer pool has been deallocated.
+ *
+ * @post frame_id is on the free list with a usage count of 0.
+ *
+ * @param FrameId frame_id of the frame being set invalid.
+ */
+void GClock::freeFrame(FrameId frame_id){
+  Clock::freeFrame(frame_id);
+  this->usage[frame_id] = 0;
+}
+
+
+/**
+ * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+ *    Prints Frame state, including ref_bit and usage count.
+ */
+void GClock::printFrame(FrameId frame_id){
+  std::cout << ", " << "ref_bit: " << this->ref_bits.test(frame_id) <<
+    ", " << "usage: " << (int) this->usage[frame_id] << std::endl;
+}
+
+
+/**
+ * @brief Prints clock_hand, average frames checked, replacement calls,
+ *    max weight and the average usage count of the frames.
+ */
+void GClock::printStats(){
+  double pct_replace = 0;
+  double usage_sum = 0;
+
+  for(FrameId i = 0; i < BUF_SIZE; i++){
+    usage_sum += this->usage[i];
+  }
+
+  if(this->new_page_calls != 0) {  // don't divide by 0
+    pct_replace = 100* (double)this->rep_calls / this->new_page_calls;
+  } 
+  std::cout << "Replacement Policy: " << "GCLOCK" << std::endl;
+  std::cout << "Number of calls to replacement policy: " 
+    << this->rep_calls << std::endl;
+  std::cout << "Percentage of new page calls that use replacement policy: " 
+    << pct_replace << "%" << std::endl;
+  std::cout << "Number of new page calls: " 
+    << this->new_page_calls << std::endl;
+  std::cout << "Average frames checked per call to replacement policy: " 
+    << this->avg_frames_checked << std::endl;
+  std::cout << "Clock hand position: " << this->clock_hand << std::endl;
+  std::cout << "Max weight: " << (int) this->max_weight << std::endl;
+  std::cout << "Average usage count: " << usage_sum / BUF_SIZE << std::endl;
+}
+
+
+/**
+ * @brief Derived class from pure virtual function that returns replacement
+ * policy type specific to this derived class.
+ *
+ * @return PolicyType GClockT.
+ *
+ */
+PolicyType GClock::_getType(){
+  return GClockT;
+}
+
+
+
+/**
+ * @brief ClockPro constructor. Initializes pointer to buffer manager's
  *    frame_table, creates the free list, sets rep_calls and
- *    avg_frames_checked to 0.
+ *    avg_frames_checked to 0, and starts with an empty clock list and a
+ *    cold target of 1.
  *
  * @pre BufferManager constructor is being called, frame_table parameter
  *    points to an initialized frame_table object.
  *
- * @post A Random policy object will be initialized with member variables
+ * @post A ClockPro object will be initialized with member variables
  *    initialized.
  *
  * @param Frame *frame_table, pointer to frame_table array of BufferManager.
  */
-Random::Random(Frame *frame_table) {
+ClockPro::ClockPro(Frame *frame_table){
   this->frame_table = frame_table;
   this->rep_calls = 0;
   this->new_page_calls = 0;
-  this->avg_frames_checked = 0;
-  for(std::uint32_t i = 0; i < BUF_SIZE; i++){
-    this->times_chosen[i] = 0;
+  this->avg_frames_checked = 0.0;
+  this->hot_count = 0;
+  this->cold_count = 0;
+  this->cold_target = 1;
+  this->pinned_count = 0;
+  this->test_hits = 0;
+
+  this->hand_hot = this->clock_list.end();
+  this->hand_cold = this->clock_list.end();
+  this->hand_test = this->clock_list.end();
+  for(FrameId i = 0; i < BUF_SIZE; i++){
+    this->frame_entry[i] = this->clock_list.end();
   }
+  this->ref_bits.clearAll();
   this->_createFree();
 }
 
@@ -285,22 +595,21 @@ Random::Random(Frame *frame_table) {
 /**
 * @brief Empty Destructor. 
 */
-Random::~Random(){}
+ClockPro::~ClockPro(){}
 
 
 /**
- * @brief Method that implements the Random replacement policy functionality
+ * @brief Method that implements the CLOCK-Pro replacement policy.
  *
  * @pre The replacement policy has been invoked. The buffer manager is
  *    attempting to add a frame to the buffer pool. The buffer map is
  *    locked.
  *
  * @post If there is a free (invalid) frame, that FrameID is chosen for
- *    replacement and is returned. Else, a random frame is selected and
- *    evaluated for eligibility. If it is pinned, another random frame is
- *    selected. If no unpinned frame is found by BUF_SIZE attempts,
- *    sequential scan is done to find an eligible frame. If all pages are
- *    pinned, an exception is thrown.
+ *    replacement and is returned. Else hand_cold sweeps the clock list
+ *    until it finds an unpinned, unreferenced cold page, whose frame is
+ *    returned. If the page was in its test period, its entry stays on the
+ *    list as a non-resident page.
  *
  * @return FrameID of the frame that is eligible for replacement in the
  *    buffer pool.
@@ -308,83 +617,2273 @@ Random::~Random(){}
  * @throw InsufficientSpaceBufMgr if all pages in the buffer pool are
  *    pinned.
  */
-FrameId Random::replace() {
-  // first check if there are free frames and return one if true
-  if(!this->free.empty()) {
+FrameId ClockPro::replace(){
+  if(!this->free.empty()){
     FrameId frame_id = this->free.front();
     this->free.pop();
     return frame_id;
   }
-  std::uint32_t rand_num = std::rand() % BUF_SIZE;
-  std::uint32_t c = 0;
-  Frame *cur_frame = &this->frame_table[rand_num];
-  // Tries random frame BUF_SIZE times
-  while(cur_frame->pin_count != 0 && c < BUF_SIZE/2) {
-    c++;
-    rand_num = std::rand() % BUF_SIZE;
-    cur_frame = &this->frame_table[rand_num];
-  }
-  // if random frame tried BUF_SIZE times, loop throuugh and check every frame
-  if(c == BUF_SIZE) {
-    for(FrameId i = 0; i < BUF_SIZE; i++) {
-      cur_frame = &this->frame_table[i];
-      if(cur_frame->pin_count == 0){
-        // update replacement stats
-        if((this->rep_calls + 1) == 0) {  // start over if wrap-around
-          this->rep_calls = 0;
+  if(this->pinned_count >= this->hot_count + this->cold_count){
+    throw InsufficientSpaceBufMgr();
+  }
+
+  std::uint32_t frames_checked = 0;
+  std::uint32_t steps = 0;
+
+  while(true){
+    // no cold page hand_cold could take: turn an unpinned hot page cold
+    if(this->cold_count == 0 || steps > 2 * this->clock_list.size()){
+      this->_runHandHot();
+      steps = 0;
+    }
+
+    std::list<ClockProEntry>::iterator it = this->hand_cold;
+    this->hand_cold = this->_nextEntry(it);
+    steps++;
+
+    if(!it->resident || it->hot){
+      continue;
+    }
+    frames_checked++;
+
+    FrameId frame_id = it->frame_id;
+    if(this->frame_table[frame_id].pin_count > 0){
+      continue;
+    }
+
+    if(this->ref_bits.test(frame_id)){
+      this->ref_bits.clear(frame_id);
+      if(it->test){
+        // reused within its test period: the page's reuse distance is small
+        it->hot = true;
+        it->test = false;
+        this->hot_count++;
+        this->cold_count--;
+        this->_moveHead(it);
+        if(this->hot_count > BUF_SIZE - this->cold_target){
+          this->_runHandHot();
         }
-        this->avg_frames_checked = (this->avg_frames_checked *
-                                    this->rep_calls) + c + i;
-        this->rep_calls ++;
-        this->avg_frames_checked /= this->rep_calls;
-        this->times_chosen[i] ++;
-        return i;
       }
+      else{
+        it->test = true;
+        this->_moveHead(it);
+      }
+      continue;
     }
-    throw InsufficientSpaceBufMgr();
-  } else { // random frame found that can be replaced before BUF_SIZE tries
-    // update replacement stats
-    //  std::cout << "frame found: " << rand_num << std::endl;
-    if((this->rep_calls + 1) == 0) {  // start over if wrap-around
-      this->rep_calls = 0;
-    }
-    this->avg_frames_checked = 
-      (this->avg_frames_checked * this->rep_calls) + c + 1;
-    this->rep_calls ++;
+
+    // evict, remembering the page if it is still in its test period
+    this->cold_count--;
+    this->frame_entry[frame_id] = this->clock_list.end();
+    if(it->test){
+      it->resident = false;
+      this->nonresident[it->page_id] = it;
+    }
+    else{
+      this->_removeEntry(it);
+    }
+
+    this->avg_frames_checked = (this->avg_frames_checked * this->rep_calls) +
+                               frames_checked;
+    this->rep_calls++;
     this->avg_frames_checked /= this->rep_calls;
-    this->times_chosen[rand_num] ++;
-    return rand_num;
+    return frame_id;
   }
 }
 
 
 /**
- * @brief Frame is being pinned with pin count going from 0 to 1. Ramdom
- *    policy has nothing to do here, but an empty method must exist for
- *    BufferManager to call.
+ * @brief Undoes the replacement of the frame replace() just returned: the
+ *    entry of its page is resident and cold again, where it was on the clock
+ *    list, and hand_cold is back on it. A page that was out of its test
+ *    period gets a new cold entry there.
  *
- * @pre A page in the buffer pool has been pinned, and the pin count of that
- *    frame has increased from 0 to 1.
+ * @pre frame_id was just returned by replace() and holds a valid, unpinned
+ *    page. No other policy method was called since.
  *
- * @post Nothing.
+ * @post frame_id has a resident cold entry on the clock list.
  *
- * @param FrameId frame_id of the frame being unpinned.
+ * @param FrameId frame_id of the frame to reinstate.
  */
-void Random::pin(FrameId frame_id){}
+void ClockPro::reinstate(FrameId frame_id){
+  PageId page_id = this->frame_table[frame_id].page_id;
+  std::unordered_map<PageId, std::list<ClockProEntry>::iterator,
+    BufHash>::iterator found = this->nonresident.find(page_id);
+
+  if(found != this->nonresident.end()){
+    found->second->resident = true;
+    this->frame_entry[frame_id] = found->second;
+    this->nonresident.erase(found);
+  }
+  else{
+    ClockProEntry entry = {page_id, frame_id, false, false, true};
+    if(this->clock_list.empty()){
+      this->frame_entry[frame_id] = this->_insertHead(entry);
+    }
+    else{
+      this->frame_entry[frame_id] =
+        this->clock_list.insert(this->hand_cold, entry);
+    }
+  }
+  // replace() moved hand_cold just past the victim
+  this->hand_cold = this->frame_entry[frame_id];
+  this->cold_count++;
+}
 
 
 /**
- * @brief Frame is being unpinned with pin count going from 1 to 0. Ramdom
- *    policy has nothing to do here, but an empty method must exist for
- *    BufferManager to call.
+ * @brief Frame is being pinned with pin count going from 0 to 1. If the
+ *    page was already resident this is a reference and its ref_bit is set.
+ *    If the frame was just loaded, an entry for its page is added to the
+ *    clock list: hot if the page was a non-resident page in its test period,
+ *    else cold in a new test period. If there are more non-resident pages
+ *    than frames, hand_test then removes one.
  *
- * @pre A page in the buffer pool has been unpinned from pin count 1 to 0.
+ * @pre A page in the buffer pool has been pinned, and the pin count of that
+ *    frame has increased from 0 to 1.
  *
- * @post Nothing.
+ * @post frame_id has a resident entry on the clock list.
  *
- * @param FrameId frame_id of the frame being unpinned.
+ * @param FrameId frame_id of the frame being pinned.
  */
-void Random::unpin(FrameId frame_id){}
+void ClockPro::pin(FrameId frame_id){
+  this->pinned_count++;
+  if(this->frame_entry[frame_id] != this->clock_list.end()){
+    // a hit, the access that faulted the page in does not count
+    this->ref_bits.set(frame_id);
+    return;
+  }
+
+  ClockProEntry entry = {this->frame_table[frame_id].page_id, frame_id,
+                         false, true, true};
+  std::unordered_map<PageId, std::list<ClockProEntry>::iterator,
+    BufHash>::iterator found = this->nonresident.find(entry.page_id);
+
+  if(found != this->nonresident.end()){
+    // missed on a page in its test period: cold pages need more room
+    this->test_hits++;
+    this->_removeEntry(found->second);
+    if(this->cold_target < BUF_SIZE - 1){
+      this->cold_target++;
+    }
+    entry.hot = true;
+    entry.test = false;
+    this->frame_entry[frame_id] = this->_insertHead(entry);
+    this->hot_count++;
+    if(this->hot_count > BUF_SIZE - this->cold_target){
+      this->_runHandHot();
+    }
+  }
+  else{
+    this->frame_entry[frame_id] = this->_insertHead(entry);
+    this->cold_count++;
+  }
+
+  // replace() leaves the victim's entry for reinstate() to find, the list
+  // is trimmed once the frame really holds another page
+  if(this->nonresident.size() > BUF_SIZE){
+    this->_runHandTest();
+  }
+}
+
+
+
+
+/**
+ * @brief Places a frame that was just unpinned according to how its page
+ *    will be accessed. SequentialHint clears its ref_bit, so a cold page is
+ *    replaced when the cold hand reaches it. KeepHotHint sets it, so a cold
+ *    page is promoted when the cold hand reaches it.
+ *
+ * @pre The pin count of frame_id has just dropped to 0.
+ * @post The ref_bit of frame_id reflects the hint.
+ */
+void ClockPro::hint(FrameId frame_id, AccessHint hint){
+  if(hint == SequentialHint){
+    this->ref_bits.clear(frame_id);
+  }
+  else if(hint == KeepHotHint){
+    this->ref_bits.set(frame_id);
+  }
+}
+
+
+/**
+ * @brief Appends the frames of the resident pages to ranked, the one
+ *    the hands would replace last first: hot pages, then cold pages with the
+ *    ref_bit set, then the other cold pages, each group in the order of the
+ *    clock list.
+ *
+ * @post The policy state is unchanged.
+ */
+void ClockPro::rankFrames(std::vector<FrameId> *ranked){
+  for(std::uint32_t pass = 0; pass < 3; pass++){
+    for(const ClockProEntry &entry : this->clock_list){
+      if(!entry.resident){
+        continue;
+      }
+      std::uint32_t group = entry.hot ? 0 :
+                            (this->ref_bits.test(entry.frame_id) ? 1 : 2);
+      if(group == pass){
+        ranked->push_back(entry.frame_id);
+      }
+    }
+  }
+}
+
+
+/**
+ * @brief The frame is invalidated in the buffer manager, and is
+ *    added to the free list of frames in the replacement policy. The entry
+ *    of the frame is removed from the clock list.
+ *
+ * @pre A page in the buffer pool has been deallocated.
+ *
+ * @post frame_id is on the free list and has no entry on the clock list.
+ *
+ * @param FrameId frame_id of the frame being set invalid.
+ */
+void ClockPro::freeFrame(FrameId frame_id){
+  this->free.push(frame_id);
+  this->ref_bits.clear(frame_id);
+
+  std::list<ClockProEntry>::iterator it = this->frame_entry[frame_id];
+  if(it != this->clock_list.end()){
+    if(it->hot){
+      this->hot_count--;
+    }
+    else{
+      this->cold_count--;
+    }
+    this->frame_entry[frame_id] = this->clock_list.end();
+    this->_removeEntry(it);
+  }
+}
+
+
+/**
+ * @brief Removes the non-resident entries of the pages of the file from the
+ *    clock list, so that a page of a file created later with the same FileId
+ *    does not start hot.
+ *
+ * @pre No page of file_id is in the buffer pool.
+ *
+ * @post No entry of the clock list is of a page of file_id.
+ */
+void ClockPro::removeFile(FileId file_id){
+  std::vector<std::list<ClockProEntry>::iterator> removed;
+  for(auto &entry : this->nonresident){
+    if(entry.first.file_id == file_id){
+      removed.push_back(entry.second);
+    }
+  }
+  for(std::list<ClockProEntry>::iterator it : removed){
+    this->_removeEntry(it);
+  }
+}
+
+
+/**
+ * @brief Updates the struct of replacement policy statistics within the
+ *    buffer state struct, including the ref_bit count.
+ *
+ * @param Pointer to the ReplacementStats struct member of BufferState struct.
+ */
+void ClockPro::getRepStats(struct BufferState::ReplacementStats *rep_stats){
+  ReplacementPolicy::getRepStats(rep_stats);
+  rep_stats->ref_bit = this->ref_bits.count();
+}
+
+
+/**
+ * @brief Prints replacement calls, average frames checked, hot and cold
+ *    page counts, the cold target and the number of non-resident pages.
+ */
+void ClockPro::printStats(){
+  double pct_replace = 0;
+
+  if(this->new_page_calls != 0) {  // don't divide by 0
+    pct_replace = 100* (double)this->rep_calls / this->new_page_calls;
+  } 
+  std::cout << "Replacement Policy: " << "CLOCK-PRO" << std::endl;
+  std::cout << "Number of calls to replacement policy: " 
+    << this->rep_calls << std::endl;
+  std::cout << "Percentage of new page calls that use replacement policy: " 
+    << pct_replace << "%" << std::endl;
+  std::cout << "Number of new page calls: " 
+    << this->new_page_calls << std::endl;
+  std::cout << "Average frames checked per call to replacement policy: " 
+    << this->avg_frames_checked << std::endl;
+  std::cout << "Hot pages: " << this->hot_count << ", cold pages: "
+    << this->cold_count << ", cold target: " << this->cold_target
+    << std::endl;
+  std::cout << "Non-resident test pages: " << this->nonresident.size()
+    << ", misses on test pages: " << this->test_hits << std::endl;
+}
+
+
+/**
+ * @brief Returns the entry after it on the circular clock list.
+ */
+std::list<ClockProEntry>::iterator
+ClockPro::_nextEntry(std::list<ClockProEntry>::iterator it){
+  ++it;
+  if(it == this->clock_list.end()){
+    it = this->clock_list.begin();
+  }
+  return it;
+}
+
+
+/**
+ * @brief Inserts an entry at the head of the clock list, just behind
+ *    hand_hot so that it is the last entry hand_hot reaches.
+ *
+ * @return Iterator to the inserted entry.
+ */
+std::list<ClockProEntry>::iterator ClockPro::_insertHead(ClockProEntry entry){
+  if(this->clock_list.empty()){
+    this->clock_list.push_back(entry);
+    this->hand_hot = this->clock_list.begin();
+    this->hand_cold = this->clock_list.begin();
+    this->hand_test = this->clock_list.begin();
+    return this->clock_list.begin();
+  }
+  return this->clock_list.insert(this->hand_hot, entry);
+}
+
+
+/**
+ * @brief Moves an entry to the head of the clock list.
+ */
+void ClockPro::_moveHead(std::list<ClockProEntry>::iterator it){
+  if(this->hand_hot == it){
+    this->hand_hot = this->_nextEntry(it);
+  }
+  if(this->hand_cold == it){
+    this->hand_cold = this->_nextEntry(it);
+  }
+  if(this->hand_test == it){
+    this->hand_test = this->_nextEntry(it);
+  }
+  this->clock_list.splice(this->hand_hot, this->clock_list, it);
+}
+
+
+/**
+ * @brief Removes an entry from the clock list, moving any hand that points
+ *    at it to the next entry.
+ */
+void ClockPro::_removeEntry(std::list<ClockProEntry>::iterator it){
+  std::list<ClockProEntry>::iterator next = this->_nextEntry(it);
+  if(next == it){
+    next = this->clock_list.end();  // it is the last entry
+  }
+  if(this->hand_hot == it){
+    this->hand_hot = next;
+  }
+  if(this->hand_cold == it){
+    this->hand_cold = next;
+  }
+  if(this->hand_test == it){
+    this->hand_test = next;
+  }
+  if(!it->resident){
+    this->nonresident.erase(it->page_id);
+  }
+  this->clock_list.erase(it);
+}
+
+
+/**
+ * @brief Ends the test period of a cold entry. A non-resident entry is
+ *    removed from the list and shrinks the cold target.
+ */
+void ClockPro::_endTest(std::list<ClockProEntry>::iterator it){
+  it->test = false;
+  if(!it->resident){
+    this->_removeEntry(it);
+    if(this->cold_target > 1){
+      this->cold_target--;
+    }
+  }
+}
+
+
+/**
+ * @brief Runs hand_hot until one unpinned, unreferenced hot page is demoted
+ *    to cold, clearing ref_bits and ending test periods on the way.
+ *
+ * @return true if a hot page was demoted.
+ */
+bool ClockPro::_runHandHot(){
+  // two sweeps clear every ref_bit, so a third would find nothing new
+  std::uint32_t limit = 2 * this->clock_list.size() + 1;
+
+  for(std::uint32_t i = 0; i < limit && !this->clock_list.empty(); i++){
+    std::list<ClockProEntry>::iterator it = this->hand_hot;
+    this->hand_hot = this->_nextEntry(it);
+
+    if(it->hot){
+      FrameId frame_id = it->frame_id;
+      if(this->frame_table[frame_id].pin_count > 0){
+        continue;
+      }
+      if(this->ref_bits.test(frame_id)){
+        this->ref_bits.clear(frame_id);
+        continue;
+      }
+      it->hot = false;
+      it->test = false;
+      this->hot_count--;
+      this->cold_count++;
+      return true;
+    }
+    if(it->test){
+      this->_endTest(it);
+    }
+  }
+  return false;
+}
+
+
+/**
+ * @brief Runs hand_test until one non-resident entry is removed, ending the
+ *    test periods of the resident cold pages on the way.
+ */
+void ClockPro::_runHandTest(){
+  std::uint32_t limit = this->clock_list.size() + 1;
+
+  for(std::uint32_t i = 0; i < limit && !this->clock_list.empty(); i++){
+    std::list<ClockProEntry>::iterator it = this->hand_test;
+    this->hand_test = this->_nextEntry(it);
+
+    if(!it->hot && it->test){
+      bool resident = it->resident;
+      this->_endTest(it);
+      if(!resident){
+        return;
+      }
+    }
+  }
+}
+
+
+/**
+ * @brief Derived class from pure virtual function that returns replacement
+ * policy type specific to this derived class.
+ *
+ * @return PolicyType ClockProT.
+ *
+ */
+PolicyType ClockPro::_getType(){
+  return ClockProT;
+}
+
+
+
+/**
+ * @brief Lirs constructor. Initializes pointer to buffer manager's
+ *    frame_table, creates the free list, sets rep_calls and
+ *    avg_frames_checked to 0, starts with an empty stack and queue, and
+ *    reserves about 1% of the buffer pool, at least one frame, for resident
+ *    HIR pages.
+ *
+ * @pre BufferManager constructor is being called, frame_table parameter
+ *    points to an initialized frame_table object.
+ *
+ * @post A Lirs object will be initialized with member variables
+ *    initialized.
+ *
+ * @param Frame *frame_table, pointer to frame_table array of BufferManager.
+ */
+Lirs::Lirs(Frame *frame_table){
+  this->frame_table = frame_table;
+  this->rep_calls = 0;
+  this->new_page_calls = 0;
+  this->avg_frames_checked = 0.0;
+  this->lir_count = 0;
+  this->pinned_count = 0;
+  this->nonresident_hits = 0;
+  this->victim_lir = false;
+
+  std::uint32_t hir_frames = BUF_SIZE / 100;
+  if(hir_frames == 0){
+    hir_frames = 1;
+  }
+  this->lir_target = BUF_SIZE - hir_frames;
+
+  for(FrameId i = 0; i < BUF_SIZE; i++){
+    this->stack_entry[i] = this->stack.end();
+    this->queue_entry[i] = this->queue.end();
+  }
+  this->_createFree();
+}
+
+
+/**
+* @brief Empty Destructor. 
+*/
+Lirs::~Lirs(){}
+
+
+/**
+ * @brief Method that implements the LIRS replacement policy.
+ *
+ * @pre The replacement policy has been invoked. The buffer manager is
+ *    attempting to add a frame to the buffer pool. The buffer map is
+ *    locked.
+ *
+ * @post If there is a free (invalid) frame, that FrameID is chosen for
+ *    replacement and is returned. Else the first unpinned resident HIR page
+ *    of the queue is replaced; if every resident HIR page is pinned, the
+ *    least recent unpinned LIR page is. A replaced page that is still on
+ *    the stack stays there as non-resident.
+ *
+ * @return FrameID of the frame that is eligible for replacement in the
+ *    buffer pool.
+ *
+ * @throw InsufficientSpaceBufMgr if all pages in the buffer pool are
+ *    pinned.
+ */
+FrameId Lirs::replace(){
+  if(!this->free.empty()){
+    FrameId frame_id = this->free.front();
+    this->free.pop();
+    return frame_id;
+  }
+  if(this->pinned_count >= this->lir_count + this->queue.size()){
+    throw InsufficientSpaceBufMgr();
+  }
+
+  std::uint32_t frames_checked = 0;
+  FrameId frame_id = BUF_SIZE;
+
+  for(std::list<FrameId>::iterator it = this->queue.begin();
+      it != this->queue.end(); it++){
+    frames_checked++;
+    if(this->frame_table[*it].pin_count == 0){
+      frame_id = *it;
+      break;
+    }
+  }
+
+  if(frame_id != BUF_SIZE){
+    this->victim_next = this->queue.erase(this->queue_entry[frame_id]);
+    this->victim_lir = false;
+    this->queue_entry[frame_id] = this->queue.end();
+
+    // still on the stack: remember it in case it is accessed again soon
+    std::list<LirsEntry>::iterator entry = this->stack_entry[frame_id];
+    if(entry != this->stack.end()){
+      entry->resident = false;
+      this->nonresident[entry->page_id] = entry;
+      this->stack_entry[frame_id] = this->stack.end();
+    }
+  }
+  else{
+    // every resident HIR page is pinned, replace the least recent LIR page
+    std::list<LirsEntry>::iterator it = this->stack.end();
+    while(it != this->stack.begin()){
+      it--;
+      if(!it->lir){
+        continue;
+      }
+      frames_checked++;
+      if(this->frame_table[it->frame_id].pin_count == 0){
+        frame_id = it->frame_id;
+        break;
+      }
+    }
+    if(frame_id == BUF_SIZE){
+      throw InsufficientSpaceBufMgr();
+    }
+    this->lir_count--;
+    this->victim_lir = true;
+    this->stack_entry[frame_id] = this->stack.end();
+    this->stack.erase(it);
+    this->_prune();
+  }
+
+  this->avg_frames_checked = (this->avg_frames_checked * this->rep_calls) +
+                             frames_checked;
+  this->rep_calls++;
+  this->avg_frames_checked /= this->rep_calls;
+  return frame_id;
+}
+
+
+/**
+ * @brief Undoes the replacement of the frame replace() just returned: a
+ *    resident HIR page goes back to its place in the queue, and its stack
+ *    entry is resident again. A LIR page replaced because every HIR page was
+ *    pinned goes back to the bottom of the stack, but the HIR entries pruned
+ *    below it stay forgotten.
+ *
+ * @pre frame_id was just returned by replace() and holds a valid, unpinned
+ *    page. No other policy method was called since.
+ *
+ * @post frame_id's page is resident with the status it had.
+ *
+ * @param FrameId frame_id of the frame to reinstate.
+ */
+void Lirs::reinstate(FrameId frame_id){
+  PageId page_id = this->frame_table[frame_id].page_id;
+
+  if(this->victim_lir){
+    LirsEntry entry = {page_id, frame_id, true, true};
+    this->stack.push_back(entry);
+    this->stack_entry[frame_id] = std::prev(this->stack.end());
+    this->lir_count++;
+    return;
+  }
+
+  this->queue_entry[frame_id] = this->queue.insert(this->victim_next,
+                                                   frame_id);
+  std::unordered_map<PageId, std::list<LirsEntry>::iterator,
+    BufHash>::iterator found = this->nonresident.find(page_id);
+  if(found != this->nonresident.end()){
+    found->second->resident = true;
+    this->stack_entry[frame_id] = found->second;
+    this->nonresident.erase(found);
+  }
+}
+
+
+/**
+ * @brief Frame is being pinned with pin count going from 0 to 1. This is an
+ *    access to the page in the frame: the page is moved to the top of the
+ *    stack, and becomes LIR if it is an HIR page found on the stack,
+ *    resident or not.
+ *
+ * @pre A page in the buffer pool has been pinned, and the pin count of that
+ *    frame has increased from 0 to 1.
+ *
+ * @post frame_id's page is at the top of the stack.
+ *
+ * @param FrameId frame_id of the frame being pinned.
+ */
+void Lirs::pin(FrameId frame_id){
+  this->pinned_count++;
+  std::list<LirsEntry>::iterator entry = this->stack_entry[frame_id];
+
+  if(entry != this->stack.end()){
+    bool bottom = std::next(entry) == this->stack.end();
+    this->stack.splice(this->stack.begin(), this->stack, entry);
+    if(entry->lir){
+      if(bottom){
+        this->_prune();
+      }
+      return;
+    }
+    // resident HIR page reused while on the stack
+    entry->lir = true;
+    this->lir_count++;
+    this->queue.erase(this->queue_entry[frame_id]);
+    this->queue_entry[frame_id] = this->queue.end();
+    this->_demoteBottom();
+    return;
+  }
+
+  if(this->queue_entry[frame_id] != this->queue.end()){
+    // resident HIR page that fell off the stack stays HIR
+    LirsEntry hir = {this->frame_table[frame_id].page_id, frame_id, false,
+                     true};
+    this->stack.push_front(hir);
+    this->stack_entry[frame_id] = this->stack.begin();
+    this->queue.splice(this->queue.end(), this->queue,
+                       this->queue_entry[frame_id]);
+    return;
+  }
+
+  // the page was just loaded into the frame
+  LirsEntry loaded = {this->frame_table[frame_id].page_id, frame_id, false,
+                      true};
+  std::unordered_map<PageId, std::list<LirsEntry>::iterator,
+    BufHash>::iterator found = this->nonresident.find(loaded.page_id);
+
+  if(found != this->nonresident.end()){
+    // missed on a page still on the stack: its reuse distance is small
+    this->nonresident_hits++;
+    this->stack.erase(found->second);
+    this->nonresident.erase(found);
+    loaded.lir = true;
+  }
+  else if(this->lir_count < this->lir_target){
+    loaded.lir = true;
+  }
+
+  this->stack.push_front(loaded);
+  this->stack_entry[frame_id] = this->stack.begin();
+  if(loaded.lir){
+    this->lir_count++;
+    if(this->lir_count > this->lir_target){
+      this->_demoteBottom();
+    }
+  }
+  else{
+    this->queue.push_back(frame_id);
+    this->queue_entry[frame_id] = std::prev(this->queue.end());
+  }
+
+  // replace() leaves the victim's entry for reinstate() to find, the stack
+  // is trimmed once the frame really holds another page
+  if(this->nonresident.size() > BUF_SIZE){
+    this->_dropNonresident();
+  }
+}
+
+
+
+
+/**
+ * @brief Places a frame that was just unpinned according to how its page
+ *    will be accessed. A resident HIR page moves to the front of the queue,
+ *    where it is replaced next, with SequentialHint, and to the back with
+ *    KeepHotHint. LIR pages are unaffected.
+ *
+ * @pre The pin count of frame_id has just dropped to 0.
+ * @post The queue position of frame_id reflects the hint.
+ */
+void Lirs::hint(FrameId frame_id, AccessHint hint){
+  std::list<FrameId>::iterator it = this->queue_entry[frame_id];
+  if(it == this->queue.end()){
+    return;
+  }
+  if(hint == SequentialHint){
+    this->queue.splice(this->queue.begin(), this->queue, it);
+  }
+  else if(hint == KeepHotHint){
+    this->queue.splice(this->queue.end(), this->queue, it);
+  }
+}
+
+
+/**
+ * @brief Appends the frames of the resident pages to ranked, the one
+ *    the policy would replace last first: LIR pages from the top of the
+ *    stack down, then HIR pages from the newest end of the queue.
+ *
+ * @post The policy state is unchanged.
+ */
+void Lirs::rankFrames(std::vector<FrameId> *ranked){
+  for(const LirsEntry &entry : this->stack){
+    if(entry.lir && entry.resident){
+      ranked->push_back(entry.frame_id);
+    }
+  }
+  for(auto it = this->queue.rbegin(); it != this->queue.rend(); ++it){
+    ranked->push_back(*it);
+  }
+}
+
+
+/**
+ * @brief The frame is invalidated in the buffer manager, and is added to
+ *    the free list of frames in the replacement policy. The page of the
+ *    frame is removed from the stack and the queue.
+ *
+ * @pre A page in the buffer pool has been deallocated.
+ *
+ * @post frame_id is on the free list and is on neither the stack nor the
+ *    queue.
+ *
+ * @param FrameId frame_id of the frame being set invalid.
+ */
+void Lirs::freeFrame(FrameId frame_id){
+  this->free.push(frame_id);
+
+  if(this->queue_entry[frame_id] != this->queue.end()){
+    this->queue.erase(this->queue_entry[frame_id]);
+    this->queue_entry[frame_id] = this->queue.end();
+  }
+  std::list<LirsEntry>::iterator entry = this->stack_entry[frame_id];
+  if(entry != this->stack.end()){
+    if(entry->lir){
+      this->lir_count--;
+    }
+    this->stack.erase(entry);
+    this->stack_entry[frame_id] = this->stack.end();
+    this->_prune();
+  }
+}
+
+
+/**
+ * @brief Removes the non-resident HIR entries of the pages of the file from
+ *    the stack, so that a page of a file created later with the same FileId
+ *    does not start LIR.
+ *
+ * @pre No page of file_id is in the buffer pool.
+ *
+ * @post No entry of the stack is of a page of file_id.
+ */
+void Lirs::removeFile(FileId file_id){
+  for(auto it = this->nonresident.begin(); it != this->nonresident.end(); ){
+    if(it->first.file_id == file_id){
+      this->stack.erase(it->second);
+      it = this->nonresident.erase(it);
+    }
+    else{
+      ++it;
+    }
+  }
+  this->_prune();
+}
+
+
+/**
+ * @brief Prints replacement calls, average frames checked, LIR and HIR page
+ *    counts and the number of non-resident HIR pages.
+ */
+void Lirs::printStats(){
+  double pct_replace = 0;
+
+  if(this->new_page_calls != 0) {  // don't divide by 0
+    pct_replace = 100* (double)this->rep_calls / this->new_page_calls;
+  } 
+  std::cout << "Replacement Policy: " << "LIRS" << std::endl;
+  std::cout << "Number of calls to replacement policy: " 
+    << this->rep_calls << std::endl;
+  std::cout << "Percentage of new page calls that use replacement policy: " 
+    << pct_replace << "%" << std::endl;
+  std::cout << "Number of new page calls: " 
+    << this->new_page_calls << std::endl;
+  std::cout << "Average frames checked per call to replacement policy: " 
+    << this->avg_frames_checked << std::endl;
+  std::cout << "LIR pages: " << this->lir_count << ", resident HIR pages: "
+    << this->queue.size() << ", stack size: " << this->stack.size()
+    << std::endl;
+  std::cout << "Non-resident HIR pages: " << this->nonresident.size()
+    << ", misses on non-resident HIR pages: " << this->nonresident_hits
+    << std::endl;
+}
+
+
+/**
+ * @brief Pops HIR entries off the bottom of the stack until the bottom entry
+ *    is LIR. Non-resident entries popped are forgotten.
+ */
+void Lirs::_prune(){
+  while(!this->stack.empty() && !this->stack.back().lir){
+    LirsEntry &bottom = this->stack.back();
+    if(bottom.resident){
+      this->stack_entry[bottom.frame_id] = this->stack.end();
+    }
+    else{
+      this->nonresident.erase(bottom.page_id);
+    }
+    this->stack.pop_back();
+  }
+}
+
+
+/**
+ * @brief Turns the LIR page at the bottom of the stack into a resident HIR
+ *    page at the end of the queue, then prunes the stack.
+ */
+void Lirs::_demoteBottom(){
+  FrameId frame_id = this->stack.back().frame_id;
+  this->lir_count--;
+  this->stack.pop_back();
+  this->stack_entry[frame_id] = this->stack.end();
+  this->queue.push_back(frame_id);
+  this->queue_entry[frame_id] = std::prev(this->queue.end());
+  this->_prune();
+}
+
+
+/**
+ * @brief Forgets the least recent non-resident entry of the stack.
+ */
+void Lirs::_dropNonresident(){
+  std::list<LirsEntry>::iterator it = this->stack.end();
+  while(it != this->stack.begin()){
+    it--;
+    if(!it->resident){
+      this->nonresident.erase(it->page_id);
+      this->stack.erase(it);
+      return;
+    }
+  }
+}
+
+
+/**
+ * @brief Derived class from pure virtual function that returns replacement
+ * policy type specific to this derived class.
+ *
+ * @return PolicyType LirsT.
+ *
+ */
+PolicyType Lirs::_getType(){
+  return LirsT;
+}
+
+
+
+/**
+ * @brief Sieve constructor. Initializes pointer to buffer manager's
+ *    frame_table, creates the free list, sets rep_calls and
+ *    avg_frames_checked to 0, and starts with an empty queue and all visited
+ *    bits cleared.
+ *
+ * @pre BufferManager constructor is being called, frame_table parameter
+ *    points to an initialized frame_table object.
+ *
+ * @post A Sieve object will be initialized with member variables
+ *    initialized.
+ *
+ * @param Frame *frame_table, pointer to frame_table array of BufferManager.
+ */
+Sieve::Sieve(Frame *frame_table){
+  this->frame_table = frame_table;
+  this->rep_calls = 0;
+  this->new_page_calls = 0;
+  this->avg_frames_checked = 0.0;
+  this->hand = this->queue.end();
+
+  for(FrameId i = 0; i < BUF_SIZE; i++){
+    this->queue_entry[i] = this->queue.end();
+    this->visited[i].store(0, std::memory_order_relaxed);
+  }
+  this->_createFree();
+}
+
+
+/**
+* @brief Empty Destructor. 
+*/
+Sieve::~Sieve(){}
+
+
+/**
+ * @brief Method that implements the SIEVE replacement policy.
+ *
+ * @pre The replacement policy has been invoked. The buffer manager is
+ *    attempting to add a frame to the buffer pool. The buffer map is
+ *    locked.
+ *
+ * @post If there is a free (invalid) frame, that FrameID is chosen for
+ *    replacement and is returned. Else the hand moves from the oldest page
+ *    towards the newest, wrapping around, clearing visited bits until it
+ *    finds an unpinned, unvisited page. That page is removed from the queue
+ *    and its frame returned.
+ *
+ * @return FrameID of the frame that is eligible for replacement in the
+ *    buffer pool.
+ *
+ * @throw InsufficientSpaceBufMgr if all pages in the buffer pool are
+ *    pinned.
+ */
+FrameId Sieve::replace(){
+  if(!this->free.empty()){
+    FrameId frame_id = this->free.front();
+    this->free.pop();
+    return frame_id;
+  }
+
+  // two passes clear every visited bit, a third finds nothing new
+  std::uint32_t limit = 2 * this->queue.size() + 1;
+  std::uint32_t frames_checked = 0;
+  std::list<FrameId>::iterator it = this->hand;
+
+  while(frames_checked < limit && !this->queue.empty()){
+    if(it == this->queue.end()){
+      it = std::prev(this->queue.end());  // back to the oldest page
+    }
+    frames_checked++;
+
+    FrameId frame_id = *it;
+    std::list<FrameId>::iterator newer =
+      (it == this->queue.begin()) ? this->queue.end() : std::prev(it);
+
+    if(this->frame_table[frame_id].pin_count > 0){
+      it = newer;
+      continue;
+    }
+    if(this->visited[frame_id].load(std::memory_order_relaxed)){
+      this->visited[frame_id].store(0, std::memory_order_relaxed);
+      it = newer;
+      continue;
+    }
+
+    this->queue.erase(it);
+    this->queue_entry[frame_id] = this->queue.end();
+    this->hand = newer;
+
+    this->avg_frames_checked = (this->avg_frames_checked * this->rep_calls) +
+                               frames_checked;
+    this->rep_calls++;
+    this->avg_frames_checked /= this->rep_calls;
+    return frame_id;
+  }
+
+  this->hand = it;
+  throw InsufficientSpaceBufMgr();
+}
+
+
+/**
+ * @brief Undoes the replacement of the frame replace() just returned: it
+ *    goes back to its place in the queue, unvisited, under the hand.
+ *
+ * @pre frame_id was just returned by replace() and holds a valid, unpinned
+ *    page. No other policy method was called since.
+ *
+ * @post frame_id is on the queue.
+ *
+ * @param FrameId frame_id of the frame to reinstate.
+ */
+void Sieve::reinstate(FrameId frame_id){
+  // replace() left the hand on the page just newer than the victim
+  std::list<FrameId>::iterator at = (this->hand == this->queue.end()) ?
+    this->queue.begin() : std::next(this->hand);
+  this->queue_entry[frame_id] = this->queue.insert(at, frame_id);
+  this->hand = this->queue_entry[frame_id];
+}
+
+
+/**
+ * @brief Frame is being pinned with pin count going from 0 to 1. If the
+ *    frame was just loaded, its page is added at the head of the queue,
+ *    unvisited. Pinning a resident page is a hit and sets its visited bit
+ *    with a relaxed store.
+ *
+ * @pre A page in the buffer pool has been pinned, and the pin count of that
+ *    frame has increased from 0 to 1.
+ *
+ * @post frame_id is on the queue.
+ *
+ * @param FrameId frame_id of the frame being pinned.
+ */
+void Sieve::pin(FrameId frame_id){
+  if(this->queue_entry[frame_id] != this->queue.end()){
+    this->visited[frame_id].store(1, std::memory_order_relaxed);
+    return;
+  }
+  this->visited[frame_id].store(0, std::memory_order_relaxed);
+  this->queue.push_front(frame_id);
+  this->queue_entry[frame_id] = this->queue.begin();
+}
+
+
+
+
+/**
+ * @brief Places a frame that was just unpinned according to how its page
+ *    will be accessed. SequentialHint clears its visited bit and moves it
+ *    under the hand, so it is the next page examined. KeepHotHint sets its
+ *    visited bit.
+ *
+ * @pre The pin count of frame_id has just dropped to 0.
+ * @post The visited bit and queue position of frame_id reflect the hint.
+ */
+void Sieve::hint(FrameId frame_id, AccessHint hint){
+  std::list<FrameId>::iterator it = this->queue_entry[frame_id];
+  if(it == this->queue.end()){
+    return;
+  }
+  if(hint == KeepHotHint){
+    this->visited[frame_id].store(1, std::memory_order_relaxed);
+    return;
+  }
+  if(hint != SequentialHint){
+    return;
+  }
+
+  this->visited[frame_id].store(0, std::memory_order_relaxed);
+  if(this->hand == this->queue.end()){
+    // the hand starts again from the oldest page
+    this->queue.splice(this->queue.end(), this->queue, it);
+  }
+  else if(this->hand != it){
+    // just older than the hand, which then steps back onto it
+    this->queue.splice(std::next(this->hand), this->queue, it);
+    this->hand = it;
+  }
+}
+
+
+/**
+ * @brief Appends the frames on the queue to ranked, the one the hand
+ *    would replace last first: visited frames from newest to oldest, then
+ *    the others in the reverse of the order the hand reaches them.
+ *
+ * @post The policy state is unchanged.
+ */
+void Sieve::rankFrames(std::vector<FrameId> *ranked){
+  for(FrameId frame_id : this->queue){
+    if(this->visited[frame_id].load(std::memory_order_relaxed)){
+      ranked->push_back(frame_id);
+    }
+  }
+  if(this->queue.empty()){
+    return;
+  }
+
+  // the hand moves from older to newer pages, and wraps to the oldest
+  std::vector<FrameId> unvisited;
+  std::list<FrameId>::iterator it = this->hand;
+  for(std::uint32_t i = 0; i < this->queue.size(); i++){
+    if(it == this->queue.end()){
+      it = std::prev(this->queue.end());
+    }
+    if(!this->visited[*it].load(std::memory_order_relaxed)){
+      unvisited.push_back(*it);
+    }
+    it = (it == this->queue.begin()) ? this->queue.end() : std::prev(it);
+  }
+  ranked->insert(ranked->end(), unvisited.rbegin(), unvisited.rend());
+}
+
+
+/**
+ * @brief The frame is invalidated in the buffer manager, and is added to
+ *    the free list of frames in the replacement policy. The frame is removed
+ *    from the queue.
+ *
+ * @pre A page in the buffer pool has been deallocated.
+ *
+ * @post frame_id is on the free list and not on the queue.
+ *
+ * @param FrameId frame_id of the frame being set invalid.
+ */
+void Sieve::freeFrame(FrameId frame_id){
+  this->free.push(frame_id);
+  this->visited[frame_id].store(0, std::memory_order_relaxed);
+
+  std::list<FrameId>::iterator it = this->queue_entry[frame_id];
+  if(it != this->queue.end()){
+    if(this->hand == it){
+      this->hand =
+        (it == this->queue.begin()) ? this->queue.end() : std::prev(it);
+    }
+    this->queue.erase(it);
+    this->queue_entry[frame_id] = this->queue.end();
+  }
+}
+
+
+/**
+ * @brief Updates the struct of replacement policy statistics within the
+ *    buffer state struct, counting visited bits as ref_bits.
+ *
+ * @param Pointer to the ReplacementStats struct member of BufferState struct.
+ */
+void Sieve::getRepStats(struct BufferState::ReplacementStats *rep_stats){
+  ReplacementPolicy::getRepStats(rep_stats);
+  for(FrameId i = 0; i < BUF_SIZE; i++){
+    rep_stats->ref_bit += this->visited[i].load(std::memory_order_relaxed);
+  }
+}
+
+
+/**
+ * @brief Prints replacement calls, average frames checked and the number of
+ *    visited frames.
+ */
+void Sieve::printStats(){
+  double pct_replace = 0;
+  std::uint32_t visited_count = 0;
+
+  if(this->new_page_calls != 0) {  // don't divide by 0
+    pct_replace = 100* (double)this->rep_calls / this->new_page_calls;
+  } 
+  for(FrameId i = 0; i < BUF_SIZE; i++){
+    visited_count += this->visited[i].load(std::memory_order_relaxed);
+  }
+  std::cout << "Replacement Policy: " << "SIEVE" << std::endl;
+  std::cout << "Number of calls to replacement policy: " 
+    << this->rep_calls << std::endl;
+  std::cout << "Percentage of new page calls that use replacement policy: " 
+    << pct_replace << "%" << std::endl;
+  std::cout << "Number of new page calls: " 
+    << this->new_page_calls << std::endl;
+  std::cout << "Average frames checked per call to replacement policy: " 
+    << this->avg_frames_checked << std::endl;
+  std::cout << "Number of visited frames: " << visited_count << std::endl;
+}
+
+
+/**
+ * @brief Derived class from pure virtual function that returns replacement
+ * policy type specific to this derived class.
+ *
+ * @return PolicyType SieveT.
+ *
+ */
+PolicyType Sieve::_getType(){
+  return SieveT;
+}
+
+
+
+/**
+ * @brief S3Fifo constructor. Initializes pointer to buffer manager's
+ *    frame_table, creates the free list, sets rep_calls and
+ *    avg_frames_checked to 0, starts with empty queues and all visited bits
+ *    cleared, and sizes small to 10% of the buffer pool, at least one frame.
+ *
+ * @pre BufferManager constructor is being called, frame_table parameter
+ *    points to an initialized frame_table object.
+ *
+ * @post A S3Fifo object will be initialized with member variables
+ *    initialized.
+ *
+ * @param Frame *frame_table, pointer to frame_table array of BufferManager.
+ */
+S3Fifo::S3Fifo(Frame *frame_table){
+  this->frame_table = frame_table;
+  this->rep_calls = 0;
+  this->new_page_calls = 0;
+  this->avg_frames_checked = 0.0;
+  this->ghost_hits = 0;
+
+  this->small_target = BUF_SIZE / 10;
+  if(this->small_target == 0){
+    this->small_target = 1;
+  }
+
+  for(FrameId i = 0; i < BUF_SIZE; i++){
+    this->queue_entry[i] = this->small.end();
+    this->in_main[i] = false;
+    this->queued[i] = false;
+    this->visited[i].store(0, std::memory_order_relaxed);
+  }
+  this->_createFree();
+}
+
+
+/**
+* @brief Empty Destructor. 
+*/
+S3Fifo::~S3Fifo(){}
+
+
+/**
+ * @brief Method that implements the S3-FIFO replacement policy.
+ *
+ * @pre The replacement policy has been invoked. The buffer manager is
+ *    attempting to add a frame to the buffer pool. The buffer map is
+ *    locked.
+ *
+ * @post If there is a free (invalid) frame, that FrameID is chosen for
+ *    replacement and is returned. Else pages are taken from the tail of
+ *    small while it holds at least its target, otherwise from the tail of
+ *    main, until an unpinned, unvisited page is found. Its frame is
+ *    returned. Pinned pages are requeued like visited ones.
+ *
+ * @return FrameID of the frame that is eligible for replacement in the
+ *    buffer pool.
+ *
+ * @throw InsufficientSpaceBufMgr if all pages in the buffer pool are
+ *    pinned.
+ */
+FrameId S3Fifo::replace(){
+  if(!this->free.empty()){
+    FrameId frame_id = this->free.front();
+    this->free.pop();
+    return frame_id;
+  }
+
+  // a page moves at most from small to main and has its visited bit cleared
+  // once before it can be replaced, so three passes see every unpinned page
+  std::uint32_t limit = 3 * (this->small.size() + this->main.size()) + 1;
+  std::uint32_t frames_checked = 0;
+  // pinned pages seen in a row at the tail of each queue
+  std::uint32_t small_pinned = 0;
+  std::uint32_t main_pinned = 0;
+
+  while(frames_checked < limit){
+    bool small_full = this->small.size() >= this->small_target ||
+                      this->main.empty() || main_pinned >= this->main.size();
+    bool use_small = !this->small.empty() && small_full &&
+                     small_pinned < this->small.size();
+    if(!use_small && (this->main.empty() ||
+                      main_pinned >= this->main.size())){
+      break;
+    }
+    frames_checked++;
+
+    if(use_small){
+      std::list<FrameId>::iterator it = std::prev(this->small.end());
+      FrameId frame_id = *it;
+      if(this->frame_table[frame_id].pin_count > 0){
+        small_pinned++;
+        this->small.splice(this->small.begin(), this->small, it);
+        continue;
+      }
+      small_pinned = 0;
+      if(this->visited[frame_id].load(std::memory_order_relaxed)){
+        // accessed again while in small: keep it in main
+        this->visited[frame_id].store(0, std::memory_order_relaxed);
+        this->main.splice(this->main.begin(), this->small, it);
+        this->in_main[frame_id] = true;
+        continue;
+      }
+
+      this->small.erase(it);
+      this->queued[frame_id] = false;
+      PageId page_id = this->frame_table[frame_id].page_id;
+      this->ghost.push_front(page_id);
+      this->ghost_entry[page_id] = this->ghost.begin();
+      this->avg_frames_checked = (this->avg_frames_checked * this->rep_calls)
+                                 + frames_checked;
+      this->rep_calls++;
+      this->avg_frames_checked /= this->rep_calls;
+      return frame_id;
+    }
+
+    std::list<FrameId>::iterator it = std::prev(this->main.end());
+    FrameId frame_id = *it;
+    if(this->frame_table[frame_id].pin_count > 0){
+      main_pinned++;
+      this->main.splice(this->main.begin(), this->main, it);
+      continue;
+    }
+    main_pinned = 0;
+    if(this->visited[frame_id].load(std::memory_order_relaxed)){
+      this->visited[frame_id].store(0, std::memory_order_relaxed);
+      this->main.splice(this->main.begin(), this->main, it);
+      continue;
+    }
+
+    this->main.erase(it);
+    this->queued[frame_id] = false;
+    this->in_main[frame_id] = false;
+    this->avg_frames_checked = (this->avg_frames_checked * this->rep_calls) +
+                               frames_checked;
+    this->rep_calls++;
+    this->avg_frames_checked /= this->rep_calls;
+    return frame_id;
+  }
+
+  throw InsufficientSpaceBufMgr();
+}
+
+
+/**
+ * @brief Undoes the replacement of the frame replace() just returned: it
+ *    goes back to the tail of the queue it was taken from, unvisited, and a
+ *    page replaced from small leaves ghost again.
+ *
+ * @pre frame_id was just returned by replace() and holds a valid, unpinned
+ *    page. No other policy method was called since.
+ *
+ * @post frame_id is on small or main, and its PageId is not in ghost.
+ *
+ * @param FrameId frame_id of the frame to reinstate.
+ */
+void S3Fifo::reinstate(FrameId frame_id){
+  std::unordered_map<PageId, std::list<PageId>::iterator,
+    BufHash>::iterator found =
+      this->ghost_entry.find(this->frame_table[frame_id].page_id);
+
+  // only pages replaced from small are put in ghost
+  if(found != this->ghost_entry.end()){
+    this->ghost.erase(found->second);
+    this->ghost_entry.erase(found);
+    this->small.push_back(frame_id);
+    this->queue_entry[frame_id] = std::prev(this->small.end());
+    this->in_main[frame_id] = false;
+  }
+  else{
+    this->main.push_back(frame_id);
+    this->queue_entry[frame_id] = std::prev(this->main.end());
+    this->in_main[frame_id] = true;
+  }
+  this->queued[frame_id] = true;
+}
+
+
+/**
+ * @brief Frame is being pinned with pin count going from 0 to 1. If the
+ *    frame was just loaded, its page is added at the head of main if its
+ *    PageId is in ghost, else at the head of small. Pinning a resident page
+ *    is a hit and sets its visited bit with a relaxed store.
+ *
+ * @pre A page in the buffer pool has been pinned, and the pin count of that
+ *    frame has increased from 0 to 1.
+ *
+ * @post frame_id is on small or main.
+ *
+ * @param FrameId frame_id of the frame being pinned.
+ */
+void S3Fifo::pin(FrameId frame_id){
+  if(this->queued[frame_id]){
+    this->visited[frame_id].store(1, std::memory_order_relaxed);
+    return;
+  }
+  this->queued[frame_id] = true;
+  this->visited[frame_id].store(0, std::memory_order_relaxed);
+
+  std::unordered_map<PageId, std::list<PageId>::iterator,
+    BufHash>::iterator found =
+      this->ghost_entry.find(this->frame_table[frame_id].page_id);
+  if(found != this->ghost_entry.end()){
+    // replaced from small too early last time
+    this->ghost_hits++;
+    this->ghost.erase(found->second);
+    this->ghost_entry.erase(found);
+    this->main.push_front(frame_id);
+    this->queue_entry[frame_id] = this->main.begin();
+    this->in_main[frame_id] = true;
+  }
+  else{
+    this->small.push_front(frame_id);
+    this->queue_entry[frame_id] = this->small.begin();
+    this->in_main[frame_id] = false;
+  }
+
+  // ghost remembers about as many pages as main holds; replace() leaves the
+  // victim's PageId for reinstate() to find, so it is trimmed only here
+  if(this->ghost.size() > BUF_SIZE - this->small_target){
+    this->ghost_entry.erase(this->ghost.back());
+    this->ghost.pop_back();
+  }
+}
+
+
+
+
+/**
+ * @brief Places a frame that was just unpinned according to how its page
+ *    will be accessed. SequentialHint clears its visited bit, so a page of
+ *    the small queue leaves without reaching the main queue. KeepHotHint sets
+ *    it.
+ *
+ * @pre The pin count of frame_id has just dropped to 0.
+ * @post The visited bit of frame_id reflects the hint.
+ */
+void S3Fifo::hint(FrameId frame_id, AccessHint hint){
+  if(hint == SequentialHint){
+    this->visited[frame_id].store(0, std::memory_order_relaxed);
+  }
+  else if(hint == KeepHotHint){
+    this->visited[frame_id].store(1, std::memory_order_relaxed);
+  }
+}
+
+
+/**
+ * @brief Appends the frames on the queues to ranked, the one the
+ *    policy would replace last first: main from newest to oldest, then small
+ *    from newest to oldest.
+ *
+ * @post The policy state is unchanged.
+ */
+void S3Fifo::rankFrames(std::vector<FrameId> *ranked){
+  ranked->insert(ranked->end(), this->main.begin(), this->main.end());
+  ranked->insert(ranked->end(), this->small.begin(), this->small.end());
+}
+
+
+/**
+ * @brief The frame is invalidated in the buffer manager, and is added to
+ *    the free list of frames in the replacement policy. The frame is removed
+ *    from small or main.
+ *
+ * @pre A page in the buffer pool has been deallocated.
+ *
+ * @post frame_id is on the free list and on neither small nor main.
+ *
+ * @param FrameId frame_id of the frame being set invalid.
+ */
+void S3Fifo::freeFrame(FrameId frame_id){
+  this->free.push(frame_id);
+  this->visited[frame_id].store(0, std::memory_order_relaxed);
+
+  if(this->queued[frame_id]){
+    if(this->in_main[frame_id]){
+      this->main.erase(this->queue_entry[frame_id]);
+    }
+    else{
+      this->small.erase(this->queue_entry[frame_id]);
+    }
+    this->queued[frame_id] = false;
+    this->in_main[frame_id] = false;
+  }
+}
+
+
+/**
+ * @brief Removes the PageIds of the pages of the file from ghost, so that a
+ *    page of a file created later with the same FileId does not skip small.
+ *
+ * @pre No page of file_id is in the buffer pool.
+ *
+ * @post No PageId in ghost is of a page of file_id.
+ */
+void S3Fifo::removeFile(FileId file_id){
+  for(auto it = this->ghost.begin(); it != this->ghost.end(); ){
+    if(it->file_id == file_id){
+      this->ghost_entry.erase(*it);
+      it = this->ghost.erase(it);
+    }
+    else{
+      ++it;
+    }
+  }
+}
+
+
+/**
+ * @brief Updates the struct of replacement policy statistics within the
+ *    buffer state struct, counting visited bits as ref_bits.
+ *
+ * @param Pointer to the ReplacementStats struct member of BufferState struct.
+ */
+void S3Fifo::getRepStats(struct BufferState::ReplacementStats *rep_stats){
+  ReplacementPolicy::getRepStats(rep_stats);
+  for(FrameId i = 0; i < BUF_SIZE; i++){
+    rep_stats->ref_bit += this->visited[i].load(std::memory_order_relaxed);
+  }
+}
+
+
+/**
+ * @brief Prints replacement calls, average frames checked, the sizes of the
+ *    three queues and the number of loads that hit ghost.
+ */
+void S3Fifo::printStats(){
+  double pct_replace = 0;
+
+  if(this->new_page_calls != 0) {  // don't divide by 0
+    pct_replace = 100* (double)this->rep_calls / this->new_page_calls;
+  } 
+  std::cout << "Replacement Policy: " << "S3-FIFO" << std::endl;
+  std::cout << "Number of calls to replacement policy: " 
+    << this->rep_calls << std::endl;
+  std::cout << "Percentage of new page calls that use replacement policy: " 
+    << pct_replace << "%" << std::endl;
+  std::cout << "Number of new page calls: " 
+    << this->new_page_calls << std::endl;
+  std::cout << "Average frames checked per call to replacement policy: " 
+    << this->avg_frames_checked << std::endl;
+  std::cout << "Small pages: " << this->small.size() << " (target "
+    << this->small_target << "), main pages: " << this->main.size()
+    << ", ghost pages: " << this->ghost.size() << std::endl;
+  std::cout << "Loads of ghost pages: " << this->ghost_hits << std::endl;
+}
+
+
+/**
+ * @brief Derived class from pure virtual function that returns replacement
+ * policy type specific to this derived class.
+ *
+ * @return PolicyType S3FifoT.
+ *
+ */
+PolicyType S3Fifo::_getType(){
+  return S3FifoT;
+}
+
+
+
+/**
+ * Partitions of PerFile.
+ */
+static const std::uint32_t PF_CLOCK = 0;
+static const std::uint32_t PF_MRU = 1;
+static const std::uint32_t PF_LRUK = 2;
+
+/**
+ * Printable names of the partitions of PerFile.
+ */
+static const char *pf_part_strs[PF_PARTS] = {"Clock", "MRU", "LRU-K"};
+
+
+/**
+ * @brief PerFile constructor. Initializes pointer to buffer manager's
+ *    frame_table, creates the free list, sets rep_calls and
+ *    avg_frames_checked to 0, and starts with empty partitions and only the
+ *    Clock partition in use.
+ *
+ * @pre BufferManager constructor is being called, frame_table parameter
+ *    points to an initialized frame_table object.
+ *
+ * @post A PerFile object will be initialized with member variables
+ *    initialized.
+ *
+ * @param Frame *frame_table, pointer to frame_table array of BufferManager.
+ */
+PerFile::PerFile(Frame *frame_table){
+  this->frame_table = frame_table;
+  this->rep_calls = 0;
+  this->new_page_calls = 0;
+  this->avg_frames_checked = 0.0;
+  this->now = 0;
+  this->steals = 0;
+
+  for(std::uint32_t p = 0; p < PF_PARTS; p++){
+    this->in_use[p] = (p == PF_CLOCK);
+    this->share[p] = (p == PF_CLOCK) ? BUF_SIZE : 0;
+    this->resident_count[p] = 0;
+  }
+  this->hand = this->ring.end();
+  for(FrameId i = 0; i < BUF_SIZE; i++){
+    this->part[i] = PF_CLOCK;
+    this->resident[i] = false;
+    this->ring_entry[i] = this->ring.end();
+    this->stack_entry[i] = this->stack.end();
+  }
+  this->_createFree();
+}
+
+
+/**
+* @brief Empty Destructor. 
+*/
+PerFile::~PerFile(){}
+
+
+/**
+ * @brief Method that chooses a frame to replace without knowing the page to
+ *    be loaded. The victim is chosen globally.
+ *
+ * @pre The replacement policy has been invoked. The buffer manager is
+ *    attempting to add a frame to the buffer pool. The buffer map is
+ *    locked.
+ *
+ * @post If there is a free (invalid) frame, that FrameID is chosen for
+ *    replacement and is returned. Else the partition furthest above its
+ *    share that has an unpinned page gives up the page its own policy
+ *    chooses.
+ *
+ * @return FrameID of the frame that is eligible for replacement in the
+ *    buffer pool.
+ *
+ * @throw InsufficientSpaceBufMgr if all pages in the buffer pool are
+ *    pinned.
+ */
+FrameId PerFile::replace(){
+  return this->_replace(PF_PARTS);
+}
+
+
+/**
+ * @brief Method that chooses a frame to replace for the page of the given
+ *    PageId.
+ *
+ * @pre Same as replace().
+ *
+ * @post If there is a free (invalid) frame, that FrameID is chosen for
+ *    replacement and is returned. Else, if the partition of the file of
+ *    page_id holds at least its share of the frames and has an unpinned
+ *    page, it gives up the page its own policy chooses. Else the victim is
+ *    chosen globally as in replace().
+ *
+ * @param page_id PageId of the page the frame is chosen for.
+ * @return FrameID of the frame that is eligible for replacement in the
+ *    buffer pool.
+ *
+ * @throw InsufficientSpaceBufMgr if all pages in the buffer pool are
+ *    pinned.
+ */
+FrameId PerFile::replaceFor(PageId page_id){
+  return this->_replace(this->_partOf(page_id.file_id));
+}
+
+
+/**
+ * @brief Chooses a victim, trying partition own first if it holds its
+ *    share, then every partition in decreasing order of frames above share.
+ *    own is PF_PARTS if the page to load is unknown.
+ *
+ * @throw InsufficientSpaceBufMgr if all pages in the buffer pool are
+ *    pinned.
+ */
+FrameId PerFile::_replace(std::uint32_t own){
+  if(!this->free.empty()){
+    FrameId frame_id = this->free.front();
+    this->free.pop();
+    return frame_id;
+  }
+
+  std::uint32_t frames_checked = 0;
+  FrameId victim = BUF_SIZE;
+  std::uint32_t from = PF_PARTS;
+  bool tried[PF_PARTS] = {false, false, false};
+
+  if(own < PF_PARTS && this->resident_count[own] >= this->share[own]){
+    victim = this->_victim(own, &frames_checked);
+    from = own;
+    tried[own] = true;
+  }
+
+  // global selection: the partition furthest above its share goes first,
+  // the next one only if every page of the first is pinned
+  while(victim == BUF_SIZE){
+    std::uint32_t best = PF_PARTS;
+    for(std::uint32_t p = 0; p < PF_PARTS; p++){
+      if(tried[p] || this->resident_count[p] == 0){
+        continue;
+      }
+      if(best == PF_PARTS ||
+          (std::int64_t)this->resident_count[p] - this->share[p] >
+          (std::int64_t)this->resident_count[best] - this->share[best]){
+        best = p;
+      }
+    }
+    if(best == PF_PARTS){
+      throw InsufficientSpaceBufMgr();
+    }
+    tried[best] = true;
+    victim = this->_victim(best, &frames_checked);
+    from = best;
+  }
+
+  if(own < PF_PARTS && from != own){
+    this->steals++;
+  }
+  this->_remove(victim);
+
+  this->avg_frames_checked = (this->avg_frames_checked * this->rep_calls) +
+                             frames_checked;
+  this->rep_calls++;
+  this->avg_frames_checked /= this->rep_calls;
+  return victim;
+}
+
+
+/**
+ * @brief Undoes the replacement of the frame replace() or replaceFor() just
+ *    returned: it is resident in its partition again, on the ring under the
+ *    hand, on top of the MRU stack or among the LRU-K candidates.
+ *
+ * @pre frame_id was just returned by replace() or replaceFor() and holds a
+ *    valid, unpinned page. No other policy method was called since.
+ *
+ * @post frame_id is resident in its partition.
+ *
+ * @param FrameId frame_id of the frame to reinstate.
+ */
+void PerFile::reinstate(FrameId frame_id){
+  std::uint32_t p = this->part[frame_id];
+  this->resident[frame_id] = true;
+  this->resident_count[p]++;
+
+  if(p == PF_CLOCK){
+    // _remove() moved the hand past the victim
+    this->ring_entry[frame_id] = this->ring.insert(this->hand, frame_id);
+    this->hand = this->ring_entry[frame_id];
+  }
+  else if(p == PF_MRU){
+    this->stack.push_front(frame_id);
+    this->stack_entry[frame_id] = this->stack.begin();
+  }
+  else{
+    this->candidates.insert(this->_key(frame_id));
+  }
+}
+
+
+/**
+ * @brief Appends the frames of unpinned pages to ranked, the one the policy
+ *    would replace last first. Each partition orders its own frames, the
+ *    Clock ring from the hand on with frames without a ref_bit first, the
+ *    MRU stack from the top and the LRU-K candidates in set order, and the
+ *    orders are merged by taking each next victim from the partition
+ *    furthest above its share, as replace() does. The merged victims are
+ *    appended in reverse.
+ *
+ * @post The policy state is unchanged.
+ */
+void PerFile::rankFrames(std::vector<FrameId> *ranked){
+  std::vector<FrameId> order[PF_PARTS];
+
+  // the hand takes the frames without a ref_bit on its first pass
+  for(std::uint32_t pass = 0; pass < 2; pass++){
+    std::list<FrameId>::iterator it = this->hand;
+    for(std::size_t i = 0; i < this->ring.size(); i++){
+      if(it == this->ring.end()){
+        it = this->ring.begin();
+      }
+      if(this->frame_table[*it].pin_count == 0 &&
+          this->ref_bits.test(*it) == (pass == 1)){
+        order[PF_CLOCK].push_back(*it);
+      }
+      ++it;
+    }
+  }
+  order[PF_MRU].assign(this->stack.begin(), this->stack.end());
+  for(std::set<std::tuple<std::uint64_t, std::uint64_t, FrameId>>::iterator
+      it = this->candidates.begin(); it != this->candidates.end(); it++){
+    order[PF_LRUK].push_back(std::get<2>(*it));
+  }
+
+  std::vector<FrameId> victims;
+  std::size_t next[PF_PARTS] = {0, 0, 0};
+  std::int64_t above[PF_PARTS];
+  for(std::uint32_t p = 0; p < PF_PARTS; p++){
+    above[p] = (std::int64_t)this->resident_count[p] - this->share[p];
+  }
+  while(true){
+    std::uint32_t best = PF_PARTS;
+    for(std::uint32_t p = 0; p < PF_PARTS; p++){
+      if(next[p] < order[p].size() &&
+          (best == PF_PARTS || above[p] > above[best])){
+        best = p;
+      }
+    }
+    if(best == PF_PARTS){
+      break;
+    }
+    victims.push_back(order[best][next[best]++]);
+    above[best]--;
+  }
+  ranked->insert(ranked->end(), victims.rbegin(), victims.rend());
+}
+
+
+/**
+ * @brief Chooses the frame of an unpinned page of partition p with the
+ *    partition's own policy, and adds the frames examined to
+ *    frames_checked. The Clock partition sweeps its hand over the ring,
+ *    clearing ref_bits, the MRU partition takes the most recently unpinned
+ *    page and the LRU-K partition the page with the largest backward
+ *    K-distance.
+ *
+ * @return FrameId of the victim, or BUF_SIZE if every page of the partition
+ *    is pinned.
+ */
+FrameId PerFile::_victim(std::uint32_t p, std::uint32_t *frames_checked){
+  if(p == PF_MRU){
+    if(this->stack.empty()){
+      return BUF_SIZE;
+    }
+    (*frames_checked)++;
+    return this->stack.front();
+  }
+
+  if(p == PF_LRUK){
+    if(this->candidates.empty()){
+      return BUF_SIZE;
+    }
+    (*frames_checked)++;
+    return std::get<2>(*this->candidates.begin());
+  }
+
+  // one pass clears every ref_bit, a second finds nothing new
+  std::uint32_t limit = 2 * this->ring.size() + 1;
+  std::uint32_t steps = 0;
+  std::list<FrameId>::iterator it = this->hand;
+
+  while(steps < limit && !this->ring.empty()){
+    if(it == this->ring.end()){
+      it = this->ring.begin();
+    }
+    steps++;
+
+    FrameId frame_id = *it;
+    if(this->frame_table[frame_id].pin_count > 0){
+      ++it;
+      continue;
+    }
+    if(this->ref_bits.test(frame_id)){
+      this->ref_bits.clear(frame_id);
+      ++it;
+      continue;
+    }
+    this->hand = it;
+    *frames_checked += steps;
+    return frame_id;
+  }
+
+  this->hand = it;
+  *frames_checked += steps;
+  return BUF_SIZE;
+}
+
+
+/**
+ * @brief Removes a resident frame from its partition.
+ */
+void PerFile::_remove(FrameId frame_id){
+  std::uint32_t p = this->part[frame_id];
+
+  if(p == PF_CLOCK){
+    std::list<FrameId>::iterator it = this->ring_entry[frame_id];
+    if(this->hand == it){
+      ++this->hand;
+    }
+    this->ring.erase(it);
+    this->ring_entry[frame_id] = this->ring.end();
+    this->ref_bits.clear(frame_id);
+  }
+  else if(p == PF_MRU){
+    if(this->stack_entry[frame_id] != this->stack.end()){
+      this->stack.erase(this->stack_entry[frame_id]);
+      this->stack_entry[frame_id] = this->stack.end();
+    }
+  }
+  else{
+    this->candidates.erase(this->_key(frame_id));
+  }
+
+  this->resident[frame_id] = false;
+  this->resident_count[p]--;
+}
+
+
+/**
+ * @brief Frame is being pinned with pin count going from 0 to 1. If the
+ *    frame was just loaded, it joins the partition of the file of its page.
+ *    Pinning a resident page is a hit: an MRU page is taken off the stack
+ *    of unpinned pages and an LRU-K page records the reference.
+ *
+ * @pre A page in the buffer pool has been pinned, and the pin count of that
+ *    frame has increased from 0 to 1.
+ *
+ * @post frame_id is resident in a partition.
+ *
+ * @param FrameId frame_id of the frame being pinned.
+ */
+void PerFile::pin(FrameId frame_id){
+  if(!this->resident[frame_id]){
+    std::uint32_t p =
+      this->_partOf(this->frame_table[frame_id].page_id.file_id);
+    this->part[frame_id] = p;
+    this->resident[frame_id] = true;
+    this->resident_count[p]++;
+
+    if(p == PF_CLOCK){
+      // behind the hand, so the new page is the last one it reaches
+      this->ring_entry[frame_id] = this->ring.insert(this->hand, frame_id);
+      this->ref_bits.clear(frame_id);
+    }
+    else if(p == PF_LRUK){
+      for(std::uint32_t k = 0; k < LRU_K; k++){
+        this->history[frame_id][k] = 0;
+      }
+      this->history[frame_id][0] = ++this->now;
+    }
+    return;
+  }
+
+  if(this->part[frame_id] == PF_MRU){
+    this->stack.erase(this->stack_entry[frame_id]);
+    this->stack_entry[frame_id] = this->stack.end();
+  }
+  else if(this->part[frame_id] == PF_LRUK){
+    this->candidates.erase(this->_key(frame_id));
+    for(std::uint32_t k = LRU_K - 1; k > 0; k--){
+      this->history[frame_id][k] = this->history[frame_id][k - 1];
+    }
+    this->history[frame_id][0] = ++this->now;
+  }
+}
+
+
+/**
+ * @brief Frame is being unpinned with pin count going from 1 to 0. A Clock
+ *    page gets its ref_bit set, an MRU page is pushed on the stack of
+ *    unpinned pages, and an LRU-K page becomes a candidate for replacement.
+ *
+ * @pre A page in the buffer pool has been unpinned from pin count 1 to 0.
+ *
+ * @post frame_id can be chosen for replacement.
+ *
+ * @param FrameId frame_id of the frame being unpinned.
+ */
+void PerFile::unpin(FrameId frame_id){
+  if(this->part[frame_id] == PF_CLOCK){
+    this->ref_bits.set(frame_id);
+  }
+  else if(this->part[frame_id] == PF_MRU){
+    this->stack.push_front(frame_id);
+    this->stack_entry[frame_id] = this->stack.begin();
+  }
+  else{
+    this->candidates.insert(this->_key(frame_id));
+  }
+}
+
+
+/**
+ * @brief Places a frame that was just unpinned according to how its page
+ *    will be accessed, within its partition. With SequentialHint a Clock
+ *    page has its ref_bit cleared and an LRU-K page forgets its older
+ *    references. With KeepHotHint a Clock page has its ref_bit set and an
+ *    MRU page moves to the bottom of the stack.
+ *
+ * @pre The pin count of frame_id has just dropped to 0.
+ * @post The partition state of frame_id reflects the hint.
+ */
+void PerFile::hint(FrameId frame_id, AccessHint hint){
+  std::uint32_t p = this->part[frame_id];
+
+  if(p == PF_CLOCK){
+    if(hint == SequentialHint){
+      this->ref_bits.clear(frame_id);
+    }
+    else if(hint == KeepHotHint){
+      this->ref_bits.set(frame_id);
+    }
+  }
+  else if(p == PF_MRU){
+    if(hint == KeepHotHint){
+      this->stack.splice(this->stack.end(), this->stack,
+                         this->stack_entry[frame_id]);
+    }
+  }
+  else if(hint == SequentialHint && LRU_K > 1){
+    // an infinite backward K-distance puts it first in line
+    this->candidates.erase(this->_key(frame_id));
+    for(std::uint32_t k = 1; k < LRU_K; k++){
+      this->history[frame_id][k] = 0;
+    }
+    this->candidates.insert(this->_key(frame_id));
+  }
+}
+
+
+/**
+ * @brief The frame is invalidated in the buffer manager, and is added to
+ *    the free list of frames in the replacement policy. The frame leaves its
+ *    partition.
+ *
+ * @pre A page in the buffer pool has been deallocated.
+ *
+ * @post frame_id is on the free list and in no partition.
+ *
+ * @param FrameId frame_id of the frame being set invalid.
+ */
+void PerFile::freeFrame(FrameId frame_id){
+  if(this->resident[frame_id]){
+    this->_remove(frame_id);
+  }
+  this->free.push(frame_id);
+}
+
+
+/**
+ * @brief Chooses the partition of the pages of the given file and
+ *    recomputes the shares of the partitions in use.
+ *
+ * @pre None.
+ * @post Pages of file_id loaded from now on join the partition of rep_type.
+ *
+ * @param file_id FileId of the file.
+ * @param rep_type ClockT, MruT or LruKT.
+ *
+ * @throw InvalidPolicyBufMgr if rep_type is not ClockT, MruT or LruKT.
+ */
+void PerFile::setFilePolicy(FileId file_id, PolicyType rep_type){
+  std::uint32_t p;
+  switch(rep_type){
+    case ClockT:
+      p = PF_CLOCK;
+      break;
+    case MruT:
+      p = PF_MRU;
+      break;
+    case LruKT:
+      p = PF_LRUK;
+      break;
+    default:
+      throw InvalidPolicyBufMgr();
+  }
+  this->file_part[file_id] = p;
+
+  std::uint32_t parts_in_use = 1;
+  this->in_use[PF_MRU] = false;
+  this->in_use[PF_LRUK] = false;
+  for(std::unordered_map<FileId, std::uint8_t>::iterator it =
+      this->file_part.begin(); it != this->file_part.end(); it++){
+    if(!this->in_use[it->second]){
+      this->in_use[it->second] = true;
+      parts_in_use++;
+    }
+  }
+  for(std::uint32_t q = 0; q < PF_PARTS; q++){
+    this->share[q] = this->in_use[q] ? BUF_SIZE / parts_in_use : 0;
+  }
+}
+
+
+/**
+ * @brief Returns the partition of the pages of the given file.
+ */
+std::uint32_t PerFile::_partOf(FileId file_id){
+  std::unordered_map<FileId, std::uint8_t>::iterator it =
+    this->file_part.find(file_id);
+  if(it == this->file_part.end()){
+    return PF_CLOCK;
+  }
+  return it->second;
+}
+
+
+/**
+ * @brief Returns the LRU-K ordering key of a frame.
+ */
+std::tuple<std::uint64_t, std::uint64_t, FrameId> PerFile::_key(
+    FrameId frame_id){
+  return std::make_tuple(this->history[frame_id][LRU_K - 1],
+                         this->history[frame_id][0], frame_id);
+}
+
+
+/**
+ * @brief Updates the struct of replacement policy statistics within the
+ *    buffer state struct. Adds the ref_bit count of the Clock partition and
+ *    the position of its clock hand.
+ *
+ * @param Pointer to the ReplacementStats struct member of BufferState struct.
+ */
+void PerFile::getRepStats(struct BufferState::ReplacementStats *rep_stats){
+  ReplacementPolicy::getRepStats(rep_stats);
+  rep_stats->ref_bit = this->ref_bits.count();
+  rep_stats->clock_hand = (this->hand == this->ring.end()) ? 0 : *this->hand;
+}
+
+
+/**
+ * @brief Prints replacement calls, average frames checked, the frames and
+ *    share of every partition, and the number of victims taken from another
+ *    partition than the one of the page loaded.
+ */
+void PerFile::printStats(){
+  double pct_replace = 0;
+
+  if(this->new_page_calls != 0) {  // don't divide by 0
+    pct_replace = 100* (double)this->rep_calls / this->new_page_calls;
+  } 
+  std::cout << "Replacement Policy: " << "PerFile" << std::endl;
+  std::cout << "Number of calls to replacement policy: " 
+    << this->rep_calls << std::endl;
+  std::cout << "Percentage of new page calls that use replacement policy: " 
+    << pct_replace << "%" << std::endl;
+  std::cout << "Number of new page calls: " 
+    << this->new_page_calls << std::endl;
+  std::cout << "Average frames checked per call to replacement policy: " 
+    << this->avg_frames_checked << std::endl;
+  for(std::uint32_t p = 0; p < PF_PARTS; p++){
+    if(this->in_use[p] || this->resident_count[p] > 0){
+      std::cout << pf_part_strs[p] << " partition: "
+        << this->resident_count[p] << " frames, share "
+        << this->share[p] << std::endl;
+    }
+  }
+  std::cout << "Number of victims taken from another partition: "
+    << this->steals << std::endl;
+}
+
+
+/**
+ * @brief Derived class from pure virtual function that returns replacement
+ * policy type specific to this derived class.
+ *
+ * @return PolicyType PerFileT.
+ *
+ */
+PolicyType PerFile::_getType(){
+  return PerFileT;
+}
+
+
+
+/**
+ * @brief Random constructor. Initializes pointer to buffer manager's
+ *    frame_table, creates the free list, sets rep_calls and
+ *    avg_frames_checked to 0.
+ *
+ * @pre BufferManager constructor is being called, frame_table parameter
+ *    points to an initialized frame_table object.
+ *
+ * @post A Random policy object will be initialized with member variables
+ *    initialized.
+ *
+ * @param Frame *frame_table, pointer to frame_table array of BufferManager.
+ */
+Random::Random(Frame *frame_table) {
+  this->frame_table = frame_table;
+  this->rep_calls = 0;
+  this->new_page_calls = 0;
+  this->avg_frames_checked = 0;
+  for(std::uint32_t i = 0; i < BUF_SIZE; i++){
+    this->times_chosen[i] = 0;
+  }
+  this->pin_bits.clearAll();
+  this->_createFree();
+}
+
+
+/**
+* @brief Empty Destructor. 
+*/
+Random::~Random(){}
+
+
+/**
+ * @brief Method that implements the Random replacement policy functionality
+ *
+ * @pre The replacement policy has been invoked. The buffer manager is
+ *    attempting to add a frame to the buffer pool. The buffer map is
+ *    locked.
+ *
+ * @post If there is a free (invalid) frame, that FrameID is chosen for
+ *    replacement and is returned. Else, a random frame is selected and
+ *    evaluated for eligibility. If it is pinned, the pinned bitmap is
+ *    scanned from that frame for the next unpinned frame, 64 frames at a
+ *    time, wrapping around the end of the buffer pool. If all pages are
+ *    pinned, an exception is thrown.
+ *
+ * @return FrameID of the frame that is eligible for replacement in the
+ *    buffer pool.
+ *
+ * @throw InsufficientSpaceBufMgr if all pages in the buffer pool are
+ *    pinned.
+ */
+FrameId Random::replace() {
+  // first check if there are free frames and return one if true
+  if(!this->free.empty()) {
+    FrameId frame_id = this->free.front();
+    this->free.pop();
+    return frame_id;
+  }
+  std::uint32_t rand_num = std::rand() % BUF_SIZE;
+  FrameId frame_id = this->pin_bits.findNextClear(rand_num);
+  if(frame_id == BUF_SIZE) {
+    throw InsufficientSpaceBufMgr();
+  }
+  // number of frames between the random frame and the one found
+  std::uint32_t c = (frame_id + BUF_SIZE - rand_num) % BUF_SIZE;
+
+  // update replacement stats
+  if((this->rep_calls + 1) == 0) {  // start over if wrap-around
+    this->rep_calls = 0;
+  }
+  this->avg_frames_checked = 
+    (this->avg_frames_checked * this->rep_calls) + c + 1;
+  this->rep_calls ++;
+  this->avg_frames_checked /= this->rep_calls;
+  this->times_chosen[frame_id] ++;
+  return frame_id;
+}
+
+
+
+
+
+
+/**
+ * @brief The frame is invalidated in the buffer manager, and is
+ *    added to the free list of frames in the replacement policy. Pinned
+ *    bit associated with this frame is set to false.
+ *
+ * @pre A page in the buffer pool has been deallocated.
+ *
+ * @post The replacement policy state is updated to reflect the freeing
+ *    of a specific frame.
+ *
+ * @param FrameId frame_id of the frame being set invalid.
+ */
+void Random::freeFrame(FrameId frame_id){
+  this->free.push(frame_id);
+  this->pin_bits.clear(frame_id);
+}
 
 
 /**
@@ -426,10 +2925,10 @@ void Random::printStats(){
  * @brief Derived class from pure virtual function that returns replacement
  * policy type specific to this derived class.
  *
- * @return RepType RandomT.
+ * @return PolicyType RandomT.
  *
  */
-RepType Random::_getType(){
+PolicyType Random::_getType(){
   return RandomT;
 }
 
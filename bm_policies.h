@@ -7,11 +7,18 @@
 
 
 #include <utility>
+#include <atomic>
 #include <list>
 #include <queue>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 
 #include "swatdb_types.h"
 #include "bm_replacement.h"     // base class def
+#include "bm_bitmap.h"          // FrameBitmap
+#include "bm_buffermap.h"       // BufHash
 
 
 /**
@@ -21,7 +28,8 @@
  * least recently used with less overhead. Chooses a page for replacement using
  * a clock hand, which loops the buffer frames in a circular order. Each frame
  * has an associated reference bit, which is turned on when the pin count goes
- * to zero.
+ * to zero. Reference and pinned bits are kept in bitmaps so the clock hand can
+ * sweep past 64 frames at a time.
  */
 class Clock: public ReplacementPolicy {
 
@@ -32,7 +40,8 @@ class Clock: public ReplacementPolicy {
     /**
      * @brief Clock constructor. Initializes pointer to buffer manager's
      *        frame_table, creates the free list, sets clock_hand, rep_calls,
-     *        and avg_frames_checked to 0, and sets all ref_bits to false.
+     *        and avg_frames_checked to 0, and sets all ref_bits and pinned
+     *        bits to false.
      *
      * @pre BufferManager constructor is being called, frame_table parameter
      *      points to an initialized frame_table object.
@@ -63,7 +72,8 @@ class Clock: public ReplacementPolicy {
      *       is not referenced, it is selected for eviction and FrameId is
      *       returned.  In the process of performing the replacement algorithm,
      *       ref_bit of some valid pages that are not pinned may be set to
-     *       false.
+     *       false. Frames are examined a word of the bitmaps at a time, and
+     *       all ref_bits the clock hand sweeps past are cleared together.
      *
      * @return FrameID of the frame that is eligible for replacement in the
      *         buffer pool.
@@ -75,31 +85,69 @@ class Clock: public ReplacementPolicy {
 
 
     /**
-     * @brief Frame is being pinned with pin count going from 0 to 1. Clock
-     *        policy has nothing to do here, but an empty method must exist for
-     *        BufferManager to call.
+     * @brief Frame is being pinned with pin count going from 0 to 1. Sets the
+     *        pinned bit associated with this frame_id.
      *
      * @pre A page in the buffer pool has been pinned, and the pin count of
      *      that frame has increased from 0 to 1.
      *
-     * @post Nothing.
+     * @post Pinned bit of frame_id is set to true.
      *
-     * @param FrameId frame_id of the frame being unpinned.
+     * @param FrameId frame_id of the frame being pinned.
      */
-    void pin(FrameId frame_id);
+    void pin(FrameId frame_id){
+      this->pin_bits.set(frame_id);
+    }
 
     /**
      * @brief Frame is being unpinned with pin count going from 1 to 0. Set the
-     *        ref_bit associated with this frame_id to true.
+     *        ref_bit associated with this frame_id to true and clears its
+     *        pinned bit.
      *
      * @pre A page in the buffer pool has been unpinned from pin count 1 to 0.
      *
-     * @post Ref_bit of frame_id is set to true.
+     * @post Ref_bit of frame_id is set to true, pinned bit is set to false.
      *
      * @param FrameId frame_id of the frame being unpinned.
      */
-    void unpin(FrameId frame_id);
+    void unpin(FrameId frame_id){
+      this->ref_bits.set(frame_id);
+      this->pin_bits.clear(frame_id);
+    }
+
+
+    /**
+     * @brief Places a frame that was just unpinned according to how its page
+     *        will be accessed. SequentialHint clears its ref_bit so the hand
+     *        replaces it on its next pass. KeepHotHint leaves the ref_bit set
+     *        by unpin: Clock keeps a single bit of history.
+     *
+     * @pre The pin count of frame_id has just dropped to 0.
+     * @post The ref_bit of frame_id reflects the hint.
+     */
+    void hint(FrameId frame_id, AccessHint hint);
 
+    /**
+     * @brief Undoes the replacement of the frame replace() just returned:
+     *        the clock_hand is back on it, so the sweep resumes there. Its
+     *        ref_bit is still clear.
+     *
+     * @pre frame_id was just returned by replace() and holds a valid,
+     *      unpinned page. No other policy method was called since.
+     * @post clock_hand is frame_id.
+     */
+    void reinstate(FrameId frame_id);
+
+    /**
+     * @brief Appends the valid frames to ranked, the one the hand would
+     *        replace last first: frames with the ref_bit set before the
+     *        others, each group from just behind the hand backwards, since
+     *        the hand reaches the frames just ahead of it first.
+     *
+     * @pre None.
+     * @post The policy state is unchanged.
+     */
+    void rankFrames(std::vector<FrameId> *ranked);
 
     /**
      * @brief Updates the struct of replacement policy statistics within the
@@ -116,7 +164,8 @@ class Clock: public ReplacementPolicy {
     /**
      * @brief The frame is invalidated in the buffer manager, and is
      *        added to the free list of frames in the replacement policy.
-     *        Ref_bit associated with this frame is set to false.
+     *        Ref_bit and pinned bit associated with this frame are set to
+     *        false.
      *
      * @pre A page in the buffer pool has been deallocated.
      *
@@ -142,7 +191,7 @@ class Clock: public ReplacementPolicy {
     void printStats();
 
 
-  private:
+  protected:
 
 
     /**
@@ -153,10 +202,16 @@ class Clock: public ReplacementPolicy {
 
 
     /**
-     * Parallel array to the frame_table which stores the ref_bits of each
+     * Bitmap parallel to the frame_table which stores the ref_bits of each
      * frame.
      */
-    bool ref_table[BUF_SIZE];
+    FrameBitmap ref_bits;
+
+    /**
+     * Bitmap parallel to the frame_table with a bit set for every frame whose
+     * pin count is above 0.
+     */
+    FrameBitmap pin_bits;
 
 
     /**
@@ -169,68 +224,260 @@ class Clock: public ReplacementPolicy {
     void _advanceClock();
 
 
+  private:
+
+
     /**
      * @brief Derived class from pure virtual function that returns replacement
      *        policy type specific to this derived class.
      *
-     * @return RepType ClockT.
+     * @return PolicyType ClockT.
      *
      */
-    RepType _getType();
+    PolicyType _getType();
 
 
 };
 
 
 /**
- * SwatDB Random Class.
- * Random is a derived class of ReplacementPolicy that manages the buffer
- * replacement policy of the DBMS. The random algorithm randomly generates
- * frame ids to check if they are eligible for replacement. Performs well on
- * large buffer pools and has minimal overhead.
+ * SwatDB GClock Class.
+ * GClock is a derived class of Clock that implements generalized clock
+ * replacement. Instead of a single ref_bit, every frame has a small usage
+ * counter that is incremented each time the frame is unpinned, saturating at
+ * max_weight, and decremented each time the clock hand sweeps past it. A frame
+ * is replaced when the hand finds it unpinned with a usage count of 0, so a
+ * frequently used page survives several sweeps of cold pages. GClock reuses
+ * the clock_hand, pinned bits and _advanceClock of Clock, and keeps ref_bits
+ * set for frames whose usage count is above 0.
  */
-class Random: public ReplacementPolicy {
+class GClock: public Clock {
 
 
   public:
 
 
     /**
-     * @brief Random constructor. Initializes pointer to buffer manager's
+     * @brief GClock constructor. Initializes the Clock state and sets every
+     *        usage count to 0.
+     *
+     * @pre BufferManager constructor is being called, frame_table parameter
+     *      points to an initialized frame_table object. max_weight is at
+     *      least 1 and at most 255.
+     *
+     * @post A GClock object will be initialized with member variables
+     *       initialized.
+     *
+     * @param Frame *frame_table, pointer to frame_table array of
+     *        BufferManager.
+     * @param max_weight cap of the usage count of each frame, GCLOCK_MAX_WEIGHT
+     *        by default.
+     */
+    GClock(Frame *frame_table, std::uint32_t max_weight = GCLOCK_MAX_WEIGHT);
+
+    /**
+     * Empty Destructor.
+     */
+    ~GClock();
+
+    /**
+     * @brief Method that implements the generalized clock replacement policy.
+     *
+     * @pre The replacement policy has been invoked. The buffer manager is
+     *      attempting to add a frame to the buffer pool. The buffer map is
+     *      locked.
+     *
+     * @post If there is a free (invalid) frame, that FrameID is chosen for
+     *       replacement and is returned. Else, the clock hand skips pinned
+     *       frames and decrements the usage count of every unpinned frame it
+     *       sweeps past, until it finds a valid unpinned frame whose usage
+     *       count is already 0, which is returned.
+     *
+     * @return FrameID of the frame that is eligible for replacement in the
+     *         buffer pool.
+     *
+     * @throw InsufficientSpaceBufMgr if all pages in the buffer pool are
+     *        pinned.
+     */
+    FrameId replace();
+
+    /**
+     * @brief Frame is being unpinned with pin count going from 1 to 0.
+     *        Increments the usage count of the frame, up to max_weight.
+     *
+     * @pre A page in the buffer pool has been unpinned from pin count 1 to 0.
+     *
+     * @post Usage count of frame_id is incremented unless it is max_weight.
+     *       ref_bit of frame_id is set, pinned bit is cleared.
+     *
+     * @param FrameId frame_id of the frame being unpinned.
+     */
+    void unpin(FrameId frame_id);
+
+    /**
+     * @brief Places a frame that was just unpinned according to how its page
+     *        will be accessed. SequentialHint drops its usage count to 0,
+     *        KeepHotHint raises it to max_weight.
+     *
+     * @pre The pin count of frame_id has just dropped to 0.
+     * @post The usage count of frame_id reflects the hint.
+     */
+    void hint(FrameId frame_id, AccessHint hint);
+
+    /**
+     * @brief Appends the valid frames to ranked, the one the hand would
+     *        replace last first: by usage count, highest first, and in the
+     *        order of Clock::rankFrames among frames of the same count.
+     *
+     * @pre None.
+     * @post The policy state is unchanged.
+     */
+    void rankFrames(std::vector<FrameId> *ranked);
+
+    /**
+     * @brief The frame is invalidated in the buffer manager, and is
+     *        added to the free list of frames in the replacement policy.
+     *        The usage count of the frame is reset to 0.
+     *
+     * @pre A page in the buffer pool has been deallocated.
+     *
+     * @post frame_id is on the free list with a usage count of 0.
+     *
+     * @param FrameId frame_id of the frame being set invalid.
+     */
+    void freeFrame(FrameId frame_id);
+
+    /**
+     * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+     *        Prints Frame state, including ref_bit and usage count.
+     */
+    void printFrame(FrameId frame_id);
+
+    /**
+     * @brief Prints clock_hand, average frames checked, replacement calls,
+     *        max weight and the average usage count of the frames.
+     */
+    void printStats();
+
+
+  private:
+
+
+    /**
+     * Parallel array to the frame_table which stores the usage count of each
+     * frame.
+     */
+    std::uint8_t usage[BUF_SIZE];
+
+    /**
+     * Cap of the usage count of each frame.
+     */
+    std::uint8_t max_weight;
+
+    /**
+     * @brief Derived class from pure virtual function that returns replacement
+     *        policy type specific to this derived class.
+     *
+     * @return PolicyType GClockT.
+     */
+    PolicyType _getType();
+
+
+};
+
+
+/**
+ * Entry of the CLOCK-Pro circular list. Resident entries describe the page in
+ * a frame of the buffer pool, non-resident entries remember a cold page that
+ * was evicted during its test period.
+ */
+struct ClockProEntry {
+
+  /**
+   * PageId of the page the entry describes.
+   */
+  PageId page_id;
+
+  /**
+   * Frame holding the page. Only meaningful if resident is true.
+   */
+  FrameId frame_id;
+
+  /**
+   * true if the page is hot, false if it is cold.
+   */
+  bool hot;
+
+  /**
+   * true if the cold page is in its test period.
+   */
+  bool test;
+
+  /**
+   * true if the page is in the buffer pool.
+   */
+  bool resident;
+};
+
+
+/**
+ * SwatDB ClockPro Class.
+ * ClockPro is a derived class of ReplacementPolicy that implements the
+ * CLOCK-Pro replacement policy, an approximation of LIRS with the overhead of
+ * Clock. Pages are hot (small reuse distance) or cold. All pages, plus the
+ * non-resident cold pages that were evicted during their test period, sit on
+ * one circular list swept by three hands:
+ *   - hand_cold finds a cold page to replace. A referenced cold page in its
+ *     test period is promoted to hot, other referenced cold pages start a new
+ *     test period.
+ *   - hand_hot demotes an unreferenced hot page to cold when there are more
+ *     hot pages than the hot target, and ends the test periods it passes.
+ *   - hand_test ends test periods and drops non-resident entries when there
+ *     are more than BUF_SIZE of them.
+ * A miss on a page that is still in its test period means cold pages were
+ * given too little space, so the cold target grows. A test period expiring
+ * without a reuse shrinks it.
+ */
+class ClockPro: public ReplacementPolicy {
+
+
+  public:
+
+
+    /**
+     * @brief ClockPro constructor. Initializes pointer to buffer manager's
      *        frame_table, creates the free list, sets rep_calls and
-     *        avg_frames_checked to 0.
+     *        avg_frames_checked to 0, and starts with an empty clock list and
+     *        a cold target of 1.
      *
      * @pre BufferManager constructor is being called, frame_table parameter
      *      points to an initialized frame_table object.
      *
-     * @post A Random policy object will be initialized with member variables
-     *      initialized.
+     * @post A ClockPro object will be initialized with member variables
+     *       initialized.
      *
      * @param Frame *frame_table, pointer to frame_table array of
      *        BufferManager.
      */
-    Random(Frame *frame_table);
+    ClockPro(Frame *frame_table);
 
     /**
      * Empty Destructor.
      */
-    ~Random();
-
+    ~ClockPro();
 
     /**
-     * @brief Method that implements the Random replacement policy
-     *        functionality
+     * @brief Method that implements the CLOCK-Pro replacement policy.
      *
      * @pre The replacement policy has been invoked. The buffer manager is
      *      attempting to add a frame to the buffer pool. The buffer map is
      *      locked.
      *
      * @post If there is a free (invalid) frame, that FrameID is chosen for
-     *       replacement and is returned. Else, a random frame is selected and
-     *       evaluated for eligibility. If it is pinned, another random frame
-     *       is selected. If no unpinned frame is found by BUF_SIZE attempts,
-     *       sequential scan is done to find an eligible frame. If all pages
-     *       are pinned, an exception is thrown.
+     *       replacement and is returned. Else hand_cold sweeps the clock list
+     *       until it finds an unpinned, unreferenced cold page, whose frame is
+     *       returned. If the page was in its test period, its entry stays on
+     *       the list as a non-resident page.
      *
      * @return FrameID of the frame that is eligible for replacement in the
      *         buffer pool.
@@ -240,59 +487,1525 @@ class Random: public ReplacementPolicy {
      */
     FrameId replace();
 
-
     /**
-     * @brief Frame is being pinned with pin count going from 0 to 1. Random
-     *        policy has nothing to do here, but an empty method must exist for
-     *        BufferManager to call.
+     * @brief Frame is being pinned with pin count going from 0 to 1. If the
+     *        page was already resident this is a reference and its ref_bit is
+     *        set. If the frame was just loaded, an entry for its page is added
+     *        to the clock list: hot if the page was a non-resident page in its
+     *        test period, else cold in a new test period. If there are more
+     *        non-resident pages than frames, hand_test then removes one.
      *
      * @pre A page in the buffer pool has been pinned, and the pin count of
      *      that frame has increased from 0 to 1.
      *
-     * @post Nothing.
+     * @post frame_id has a resident entry on the clock list.
      *
-     * @param FrameId frame_id of the frame being unpinned.
+     * @param FrameId frame_id of the frame being pinned.
      */
     void pin(FrameId frame_id);
 
     /**
-     * @brief Frame is being unpinned with pin count going from 1 to 0. Random
-     *        policy has nothing to do here, but an empty method must exist for
-     *        BufferManager to call.
+     * @brief Frame is being unpinned with pin count going from 1 to 0. Only
+     *        the count of pinned frames changes, references are recorded by
+     *        pin.
      *
      * @pre A page in the buffer pool has been unpinned from pin count 1 to 0.
      *
-     * @post Nothing.
+     * @post The number of pinned frames is decremented.
      *
      * @param FrameId frame_id of the frame being unpinned.
      */
-    void unpin(FrameId frame_id);
+    void unpin(FrameId frame_id){
+      this->pinned_count--;
+    }
+
+    /**
+     * @brief Places a frame that was just unpinned according to how its page
+     *        will be accessed. SequentialHint clears its ref_bit, so a cold
+     *        page is replaced when the cold hand reaches it. KeepHotHint sets
+     *        it, so a cold page is promoted when the cold hand reaches it.
+     *
+     * @pre The pin count of frame_id has just dropped to 0.
+     * @post The ref_bit of frame_id reflects the hint.
+     */
+    void hint(FrameId frame_id, AccessHint hint);
 
+    /**
+     * @brief Undoes the replacement of the frame replace() just returned:
+     *        the entry of its page is resident and cold again, where it was
+     *        on the clock list, and hand_cold is back on it. A page that was
+     *        out of its test period gets a new cold entry there.
+     *
+     * @pre frame_id was just returned by replace() and holds a valid,
+     *      unpinned page. No other policy method was called since.
+     * @post frame_id has a resident cold entry on the clock list.
+     */
+    void reinstate(FrameId frame_id);
 
     /**
-     * @brief Prints average frames checked, replacement calls, summary stats
-     *        on randomness.
+     * @brief Appends the frames of the resident pages to ranked, the one
+     *        the hands would replace last first: hot pages, then cold pages
+     *        with the ref_bit set, then the other cold pages, each group in
+     *        the order of the clock list.
+     *
+     * @pre None.
+     * @post The policy state is unchanged.
+     */
+    void rankFrames(std::vector<FrameId> *ranked);
+
+    /**
+     * @brief The frame is invalidated in the buffer manager, and is
+     *        added to the free list of frames in the replacement policy.
+     *        The entry of the frame is removed from the clock list.
+     *
+     * @pre A page in the buffer pool has been deallocated.
+     *
+     * @post frame_id is on the free list and has no entry on the clock list.
+     *
+     * @param FrameId frame_id of the frame being set invalid.
+     */
+    void freeFrame(FrameId frame_id);
+
+    /**
+     * @brief Removes the non-resident entries of the pages of the file from
+     *        the clock list, so that a page of a file created later with
+     *        the same FileId does not start hot.
+     *
+     * @pre No page of file_id is in the buffer pool.
+     *
+     * @post No entry of the clock list is of a page of file_id.
+     */
+    void removeFile(FileId file_id);
+
+    /**
+     * @brief Updates the struct of replacement policy statistics within the
+     *        buffer state struct, including the ref_bit count.
+     *
+     * @param Pointer to the ReplacementStats struct member of BufferState
+     *        struct.
+     */
+    void getRepStats(struct BufferState::ReplacementStats *rep_stats);
+
+    /**
+     * @brief Prints replacement calls, average frames checked, hot and cold
+     *        page counts, the cold target and the number of non-resident
+     *        pages.
      */
     void printStats();
 
+    /**
+     * @brief Returns the number of resident hot pages.
+     */
+    std::uint32_t getHotCount(){
+      return this->hot_count;
+    }
+
+    /**
+     * @brief Returns the number of resident cold pages.
+     */
+    std::uint32_t getColdCount(){
+      return this->cold_count;
+    }
+
+    /**
+     * @brief Returns the number of frames the policy adapts to hold cold
+     *        pages.
+     */
+    std::uint32_t getColdTarget(){
+      return this->cold_target;
+    }
+
+    /**
+     * @brief Returns the number of non-resident pages in their test period.
+     */
+    std::uint32_t getNonresidentCount(){
+      return this->nonresident.size();
+    }
+
 
   private:
 
 
     /**
-     * @brief Derived class from pure virtual function that returns replacement
-     *        policy type specific to this derived class.
+     * Circular list of resident and non-resident entries swept by the hands.
+     */
+    std::list<ClockProEntry> clock_list;
+
+    /**
+     * Hand that demotes hot pages.
+     */
+    std::list<ClockProEntry>::iterator hand_hot;
+
+    /**
+     * Hand that finds cold pages to replace.
+     */
+    std::list<ClockProEntry>::iterator hand_cold;
+
+    /**
+     * Hand that ends test periods and drops non-resident entries.
+     */
+    std::list<ClockProEntry>::iterator hand_test;
+
+    /**
+     * Parallel array to the frame_table which stores the entry of the page in
+     * each frame, or clock_list.end() if the frame has no entry.
+     */
+    std::list<ClockProEntry>::iterator frame_entry[BUF_SIZE];
+
+    /**
+     * Maps the PageId of every non-resident entry to its place in the list.
+     */
+    std::unordered_map<PageId, std::list<ClockProEntry>::iterator, BufHash>
+      nonresident;
+
+    /**
+     * Bitmap parallel to the frame_table which stores the ref_bits of each
+     * frame.
+     */
+    FrameBitmap ref_bits;
+
+    /**
+     * Number of resident hot pages.
+     */
+    std::uint32_t hot_count;
+
+    /**
+     * Number of resident cold pages.
+     */
+    std::uint32_t cold_count;
+
+    /**
+     * Number of frames the policy adapts to hold cold pages. The rest of the
+     * buffer pool is the hot target.
+     */
+    std::uint32_t cold_target;
+
+    /**
+     * Number of frames with pin count above 0.
+     */
+    std::uint32_t pinned_count;
+
+    /**
+     * Number of misses on non-resident pages still in their test period.
+     */
+    std::uint64_t test_hits;
+
+    /**
+     * @brief Returns the entry after it on the circular clock list.
+     */
+    std::list<ClockProEntry>::iterator
+      _nextEntry(std::list<ClockProEntry>::iterator it);
+
+    /**
+     * @brief Inserts an entry at the head of the clock list, just behind
+     *        hand_hot so that it is the last entry hand_hot reaches.
      *
-     * @return RepType RandomT.
+     * @return Iterator to the inserted entry.
      */
-    RepType _getType();
+    std::list<ClockProEntry>::iterator _insertHead(ClockProEntry entry);
 
+    /**
+     * @brief Moves an entry to the head of the clock list.
+     */
+    void _moveHead(std::list<ClockProEntry>::iterator it);
 
     /**
-     * Parallel array to frame_table that stores number of times each frame_id
-     *    is chosen for replacement. Is useful for determining randomness.
+     * @brief Removes an entry from the clock list, moving any hand that
+     *        points at it to the next entry.
      */
-    int times_chosen[BUF_SIZE];
+    void _removeEntry(std::list<ClockProEntry>::iterator it);
+
+    /**
+     * @brief Ends the test period of a cold entry. A non-resident entry is
+     *        removed from the list and shrinks the cold target.
+     */
+    void _endTest(std::list<ClockProEntry>::iterator it);
+
+    /**
+     * @brief Runs hand_hot until one unpinned, unreferenced hot page is
+     *        demoted to cold, clearing ref_bits and ending test periods on
+     *        the way.
+     *
+     * @return true if a hot page was demoted.
+     */
+    bool _runHandHot();
+
+    /**
+     * @brief Runs hand_test until one non-resident entry is removed, ending
+     *        the test periods of the resident cold pages on the way.
+     */
+    void _runHandTest();
+
+    /**
+     * @brief Derived class from pure virtual function that returns replacement
+     *        policy type specific to this derived class.
+     *
+     * @return PolicyType ClockProT.
+     */
+    PolicyType _getType();
+
+
+};
+
+
+/**
+ * Entry of the LIRS stack. Resident entries describe the page in a frame of
+ * the buffer pool, non-resident entries remember an HIR page that was evicted
+ * while it was still on the stack.
+ */
+struct LirsEntry {
+
+  /**
+   * PageId of the page the entry describes.
+   */
+  PageId page_id;
+
+  /**
+   * Frame holding the page. Only meaningful if resident is true.
+   */
+  FrameId frame_id;
+
+  /**
+   * true if the page has low inter-reference recency (LIR), false if HIR.
+   */
+  bool lir;
+
+  /**
+   * true if the page is in the buffer pool.
+   */
+  bool resident;
+};
+
+
+/**
+ * SwatDB Lirs Class.
+ * Lirs is a derived class of ReplacementPolicy that implements the LIRS
+ * (Low Inter-reference Recency Set) replacement policy. Pages are ranked by
+ * their inter-reference recency, the number of distinct pages accessed
+ * between their last two accesses, rather than by recency alone. Most of the
+ * buffer pool holds LIR pages, which are never chosen for replacement; a
+ * small part holds resident HIR pages, which are replaced in FIFO order.
+ *   - The stack S holds every LIR page and the HIR pages, resident or not,
+ *     accessed more recently than the least recent LIR page. Its bottom is
+ *     always an LIR page.
+ *   - The queue Q holds the resident HIR pages in replacement order.
+ * An HIR page accessed again while it is still on S has a smaller
+ * inter-reference recency than the bottom LIR page, so the two swap status.
+ * This keeps loops slightly larger than the buffer pool mostly resident,
+ * where LRU and Clock replace every page just before it is reused.
+ */
+class Lirs: public ReplacementPolicy {
+
+
+  public:
+
+
+    /**
+     * @brief Lirs constructor. Initializes pointer to buffer manager's
+     *        frame_table, creates the free list, sets rep_calls and
+     *        avg_frames_checked to 0, starts with an empty stack and queue,
+     *        and reserves about 1% of the buffer pool, at least one frame,
+     *        for resident HIR pages.
+     *
+     * @pre BufferManager constructor is being called, frame_table parameter
+     *      points to an initialized frame_table object.
+     *
+     * @post A Lirs object will be initialized with member variables
+     *       initialized.
+     *
+     * @param Frame *frame_table, pointer to frame_table array of
+     *        BufferManager.
+     */
+    Lirs(Frame *frame_table);
+
+    /**
+     * Empty Destructor.
+     */
+    ~Lirs();
+
+    /**
+     * @brief Method that implements the LIRS replacement policy.
+     *
+     * @pre The replacement policy has been invoked. The buffer manager is
+     *      attempting to add a frame to the buffer pool. The buffer map is
+     *      locked.
+     *
+     * @post If there is a free (invalid) frame, that FrameID is chosen for
+     *       replacement and is returned. Else the first unpinned resident HIR
+     *       page of the queue is replaced; if every resident HIR page is
+     *       pinned, the least recent unpinned LIR page is. A replaced page
+     *       that is still on the stack stays there as non-resident.
+     *
+     * @return FrameID of the frame that is eligible for replacement in the
+     *         buffer pool.
+     *
+     * @throw InsufficientSpaceBufMgr if all pages in the buffer pool are
+     *        pinned.
+     */
+    FrameId replace();
+
+    /**
+     * @brief Frame is being pinned with pin count going from 0 to 1. This is
+     *        an access to the page in the frame: the page is moved to the top
+     *        of the stack, and becomes LIR if it is an HIR page found on the
+     *        stack, resident or not. A load forgets the least recent
+     *        non-resident page if there are more of them than frames.
+     *
+     * @pre A page in the buffer pool has been pinned, and the pin count of
+     *      that frame has increased from 0 to 1.
+     *
+     * @post frame_id's page is at the top of the stack.
+     *
+     * @param FrameId frame_id of the frame being pinned.
+     */
+    void pin(FrameId frame_id);
+
+    /**
+     * @brief Frame is being unpinned with pin count going from 1 to 0. Only
+     *        the count of pinned frames changes, accesses are recorded by
+     *        pin.
+     *
+     * @pre A page in the buffer pool has been unpinned from pin count 1 to 0.
+     *
+     * @post The number of pinned frames is decremented.
+     *
+     * @param FrameId frame_id of the frame being unpinned.
+     */
+    void unpin(FrameId frame_id){
+      this->pinned_count--;
+    }
+
+    /**
+     * @brief Places a frame that was just unpinned according to how its page
+     *        will be accessed. A resident HIR page moves to the front of the
+     *        queue, where it is replaced next, with SequentialHint, and to
+     *        the back with KeepHotHint. LIR pages are unaffected.
+     *
+     * @pre The pin count of frame_id has just dropped to 0.
+     * @post The queue position of frame_id reflects the hint.
+     */
+    void hint(FrameId frame_id, AccessHint hint);
+
+    /**
+     * @brief Undoes the replacement of the frame replace() just returned: a
+     *        resident HIR page goes back to its place in the queue, and its
+     *        stack entry is resident again. A LIR page replaced because
+     *        every HIR page was pinned goes back to the bottom of the stack,
+     *        but the HIR entries pruned below it stay forgotten.
+     *
+     * @pre frame_id was just returned by replace() and holds a valid,
+     *      unpinned page. No other policy method was called since.
+     * @post frame_id's page is resident with the status it had.
+     */
+    void reinstate(FrameId frame_id);
+
+    /**
+     * @brief Appends the frames of the resident pages to ranked, the one
+     *        the policy would replace last first: LIR pages from the top of
+     *        the stack down, then HIR pages from the newest end of the queue.
+     *
+     * @pre None.
+     * @post The policy state is unchanged.
+     */
+    void rankFrames(std::vector<FrameId> *ranked);
+
+    /**
+     * @brief The frame is invalidated in the buffer manager, and is
+     *        added to the free list of frames in the replacement policy.
+     *        The page of the frame is removed from the stack and the queue.
+     *
+     * @pre A page in the buffer pool has been deallocated.
+     *
+     * @post frame_id is on the free list and is on neither the stack nor the
+     *       queue.
+     *
+     * @param FrameId frame_id of the frame being set invalid.
+     */
+    void freeFrame(FrameId frame_id);
+
+    /**
+     * @brief Removes the non-resident HIR entries of the pages of the file
+     *        from the stack, so that a page of a file created later with
+     *        the same FileId does not start LIR.
+     *
+     * @pre No page of file_id is in the buffer pool.
+     *
+     * @post No entry of the stack is of a page of file_id.
+     */
+    void removeFile(FileId file_id);
+
+    /**
+     * @brief Prints replacement calls, average frames checked, LIR and HIR
+     *        page counts and the number of non-resident HIR pages.
+     */
+    void printStats();
+
+    /**
+     * @brief Returns the number of LIR pages.
+     */
+    std::uint32_t getLirCount(){
+      return this->lir_count;
+    }
+
+    /**
+     * @brief Returns the number of resident HIR pages.
+     */
+    std::uint32_t getHirCount(){
+      return this->queue.size();
+    }
+
+    /**
+     * @brief Returns the number of non-resident HIR pages on the stack.
+     */
+    std::uint32_t getNonresidentCount(){
+      return this->nonresident.size();
+    }
+
+    /**
+     * @brief Returns the number of entries on the stack.
+     */
+    std::uint32_t getStackSize(){
+      return this->stack.size();
+    }
+
+    /**
+     * @brief Returns the entry at the bottom of the stack.
+     *
+     * @pre The stack is not empty.
+     */
+    LirsEntry getStackBottom(){
+      return this->stack.back();
+    }
+
+
+  private:
+
+
+    /**
+     * Stack S, the most recently accessed page at the front.
+     */
+    std::list<LirsEntry> stack;
+
+    /**
+     * Queue Q of frames holding resident HIR pages, the next to be replaced
+     * at the front.
+     */
+    std::list<FrameId> queue;
+
+    /**
+     * Parallel array to the frame_table which stores the stack entry of the
+     * page in each frame, or stack.end() if the page is not on the stack.
+     */
+    std::list<LirsEntry>::iterator stack_entry[BUF_SIZE];
+
+    /**
+     * Parallel array to the frame_table which stores the queue entry of each
+     * frame, or queue.end() if the frame is not on the queue.
+     */
+    std::list<FrameId>::iterator queue_entry[BUF_SIZE];
+
+    /**
+     * Maps the PageId of every non-resident HIR page on the stack to its
+     * entry.
+     */
+    std::unordered_map<PageId, std::list<LirsEntry>::iterator, BufHash>
+      nonresident;
+
+    /**
+     * Number of resident LIR pages.
+     */
+    std::uint32_t lir_count;
+
+    /**
+     * Number of frames that may hold LIR pages. The rest of the buffer pool
+     * holds resident HIR pages.
+     */
+    std::uint32_t lir_target;
+
+    /**
+     * Number of frames with pin count above 0.
+     */
+    std::uint32_t pinned_count;
+
+    /**
+     * Number of misses on non-resident HIR pages that made them LIR.
+     */
+    std::uint64_t nonresident_hits;
+
+    /**
+     * Queue entry that followed the last HIR page replaced, where
+     * reinstate() puts it back.
+     */
+    std::list<FrameId>::iterator victim_next;
+
+    /**
+     * true if the last page replaced was LIR.
+     */
+    bool victim_lir;
+
+    /**
+     * @brief Pops HIR entries off the bottom of the stack until the bottom
+     *        entry is LIR. Non-resident entries popped are forgotten.
+     */
+    void _prune();
+
+    /**
+     * @brief Turns the LIR page at the bottom of the stack into a resident
+     *        HIR page at the end of the queue, then prunes the stack.
+     */
+    void _demoteBottom();
+
+    /**
+     * @brief Forgets the least recent non-resident entry of the stack.
+     */
+    void _dropNonresident();
+
+    /**
+     * @brief Derived class from pure virtual function that returns replacement
+     *        policy type specific to this derived class.
+     *
+     * @return PolicyType LirsT.
+     */
+    PolicyType _getType();
+
+
+};
+
+
+/**
+ * SwatDB Sieve Class.
+ * Sieve is a derived class of ReplacementPolicy that implements the SIEVE
+ * replacement policy. Loaded pages are queued in FIFO order and never move on
+ * a hit; a hit only sets the visited bit of the frame. A hand walks the queue
+ * from the oldest page towards the newest, clearing visited bits, and
+ * replaces the first unpinned page it finds unvisited. Pages that survive
+ * stay in place, so new pages and old popular pages are kept apart and a
+ * one-time scan is replaced quickly.
+ * A hit does not reorder the queue: pin of a resident page is a single store
+ * to the frame's visited byte and unpin does nothing. The buffer manager
+ * around it still needs its caller to serialize hits as well as misses.
+ */
+class Sieve: public ReplacementPolicy {
+
+
+  public:
+
+
+    /**
+     * @brief Sieve constructor. Initializes pointer to buffer manager's
+     *        frame_table, creates the free list, sets rep_calls and
+     *        avg_frames_checked to 0, and starts with an empty queue and all
+     *        visited bits cleared.
+     *
+     * @pre BufferManager constructor is being called, frame_table parameter
+     *      points to an initialized frame_table object.
+     *
+     * @post A Sieve object will be initialized with member variables
+     *       initialized.
+     *
+     * @param Frame *frame_table, pointer to frame_table array of
+     *        BufferManager.
+     */
+    Sieve(Frame *frame_table);
+
+    /**
+     * Empty Destructor.
+     */
+    ~Sieve();
+
+    /**
+     * @brief Method that implements the SIEVE replacement policy.
+     *
+     * @pre The replacement policy has been invoked. The buffer manager is
+     *      attempting to add a frame to the buffer pool. The buffer map is
+     *      locked.
+     *
+     * @post If there is a free (invalid) frame, that FrameID is chosen for
+     *       replacement and is returned. Else the hand moves from the oldest
+     *       page towards the newest, wrapping around, clearing visited bits
+     *       until it finds an unpinned, unvisited page. That page is removed
+     *       from the queue and its frame returned.
+     *
+     * @return FrameID of the frame that is eligible for replacement in the
+     *         buffer pool.
+     *
+     * @throw InsufficientSpaceBufMgr if all pages in the buffer pool are
+     *        pinned.
+     */
+    FrameId replace();
+
+    /**
+     * @brief Frame is being pinned with pin count going from 0 to 1. If the
+     *        frame was just loaded, its page is added at the head of the
+     *        queue, unvisited. Pinning a resident page is a hit and sets its
+     *        visited bit with a relaxed store.
+     *
+     * @pre A page in the buffer pool has been pinned, and the pin count of
+     *      that frame has increased from 0 to 1.
+     *
+     * @post frame_id is on the queue.
+     *
+     * @param FrameId frame_id of the frame being pinned.
+     */
+    void pin(FrameId frame_id);
+
+    /**
+     * @brief Frame is being unpinned with pin count going from 1 to 0. Does
+     *        nothing: every load is followed by an unpin, so setting the
+     *        visited bit here would mark pages visited before any reuse.
+     *
+     * @pre A page in the buffer pool has been unpinned from pin count 1 to 0.
+     *
+     * @post The policy state is unchanged.
+     *
+     * @param FrameId frame_id of the frame being unpinned.
+     */
+    void unpin(FrameId frame_id){
+    }
+
+    /**
+     * @brief Places a frame that was just unpinned according to how its page
+     *        will be accessed. SequentialHint clears its visited bit and
+     *        moves it under the hand, so it is the next page examined.
+     *        KeepHotHint sets its visited bit.
+     *
+     * @pre The pin count of frame_id has just dropped to 0.
+     * @post The visited bit and queue position of frame_id reflect the hint.
+     */
+    void hint(FrameId frame_id, AccessHint hint);
+
+    /**
+     * @brief Undoes the replacement of the frame replace() just returned:
+     *        it goes back to its place in the queue, unvisited, under the
+     *        hand.
+     *
+     * @pre frame_id was just returned by replace() and holds a valid,
+     *      unpinned page. No other policy method was called since.
+     * @post frame_id is on the queue.
+     */
+    void reinstate(FrameId frame_id);
+
+    /**
+     * @brief Appends the frames on the queue to ranked, the one the hand
+     *        would replace last first: visited frames from newest to oldest,
+     *        then the others in the reverse of the order the hand reaches
+     *        them.
+     *
+     * @pre None.
+     * @post The policy state is unchanged.
+     */
+    void rankFrames(std::vector<FrameId> *ranked);
+
+    /**
+     * @brief The frame is invalidated in the buffer manager, and is
+     *        added to the free list of frames in the replacement policy.
+     *        The frame is removed from the queue.
+     *
+     * @pre A page in the buffer pool has been deallocated.
+     *
+     * @post frame_id is on the free list and not on the queue.
+     *
+     * @param FrameId frame_id of the frame being set invalid.
+     */
+    void freeFrame(FrameId frame_id);
+
+    /**
+     * @brief Updates the struct of replacement policy statistics within the
+     *        buffer state struct, counting visited bits as ref_bits.
+     *
+     * @param Pointer to the ReplacementStats struct member of BufferState
+     *        struct.
+     */
+    void getRepStats(struct BufferState::ReplacementStats *rep_stats);
+
+    /**
+     * @brief Prints replacement calls, average frames checked and the number
+     *        of visited frames.
+     */
+    void printStats();
+
+
+  private:
+
+
+    /**
+     * Queue of frames holding loaded pages, the newest at the front.
+     */
+    std::list<FrameId> queue;
+
+    /**
+     * Position of the hand in the queue. queue.end() means the hand starts
+     * again from the oldest page.
+     */
+    std::list<FrameId>::iterator hand;
+
+    /**
+     * Parallel array to the frame_table which stores the queue entry of each
+     * frame, or queue.end() if the frame is not on the queue.
+     */
+    std::list<FrameId>::iterator queue_entry[BUF_SIZE];
+
+    /**
+     * Parallel array to the frame_table which stores the visited bit of each
+     * frame, the only state a hit writes.
+     */
+    std::atomic<std::uint8_t> visited[BUF_SIZE];
+
+    /**
+     * @brief Derived class from pure virtual function that returns replacement
+     *        policy type specific to this derived class.
+     *
+     * @return PolicyType SieveT.
+     */
+    PolicyType _getType();
+
+
+};
+
+
+/**
+ * SwatDB S3Fifo Class.
+ * S3Fifo is a derived class of ReplacementPolicy that implements the S3-FIFO
+ * replacement policy with three FIFO queues:
+ *   - small, about 10% of the buffer pool, where newly loaded pages start.
+ *     Its oldest page moves to main if it was visited, else it is replaced
+ *     and remembered in ghost.
+ *   - main, the rest of the buffer pool. Its oldest page goes back to the
+ *     head of main if it was visited, else it is replaced.
+ *   - ghost, the PageIds of pages recently replaced from small. A page
+ *     loaded while in ghost skips small and goes to main.
+ * Most pages are only accessed once and leave through small after a short
+ * stay, without displacing the pages of main.
+ * A hit does not reorder the queues: pin of a resident page is a single store
+ * to the frame's visited byte and unpin does nothing. The buffer manager
+ * around it still needs its caller to serialize hits as well as misses.
+ * S3-FIFO's two bit
+ * frequency counter is reduced to that one bit.
+ */
+class S3Fifo: public ReplacementPolicy {
+
+
+  public:
+
+
+    /**
+     * @brief S3Fifo constructor. Initializes pointer to buffer manager's
+     *        frame_table, creates the free list, sets rep_calls and
+     *        avg_frames_checked to 0, starts with empty queues and all
+     *        visited bits cleared, and sizes small to 10% of the buffer
+     *        pool, at least one frame.
+     *
+     * @pre BufferManager constructor is being called, frame_table parameter
+     *      points to an initialized frame_table object.
+     *
+     * @post A S3Fifo object will be initialized with member variables
+     *       initialized.
+     *
+     * @param Frame *frame_table, pointer to frame_table array of
+     *        BufferManager.
+     */
+    S3Fifo(Frame *frame_table);
+
+    /**
+     * Empty Destructor.
+     */
+    ~S3Fifo();
+
+    /**
+     * @brief Method that implements the S3-FIFO replacement policy.
+     *
+     * @pre The replacement policy has been invoked. The buffer manager is
+     *      attempting to add a frame to the buffer pool. The buffer map is
+     *      locked.
+     *
+     * @post If there is a free (invalid) frame, that FrameID is chosen for
+     *       replacement and is returned. Else pages are taken from the tail
+     *       of small while it holds at least its target, otherwise from the
+     *       tail of main, until an unpinned, unvisited page is found. Its
+     *       frame is returned. Pinned pages are requeued like visited ones.
+     *
+     * @return FrameID of the frame that is eligible for replacement in the
+     *         buffer pool.
+     *
+     * @throw InsufficientSpaceBufMgr if all pages in the buffer pool are
+     *        pinned.
+     */
+    FrameId replace();
+
+    /**
+     * @brief Frame is being pinned with pin count going from 0 to 1. If the
+     *        frame was just loaded, its page is added at the head of main if
+     *        its PageId is in ghost, else at the head of small, and the
+     *        oldest PageId in ghost is dropped if ghost is over its size.
+     *        Pinning a resident page is a hit and sets its visited bit with a
+     *        relaxed store.
+     *
+     * @pre A page in the buffer pool has been pinned, and the pin count of
+     *      that frame has increased from 0 to 1.
+     *
+     * @post frame_id is on small or main.
+     *
+     * @param FrameId frame_id of the frame being pinned.
+     */
+    void pin(FrameId frame_id);
+
+    /**
+     * @brief Frame is being unpinned with pin count going from 1 to 0. Does
+     *        nothing: every load is followed by an unpin, so setting the
+     *        visited bit here would mark pages visited before any reuse.
+     *
+     * @pre A page in the buffer pool has been unpinned from pin count 1 to 0.
+     *
+     * @post The policy state is unchanged.
+     *
+     * @param FrameId frame_id of the frame being unpinned.
+     */
+    void unpin(FrameId frame_id){
+    }
+
+    /**
+     * @brief Places a frame that was just unpinned according to how its page
+     *        will be accessed. SequentialHint clears its visited bit, so a
+     *        page of the small queue leaves without reaching the main queue.
+     *        KeepHotHint sets it.
+     *
+     * @pre The pin count of frame_id has just dropped to 0.
+     * @post The visited bit of frame_id reflects the hint.
+     */
+    void hint(FrameId frame_id, AccessHint hint);
+
+    /**
+     * @brief Undoes the replacement of the frame replace() just returned:
+     *        it goes back to the tail of the queue it was taken from,
+     *        unvisited, and a page replaced from small leaves ghost again.
+     *
+     * @pre frame_id was just returned by replace() and holds a valid,
+     *      unpinned page. No other policy method was called since.
+     * @post frame_id is on small or main, and its PageId is not in ghost.
+     */
+    void reinstate(FrameId frame_id);
+
+    /**
+     * @brief Appends the frames on the queues to ranked, the one the
+     *        policy would replace last first: main from newest to oldest,
+     *        then small from newest to oldest.
+     *
+     * @pre None.
+     * @post The policy state is unchanged.
+     */
+    void rankFrames(std::vector<FrameId> *ranked);
+
+    /**
+     * @brief The frame is invalidated in the buffer manager, and is
+     *        added to the free list of frames in the replacement policy.
+     *        The frame is removed from small or main.
+     *
+     * @pre A page in the buffer pool has been deallocated.
+     *
+     * @post frame_id is on the free list and on neither small nor main.
+     *
+     * @param FrameId frame_id of the frame being set invalid.
+     */
+    void freeFrame(FrameId frame_id);
+
+    /**
+     * @brief Removes the PageIds of the pages of the file from ghost, so
+     *        that a page of a file created later with the same FileId does
+     *        not skip small.
+     *
+     * @pre No page of file_id is in the buffer pool.
+     *
+     * @post No PageId in ghost is of a page of file_id.
+     */
+    void removeFile(FileId file_id);
+
+    /**
+     * @brief Updates the struct of replacement policy statistics within the
+     *        buffer state struct, counting visited bits as ref_bits.
+     *
+     * @param Pointer to the ReplacementStats struct member of BufferState
+     *        struct.
+     */
+    void getRepStats(struct BufferState::ReplacementStats *rep_stats);
+
+    /**
+     * @brief Prints replacement calls, average frames checked, the sizes of
+     *        the three queues and the number of loads that hit ghost.
+     */
+    void printStats();
+
+    /**
+     * @brief Returns the number of frames on small.
+     */
+    std::uint32_t getSmallCount(){
+      return this->small.size();
+    }
+
+    /**
+     * @brief Returns the number of frames on main.
+     */
+    std::uint32_t getMainCount(){
+      return this->main.size();
+    }
+
+    /**
+     * @brief Returns the number of PageIds in ghost.
+     */
+    std::uint32_t getGhostCount(){
+      return this->ghost.size();
+    }
+
+
+  private:
+
+
+    /**
+     * Small FIFO queue of frames, the newest at the front.
+     */
+    std::list<FrameId> small;
+
+    /**
+     * Main FIFO queue of frames, the newest at the front.
+     */
+    std::list<FrameId> main;
+
+    /**
+     * Ghost FIFO queue of PageIds replaced from small, the newest at the
+     * front.
+     */
+    std::list<PageId> ghost;
+
+    /**
+     * Maps the PageIds in ghost to their entries.
+     */
+    std::unordered_map<PageId, std::list<PageId>::iterator, BufHash>
+      ghost_entry;
+
+    /**
+     * Parallel array to the frame_table which stores the entry of each frame
+     * in small or main. Entries stay valid when spliced between the two.
+     */
+    std::list<FrameId>::iterator queue_entry[BUF_SIZE];
+
+    /**
+     * Parallel array to the frame_table, true if the frame is on main.
+     */
+    bool in_main[BUF_SIZE];
+
+    /**
+     * Parallel array to the frame_table, true if the frame is on small or
+     * main.
+     */
+    bool queued[BUF_SIZE];
+
+    /**
+     * Parallel array to the frame_table which stores the visited bit of each
+     * frame, the only state a hit writes.
+     */
+    std::atomic<std::uint8_t> visited[BUF_SIZE];
+
+    /**
+     * Number of frames small may hold before its pages are replaced first.
+     */
+    std::uint32_t small_target;
+
+    /**
+     * Number of loads whose PageId was in ghost.
+     */
+    std::uint64_t ghost_hits;
+
+    /**
+     * @brief Derived class from pure virtual function that returns replacement
+     *        policy type specific to this derived class.
+     *
+     * @return PolicyType S3FifoT.
+     */
+    PolicyType _getType();
+
+
+};
+
+
+/**
+ * Number of partitions of PerFile: one each for Clock, MRU and LRU-K.
+ */
+static const std::uint32_t PF_PARTS = 3;
+
+/**
+ * SwatDB PerFile Class.
+ * PerFile is a derived class of ReplacementPolicy that lets each file choose
+ * how its pages are replaced. The buffer pool is split into a Clock, an MRU
+ * and an LRU-K partition, and every loaded page joins the partition of the
+ * policy registered for its file, Clock by default. Each partition in use is
+ * entitled to an equal share of the frames. A page is read in by replacing a
+ * page of its own partition once the partition holds its share. Otherwise,
+ * or when the partition has no unpinned page left, the victim is chosen
+ * globally, from the partition furthest above its share that has an unpinned
+ * page.
+ */
+class PerFile: public ReplacementPolicy {
+
+
+  public:
+
+
+    /**
+     * @brief PerFile constructor. Initializes pointer to buffer manager's
+     *        frame_table, creates the free list, sets rep_calls and
+     *        avg_frames_checked to 0, and starts with empty partitions and
+     *        only the Clock partition in use.
+     *
+     * @pre BufferManager constructor is being called, frame_table parameter
+     *      points to an initialized frame_table object.
+     *
+     * @post A PerFile object will be initialized with member variables
+     *       initialized.
+     *
+     * @param Frame *frame_table, pointer to frame_table array of
+     *        BufferManager.
+     */
+    PerFile(Frame *frame_table);
+
+    /**
+     * Empty Destructor.
+     */
+    ~PerFile();
+
+    /**
+     * @brief Method that chooses a frame to replace without knowing the page
+     *        to be loaded. The victim is chosen globally.
+     *
+     * @pre The replacement policy has been invoked. The buffer manager is
+     *      attempting to add a frame to the buffer pool. The buffer map is
+     *      locked.
+     *
+     * @post If there is a free (invalid) frame, that FrameID is chosen for
+     *       replacement and is returned. Else the partition furthest above
+     *       its share that has an unpinned page gives up the page its own
+     *       policy chooses.
+     *
+     * @return FrameID of the frame that is eligible for replacement in the
+     *         buffer pool.
+     *
+     * @throw InsufficientSpaceBufMgr if all pages in the buffer pool are
+     *        pinned.
+     */
+    FrameId replace();
+
+    /**
+     * @brief Method that chooses a frame to replace for the page of the
+     *        given PageId.
+     *
+     * @pre Same as replace().
+     *
+     * @post If there is a free (invalid) frame, that FrameID is chosen for
+     *       replacement and is returned. Else, if the partition of the file
+     *       of page_id holds at least its share of the frames and has an
+     *       unpinned page, it gives up the page its own policy chooses. Else
+     *       the victim is chosen globally as in replace().
+     *
+     * @param page_id PageId of the page the frame is chosen for.
+     * @return FrameID of the frame that is eligible for replacement in the
+     *         buffer pool.
+     *
+     * @throw InsufficientSpaceBufMgr if all pages in the buffer pool are
+     *        pinned.
+     */
+    FrameId replaceFor(PageId page_id);
+
+    /**
+     * @brief Frame is being pinned with pin count going from 0 to 1. If the
+     *        frame was just loaded, it joins the partition of the file of its
+     *        page. Pinning a resident page is a hit: an MRU page is taken off
+     *        the stack of unpinned pages and an LRU-K page records the
+     *        reference.
+     *
+     * @pre A page in the buffer pool has been pinned, and the pin count of
+     *      that frame has increased from 0 to 1.
+     *
+     * @post frame_id is resident in a partition.
+     *
+     * @param FrameId frame_id of the frame being pinned.
+     */
+    void pin(FrameId frame_id);
+
+    /**
+     * @brief Frame is being unpinned with pin count going from 1 to 0. A
+     *        Clock page gets its ref_bit set, an MRU page is pushed on the
+     *        stack of unpinned pages, and an LRU-K page becomes a candidate
+     *        for replacement.
+     *
+     * @pre A page in the buffer pool has been unpinned from pin count 1 to 0.
+     *
+     * @post frame_id can be chosen for replacement.
+     *
+     * @param FrameId frame_id of the frame being unpinned.
+     */
+    void unpin(FrameId frame_id);
+
+    /**
+     * @brief Places a frame that was just unpinned according to how its page
+     *        will be accessed, within its partition. With SequentialHint a
+     *        Clock page has its ref_bit cleared and an LRU-K page forgets
+     *        its older references. With KeepHotHint a Clock page has its
+     *        ref_bit set and an MRU page moves to the bottom of the stack.
+     *
+     * @pre The pin count of frame_id has just dropped to 0.
+     * @post The partition state of frame_id reflects the hint.
+     */
+    void hint(FrameId frame_id, AccessHint hint);
+
+    /**
+     * @brief Undoes the replacement of the frame replace() or replaceFor()
+     *        just returned: it is resident in its partition again, on the
+     *        ring under the hand, on top of the MRU stack or among the LRU-K
+     *        candidates.
+     *
+     * @pre frame_id was just returned by replace() or replaceFor() and
+     *      holds a valid, unpinned page. No other policy method was called
+     *      since.
+     * @post frame_id is resident in its partition.
+     */
+    void reinstate(FrameId frame_id);
+
+    /**
+     * @brief Appends the frames of unpinned pages to ranked, the one the
+     *        policy would replace last first. Each partition orders its own
+     *        frames, the Clock ring from the hand on with frames without a
+     *        ref_bit first, the MRU stack from the top and the LRU-K
+     *        candidates in set order, and the orders are merged by taking
+     *        each next victim from the partition furthest above its share,
+     *        as replace() does. The merged victims are appended in reverse.
+     *
+     * @pre None.
+     * @post The policy state is unchanged.
+     */
+    void rankFrames(std::vector<FrameId> *ranked);
+
+    /**
+     * @brief The frame is invalidated in the buffer manager, and is
+     *        added to the free list of frames in the replacement policy.
+     *        The frame leaves its partition.
+     *
+     * @pre A page in the buffer pool has been deallocated.
+     *
+     * @post frame_id is on the free list and in no partition.
+     *
+     * @param FrameId frame_id of the frame being set invalid.
+     */
+    void freeFrame(FrameId frame_id);
+
+    /**
+     * @brief Chooses the partition of the pages of the given file and
+     *        recomputes the shares of the partitions in use.
+     *
+     * @pre None.
+     * @post Pages of file_id loaded from now on join the partition of
+     *       rep_type.
+     *
+     * @param file_id FileId of the file.
+     * @param rep_type ClockT, MruT or LruKT.
+     *
+     * @throw InvalidPolicyBufMgr if rep_type is not ClockT, MruT or LruKT.
+     */
+    void setFilePolicy(FileId file_id, PolicyType rep_type);
+
+    /**
+     * @brief Updates the struct of replacement policy statistics within the
+     *        buffer state struct. Adds the ref_bit count of the Clock
+     *        partition and the position of its clock hand.
+     *
+     * @param Pointer to the ReplacementStats struct member of BufferState
+     *        struct.
+     */
+    void getRepStats(struct BufferState::ReplacementStats *rep_stats);
+
+    /**
+     * @brief Prints replacement calls, average frames checked, the frames
+     *        and share of every partition, and the number of victims taken
+     *        from another partition than the one of the page loaded.
+     */
+    void printStats();
+
+
+  private:
+
+
+    /**
+     * Partition of each file with a registered policy.
+     */
+    std::unordered_map<FileId, std::uint8_t> file_part;
+
+    /**
+     * True for a partition that is in use: the Clock partition, and every
+     * partition some file is registered with.
+     */
+    bool in_use[PF_PARTS];
+
+    /**
+     * Number of frames each partition in use is entitled to.
+     */
+    std::uint32_t share[PF_PARTS];
+
+    /**
+     * Number of frames holding a page of each partition.
+     */
+    std::uint32_t resident_count[PF_PARTS];
+
+    /**
+     * Parallel array to the frame_table which stores the partition of each
+     * frame holding a page.
+     */
+    std::uint8_t part[BUF_SIZE];
+
+    /**
+     * Parallel array to the frame_table, true while the frame holds a page
+     * of some partition.
+     */
+    bool resident[BUF_SIZE];
+
+    /**
+     * Frames of the Clock partition, in the order the hand visits them.
+     */
+    std::list<FrameId> ring;
+
+    /**
+     * Position of the clock hand in ring. ring.end() means the hand starts
+     * again from the front.
+     */
+    std::list<FrameId>::iterator hand;
+
+    /**
+     * Parallel array to the frame_table which stores the ring entry of each
+     * frame of the Clock partition.
+     */
+    std::list<FrameId>::iterator ring_entry[BUF_SIZE];
+
+    /**
+     * Bitmap parallel to the frame_table with the ref_bit of every frame of
+     * the Clock partition.
+     */
+    FrameBitmap ref_bits;
+
+    /**
+     * Unpinned frames of the MRU partition, the most recently unpinned at
+     * the front.
+     */
+    std::list<FrameId> stack;
+
+    /**
+     * Parallel array to the frame_table which stores the stack entry of each
+     * frame, or stack.end() if the frame is not on the stack.
+     */
+    std::list<FrameId>::iterator stack_entry[BUF_SIZE];
+
+    /**
+     * Times of the last LRU_K references of each frame of the LRU-K
+     * partition, the most recent first, 0 for a reference that never
+     * happened.
+     */
+    std::uint64_t history[BUF_SIZE][LRU_K];
+
+    /**
+     * Unpinned frames of the LRU-K partition ordered by the time of their
+     * K-th most recent reference, then of their most recent one. The first
+     * frame has the largest backward K-distance and is replaced first.
+     */
+    std::set<std::tuple<std::uint64_t, std::uint64_t, FrameId>> candidates;
+
+    /**
+     * Logical time, incremented on every reference to an LRU-K page.
+     */
+    std::uint64_t now;
+
+    /**
+     * Number of victims taken from another partition than the one of the
+     * page loaded.
+     */
+    std::uint64_t steals;
+
+    /**
+     * @brief Returns the partition of the pages of the given file.
+     */
+    std::uint32_t _partOf(FileId file_id);
+
+    /**
+     * @brief Chooses the frame of an unpinned page of partition p with the
+     *        partition's own policy, and adds the frames examined to
+     *        frames_checked.
+     *
+     * @return FrameId of the victim, or BUF_SIZE if every page of the
+     *         partition is pinned.
+     */
+    FrameId _victim(std::uint32_t p, std::uint32_t *frames_checked);
+
+    /**
+     * @brief Chooses a victim, trying partition own first if it holds its
+     *        share, then every partition in decreasing order of frames above
+     *        share. own is PF_PARTS if the page to load is unknown.
+     *
+     * @throw InsufficientSpaceBufMgr if all pages in the buffer pool are
+     *        pinned.
+     */
+    FrameId _replace(std::uint32_t own);
+
+    /**
+     * @brief Removes a resident frame from its partition.
+     */
+    void _remove(FrameId frame_id);
+
+    /**
+     * @brief Returns the LRU-K ordering key of a frame.
+     */
+    std::tuple<std::uint64_t, std::uint64_t, FrameId> _key(FrameId frame_id);
+
+    /**
+     * @brief Derived class from pure virtual function that returns replacement
+     *        policy type specific to this derived class.
+     *
+     * @return PolicyType PerFileT.
+     */
+    PolicyType _getType();
+
+
+};
+
+
+/**
+ * SwatDB Random Class.
+ * Random is a derived class of ReplacementPolicy that manages the buffer
+ * replacement policy of the DBMS. The random algorithm randomly generates
+ * a frame id and replaces the first unpinned frame at or after it. Performs
+ * well on large buffer pools and has minimal overhead.
+ */
+class Random: public ReplacementPolicy {
+
+
+  public:
+
+
+    /**
+     * @brief Random constructor. Initializes pointer to buffer manager's
+     *        frame_table, creates the free list, sets rep_calls and
+     *        avg_frames_checked to 0.
+     *
+     * @pre BufferManager constructor is being called, frame_table parameter
+     *      points to an initialized frame_table object.
+     *
+     * @post A Random policy object will be initialized with member variables
+     *      initialized.
+     *
+     * @param Frame *frame_table, pointer to frame_table array of
+     *        BufferManager.
+     */
+    Random(Frame *frame_table);
+
+    /**
+     * Empty Destructor.
+     */
+    ~Random();
+
+
+    /**
+     * @brief Method that implements the Random replacement policy
+     *        functionality
+     *
+     * @pre The replacement policy has been invoked. The buffer manager is
+     *      attempting to add a frame to the buffer pool. The buffer map is
+     *      locked.
+     *
+     * @post If there is a free (invalid) frame, that FrameID is chosen for
+     *       replacement and is returned. Else, a random frame is selected and
+     *       evaluated for eligibility. If it is pinned, the pinned bitmap is
+     *       scanned from that frame for the next unpinned frame, wrapping
+     *       around the end of the buffer pool. If all pages are pinned, an
+     *       exception is thrown.
+     *
+     * @return FrameID of the frame that is eligible for replacement in the
+     *         buffer pool.
+     *
+     * @throw InsufficientSpaceBufMgr if all pages in the buffer pool are
+     *        pinned.
+     */
+    FrameId replace();
+
+
+    /**
+     * @brief Frame is being pinned with pin count going from 0 to 1. Sets the
+     *        pinned bit associated with this frame_id.
+     *
+     * @pre A page in the buffer pool has been pinned, and the pin count of
+     *      that frame has increased from 0 to 1.
+     *
+     * @post Pinned bit of frame_id is set to true.
+     *
+     * @param FrameId frame_id of the frame being pinned.
+     */
+    void pin(FrameId frame_id){
+      this->pin_bits.set(frame_id);
+    }
+
+    /**
+     * @brief Frame is being unpinned with pin count going from 1 to 0. Clears
+     *        the pinned bit associated with this frame_id.
+     *
+     * @pre A page in the buffer pool has been unpinned from pin count 1 to 0.
+     *
+     * @post Pinned bit of frame_id is set to false.
+     *
+     * @param FrameId frame_id of the frame being unpinned.
+     */
+    void unpin(FrameId frame_id){
+      this->pin_bits.clear(frame_id);
+    }
+
+
+    /**
+     * @brief The frame is invalidated in the buffer manager, and is
+     *        added to the free list of frames in the replacement policy.
+     *        Pinned bit associated with this frame is set to false.
+     *
+     * @pre A page in the buffer pool has been deallocated.
+     *
+     * @post The replacement policy state is updated to reflect the freeing
+     *       of a specific frame.
+     *
+     * @param FrameId frame_id of the frame being set invalid.
+     */
+    void freeFrame(FrameId frame_id);
+
+
+    /**
+     * @brief Prints average frames checked, replacement calls, summary stats
+     *        on randomness.
+     */
+    void printStats();
+
+
+  private:
+
+
+    /**
+     * @brief Derived class from pure virtual function that returns replacement
+     *        policy type specific to this derived class.
+     *
+     * @return PolicyType RandomT.
+     */
+    PolicyType _getType();
+
+
+    /**
+     * Parallel array to frame_table that stores number of times each frame_id
+     *    is chosen for replacement. Is useful for determining randomness.
+     */
+    int times_chosen[BUF_SIZE];
+
+
+    /**
+     * Bitmap parallel to the frame_table with a bit set for every frame whose
+     * pin count is above 0.
+     */
+    FrameBitmap pin_bits;
 
 
 };
@@ -413,10 +2126,10 @@ class MRU: public ReplacementPolicy {
      * @brief Derived class from pure virtual function that returns replacement
      *        policy type specific to this derived class.
      *
-     * @return RepType MruT.
+     * @return PolicyType MruT.
      *
      */
-    RepType _getType();
+    PolicyType _getType();
 
 
     /**
@@ -546,9 +2259,9 @@ class LRU: public ReplacementPolicy {
      * @brief Derived class from pure virtual function that returns replacement
      *        policy type specific to this derived class.
      *
-     * @return RepType LruT.
+     * @return PolicyType LruT.
      */
-    RepType _getType();
+    PolicyType _getType();
 
 
     /**
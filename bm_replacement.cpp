@@ -33,6 +33,94 @@ void ReplacementPolicy::freeFrame(FrameId frame_id) {
 }
 
 
+/**
+ * @brief Virtual method that implements any necessary update to replacement
+ *    policy state following the removal of a file, after freeFrame was
+ *    called for each of its frames. Policies that remember pages no longer
+ *    in the buffer pool forget those of the file. Does nothing by default.
+ *
+ * @pre No page of file_id is in the buffer pool.
+ *
+ * @post The replacement policy holds no state for pages of file_id.
+ */
+void ReplacementPolicy::removeFile(FileId file_id) {
+}
+
+
+/**
+ * @brief Virtual method that places a frame that was just unpinned according
+ *    to how its page will be accessed: SequentialHint asks for the cold end,
+ *    where it is replaced soon, KeepHotHint for the hot end. Does nothing by
+ *    default.
+ *
+ * @pre The pin count of frame_id has just dropped to 0 and unpin was called.
+ *    hint is neither NoHint nor OnceHint, which the buffer manager handles
+ *    itself.
+ *
+ * @post The replacement policy state reflects the hint.
+ */
+void ReplacementPolicy::hint(FrameId frame_id, AccessHint hint) {
+}
+
+
+/**
+ * @brief Virtual method that undoes the replacement of the frame the last
+ *    call to replace() or replaceFor() returned: the frame keeps its page,
+ *    which the policy tracks again where it was before, without counting an
+ *    access. Policies that take the victim off their lists or move a hand
+ *    past it override it, it does nothing by default.
+ *
+ * @pre frame_id was just returned by replace() or replaceFor() and holds a
+ *    valid, unpinned page. No other policy method was called since.
+ *
+ * @post frame_id is resident in the policy as it was before it was chosen.
+ */
+void ReplacementPolicy::reinstate(FrameId frame_id) {
+}
+
+
+/**
+ * @brief Virtual method that appends the frames the policy tracks to ranked,
+ *    the one it would replace last first. Does nothing by default, leaving
+ *    the frames in frame table order.
+ *
+ * @post Frames may be missing from ranked or listed more than once, and
+ *    invalid frames may be listed. The policy state is unchanged.
+ */
+void ReplacementPolicy::rankFrames(std::vector<FrameId> *ranked) {
+}
+
+
+/**
+ * @brief Chooses a frame to replace for the page of the given PageId, which
+ *    is about to be read into the buffer pool. Policies that treat pages
+ *    differently by their file override it, the others simply call
+ *    replace().
+ *
+ * @param page_id PageId of the page the frame is chosen for.
+ * @return FrameID of the frame that is eligible for replacement in the
+ *    buffer pool.
+ *
+ * @throw InsufficientSpaceBufMgr if all pages in the buffer pool are
+ *    pinned.
+ */
+FrameId ReplacementPolicy::replaceFor(PageId page_id) {
+  return this->replace();
+}
+
+
+/**
+ * @brief Chooses the replacement policy used for the pages of the given
+ *    file. Only policies that partition the buffer pool by file support it.
+ *
+ * @throw InvalidPolicyBufMgr if the policy does not support per-file
+ *    selection, or rep_type is not supported by it.
+ */
+void ReplacementPolicy::setFilePolicy(FileId file_id, PolicyType rep_type) {
+  throw InvalidPolicyBufMgr();
+}
+
+
 /**
  * @brief Updates the struct of replacement policy statistics within the
  *    buffer state struct. Adds the replacement type, number of calls to
@@ -88,5 +176,5 @@ void ReplacementPolicy::_createFree(){
   *    Used to compute statistics about replacment algorithms.
   */
 void ReplacementPolicy::incrementGetAllocCount(){
-  this->new_page_calls++;
+  this->new_page_calls.fetch_add(1, std::memory_order_relaxed);
 }
\ No newline at end of file
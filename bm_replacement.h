@@ -6,7 +6,9 @@
  */
 
 
+#include <atomic>
 #include <utility>
+#include <vector>
 #include "swatdb_types.h"
 #include "bufmgr.h"   // need for BufferState stats struct
 
@@ -49,6 +51,24 @@ class ReplacementPolicy {
      */
     virtual FrameId replace() = 0;
 
+    /**
+     * @brief Chooses a frame to replace for the page of the given PageId,
+     *        which is about to be read into the buffer pool. Policies that
+     *        treat pages differently by their file override it, the others
+     *        simply call replace().
+     *
+     * @pre Same as replace().
+     * @post Same as replace().
+     *
+     * @param page_id PageId of the page the frame is chosen for.
+     * @return FrameID of the frame that is eligible for replacement in the
+     *         buffer pool.
+     *
+     * @throw InsufficientSpaceBufMgr if all pages in the buffer pool are
+     *        pinned.
+     */
+    virtual FrameId replaceFor(PageId page_id);
+
     /**
      * @brief Pure virtual method that implements any necessary update to
      *        replacement policy state following the pinning of a page in the
@@ -75,6 +95,49 @@ class ReplacementPolicy {
      */
     virtual void unpin(FrameId frame_id) = 0;
 
+    /**
+     * @brief Virtual method that places a frame that was just unpinned
+     *        according to how its page will be accessed: SequentialHint
+     *        asks for the cold end, where it is replaced soon, KeepHotHint
+     *        for the hot end. Does nothing by default.
+     *
+     * @pre The pin count of frame_id has just dropped to 0 and unpin was
+     *      called. hint is neither NoHint nor OnceHint, which the buffer
+     *      manager handles itself.
+     *
+     * @post The replacement policy state reflects the hint.
+     */
+    virtual void hint(FrameId frame_id, AccessHint hint);
+
+    /**
+     * @brief Virtual method that undoes the replacement of the frame the
+     *        last call to replace() or replaceFor() returned: the frame keeps
+     *        its page, which the policy tracks again where it was before,
+     *        without counting an access. Policies that take the victim off
+     *        their lists or move a hand past it override it, it does nothing
+     *        by default.
+     *
+     * @pre frame_id was just returned by replace() or replaceFor() and
+     *      holds a valid, unpinned page. No other policy method was called
+     *      since.
+     *
+     * @post frame_id is resident in the policy as it was before it was
+     *       chosen.
+     */
+    virtual void reinstate(FrameId frame_id);
+
+    /**
+     * @brief Virtual method that appends the frames the policy tracks to
+     *        ranked, the one it would replace last first. Used to save the
+     *        resident pages in the order they should be read back in. Does
+     *        nothing by default, leaving the frames in frame table order.
+     *
+     * @pre None.
+     * @post Frames may be missing from ranked or listed more than once, and
+     *       invalid frames may be listed. The policy state is unchanged.
+     */
+    virtual void rankFrames(std::vector<FrameId> *ranked);
+
     /**
      * @brief Virtual method that implements any necessary update to
      *        replacement policy state following the deallocation of a page in
@@ -90,6 +153,33 @@ class ReplacementPolicy {
      */
     virtual void freeFrame(FrameId frame_id);
 
+    /**
+     * @brief Virtual method that implements any necessary update to
+     *        replacement policy state following the removal of a file, after
+     *        freeFrame was called for each of its frames. Policies that
+     *        remember pages no longer in the buffer pool forget those of the
+     *        file. Does nothing by default.
+     *
+     * @pre No page of file_id is in the buffer pool.
+     *
+     * @post The replacement policy holds no state for pages of file_id.
+     */
+    virtual void removeFile(FileId file_id);
+
+    /**
+     * @brief Chooses the replacement policy used for the pages of the given
+     *        file. Only policies that partition the buffer pool by file
+     *        support it.
+     *
+     * @pre None.
+     * @post The policy of the pages of file_id read in from now on is
+     *       rep_type.
+     *
+     * @throw InvalidPolicyBufMgr if the policy does not support per-file
+     *        selection, or rep_type is not supported by it.
+     */
+    virtual void setFilePolicy(FileId file_id, PolicyType rep_type);
+
     
     /**
     * @brief Updates the struct of replacement policy statistics within the
@@ -128,9 +218,9 @@ class ReplacementPolicy {
      * @brief Returns the type of a given replacement policy. Used to fill
      *        struct of replacement statistics.
      *
-     * @return RepType of replacement policy.
+     * @return PolicyType of replacement policy.
      */
-    virtual RepType _getType() = 0;
+    virtual PolicyType _getType() = 0;
 
     /**
      * @brief Creates a free list for the buffer pool by checking each frame in
@@ -168,9 +258,10 @@ class ReplacementPolicy {
     /**
      * Running total of the number of calls to getPage or allocatePage in the 
      * buf_mgr. Allows calculation of percentage of getPages where replacement 
-     * was required. 
+     * was required. Atomic, so that it may be read while the buffer manager
+     * is in use.
      */
-    std::uint64_t new_page_calls; 
+    std::atomic<std::uint64_t> new_page_calls; 
 
 };
 
@@ -0,0 +1,346 @@
+/**
+ * @file bm_replay.cpp
+ * @author Nikoloz Khmaladze & Omar Ebied
+ * @date 2025-02-09
+ *
+ * Implementation of the trace replay.
+ * A ReplaySimulator is the part of BasicBufferManager that the replacement
+ * policy sees: the frame table, the buffer map and the calls to the policy,
+ * with the page I/O replaced by counters. It is instantiated for the same
+ * policies as BasicBufferManager, chosen by PolicyType in the same way.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include "bm_replay.h"
+#include "bm_buffermap.h"
+#include "bm_frame.h"
+#include "bm_policies.h"
+#include "swatdb_exceptions.h"
+
+
+/**
+ * Replays a trace through a replacement policy, counting what it would have
+ * cost.
+ */
+class ReplaySimulatorBase {
+
+  public:
+
+    virtual ~ReplaySimulatorBase(){}
+
+    /**
+     * @brief Replays the trace into result.
+     */
+    virtual void run(const std::vector<TraceEvent> &events,
+                     ReplayResult *result) = 0;
+};
+
+
+/**
+ * ReplaySimulator for a replacement policy fixed at compile time, held by
+ * value like in BasicBufferManager.
+ */
+template <class Policy>
+class ReplaySimulator final : public ReplaySimulatorBase {
+
+  public:
+
+    /**
+     * @brief ReplaySimulator constructor. Pins BUF_SIZE - pool_size frames
+     *        for good, so that the policy only ever chooses among pool_size
+     *        of them.
+     */
+    ReplaySimulator(std::uint32_t pool_size) : policy(this->frame_table){
+      PageId reserved;
+      reserved.file_id = (FileId)-1;
+      for( std::uint32_t i = pool_size; i < BUF_SIZE; i++ ){
+        reserved.page_num = i;
+        FrameId frame_id = policy.replaceFor(reserved);
+        frame_table[frame_id].page_id = reserved;
+        frame_table[frame_id].valid = true;
+        frame_table[frame_id].pin_count = 1;
+        policy.pin(frame_id);
+      }
+      this->pinned = BUF_SIZE - pool_size;
+    }
+
+    /**
+     * @brief Replays the trace into result.
+     */
+    void run(const std::vector<TraceEvent> &events,
+             ReplayResult *result) override{
+      for( const TraceEvent &event : events ){
+        switch( event.op ){
+          case TraceGet:
+            result->gets++;
+            _get(event.page_id, false, result);
+            break;
+          case TraceAllocate:
+            _get(event.page_id, true, result);
+            break;
+          case TraceRelease:
+            _release(event.page_id, event.dirty);
+            break;
+        }
+      }
+    }
+
+  private:
+
+    /**
+     * The frame table, the policy and the buffer map, as in
+     * BasicBufferManager. policy must be declared after frame_table.
+     */
+    Frame frame_table[BUF_SIZE];
+    Policy policy;
+    BufferMap buf_map;
+
+    /**
+     * Number of frames with a pin count above 0.
+     */
+    std::uint32_t pinned;
+
+    /**
+     * @brief Pins the page, reading it in if it is not resident, as
+     *        getPage does, or installing it without a read, as allocatePage
+     *        does.
+     */
+    void _get(PageId page_id, bool allocate, ReplayResult *result){
+      policy.incrementGetAllocCount();
+
+      if( buf_map.contains(page_id) ){
+        FrameId frame_id = buf_map.get(page_id);
+        Frame &frame = frame_table[frame_id];
+        if( !allocate ){
+          result->hits++;
+        }
+        frame.pin_count++;
+        if( frame.pin_count == 1 ){
+          pinned++;
+          policy.pin(frame_id);
+        }
+        return;
+      }
+
+      if( pinned == BUF_SIZE ){
+        result->pin_waits++;
+        return;
+      }
+      FrameId frame_id;
+      try{
+        frame_id = policy.replaceFor(page_id);
+      }catch (InsufficientSpaceBufMgr &e){
+        result->pin_waits++;
+        return;
+      }
+
+      Frame &frame = frame_table[frame_id];
+      if( frame.valid ){
+        result->evictions++;
+        if( frame.dirty ){
+          result->writes++;
+        }
+        buf_map.remove(frame.page_id);
+      }
+      if( !allocate ){
+        result->misses++;
+        result->reads++;
+      }
+
+      frame.page_id = page_id;
+      frame.valid = true;
+      frame.pin_count = 1;
+      frame.dirty = false;
+      buf_map.insert(page_id, frame_id);
+      pinned++;
+      policy.pin(frame_id);
+    }
+
+    /**
+     * @brief Unpins the page, as releasePage does.
+     */
+    void _release(PageId page_id, bool dirty){
+      if( !buf_map.contains(page_id) ){
+        return;
+      }
+      FrameId frame_id = buf_map.get(page_id);
+      Frame &frame = frame_table[frame_id];
+      if( frame.pin_count == 0 ){
+        return;
+      }
+      if( dirty ){
+        frame.dirty = true;
+      }
+      frame.pin_count--;
+      if( frame.pin_count == 0 ){
+        pinned--;
+        policy.unpin(frame_id);
+      }
+    }
+};
+
+
+/**
+ * @brief Creates the ReplaySimulator of the replacement policy of the given
+ *    type.
+ *
+ * @throw InvalidPolicyBufMgr If the policy has no implementation.
+ */
+static ReplaySimulatorBase *_createSimulator(PolicyType rep_type,
+                                             std::uint32_t pool_size){
+  switch(rep_type) {
+    case ClockT:
+      return new ReplaySimulator<Clock>(pool_size);
+    case RandomT:
+      return new ReplaySimulator<Random>(pool_size);
+    case GClockT:
+      return new ReplaySimulator<GClock>(pool_size);
+    case ClockProT:
+      return new ReplaySimulator<ClockPro>(pool_size);
+    case LirsT:
+      return new ReplaySimulator<Lirs>(pool_size);
+    case SieveT:
+      return new ReplaySimulator<Sieve>(pool_size);
+    case S3FifoT:
+      return new ReplaySimulator<S3Fifo>(pool_size);
+    case PerFileT:
+      return new ReplaySimulator<PerFile>(pool_size);
+    default:
+      throw InvalidPolicyBufMgr(); // no replacement policy defined
+  }
+}
+
+
+/**
+ * @brief Returns true if the policy of the given type derives its targets
+ *    and the number of pages it remembers from BUF_SIZE: CLOCK-Pro's cold
+ *    target, the LIR target of LIRS, S3-FIFO's small queue and the shares of
+ *    PerFile. Frames kept pinned would skew them, so such a policy can only
+ *    be replayed with BUF_SIZE frames.
+ */
+bool bm_replay_sized(PolicyType rep_type){
+  return rep_type == ClockProT || rep_type == LirsT || rep_type == S3FifoT ||
+         rep_type == PerFileT;
+}
+
+
+/**
+ * @brief Replays a trace through the replacement policy of config with a
+ *    buffer pool of config.pool_size frames, and counts what it would have
+ *    cost.
+ *
+ * @param events The trace, in order.
+ * @param config Policy and pool size.
+ * @return The counts of the replay.
+ *
+ * @throw InvalidPolicyBufMgr If the policy has no implementation,
+ *    pool_size is 0 or above BUF_SIZE, or pool_size is below BUF_SIZE for a
+ *    policy bm_replay_sized is true for.
+ */
+ReplayResult bm_replay(const std::vector<TraceEvent> &events,
+                       const ReplayConfig &config){
+  if( config.pool_size == 0 || config.pool_size > BUF_SIZE ){
+    throw InvalidPolicyBufMgr();
+  }
+  if( config.pool_size < BUF_SIZE && bm_replay_sized(config.rep_type) ){
+    throw InvalidPolicyBufMgr();
+  }
+  ReplayResult result = {config, true, 0, 0, 0, 0, 0, 0, 0, 0.0};
+
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+  std::unique_ptr<ReplaySimulatorBase> simulator(
+      _createSimulator(config.rep_type, config.pool_size));
+  simulator->run(events, &result);
+  result.seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  return result;
+}
+
+/**
+ * @brief Replays a trace with every config, num_threads configs at a time.
+ *    Each thread takes the next config not yet replayed, so long and short
+ *    replays balance out. The result of a config bm_replay throws for is
+ *    not valid.
+ *
+ * @param events The trace, in order.
+ * @param configs Policies and pool sizes.
+ * @param num_threads Number of replays run at once, at least 1.
+ * @return The results, in the order of configs.
+ */
+std::vector<ReplayResult> bm_replay_all(
+    const std::vector<TraceEvent> &events,
+    const std::vector<ReplayConfig> &configs, std::uint32_t num_threads){
+  std::vector<ReplayResult> results(configs.size());
+  std::atomic<std::size_t> next(0);
+
+  auto work = [&](){
+    std::size_t i;
+    while( (i = next.fetch_add(1)) < configs.size() ){
+      try{
+        results[i] = bm_replay(events, configs[i]);
+      }catch (InvalidPolicyBufMgr &e){
+        results[i] = ReplayResult{configs[i], false, 0, 0, 0, 0, 0, 0, 0,
+                                  0.0};
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for( std::uint32_t t = 1; t < num_threads && t < configs.size(); t++ ){
+    threads.emplace_back(work);
+  }
+  work();
+  for( std::thread &thread : threads ){
+    thread.join();
+  }
+  return results;
+}
+
+/**
+ * @brief Prints results as a table, one config a row.
+ */
+void bm_print_replay(const std::vector<ReplayResult> &results){
+  std::ios_base::fmtflags flags = std::cout.flags();
+  std::streamsize precision = std::cout.precision();
+
+  std::cout << std::left << std::setw(10) << "policy" << std::right
+    << std::setw(10) << "frames" << std::setw(12) << "gets"
+    << std::setw(10) << "hit rate" << std::setw(12) << "reads"
+    << std::setw(12) << "writes" << std::setw(12) << "evictions"
+    << std::setw(10) << "pin waits" << std::setw(10) << "seconds"
+    << std::endl;
+  for( const ReplayResult &result : results ){
+    std::cout << std::left << std::setw(10)
+      << bm_rep_str(result.config.rep_type) << std::right << std::setw(10)
+      << result.config.pool_size;
+    if( !result.valid ){
+      if( result.config.pool_size < BUF_SIZE &&
+          bm_replay_sized(result.config.rep_type) ){
+        std::cout << "  not supported: sized to BUF_SIZE (" << BUF_SIZE
+          << ") frames" << std::endl;
+      }
+      else{
+        std::cout << "  not supported" << std::endl;
+      }
+      continue;
+    }
+    double hit_rate = result.gets > 0 ? (double)result.hits / result.gets : 0;
+    std::cout << std::setw(12) << result.gets << std::fixed
+      << std::setprecision(4) << std::setw(10) << hit_rate
+      << std::setw(12) << result.reads << std::setw(12) << result.writes
+      << std::setw(12) << result.evictions << std::setw(10)
+      << result.pin_waits << std::setprecision(3) << std::setw(10)
+      << result.seconds << std::endl;
+    std::cout.flags(flags);
+  }
+
+  std::cout.flags(flags);
+  std::cout.precision(precision);
+}
@@ -0,0 +1,92 @@
+#ifndef _SWATDB_BM_REPLAY_H_
+#define  _SWATDB_BM_REPLAY_H_
+
+/**
+ * \file bm_replay.h: replays page access traces recorded by a TraceRecorder
+ * through the replacement policies, to compare their hit rates and I/O
+ * offline
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "swatdb_types.h"
+#include "bufmgr.h"         // PolicyType constants
+#include "bm_trace.h"       // TraceEvent
+
+
+/**
+ * A replacement policy and a buffer pool size to replay a trace with.
+ */
+struct ReplayConfig {
+  PolicyType rep_type;          // replacement policy
+  std::uint32_t pool_size;   // frames of the buffer pool, at most BUF_SIZE
+};
+
+/**
+ * What a trace would have cost with a ReplayConfig.
+ */
+struct ReplayResult {
+  ReplayConfig config;
+  bool valid;                // false if the policy or size is not supported
+  std::uint64_t gets;        // getPage calls replayed
+  std::uint64_t hits;        // getPage calls that found the page resident
+  std::uint64_t misses;      // getPage calls that read the page in
+  std::uint64_t reads;       // pages read
+  std::uint64_t writes;      // dirty pages written back on eviction
+  std::uint64_t evictions;   // pages removed to make room
+  std::uint64_t pin_waits;   // calls turned away, every frame pinned
+  double seconds;            // time the replay took
+};
+
+/**
+ * @brief Replays a trace through the replacement policy of config with a
+ *        buffer pool of config.pool_size frames, and counts what it would
+ *        have cost. The policy runs over a frame table as in
+ *        BasicBufferManager, with the same calls for every getPage,
+ *        releasePage and allocatePage, but no page is read or written, so
+ *        no DiskManager is needed. A pool smaller than BUF_SIZE is made by
+ *        keeping the other frames pinned, which only the policies that do
+ *        not size themselves to BUF_SIZE support (see bm_replay_sized).
+ *        Releases of pages the trace never got, e.g. of a trace started
+ *        mid-run, are ignored.
+ *
+ * @param events The trace, in order.
+ * @param config Policy and pool size.
+ * @return The counts of the replay.
+ *
+ * @throw InvalidPolicyBufMgr If the policy has no implementation,
+ *        pool_size is 0 or above BUF_SIZE, or pool_size is below BUF_SIZE
+ *        for a policy bm_replay_sized is true for.
+ */
+ReplayResult bm_replay(const std::vector<TraceEvent> &events,
+                       const ReplayConfig &config);
+
+/**
+ * @brief Returns true if the policy of the given type derives its targets
+ *        and the number of pages it remembers from BUF_SIZE: CLOCK-Pro's
+ *        cold target, the LIR target of LIRS, S3-FIFO's small queue and
+ *        the shares of PerFile. Frames kept pinned would skew them, so such
+ *        a policy can only be replayed with BUF_SIZE frames.
+ */
+bool bm_replay_sized(PolicyType rep_type);
+
+/**
+ * @brief Replays a trace with every config, num_threads configs at a time.
+ *        The result of a config bm_replay throws for is not valid.
+ *
+ * @param events The trace, in order.
+ * @param configs Policies and pool sizes.
+ * @param num_threads Number of replays run at once, at least 1.
+ * @return The results, in the order of configs.
+ */
+std::vector<ReplayResult> bm_replay_all(
+    const std::vector<TraceEvent> &events,
+    const std::vector<ReplayConfig> &configs, std::uint32_t num_threads);
+
+/**
+ * @brief Prints results as a table, one config a row.
+ */
+void bm_print_replay(const std::vector<ReplayResult> &results);
+
+#endif
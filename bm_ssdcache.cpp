@@ -0,0 +1,335 @@
+/**
+ * @file bm_ssdcache.cpp
+ * @author Nikoloz Khmaladze & Omar Ebied
+ * @date 2025-02-09
+ *
+ * Implementation of the SsdCache class.
+ * Evicted pages are copied into a queue and written to the cache file by a
+ * writer thread, so eviction never waits for the local drive. A page is in
+ * at most one of the queue and the cache file, and the latch is held while
+ * a slot is read, so the writer, which only writes to slots no page maps
+ * to, never overwrites a slot being read.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "bm_ssdcache.h"
+#include "swatdb_exceptions.h"
+#include "bm_exceptions.h"
+#include "page.h"
+
+/**
+ * First word of the index file.
+ */
+static const char *BM_SSD_INDEX_MAGIC = "swatdb-ssd-cache";
+
+
+/**
+ * @brief SsdCache constructor. Opens or creates the cache file with
+ *    num_slots page slots, reads its index if it was closed cleanly with as
+ *    many slots, and starts the writer thread.
+ *
+ * @param path Path of the cache file.
+ * @param num_slots Number of pages the cache file holds.
+ *
+ * @throw InvalidArgumentBufMgr If num_slots is 0.
+ * @throw IOErrorBufMgr If the cache file cannot be opened or sized.
+ */
+SsdCache::SsdCache(const std::string &path, std::uint32_t num_slots)
+  : slot_page(num_slots), slot_used(num_slots, false){
+  if( num_slots == 0 ){
+    throw InvalidArgumentBufMgr();
+  }
+  this->fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if( this->fd < 0 ){
+    throw IOErrorBufMgr(path);
+  }
+  if( ftruncate(this->fd, (off_t)num_slots * PAGE_SIZE) != 0 ){
+    close(this->fd);
+    throw IOErrorBufMgr(path);
+  }
+
+  this->path = path;
+  this->num_slots = num_slots;
+  this->next_slot = 0;
+  this->generation = 0;
+  this->stopping = false;
+  this->writing = false;
+  this->keep_index = true;
+  std::memset(&this->stats, 0, sizeof(this->stats));
+  _loadIndex();
+
+  this->writer = std::thread(&SsdCache::_writerLoop, this);
+}
+
+/**
+ * @brief SsdCache destructor. Writes the pages waiting in the queue, stops
+ *    the writer thread and writes the index, unless discard was called.
+ */
+SsdCache::~SsdCache(){
+  {
+    std::lock_guard<std::mutex> lock(latch);
+    stopping = true;
+  }
+  work.notify_all();
+  writer.join();
+  if( keep_index ){
+    _saveIndex();
+  }
+  close(fd);
+}
+
+/**
+ * @brief Drops every page of the cache, so that the destructor leaves no
+ *    index and the cache file starts empty when it is opened again. The
+ *    writer skips the queued pages, as none is pending any more.
+ */
+void SsdCache::discard(){
+  std::lock_guard<std::mutex> lock(latch);
+  pending.clear();
+  index.clear();
+  slot_used.assign(num_slots, false);
+  keep_index = false;
+}
+
+/**
+ * @brief Queues the page to be written to the cache file, replacing an
+ *    older copy.
+ *
+ * @pre page holds the page of page_id as it is on primary storage.
+ * @post The page is queued, unless BM_SSD_MAX_PENDING pages are, in which
+ *    case no copy of it is left in the cache.
+ */
+void SsdCache::insert(PageId page_id, Page *page){
+  std::lock_guard<std::mutex> lock(latch);
+
+  _unindex(page_id);
+  if( pending.size() >= BM_SSD_MAX_PENDING &&
+      pending.find(page_id) == pending.end() ){
+    stats.dropped++;
+    return;
+  }
+
+  Pending &entry = pending[page_id];
+  entry.data.assign(page->getData(), page->getData() + PAGE_SIZE);
+  entry.generation = ++generation;
+  queue.push_back(std::make_pair(page_id, entry.generation));
+  work.notify_one();
+}
+
+/**
+ * @brief Reads the page from the queue or the cache file into page and
+ *    drops it from the cache.
+ *
+ * @return true if the page was in the cache.
+ */
+bool SsdCache::fetch(PageId page_id, Page *page){
+  std::lock_guard<std::mutex> lock(latch);
+
+  auto queued = pending.find(page_id);
+  if( queued != pending.end() ){
+    std::memcpy(page->getData(), queued->second.data.data(), PAGE_SIZE);
+    pending.erase(queued);
+    stats.hits++;
+    return true;
+  }
+
+  auto cached = index.find(page_id);
+  if( cached == index.end() ){
+    stats.misses++;
+    return false;
+  }
+  ssize_t n = pread(fd, page->getData(), PAGE_SIZE,
+                    (off_t)cached->second * PAGE_SIZE);
+  _unindex(page_id);
+  if( n != (ssize_t)PAGE_SIZE ){
+    stats.misses++;
+    return false;
+  }
+  stats.hits++;
+  return true;
+}
+
+/**
+ * @brief Drops the page from the cache, if it is there.
+ */
+void SsdCache::remove(PageId page_id){
+  std::lock_guard<std::mutex> lock(latch);
+  pending.erase(page_id);
+  _unindex(page_id);
+}
+
+/**
+ * @brief Drops every page of the file from the cache.
+ */
+void SsdCache::removeFile(FileId file_id){
+  std::lock_guard<std::mutex> lock(latch);
+  for( auto it = pending.begin(); it != pending.end(); ){
+    if( it->first.file_id == file_id ){
+      it = pending.erase(it);
+    }
+    else{
+      ++it;
+    }
+  }
+  for( std::uint32_t i = 0; i < num_slots; i++ ){
+    if( slot_used[i] && slot_page[i].file_id == file_id ){
+      _unindex(slot_page[i]);
+    }
+  }
+}
+
+/**
+ * @brief Waits until every queued page is written to the cache file.
+ */
+void SsdCache::drain(){
+  std::unique_lock<std::mutex> lock(latch);
+  idle.wait(lock, [this]{ return queue.empty() && !writing; });
+}
+
+/**
+ * @brief Returns the counters of the cache.
+ */
+SsdCacheStats SsdCache::getStats(){
+  std::lock_guard<std::mutex> lock(latch);
+  SsdCacheStats current = stats;
+  current.resident = index.size();
+  current.pending = pending.size();
+  return current;
+}
+
+/**
+ * @brief Prints the hit rate, writes and use of the cache file.
+ */
+void SsdCache::printStats(){
+  SsdCacheStats current = getStats();
+  std::cout << "SSD cache " << path << ": " << current.hits << " of "
+    << current.hits + current.misses << " misses served, "
+    << current.writes << " pages written, " << current.dropped
+    << " dropped, " << current.resident << " of " << num_slots
+    << " slots used, " << current.pending << " pending" << std::endl;
+}
+
+/**
+ * @brief Body of the writer thread: writes queued pages to slots until
+ *    stopping is set and the queue is empty. The page is copied, so that a
+ *    fetch can still take it from pending while it is written, and is only
+ *    indexed if it was not fetched, removed or replaced in the meantime.
+ */
+void SsdCache::_writerLoop(){
+  std::unique_lock<std::mutex> lock(latch);
+  std::vector<char> data(PAGE_SIZE);
+
+  while( true ){
+    work.wait(lock, [this]{ return stopping || !queue.empty(); });
+    if( queue.empty() ){
+      break;
+    }
+
+    std::pair<PageId, std::uint64_t> entry = queue.front();
+    queue.pop_front();
+    auto it = pending.find(entry.first);
+    if( it == pending.end() || it->second.generation != entry.second ){
+      if( queue.empty() ){
+        idle.notify_all();
+      }
+      continue;
+    }
+    std::memcpy(data.data(), it->second.data.data(), PAGE_SIZE);
+
+    // the oldest page goes, and no page maps to the slot while it is written
+    std::uint32_t slot = next_slot;
+    next_slot = (next_slot + 1) % num_slots;
+    if( slot_used[slot] ){
+      _unindex(slot_page[slot]);
+    }
+
+    writing = true;
+    lock.unlock();
+    ssize_t n = pwrite(fd, data.data(), PAGE_SIZE, (off_t)slot * PAGE_SIZE);
+    lock.lock();
+    writing = false;
+
+    it = pending.find(entry.first);
+    if( it != pending.end() && it->second.generation == entry.second ){
+      pending.erase(it);
+      if( n == (ssize_t)PAGE_SIZE ){
+        index[entry.first] = slot;
+        slot_page[slot] = entry.first;
+        slot_used[slot] = true;
+        stats.writes++;
+      }
+    }
+    if( queue.empty() ){
+      idle.notify_all();
+    }
+  }
+  idle.notify_all();
+}
+
+/**
+ * @brief Frees the slot of the page, if it is in the cache file.
+ *
+ * @pre latch is held.
+ */
+void SsdCache::_unindex(PageId page_id){
+  auto it = index.find(page_id);
+  if( it != index.end() ){
+    slot_used[it->second] = false;
+    index.erase(it);
+  }
+}
+
+/**
+ * @brief Reads the index written when the cache was last closed, and
+ *    removes it, so that a crash leaves no index of pages that may have
+ *    changed. An index of another number of slots, or a damaged one, is
+ *    ignored.
+ */
+void SsdCache::_loadIndex(){
+  std::string index_path = path + ".idx";
+  std::ifstream in(index_path);
+  std::string magic;
+  std::uint32_t slots, next, count;
+
+  if( in >> magic >> slots >> next >> count && magic == BM_SSD_INDEX_MAGIC &&
+      slots == num_slots && next < num_slots ){
+    next_slot = next;
+    for( std::uint32_t i = 0; i < count; i++ ){
+      PageId page_id;
+      std::uint32_t slot;
+      if( !(in >> page_id.file_id >> page_id.page_num >> slot) ||
+          slot >= num_slots || slot_used[slot] ){
+        index.clear();
+        slot_used.assign(num_slots, false);
+        break;
+      }
+      index[page_id] = slot;
+      slot_page[slot] = page_id;
+      slot_used[slot] = true;
+    }
+  }
+  in.close();
+  std::remove(index_path.c_str());
+}
+
+/**
+ * @brief Writes the index of the cache file, after the pages are synced to
+ *    it.
+ */
+void SsdCache::_saveIndex(){
+  fsync(fd);
+  std::ofstream out(path + ".idx");
+  out << BM_SSD_INDEX_MAGIC << " " << num_slots << " " << next_slot << " "
+    << index.size() << "\n";
+  for( auto &entry : index ){
+    out << entry.first.file_id << " " << entry.first.page_num << " "
+      << entry.second << "\n";
+  }
+}
@@ -0,0 +1,259 @@
+#ifndef _SWATDB_BM_SSDCACHE_H_
+#define  _SWATDB_BM_SSDCACHE_H_
+
+/**
+ * \file bm_ssdcache.h: SsdCache class: cache file of evicted pages on fast
+ * local storage, between the buffer pool and the DiskManager
+ */
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "swatdb_types.h"
+#include "bm_buffermap.h"   // BufHash
+
+class Page;
+
+
+/**
+ * Largest number of pages waiting to be written to the cache file. A page
+ * evicted while the writer is this far behind is not cached.
+ */
+static const std::uint32_t BM_SSD_MAX_PENDING = 256;
+
+
+/**
+ * Counters of an SsdCache.
+ */
+struct SsdCacheStats {
+  std::uint64_t hits;       // fetches served from the cache file or queue
+  std::uint64_t misses;     // fetches left to the DiskManager
+  std::uint64_t writes;     // pages written to the cache file
+  std::uint64_t dropped;    // pages not cached because the queue was full
+  std::uint32_t resident;   // pages in the cache file now
+  std::uint32_t pending;    // pages waiting to be written now
+};
+
+
+/**
+ * SwatDB SsdCache Class.
+ * Second level page cache kept in a file on fast local storage, such as an
+ * NVMe drive, for data whose files live on slower storage. Pages evicted
+ * from the buffer pool are handed to a writer thread, which writes them to
+ * slots of the cache file, and a miss in the buffer pool is looked up here
+ * before the DiskManager reads it from primary storage.
+ *
+ * Only pages that are on primary storage as they are handed over, clean or
+ * just written back, are cached, so dirty pages are always written through
+ * and losing the cache file loses nothing. The cache is exclusive: a page
+ * leaves it when it is read back into the buffer pool, so it never holds a
+ * copy that the buffer pool has since changed. Slots are reused in round
+ * robin order, so the cache file is written like a log and the oldest pages
+ * are replaced first.
+ *
+ * The slot index is written next to the cache file, as path + ".idx", when
+ * the cache is closed, and read back when it is opened again, so the cached
+ * pages survive a clean restart. The index is removed while the cache is
+ * open, so after a crash the cache starts empty, and a cache closed with
+ * discard leaves none. The cached pages are only valid if their files are
+ * changed only through buffer managers that use this cache in the
+ * meantime.
+ */
+class SsdCache {
+
+  public:
+
+    /**
+     * @brief SsdCache constructor. Opens or creates the cache file with
+     *        num_slots page slots, reads its index if it was closed cleanly
+     *        with as many slots, and starts the writer thread.
+     *
+     * @param path Path of the cache file.
+     * @param num_slots Number of pages the cache file holds.
+     *
+     * @throw InvalidArgumentBufMgr If num_slots is 0.
+     * @throw IOErrorBufMgr If the cache file cannot be opened or sized.
+     */
+    SsdCache(const std::string &path, std::uint32_t num_slots);
+
+    /**
+     * @brief SsdCache destructor. Writes the pages waiting in the queue,
+     *        stops the writer thread and writes the index, unless discard
+     *        was called.
+     */
+    ~SsdCache();
+
+    /**
+     * @brief Drops every page of the cache, so that the destructor leaves
+     *        no index and the cache file starts empty when it is opened
+     *        again.
+     */
+    void discard();
+
+    /**
+     * @brief Queues the page to be written to the cache file, replacing an
+     *        older copy.
+     *
+     * @pre page holds the page of page_id as it is on primary storage.
+     * @post The page is queued, unless BM_SSD_MAX_PENDING pages are.
+     */
+    void insert(PageId page_id, Page *page);
+
+    /**
+     * @brief Reads the page from the queue or the cache file into page and
+     *        drops it from the cache.
+     *
+     * @return true if the page was in the cache.
+     */
+    bool fetch(PageId page_id, Page *page);
+
+    /**
+     * @brief Drops the page from the cache, if it is there.
+     */
+    void remove(PageId page_id);
+
+    /**
+     * @brief Drops every page of the file from the cache.
+     */
+    void removeFile(FileId file_id);
+
+    /**
+     * @brief Waits until every queued page is written to the cache file.
+     */
+    void drain();
+
+    /**
+     * @brief Returns the counters of the cache.
+     */
+    SsdCacheStats getStats();
+
+    /**
+     * @brief Prints the hit rate, writes and use of the cache file.
+     */
+    void printStats();
+
+  private:
+
+    /**
+     * A page waiting to be written, with the generation of its insert.
+     */
+    struct Pending {
+      std::vector<char> data;
+      std::uint64_t generation;
+    };
+
+    /**
+     * Path of the cache file.
+     */
+    std::string path;
+
+    /**
+     * Unix file descriptor of the cache file.
+     */
+    int fd;
+
+    /**
+     * Number of slots of the cache file.
+     */
+    std::uint32_t num_slots;
+
+    /**
+     * Slot the writer fills next.
+     */
+    std::uint32_t next_slot;
+
+    /**
+     * Maps the PageIds of the pages in the cache file to their slot.
+     */
+    std::unordered_map<PageId, std::uint32_t, BufHash> index;
+
+    /**
+     * Parallel array to the slots of the PageId each holds, valid where
+     * slot_used is set.
+     */
+    std::vector<PageId> slot_page;
+    std::vector<bool> slot_used;
+
+    /**
+     * Pages waiting to be written, and the order they were queued in. An
+     * entry of queue whose generation differs from the one in pending is
+     * stale.
+     */
+    std::unordered_map<PageId, Pending, BufHash> pending;
+    std::deque<std::pair<PageId, std::uint64_t>> queue;
+
+    /**
+     * Generation of the last insert.
+     */
+    std::uint64_t generation;
+
+    /**
+     * Counters.
+     */
+    SsdCacheStats stats;
+
+    /**
+     * Protects every member above.
+     */
+    std::mutex latch;
+
+    /**
+     * Signalled when a page is queued, when the queue empties, and on
+     * shutdown.
+     */
+    std::condition_variable work;
+    std::condition_variable idle;
+
+    /**
+     * Set to stop the writer.
+     */
+    bool stopping;
+
+    /**
+     * Set while the writer is writing a page it took off the queue.
+     */
+    bool writing;
+
+    /**
+     * Cleared by discard, so that the index is not written.
+     */
+    bool keep_index;
+
+    /**
+     * The writer thread.
+     */
+    std::thread writer;
+
+    /**
+     * @brief Body of the writer thread: writes queued pages to slots until
+     *        stopping is set and the queue is empty.
+     */
+    void _writerLoop();
+
+    /**
+     * @brief Frees the slot of the page, if it is in the cache file.
+     *
+     * @pre latch is held.
+     */
+    void _unindex(PageId page_id);
+
+    /**
+     * @brief Reads the index written when the cache was last closed, and
+     *        removes it.
+     */
+    void _loadIndex();
+
+    /**
+     * @brief Writes the index of the cache file.
+     */
+    void _saveIndex();
+};
+
+#endif
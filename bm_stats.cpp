@@ -0,0 +1,99 @@
+/**
+ * @file bm_stats.cpp
+ * @author Nikoloz Khmaladze & Omar Ebied
+ * @date 2025-02-09
+ *
+ * Implementation of the StatCounters class.
+ */
+
+#include <iostream>
+
+#include "bm_stats.h"
+
+
+/**
+ * @brief Adds every counter of stats to total, for buffer managers made of
+ *    several BufferManagers.
+ */
+void bm_add_stats(BufferStats *total, const BufferStats &stats){
+  total->hits += stats.hits;
+  total->misses += stats.misses;
+  total->clean_evictions += stats.clean_evictions;
+  total->dirty_evictions += stats.dirty_evictions;
+  total->reads += stats.reads;
+  total->writes += stats.writes;
+  total->bytes_read += stats.bytes_read;
+  total->bytes_written += stats.bytes_written;
+  total->pin_waits += stats.pin_waits;
+}
+
+/**
+ * @brief Subtracts every counter of stats from total, to get the counters of
+ *    the operations between two snapshots.
+ *
+ * @pre stats is a snapshot of the same buffer manager taken before total.
+ */
+void bm_sub_stats(BufferStats *total, const BufferStats &stats){
+  total->hits -= stats.hits;
+  total->misses -= stats.misses;
+  total->clean_evictions -= stats.clean_evictions;
+  total->dirty_evictions -= stats.dirty_evictions;
+  total->reads -= stats.reads;
+  total->writes -= stats.writes;
+  total->bytes_read -= stats.bytes_read;
+  total->bytes_written -= stats.bytes_written;
+  total->pin_waits -= stats.pin_waits;
+}
+
+/**
+ * @brief Prints every counter of stats, with the hit rate.
+ */
+void bm_print_stats(const BufferStats &stats){
+  std::uint64_t lookups = stats.hits + stats.misses;
+  std::cout << "Number of hits: " << stats.hits << std::endl;
+  std::cout << "Number of misses: " << stats.misses << std::endl;
+  if( lookups > 0 ){
+    std::cout << "Hit rate: " << (double)stats.hits / lookups << std::endl;
+  }
+  std::cout << "Number of clean evictions: " << stats.clean_evictions <<
+    std::endl;
+  std::cout << "Number of dirty evictions: " << stats.dirty_evictions <<
+    std::endl;
+  std::cout << "Pages read: " << stats.reads << " (" << stats.bytes_read <<
+    " bytes)" << std::endl;
+  std::cout << "Pages written: " << stats.writes << " (" <<
+    stats.bytes_written << " bytes)" << std::endl;
+  std::cout << "Number of pin waits: " << stats.pin_waits << std::endl;
+}
+
+
+/**
+ * @brief StatCounters constructor. Every counter starts at 0.
+ */
+StatCounters::StatCounters(){
+  for( Shard &shard : this->shards ){
+    for( std::uint32_t i = 0; i < BM_NUM_STATS; i++ ){
+      shard.counts[i].store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+/**
+ * @brief Returns the counters, summed over the shards. They belong to the
+ *    same moment only if no operation is in progress, e.g. under the latch
+ *    of the buffer manager.
+ */
+BufferStats StatCounters::snapshot() const{
+  std::uint64_t sum[BM_NUM_STATS] = {0};
+
+  for( const Shard &shard : this->shards ){
+    for( std::uint32_t i = 0; i < BM_NUM_STATS; i++ ){
+      sum[i] += shard.counts[i].load(std::memory_order_relaxed);
+    }
+  }
+
+  return BufferStats{sum[StatHits], sum[StatMisses],
+                     sum[StatCleanEvictions], sum[StatDirtyEvictions],
+                     sum[StatReads], sum[StatWrites], sum[StatBytesRead],
+                     sum[StatBytesWritten], sum[StatPinWaits]};
+}
@@ -0,0 +1,139 @@
+#ifndef _SWATDB_BM_STATS_H_
+#define  _SWATDB_BM_STATS_H_
+
+/**
+ * \file bm_stats.h: StatCounters class: always-on hit, miss, eviction and
+ * I/O counters of a buffer manager, and the BufferStats snapshot of them
+ */
+
+#include <atomic>
+#include <cstdint>
+
+
+/**
+ * The counters kept by a StatCounters, indexing StatCounters::counts.
+ */
+enum BufferStat {
+  StatHits,             // getPage calls that found the page resident
+  StatMisses,           // getPage calls that read the page in
+  StatCleanEvictions,   // clean pages removed from the buffer pool
+  StatDirtyEvictions,   // dirty pages written back and removed
+  StatReads,            // pages read through the DiskManager
+  StatWrites,           // pages written through the DiskManager
+  StatBytesRead,        // bytes read through the DiskManager
+  StatBytesWritten,     // bytes written through the DiskManager
+  StatPinWaits,         // calls turned away because every page was pinned
+  BM_NUM_STATS
+};
+
+
+/**
+ * Snapshot of the counters of a buffer manager. Kept next to BufferState,
+ * which describes the buffer pool itself.
+ */
+struct BufferStats {
+  std::uint64_t hits;
+  std::uint64_t misses;
+  std::uint64_t clean_evictions;
+  std::uint64_t dirty_evictions;
+  std::uint64_t reads;
+  std::uint64_t writes;
+  std::uint64_t bytes_read;
+  std::uint64_t bytes_written;
+  std::uint64_t pin_waits;
+};
+
+/**
+ * @brief Adds every counter of stats to total, for buffer managers made of
+ *        several BufferManagers.
+ */
+void bm_add_stats(BufferStats *total, const BufferStats &stats);
+
+/**
+ * @brief Subtracts every counter of stats from total, to get the counters of
+ *        the operations between two snapshots.
+ *
+ * @pre stats is a snapshot of the same buffer manager taken before total.
+ */
+void bm_sub_stats(BufferStats *total, const BufferStats &stats);
+
+/**
+ * @brief Prints every counter of stats, with the hit rate.
+ */
+void bm_print_stats(const BufferStats &stats);
+
+
+/**
+ * Number of shards of a StatCounters. Threads are given shards in the order
+ * they first count, so up to this many threads each bump their own shard.
+ */
+static const std::uint32_t BM_STAT_SHARDS = 64;
+
+/**
+ * @brief Returns the shard of StatCounters of the calling thread, the same
+ *        for every StatCounters.
+ */
+inline std::uint32_t bm_stat_shard(){
+  static std::atomic<std::uint32_t> next_shard(0);
+  thread_local std::uint32_t shard =
+    next_shard.fetch_add(1, std::memory_order_relaxed) % BM_STAT_SHARDS;
+  return shard;
+}
+
+
+/**
+ * SwatDB StatCounters Class.
+ * Counters of one buffer manager, sharded per thread. Each shard sits on
+ * cache lines of its own and is bumped by the threads given it with a
+ * relaxed atomic add, which is a plain add on a line no other thread
+ * writes as long as there are no more than BM_STAT_SHARDS threads, so
+ * threads taking turns on the latch of a buffer manager do not pass the
+ * counters' cache lines back and forth. Buffer managers made of several
+ * BufferManagers, like PartitionedBufferManager and NumaBufferManager, keep
+ * counters per BufferManager and sum them when they are read.
+ *
+ * snapshot() sums the shards. Every counter it returns is exact, but it
+ * takes no lock, so the counters only belong to the same moment, between
+ * two operations, when it is called under the latch of the buffer manager,
+ * or while no operation is in progress.
+ */
+class StatCounters {
+
+  public:
+
+    /**
+     * @brief StatCounters constructor. Every counter starts at 0.
+     */
+    StatCounters();
+
+    /**
+     * @brief Adds n to a counter, in the shard of the calling thread.
+     */
+    void add(BufferStat stat, std::uint64_t n = 1){
+      this->shards[bm_stat_shard()].counts[stat].fetch_add(
+          n, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the counters, summed over the shards. They belong to
+     *        the same moment only if no operation is in progress, e.g. under
+     *        the latch of the buffer manager.
+     */
+    BufferStats snapshot() const;
+
+  private:
+
+    /**
+     * The counters of the threads given a shard, indexed by BufferStat.
+     */
+    struct alignas(64) Shard {
+      std::atomic<std::uint64_t> counts[BM_NUM_STATS];
+    };
+
+    /**
+     * The shards, indexed by bm_stat_shard().
+     */
+    Shard shards[BM_STAT_SHARDS];
+};
+
+#endif
@@ -0,0 +1,171 @@
+/**
+ * @file bm_tinylfu.cpp
+ * @author Nikoloz Khmaladze & Omar Ebied
+ * @date 2025-02-09
+ * 
+ * Implementation of the TinyLfu class.
+ * This file implements the TinyLFU admission filter used by the
+ * BufferManager: a doorkeeper bloom filter and a count-min sketch of recent
+ * page accesses, aged by halving every counter once a sample of accesses is
+ * complete.
+ */
+
+#include <iostream>
+#include <cstring>
+
+#include "bm_tinylfu.h"
+#include "bm_buffermap.h"
+
+/**
+ * @brief Returns the smallest power of 2 that is at least n.
+ */
+static std::uint32_t nextPowerOf2(std::uint32_t n){
+  std::uint32_t p = 1;
+  while(p < n){
+    p <<= 1;
+  }
+  return p;
+}
+
+
+/**
+ * @brief TinyLfu constructor. Sizes the sketch and the doorkeeper for a
+ *    buffer pool of the given number of frames, with a sample of 10
+ *    accesses per frame between agings.
+ *
+ * @param capacity Number of frames of the buffer pool.
+ */
+TinyLfu::TinyLfu(std::uint32_t capacity){
+  this->sample_size = 10 * capacity;
+  this->width = nextPowerOf2(capacity < 16 ? 16 : capacity);
+  // about 8 bits per distinct page of a sample, at most sample_size of them
+  this->doorkeeper_bits = nextPowerOf2(8 * this->sample_size);
+  this->counters.assign(DEPTH * this->width, 0);
+  this->doorkeeper.assign(this->doorkeeper_bits / 64 + 1, 0);
+  this->additions = 0;
+  this->candidates = 0;
+  this->rejections = 0;
+  this->resets = 0;
+}
+
+
+/**
+ * @brief Records one access to the page.
+ *
+ * @post The estimate of page_id is incremented unless its counters are
+ *    saturated. Counters are halved if the sample is complete.
+ */
+void TinyLfu::recordAccess(PageId page_id){
+  std::uint64_t hash = bm_hash64(page_id, HASH_SEED);
+
+  if(!this->_inDoorkeeper(hash)){
+    this->_addDoorkeeper(hash);
+  }
+  else{
+    for(std::uint32_t r = 0; r < DEPTH; r++){
+      std::uint8_t &count = this->counters[this->_index(hash, r)];
+      if(count < MAX_COUNT){
+        count++;
+      }
+    }
+  }
+
+  this->additions++;
+  if(this->additions >= this->sample_size){
+    this->_age();
+  }
+}
+
+
+/**
+ * @brief Returns the estimated number of recent accesses to the page.
+ */
+std::uint32_t TinyLfu::estimate(PageId page_id){
+  std::uint64_t hash = bm_hash64(page_id, HASH_SEED);
+  std::uint32_t min = MAX_COUNT;
+
+  for(std::uint32_t r = 0; r < DEPTH; r++){
+    std::uint32_t count = this->counters[this->_index(hash, r)];
+    if(count < min){
+      min = count;
+    }
+  }
+  if(this->_inDoorkeeper(hash)){
+    min++;
+  }
+  return min;
+}
+
+
+/**
+ * @brief Decides whether a page being read in should replace the page in the
+ *    victim frame.
+ *
+ * @return true if candidate is estimated to be accessed more often than
+ *    victim.
+ */
+bool TinyLfu::admit(PageId candidate, PageId victim){
+  this->candidates++;
+  if(this->estimate(candidate) > this->estimate(victim)){
+    return true;
+  }
+  this->rejections++;
+  return false;
+}
+
+
+/**
+ * @brief Prints the number of admission decisions, rejections and agings.
+ */
+void TinyLfu::printStats(){
+  std::cout << "TinyLFU admission: " << this->rejections << " of "
+    << this->candidates << " candidates bypassed the buffer pool, "
+    << this->resets << " agings" << std::endl;
+}
+
+
+/**
+ * @brief Returns the index in counters of the page's counter in row r.
+ */
+std::uint32_t TinyLfu::_index(std::uint64_t hash, std::uint32_t r){
+  // double hashing: row r probes h1 + r * h2
+  std::uint32_t h1 = (std::uint32_t)hash;
+  std::uint32_t h2 = (std::uint32_t)(hash >> 32) | 1;
+  return r * this->width + ((h1 + r * h2) & (this->width - 1));
+}
+
+
+/**
+ * @brief Returns true if both doorkeeper bits of the hash are set.
+ */
+bool TinyLfu::_inDoorkeeper(std::uint64_t hash){
+  std::uint32_t b1 = (std::uint32_t)hash & (this->doorkeeper_bits - 1);
+  std::uint32_t b2 = (std::uint32_t)(hash >> 32) & (this->doorkeeper_bits - 1);
+  return ((this->doorkeeper[b1 / 64] >> (b1 % 64)) & 1) &&
+         ((this->doorkeeper[b2 / 64] >> (b2 % 64)) & 1);
+}
+
+
+/**
+ * @brief Sets both doorkeeper bits of the hash.
+ */
+void TinyLfu::_addDoorkeeper(std::uint64_t hash){
+  std::uint32_t b1 = (std::uint32_t)hash & (this->doorkeeper_bits - 1);
+  std::uint32_t b2 = (std::uint32_t)(hash >> 32) & (this->doorkeeper_bits - 1);
+  this->doorkeeper[b1 / 64] |= 1ULL << (b1 % 64);
+  this->doorkeeper[b2 / 64] |= 1ULL << (b2 % 64);
+}
+
+
+/**
+ * @brief Halves every counter and clears the doorkeeper.
+ */
+void TinyLfu::_age(){
+  for(std::uint32_t i = 0; i < this->counters.size(); i++){
+    this->counters[i] >>= 1;
+  }
+  std::memset(this->doorkeeper.data(), 0,
+              this->doorkeeper.size() * sizeof(std::uint64_t));
+  this->additions /= 2;
+  this->resets++;
+}
@@ -0,0 +1,153 @@
+#ifndef _SWATDB_BM_TINYLFU_H_
+#define  _SWATDB_BM_TINYLFU_H_
+
+/**
+ * \file bm_tinylfu.h: TinyLFU admission filter for the buffer pool
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "swatdb_types.h"
+
+
+/**
+ * SwatDB TinyLfu Class.
+ * TinyLfu estimates how often each PageId was accessed recently, so that the
+ * buffer manager can refuse to replace a frame with a page that is accessed
+ * less often than the page it would replace. It combines:
+ *   - a doorkeeper, a bloom filter that absorbs the first access to a page so
+ *     that pages accessed once never reach the sketch.
+ *   - a count-min sketch of 4 rows of counters capped at 15, incremented on
+ *     every later access. The estimate is the smallest of the 4 counters.
+ * Every sample_size accesses all counters are halved and the doorkeeper is
+ *   cleared, so that the estimates follow recent frequency.
+ */
+class TinyLfu {
+
+  public:
+
+    /**
+     * @brief TinyLfu constructor. Sizes the sketch and the doorkeeper for a
+     *        buffer pool of the given number of frames, with a sample of 10
+     *        accesses per frame between agings.
+     *
+     * @param capacity Number of frames of the buffer pool.
+     */
+    TinyLfu(std::uint32_t capacity);
+
+    /**
+     * @brief Records one access to the page.
+     *
+     * @post The estimate of page_id is incremented unless its counters are
+     *       saturated. Counters are halved if the sample is complete.
+     */
+    void recordAccess(PageId page_id);
+
+    /**
+     * @brief Returns the estimated number of recent accesses to the page.
+     */
+    std::uint32_t estimate(PageId page_id);
+
+    /**
+     * @brief Decides whether a page being read in should replace the page in
+     *        the victim frame.
+     *
+     * @return true if candidate is estimated to be accessed more often than
+     *         victim.
+     */
+    bool admit(PageId candidate, PageId victim);
+
+    /**
+     * @brief Prints the number of admission decisions, rejections and agings.
+     */
+    void printStats();
+
+  private:
+
+    /**
+     * Number of rows of the count-min sketch.
+     */
+    static const std::uint32_t DEPTH = 4;
+
+    /**
+     * Largest value of a counter.
+     */
+    static const std::uint8_t MAX_COUNT = 15;
+
+    /**
+     * Seed of the hash of the sketch and the doorkeeper. Both take the low
+     *   bits of each half of the hash, the same bits the shards of
+     *   PartitionedBufferManager are picked by, so unsalted every page of a
+     *   shard would share those bits and crowd into a fraction of the
+     *   counters.
+     */
+    static const std::uint64_t HASH_SEED = 1;
+
+    /**
+     * Counters of the sketch, row r occupying [r * width, (r + 1) * width).
+     */
+    std::vector<std::uint8_t> counters;
+
+    /**
+     * Bits of the doorkeeper bloom filter.
+     */
+    std::vector<std::uint64_t> doorkeeper;
+
+    /**
+     * Number of counters in each row, a power of 2.
+     */
+    std::uint32_t width;
+
+    /**
+     * Number of bits in the doorkeeper, a power of 2.
+     */
+    std::uint32_t doorkeeper_bits;
+
+    /**
+     * Number of accesses between agings.
+     */
+    std::uint32_t sample_size;
+
+    /**
+     * Number of accesses recorded since the last aging.
+     */
+    std::uint32_t additions;
+
+    /**
+     * Number of calls to admit.
+     */
+    std::uint64_t candidates;
+
+    /**
+     * Number of calls to admit that returned false.
+     */
+    std::uint64_t rejections;
+
+    /**
+     * Number of agings.
+     */
+    std::uint64_t resets;
+
+    /**
+     * @brief Returns the index in counters of the page's counter in row r.
+     */
+    std::uint32_t _index(std::uint64_t hash, std::uint32_t r);
+
+    /**
+     * @brief Returns true if both doorkeeper bits of the hash are set.
+     */
+    bool _inDoorkeeper(std::uint64_t hash);
+
+    /**
+     * @brief Sets both doorkeeper bits of the hash.
+     */
+    void _addDoorkeeper(std::uint64_t hash);
+
+    /**
+     * @brief Halves every counter and clears the doorkeeper.
+     */
+    void _age();
+};
+
+#endif
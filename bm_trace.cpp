@@ -0,0 +1,292 @@
+/**
+ * @file bm_trace.cpp
+ * @author Nikoloz Khmaladze & Omar Ebied
+ * @date 2025-02-09
+ *
+ * Implementation of the TraceRecorder class and of the reader of its trace
+ * files.
+ * Events are kept raw, with their bm_cycles stamp, while they are buffered,
+ * so that recording one is a few stores. Times are turned into nanoseconds,
+ * and pages into differences, only when a buffer is written out.
+ */
+
+#include <algorithm>
+
+#include "bm_trace.h"
+#include "swatdb_exceptions.h"
+#include "bm_exceptions.h"
+
+/**
+ * First bytes of a trace file.
+ */
+static const char BM_TRACE_MAGIC[8] = {'s', 'w', 'a', 't', 't', 'r', 'c', '1'};
+
+/**
+ * Number of the next TraceRecorder created. 0 is no recorder.
+ */
+static std::atomic<std::uint64_t> bm_trace_next_id(1);
+
+thread_local std::uint64_t TraceRecorder::thread_recorder = 0;
+thread_local TraceRecorder::ThreadBuffer *TraceRecorder::thread_buffer =
+  nullptr;
+
+
+/**
+ * Largest number of bytes of a variable length integer, and of an event.
+ */
+static const std::size_t BM_TRACE_MAX_VARINT = 10;
+static const std::size_t BM_TRACE_MAX_EVENT = 1 + 3 * BM_TRACE_MAX_VARINT;
+
+/**
+ * @brief Writes n at out as a variable length integer: 7 bits a byte, low
+ *    bits first, the top bit set on every byte but the last.
+ *
+ * @return Pointer past the last byte written.
+ */
+static char *_putVarint(char *out, std::uint64_t n){
+  while( n >= 0x80 ){
+    *out++ = (char)(n | 0x80);
+    n >>= 7;
+  }
+  *out++ = (char)n;
+  return out;
+}
+
+/**
+ * @brief Writes a signed difference at out, zigzag encoded so that small
+ *    negative differences are as short as small positive ones.
+ *
+ * @return Pointer past the last byte written.
+ */
+static char *_putDelta(char *out, std::int64_t delta){
+  return _putVarint(out,
+      ((std::uint64_t)delta << 1) ^ (std::uint64_t)(delta >> 63));
+}
+
+/**
+ * @brief Reads a variable length integer written by _putVarint.
+ *
+ * @return false at the end of the file or on a damaged integer.
+ */
+static bool _getVarint(std::istream &in, std::uint64_t *n){
+  *n = 0;
+  for( std::uint32_t shift = 0; shift < 64; shift += 7 ){
+    int byte = in.get();
+    if( byte == EOF ){
+      return false;
+    }
+    *n |= (std::uint64_t)(byte & 0x7f) << shift;
+    if( (byte & 0x80) == 0 ){
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Reads a difference written by _putDelta.
+ */
+static bool _getDelta(std::istream &in, std::int64_t *delta){
+  std::uint64_t n;
+  if( !_getVarint(in, &n) ){
+    return false;
+  }
+  *delta = (std::int64_t)(n >> 1) ^ -(std::int64_t)(n & 1);
+  return true;
+}
+
+
+/**
+ * @brief Reads a trace file written by a TraceRecorder into events, in the
+ *    order they were recorded in across every thread. Each chunk holds the
+ *    events of one thread in order, so the chunks are merged by time,
+ *    keeping the order of events recorded in the same nanosecond.
+ *
+ * @param path Path of the trace file.
+ * @param events Vector the events are appended to.
+ * @return false if the file is missing, is not a trace or is cut short, in
+ *    which case the events read before the damage are kept.
+ */
+bool bm_read_trace(const std::string &path, std::vector<TraceEvent> *events){
+  std::ifstream in(path, std::ios::binary);
+  char magic[sizeof(BM_TRACE_MAGIC)];
+  if( !in.read(magic, sizeof(magic)) ||
+      !std::equal(magic, magic + sizeof(magic), BM_TRACE_MAGIC) ){
+    return false;
+  }
+
+  std::size_t first = events->size();
+  bool intact = true;
+  std::uint64_t thread, count, time;
+  while( _getVarint(in, &thread) ){
+    if( !_getVarint(in, &count) || !_getVarint(in, &time) ){
+      intact = false;
+      break;
+    }
+    std::int64_t file_id = 0, page_num = 0;
+    for( std::uint64_t i = 0; i < count && intact; i++ ){
+      int flags = in.get();
+      std::int64_t dtime, dfile, dpage;
+      if( flags == EOF || !_getDelta(in, &dtime) ||
+          !_getDelta(in, &dfile) || !_getDelta(in, &dpage) ){
+        intact = false;
+        break;
+      }
+      time += dtime;
+      file_id += dfile;
+      page_num += dpage;
+      TraceEvent event;
+      event.time = time;
+      event.page_id.file_id = (FileId)file_id;
+      event.page_id.page_num = (PageNum)page_num;
+      event.thread = (std::uint32_t)thread;
+      event.op = (TraceOp)(flags >> 2);
+      event.hit = (flags & 1) != 0;
+      event.dirty = (flags & 2) != 0;
+      events->push_back(event);
+    }
+    if( !intact ){
+      break;
+    }
+  }
+
+  std::stable_sort(events->begin() + first, events->end(),
+      [](const TraceEvent &a, const TraceEvent &b){ return a.time < b.time; });
+  return intact;
+}
+
+
+/**
+ * @brief TraceRecorder constructor. Creates the trace file and starts the
+ *    clock of the trace.
+ *
+ * @param path Path of the trace file, truncated if it exists.
+ *
+ * @throw IOErrorBufMgr If the trace file cannot be created.
+ */
+TraceRecorder::TraceRecorder(const std::string &path)
+  : out(path, std::ios::binary | std::ios::trunc){
+  if( !this->out.write(BM_TRACE_MAGIC, sizeof(BM_TRACE_MAGIC)) ){
+    throw IOErrorBufMgr(path);
+  }
+  this->ns_per_cycle = 1.0 / bm_cycles_per_ns();
+  this->id = bm_trace_next_id.fetch_add(1);
+  this->start_cycles = bm_cycles();
+  this->num_events.store(0);
+  this->closed = false;
+}
+
+/**
+ * @brief TraceRecorder destructor. Closes the trace.
+ */
+TraceRecorder::~TraceRecorder(){
+  close();
+}
+
+/**
+ * @brief Writes the events of every thread to the file and closes it.
+ *    Calling it again does nothing.
+ *
+ * @pre No thread is recording.
+ * @return false if a write to the file failed.
+ */
+bool TraceRecorder::close(){
+  std::lock_guard<std::mutex> lock(latch);
+  if( closed ){
+    return !out.fail();
+  }
+  for( std::unique_ptr<ThreadBuffer> &buffer : buffers ){
+    std::string chunk;
+    _encode(buffer.get(), &chunk);
+    out.write(chunk.data(), chunk.size());
+  }
+  out.close();
+  closed = true;
+  return !out.fail();
+}
+
+/**
+ * @brief Returns the number of events written to the file so far.
+ */
+std::uint64_t TraceRecorder::getNumEvents(){
+  return num_events.load();
+}
+
+/**
+ * @brief Finds the buffer of the calling thread, creating it on its first
+ *    event, and caches it for the thread.
+ */
+TraceRecorder::ThreadBuffer *TraceRecorder::_addThread(){
+  std::lock_guard<std::mutex> lock(latch);
+  std::thread::id self = std::this_thread::get_id();
+
+  auto it = threads.find(self);
+  if( it == threads.end() ){
+    std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer);
+    buffer->thread = buffers.size();
+    buffer->count = 0;
+    it = threads.emplace(self, buffers.size()).first;
+    buffers.push_back(std::move(buffer));
+  }
+  thread_recorder = id;
+  thread_buffer = buffers[it->second].get();
+  return thread_buffer;
+}
+
+/**
+ * @brief Encodes the events of a buffer as a chunk, appends it to the file
+ *    and empties the buffer. Only the write to the file is done under the
+ *    latch.
+ */
+void TraceRecorder::_flush(ThreadBuffer *buffer){
+  std::string chunk;
+  _encode(buffer, &chunk);
+  std::lock_guard<std::mutex> lock(latch);
+  out.write(chunk.data(), chunk.size());
+}
+
+/**
+ * @brief Encodes the events of a buffer as a chunk into chunk, counts them
+ *    and empties the buffer.
+ */
+void TraceRecorder::_encode(ThreadBuffer *buffer, std::string *chunk){
+  if( buffer->count == 0 ){
+    return;
+  }
+
+  chunk->resize((3 + buffer->count) * BM_TRACE_MAX_EVENT);
+  char *out = &(*chunk)[0];
+  std::uint64_t time = _nanos(buffer->events[0].cycles);
+  out = _putVarint(out, buffer->thread);
+  out = _putVarint(out, buffer->count);
+  out = _putVarint(out, time);
+
+  std::int64_t file_id = 0, page_num = 0;
+  for( std::uint32_t i = 0; i < buffer->count; i++ ){
+    Raw &raw = buffer->events[i];
+    std::uint64_t now = _nanos(raw.cycles);
+    *out++ = (char)raw.flags;
+    out = _putDelta(out, (std::int64_t)(now - time));
+    out = _putDelta(out, (std::int64_t)raw.page_id.file_id - file_id);
+    out = _putDelta(out, (std::int64_t)raw.page_id.page_num - page_num);
+    time = now;
+    file_id = raw.page_id.file_id;
+    page_num = raw.page_id.page_num;
+  }
+  chunk->resize(out - &(*chunk)[0]);
+
+  num_events.fetch_add(buffer->count);
+  buffer->count = 0;
+}
+
+/**
+ * @brief Returns the time of a bm_cycles stamp in nanoseconds since the
+ *    trace was started. A stamp taken on a core whose counter is slightly
+ *    behind the one the trace was started on is taken as the start.
+ */
+std::uint64_t TraceRecorder::_nanos(std::uint64_t cycles){
+  if( cycles < start_cycles ){
+    return 0;
+  }
+  return (cycles - start_cycles) * ns_per_cycle;
+}
@@ -0,0 +1,245 @@
+#ifndef _SWATDB_BM_TRACE_H_
+#define  _SWATDB_BM_TRACE_H_
+
+/**
+ * \file bm_trace.h: TraceRecorder class: records the getPage, releasePage
+ * and allocatePage calls of buffer managers to a compact binary trace file,
+ * for tuning replacement policies offline
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "swatdb_types.h"
+#include "bm_latency.h"     // bm_cycles
+
+
+/**
+ * The calls recorded in a trace.
+ */
+enum TraceOp {
+  TraceGet,        // getPage
+  TraceRelease,    // releasePage
+  TraceAllocate    // allocatePage
+};
+
+/**
+ * One recorded call.
+ */
+struct TraceEvent {
+  std::uint64_t time;      // nanoseconds since the trace was started
+  PageId page_id;          // page of the call
+  std::uint32_t thread;    // recording thread, numbered from 0
+  TraceOp op;              // the call
+  bool hit;                // getPage found the page resident
+  bool dirty;              // releasePage marked the page dirty
+};
+
+/**
+ * Number of events each thread buffers before it writes them to the trace
+ * file.
+ */
+static const std::uint32_t BM_TRACE_BUFFER = 4096;
+
+/**
+ * @brief Reads a trace file written by a TraceRecorder into events, in the
+ *        order they were recorded in across every thread.
+ *
+ * @param path Path of the trace file.
+ * @param events Vector the events are appended to.
+ * @return false if the file is missing, is not a trace or is cut short, in
+ *         which case the events read before the damage are kept.
+ */
+bool bm_read_trace(const std::string &path, std::vector<TraceEvent> *events);
+
+
+/**
+ * SwatDB TraceRecorder Class.
+ * Records the page accesses of one or more buffer managers, given to them
+ * with setTracer, to a trace file. Each recording thread appends fixed-size
+ * events to a buffer of its own, with no lock and no shared cache line, and
+ * stamps them with bm_cycles. A full buffer is encoded and appended to the
+ * file by the thread that filled it, under the only lock of the recorder, so
+ * the cost of the file is spread over BM_TRACE_BUFFER events.
+ *
+ * The trace file starts with a magic word, followed by one chunk per flushed
+ * buffer: the thread, the number of events and the time of the first event,
+ * then for each event its op and flags in one byte and the differences of
+ * its time, file and page number from the event before, as variable length
+ * integers. Scans and repeated accesses to a few hot pages encode to two or
+ * three bytes an event. Chunks of different threads interleave, and
+ * bm_read_trace merges them back by time.
+ */
+class TraceRecorder {
+
+  public:
+
+    /**
+     * @brief TraceRecorder constructor. Creates the trace file and starts
+     *        the clock of the trace.
+     *
+     * @param path Path of the trace file, truncated if it exists.
+     *
+     * @throw IOErrorBufMgr If the trace file cannot be created.
+     */
+    TraceRecorder(const std::string &path);
+
+    /**
+     * @brief TraceRecorder destructor. Closes the trace.
+     */
+    ~TraceRecorder();
+
+    /**
+     * @brief Appends an event to the buffer of the calling thread, writing
+     *        the buffer to the file first if it is full.
+     *
+     * @pre close has not been called.
+     *
+     * @param op The call.
+     * @param page_id Page of the call.
+     * @param hit getPage found the page resident.
+     * @param dirty releasePage marked the page dirty.
+     */
+    void record(TraceOp op, PageId page_id, bool hit = false,
+                bool dirty = false){
+      ThreadBuffer *buffer = _threadBuffer();
+      if( buffer->count == BM_TRACE_BUFFER ){
+        _flush(buffer);
+      }
+      Raw &raw = buffer->events[buffer->count++];
+      raw.cycles = bm_cycles();
+      raw.page_id = page_id;
+      raw.flags = (op << 2) | (hit ? 1 : 0) | (dirty ? 2 : 0);
+    }
+
+    /**
+     * @brief Writes the events of every thread to the file and closes it.
+     *        Calling it again does nothing.
+     *
+     * @pre No thread is recording: every buffer manager recording into it
+     *      has had its tracer unset, or is no longer used.
+     * @return false if a write to the file failed.
+     */
+    bool close();
+
+    /**
+     * @brief Returns the number of events written to the file so far.
+     */
+    std::uint64_t getNumEvents();
+
+  private:
+
+    /**
+     * An event as it is buffered, before its time is converted.
+     */
+    struct Raw {
+      std::uint64_t cycles;
+      PageId page_id;
+      std::uint8_t flags;
+    };
+
+    /**
+     * Buffer of one recording thread, only ever touched by that thread
+     * until close.
+     */
+    struct ThreadBuffer {
+      std::uint32_t thread;
+      std::uint32_t count;
+      Raw events[BM_TRACE_BUFFER];
+    };
+
+    /**
+     * Number of the recorder, so that a thread never takes a recorder
+     * created at the address of a destroyed one for it.
+     */
+    std::uint64_t id;
+
+    /**
+     * bm_cycles when the trace was started.
+     */
+    std::uint64_t start_cycles;
+
+    /**
+     * Nanoseconds a bm_cycle lasts.
+     */
+    double ns_per_cycle;
+
+    /**
+     * The trace file.
+     */
+    std::ofstream out;
+
+    /**
+     * Buffers of every thread that recorded, indexed by thread number.
+     */
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+    /**
+     * Maps the recording threads to their thread number.
+     */
+    std::unordered_map<std::thread::id, std::uint32_t> threads;
+
+    /**
+     * Number of events written.
+     */
+    std::atomic<std::uint64_t> num_events;
+
+    /**
+     * Set once close has run.
+     */
+    bool closed;
+
+    /**
+     * Protects out, buffers, threads and closed.
+     */
+    std::mutex latch;
+
+    /**
+     * Recorder whose buffer the calling thread used last, and that buffer.
+     */
+    static thread_local std::uint64_t thread_recorder;
+    static thread_local ThreadBuffer *thread_buffer;
+
+    /**
+     * @brief Returns the buffer of the calling thread.
+     */
+    ThreadBuffer *_threadBuffer(){
+      if( thread_recorder == this->id ){
+        return thread_buffer;
+      }
+      return _addThread();
+    }
+
+    /**
+     * @brief Finds the buffer of the calling thread, creating it on its
+     *        first event, and caches it for the thread.
+     */
+    ThreadBuffer *_addThread();
+
+    /**
+     * @brief Encodes the events of a buffer as a chunk, appends it to the
+     *        file and empties the buffer.
+     */
+    void _flush(ThreadBuffer *buffer);
+
+    /**
+     * @brief Encodes the events of a buffer as a chunk into chunk, counts
+     *        them and empties the buffer.
+     */
+    void _encode(ThreadBuffer *buffer, std::string *chunk);
+
+    /**
+     * @brief Returns the time of a bm_cycles stamp in nanoseconds since the
+     *        trace was started.
+     */
+    std::uint64_t _nanos(std::uint64_t cycles);
+};
+
+#endif
@@ -0,0 +1,303 @@
+/**
+ * @file bm_workload.cpp
+ * @author Nikoloz Khmaladze & Omar Ebied
+ * @date 2025-02-09
+ *
+ * Implementation of the Workload class and of running a workload through a
+ * BufferManager.
+ * The Zipf draw is the one of Gray et al., "Quickly Generating Billion-Record
+ * Synthetic Databases" (SIGMOD '94), as in the ZipfianGenerator of YCSB.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+#include "bm_workload.h"
+#include "bufmgr.h"
+#include "swatdb_exceptions.h"
+#include "bm_exceptions.h"
+
+/**
+ * Names of the patterns, indexed by WorkloadType.
+ */
+static const char *BM_WORKLOAD_STRS[BM_NUM_WORKLOADS] = {"uniform", "zipf",
+  "hotspot", "latest", "scan", "loop"};
+
+/**
+ * Primes, below 2^32, tried in order as the multiplier of the permutation
+ * of Zipf ranks to pages.
+ */
+static const std::uint64_t BM_WORKLOAD_PRIMES[] = {2654435761ULL,
+  2246822519ULL, 3266489917ULL};
+
+
+/**
+ * @brief Returns the name of the pattern, as parsed by bm_parse_workload.
+ */
+std::string bm_workload_str(WorkloadType type){
+  return BM_WORKLOAD_STRS[type];
+}
+
+/**
+ * @brief Returns the parameters of the pattern with the defaults of YCSB:
+ *    theta 0.99, 20% of the pages getting 80% of the accesses, scans of 100
+ *    pages starting at 5% of the accesses, and reads only.
+ */
+WorkloadConfig bm_default_workload(WorkloadType type){
+  return WorkloadConfig{type, 0.99, 0.2, 0.8, 0.05, 100, 0.0, 1};
+}
+
+/**
+ * @brief Parses a workload of the form name[:param[:param]], e.g. zipf:0.9,
+ *    hotspot:0.1:0.9 or scan:0.05:64, the parameters in the order of
+ *    WorkloadConfig and the others left at their defaults.
+ *
+ * @param spec The workload.
+ * @param config Set to the parsed parameters.
+ * @return false if spec is not a workload.
+ */
+bool bm_parse_workload(const std::string &spec, WorkloadConfig *config){
+  std::vector<std::string> fields;
+  std::stringstream in(spec);
+  std::string field;
+  while( std::getline(in, field, ':') ){
+    fields.push_back(field);
+  }
+  if( fields.empty() ){
+    return false;
+  }
+
+  std::vector<double> params;
+  for( std::size_t i = 1; i < fields.size(); i++ ){
+    char *end;
+    params.push_back(std::strtod(fields[i].c_str(), &end));
+    if( fields[i].empty() || *end != '\0' ){
+      return false;
+    }
+  }
+
+  for( int i = 0; i < BM_NUM_WORKLOADS; i++ ){
+    if( fields[0] != BM_WORKLOAD_STRS[i] ){
+      continue;
+    }
+    *config = bm_default_workload((WorkloadType)i);
+    switch( i ){
+      case WorkloadZipf:
+      case WorkloadLatest:
+        if( params.size() > 1 ){
+          return false;
+        }
+        if( params.size() > 0 ){
+          config->theta = params[0];
+        }
+        return true;
+      case WorkloadHotspot:
+        if( params.size() > 2 ){
+          return false;
+        }
+        if( params.size() > 0 ){
+          config->hot_fraction = params[0];
+        }
+        if( params.size() > 1 ){
+          config->hot_probability = params[1];
+        }
+        return true;
+      case WorkloadScanMix:
+        if( params.size() > 2 ){
+          return false;
+        }
+        if( params.size() > 0 ){
+          config->scan_fraction = params[0];
+        }
+        if( params.size() > 1 ){
+          config->scan_length = params[1];
+        }
+        return true;
+      default:
+        return params.empty();
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Runs num_ops accesses of workload through buf_mgr, each a getPage
+ *    and a releasePage, dirty if the access writes.
+ *
+ * @pre Every page of the workload is allocated, and no page is pinned by
+ *    another caller of buf_mgr.
+ *
+ * @param buf_mgr The buffer manager.
+ * @param workload The workload, advanced by num_ops accesses.
+ * @param num_ops Number of accesses.
+ * @return The counters of buf_mgr over the run and its time.
+ */
+WorkloadResult bm_run_workload(BufferManager *buf_mgr, Workload &workload,
+                               std::uint64_t num_ops){
+  WorkloadResult result;
+  BufferStats before = buf_mgr->getBufferStats();
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+
+  for( std::uint64_t i = 0; i < num_ops; i++ ){
+    WorkloadAccess access = workload.next();
+    buf_mgr->getPage(access.page_id);
+    buf_mgr->releasePage(access.page_id, access.write);
+  }
+
+  result.seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  result.ops = num_ops;
+  result.stats = buf_mgr->getBufferStats();
+  bm_sub_stats(&result.stats, before);
+  return result;
+}
+
+
+/**
+ * @brief Workload constructor.
+ *
+ * @param config The pattern and its parameters.
+ * @param files The pages of each file of the page space.
+ *
+ * @throw InvalidArgumentBufMgr If the page space is empty, or a parameter
+ *    is out of range.
+ */
+Workload::Workload(const WorkloadConfig &config,
+                   const std::vector<std::vector<PageId>> &files)
+  : config(config), uniform(0.0, 1.0){
+  for( const std::vector<PageId> &file : files ){
+    this->pages.insert(this->pages.end(), file.begin(), file.end());
+  }
+  if( this->pages.empty() || config.type >= BM_NUM_WORKLOADS ||
+      config.theta < 0 || config.theta >= 1 ||
+      config.hot_fraction <= 0 || config.hot_fraction > 1 ||
+      config.hot_probability < 0 || config.hot_probability > 1 ||
+      config.scan_fraction < 0 || config.scan_fraction > 1 ||
+      config.scan_length == 0 ||
+      config.write_fraction < 0 || config.write_fraction > 1 ){
+    throw InvalidArgumentBufMgr();
+  }
+
+  std::uint64_t n = this->pages.size();
+  this->zeta_n = 0;
+  for( std::uint64_t i = 1; i <= n; i++ ){
+    this->zeta_n += 1.0 / std::pow((double)i, config.theta);
+  }
+  this->zeta_2 = 1.0 + std::pow(0.5, config.theta);
+  this->alpha = 1.0 / (1.0 - config.theta);
+  // with 1 or 2 pages the first two cases of _zipf cover every draw
+  this->eta = n <= 2 ? 0 : (1.0 - std::pow(2.0 / n, 1.0 - config.theta)) /
+                           (1.0 - this->zeta_2 / this->zeta_n);
+
+  for( std::uint64_t prime : BM_WORKLOAD_PRIMES ){
+    this->scramble = prime;
+    if( n % prime != 0 ){
+      break;
+    }
+  }
+  reseed(config.seed);
+}
+
+/**
+ * @brief Returns the next access.
+ */
+WorkloadAccess Workload::next(){
+  WorkloadAccess access;
+  access.page_id = pages[_nextIndex()];
+  access.write = config.write_fraction > 0 &&
+                 uniform(rng) < config.write_fraction;
+  return access;
+}
+
+/**
+ * @brief Restarts the random number generator from seed, and any scan or
+ *    loop from the start.
+ */
+void Workload::reseed(std::uint64_t seed){
+  this->config.seed = seed;
+  this->rng.seed(seed);
+  this->scan_next = 0;
+  this->scan_left = 0;
+}
+
+/**
+ * @brief Returns the number of pages of the page space.
+ */
+std::uint32_t Workload::getNumPages(){
+  return pages.size();
+}
+
+/**
+ * @brief Returns the parameters of the workload.
+ */
+WorkloadConfig Workload::getConfig(){
+  return config;
+}
+
+/**
+ * @brief Returns a Zipf distributed rank in [0, number of pages), 0 the most
+ *    likely.
+ */
+std::uint32_t Workload::_zipf(){
+  double u = uniform(rng);
+  double uz = u * zeta_n;
+  if( uz < 1.0 ){
+    return 0;
+  }
+  if( uz < zeta_2 ){
+    return 1;
+  }
+  std::uint64_t rank = pages.size() * std::pow(eta * u - eta + 1, alpha);
+  return rank < pages.size() ? rank : pages.size() - 1;
+}
+
+/**
+ * @brief Returns a uniform index in [0, n).
+ */
+std::uint32_t Workload::_uniform(std::uint32_t n){
+  return rng() % n;
+}
+
+/**
+ * @brief Returns the index in pages of the next access of the pattern.
+ */
+std::uint32_t Workload::_nextIndex(){
+  std::uint32_t n = pages.size();
+  std::uint32_t index;
+
+  switch( config.type ){
+    case WorkloadZipf:
+      return (_zipf() * scramble) % n;
+    case WorkloadHotspot: {
+      std::uint32_t hot = std::max(1.0, config.hot_fraction * n);
+      if( hot >= n || uniform(rng) < config.hot_probability ){
+        return _uniform(hot);
+      }
+      return hot + _uniform(n - hot);
+    }
+    case WorkloadLatest:
+      return n - 1 - _zipf();
+    case WorkloadScanMix:
+      if( scan_left == 0 ){
+        if( uniform(rng) >= config.scan_fraction ){
+          return (_zipf() * scramble) % n;
+        }
+        scan_next = _uniform(n);
+        scan_left = config.scan_length;
+      }
+      scan_left--;
+      index = scan_next;
+      scan_next = (scan_next + 1) % n;
+      return index;
+    case WorkloadLoop:
+      index = scan_next;
+      scan_next = (scan_next + 1) % n;
+      return index;
+    default:
+      return _uniform(n);
+  }
+}
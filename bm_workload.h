@@ -0,0 +1,210 @@
+#ifndef _SWATDB_BM_WORKLOAD_H_
+#define  _SWATDB_BM_WORKLOAD_H_
+
+/**
+ * \file bm_workload.h: Workload class: YCSB-style generators of page
+ * accesses over the pages of one or more files, for benchmarking the
+ * replacement policies and pool sizes
+ */
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "swatdb_types.h"
+#include "bm_stats.h"       // BufferStats
+
+class BufferManager;
+class Workload;
+
+
+/**
+ * Access patterns a Workload generates.
+ */
+enum WorkloadType {
+  WorkloadUniform,   // every page equally likely
+  WorkloadZipf,      // Zipf over the pages in a scrambled order
+  WorkloadHotspot,   // hot_probability of the accesses to hot_fraction of
+                     // the pages, the first ones of the space
+  WorkloadLatest,    // Zipf over the pages from the last one back, the
+                     // pages allocated last being the hottest
+  WorkloadScanMix,   // Zipf point accesses, with scan_fraction of them
+                     // starting a sequential scan of scan_length pages
+  WorkloadLoop,      // every page in order, over and over
+  BM_NUM_WORKLOADS
+};
+
+/**
+ * Parameters of a Workload. Each pattern only reads its own.
+ */
+struct WorkloadConfig {
+  WorkloadType type;
+  double theta;               // Zipf skew, in [0, 1); YCSB uses 0.99
+  double hot_fraction;        // Hotspot: fraction of the pages that is hot
+  double hot_probability;     // Hotspot: fraction of accesses that are hot
+  double scan_fraction;       // ScanMix: fraction of accesses starting a scan
+  std::uint32_t scan_length;  // ScanMix: pages of a scan
+  double write_fraction;      // fraction of accesses that dirty the page
+  std::uint64_t seed;         // seed of the random number generator
+};
+
+/**
+ * One access of a Workload.
+ */
+struct WorkloadAccess {
+  PageId page_id;
+  bool write;                 // the page is released dirty
+};
+
+/**
+ * What running a Workload through a BufferManager did.
+ */
+struct WorkloadResult {
+  std::uint64_t ops;          // getPage/releasePage pairs
+  BufferStats stats;          // counters of the buffer manager over the run
+  double seconds;             // time the run took
+};
+
+/**
+ * @brief Returns the name of the pattern, as parsed by bm_parse_workload.
+ */
+std::string bm_workload_str(WorkloadType type);
+
+/**
+ * @brief Returns the parameters of the pattern with the defaults of YCSB:
+ *        theta 0.99, 20% of the pages getting 80% of the accesses, scans of
+ *        100 pages starting at 5% of the accesses, and reads only.
+ */
+WorkloadConfig bm_default_workload(WorkloadType type);
+
+/**
+ * @brief Parses a workload of the form name[:param[:param]], e.g. zipf:0.9,
+ *        hotspot:0.1:0.9 or scan:0.05:64, the parameters in the order of
+ *        WorkloadConfig and the others left at their defaults.
+ *
+ * @param spec The workload.
+ * @param config Set to the parsed parameters.
+ * @return false if spec is not a workload.
+ */
+bool bm_parse_workload(const std::string &spec, WorkloadConfig *config);
+
+/**
+ * @brief Runs num_ops accesses of workload through buf_mgr, each a getPage
+ *        and a releasePage, dirty if the access writes.
+ *
+ * @pre Every page of the workload is allocated, and no page is pinned by
+ *      another caller of buf_mgr.
+ *
+ * @param buf_mgr The buffer manager.
+ * @param workload The workload, advanced by num_ops accesses.
+ * @param num_ops Number of accesses.
+ * @return The counters of buf_mgr over the run and its time.
+ */
+WorkloadResult bm_run_workload(BufferManager *buf_mgr, Workload &workload,
+                               std::uint64_t num_ops);
+
+
+/**
+ * SwatDB Workload Class.
+ * Generates page accesses with one of the patterns of YCSB and of the
+ * buffer pool literature, over a page space made of the pages of one or more
+ * files, concatenated in order. Zipf ranks are drawn with the method of Gray
+ * et al. used by YCSB, in O(1) per access after an O(n) setup, and mapped
+ * to pages by a fixed permutation, so that the hot pages are spread over
+ * the files and over the shards of a PartitionedBufferManager. Copies of a
+ * Workload reseeded differently draw independent accesses from the same
+ * distribution, e.g. one per thread, without repeating the setup.
+ */
+class Workload {
+
+  public:
+
+    /**
+     * @brief Workload constructor.
+     *
+     * @param config The pattern and its parameters.
+     * @param files The pages of each file of the page space.
+     *
+     * @throw InvalidArgumentBufMgr If the page space is empty, or a
+     *        parameter is out of range.
+     */
+    Workload(const WorkloadConfig &config,
+             const std::vector<std::vector<PageId>> &files);
+
+    /**
+     * @brief Returns the next access.
+     */
+    WorkloadAccess next();
+
+    /**
+     * @brief Restarts the random number generator from seed, and any scan
+     *        or loop from the start.
+     */
+    void reseed(std::uint64_t seed);
+
+    /**
+     * @brief Returns the number of pages of the page space.
+     */
+    std::uint32_t getNumPages();
+
+    /**
+     * @brief Returns the parameters of the workload.
+     */
+    WorkloadConfig getConfig();
+
+  private:
+
+    WorkloadConfig config;
+
+    /**
+     * The page space.
+     */
+    std::vector<PageId> pages;
+
+    /**
+     * Random number generator and the uniform [0, 1) draw.
+     */
+    std::mt19937_64 rng;
+    std::uniform_real_distribution<double> uniform;
+
+    /**
+     * Constants of the Zipf draw of Gray et al.: zeta(n, theta), zeta(2,
+     * theta), 1 / (1 - theta) and eta.
+     */
+    double zeta_n;
+    double zeta_2;
+    double alpha;
+    double eta;
+
+    /**
+     * Multiplier of the permutation of Zipf ranks to pages, coprime with the
+     * number of pages.
+     */
+    std::uint64_t scramble;
+
+    /**
+     * Next page of the scan in progress and pages left in it, or of the
+     * loop.
+     */
+    std::uint32_t scan_next;
+    std::uint32_t scan_left;
+
+    /**
+     * @brief Returns a Zipf distributed rank in [0, number of pages), 0 the
+     *        most likely.
+     */
+    std::uint32_t _zipf();
+
+    /**
+     * @brief Returns a uniform index in [0, n).
+     */
+    std::uint32_t _uniform(std::uint32_t n);
+
+    /**
+     * @brief Returns the index in pages of the next access of the pattern.
+     */
+    std::uint32_t _nextIndex();
+};
+
+#endif
@@ -9,14 +9,28 @@
  * allocation, deallocation, retrieval, and replacement, interacting with
  * the DiskManager for disk I/O and using a ReplacementPolicy to determine
  * which pages to evict.  This file defines the methods declared in bufmgr.h.
+ * BasicBufferManager is explicitly instantiated here for every policy that
+ * BufferManager can be constructed with.
  */
 
+#include <new>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
 #include "bufmgr.h"
+#include "bm_memory.h"
+#include "bm_mmap.h"
+#include "bm_ccache.h"
+#include "bm_ssdcache.h"
+#include "bm_metrics.h"
+#include "bm_trace.h"
 #include "bm_frame.h"
 #include "bm_buffermap.h"
 #include "bm_policies.h"
 #include "bm_replacement.h"
 #include "swatdb_exceptions.h"
+#include "bm_exceptions.h"
 #include "diskmgr.h"
 #include "file.h"
 #include "page.h"
@@ -25,60 +39,135 @@
 
 
 /**
- * SwatDb BufferManager Class.
- * BufferManager manages in memory space of DBMS at page level granularity.
- * At higher level, pages of data could be allocated, deallocated, retrieved
- * to memory and fliushed to disk, using various methods.
+ * First word of a dump of the resident pages.
+ */
+static const char *BM_DUMP_MAGIC = "swatdb-resident-pages";
+
+/**
+ * Printable names of the replacement policy types declared in bufmgr.h,
+ * starting with the one numbered INVALID_REP_TYPE + 1.
+ */
+static const char *bm_ext_rep_strs[] = {"GClock", "ClockPro", "Lirs", "Sieve",
+                                         "S3Fifo", "PerFile", "LruK"};
+
+/**
+ * @brief Returns the printable name of a replacement policy type, including
+ *    the types declared in bufmgr.h that bm_rep_strs does not know about.
+ */
+std::string bm_rep_str(PolicyType rep_type){
+  if(rep_type < 0){
+    return bm_rep_strs[INVALID_REP_TYPE];
+  }
+  if(rep_type <= INVALID_REP_TYPE){
+    return bm_rep_strs[rep_type];
+  }
+  std::uint32_t ext = rep_type - INVALID_REP_TYPE - 1;
+  if(ext < sizeof(bm_ext_rep_strs) / sizeof(bm_ext_rep_strs[0])){
+    return bm_ext_rep_strs[ext];
+  }
+  return bm_rep_strs[INVALID_REP_TYPE];
+}
+
+/**
+ * @brief Adds the page counts and replacement calls of state to total, for
+ *    buffer managers made of several BufferManagers. avg_frames_checked is
+ *    weighted by the replacement calls of both, and total keeps its rep_type
+ *    and clock_hand.
+ */
+void bm_add_state(BufferState *total, const BufferState &state){
+  std::uint64_t rep_calls = total->replace_stats.rep_calls +
+                            state.replace_stats.rep_calls;
+  if( rep_calls > 0 ){
+    total->replace_stats.avg_frames_checked =
+      (total->replace_stats.avg_frames_checked *
+         total->replace_stats.rep_calls +
+       state.replace_stats.avg_frames_checked *
+         state.replace_stats.rep_calls) / rep_calls;
+  }
+  total->total += state.total;
+  total->valid += state.valid;
+  total->pinned += state.pinned;
+  total->unpinned += state.unpinned;
+  total->dirty += state.dirty;
+  total->replace_stats.rep_calls = rep_calls;
+  total->replace_stats.new_page_calls += state.replace_stats.new_page_calls;
+  total->replace_stats.ref_bit += state.replace_stats.ref_bit;
+}
+
+
+/**
+ * SwatDB BasicBufferManager Class.
+ * Buffer manager whose replacement policy is fixed at compile time. The
+ * policy is held by value, so its pin and unpin hooks are called directly.
  */
 
 /**
- * @brief BufferManager constructor. Initializes the buf_pool and
- *    frame_table, and stores a pointer to SwatDB's DiskManager.
+ * @brief BasicBufferManager constructor. Initializes the buf_pool,
+ *    frame_table and replacement policy, and stores a pointer to SwatDB's
+ *    DiskManager.
  *
  * @pre disk_mgr points to an initialized DiskManager object.
- * @post A BufferManager object will be initialized with an empty
- *    buffer pool. disk_mgr is set to the given DiskManager* and
- *    clock_hand is set to 0.
+ * @post A BasicBufferManager object will be initialized with an empty
+ *    buffer pool.
  *
  * @param disk_mgr A pointer to SwatDB's DiskManager object.
  *    (DiskManager*).
- *
- * @throw InvalidPolicyBufMgr If the replacement policy type is invalid. 
  */
-BufferManager::BufferManager(DiskManager *disk_mgr, RepType rep_type){
-  
-  this->disk_mgr = disk_mgr;
-  switch(rep_type) {
-    case ClockT:{
-      this->replacement_pol = new Clock(this->frame_table);
-      break; }
-    case RandomT: {
-      this->replacement_pol = new Random(this->frame_table);
-      break; }
-
+template <class Policy>
+BasicBufferManager<Policy>::BasicBufferManager(DiskManager *disk_mgr)
+  : policy(this->frame_table){
 
-    default:
-      throw InvalidPolicyBufMgr(); // no replacement policy defined
+  this->disk_mgr = disk_mgr;
+  this->admission = nullptr;
+  this->mapped = nullptr;
+  this->ccache = nullptr;
+  this->ssd_cache = nullptr;
+  this->warm_next = 0;
+  this->dump_interval = 0;
+  this->dump_misses = 0;
+  this->latency_every = 0;
+  this->tracer = nullptr;
+  this->mrc = nullptr;
+  for (FrameId i = 0; i < BUF_SIZE; ++i) {
+    this->frame_hint[i] = NoHint;
   }
 }
 
 /**
- * @brief BufferManager destructor.
+ * @brief BasicBufferManager destructor.
  *
  * @pre None.
- * @post Every valid and dirty Page in buffer pool is written to disk.
+ * @post Every valid and dirty Page in buffer pool and in the bypass area is
+ *    written to disk. The resident pages are dumped if automatic dumps are
+ *    on.
  */
-BufferManager::~BufferManager(){
+template <class Policy>
+BasicBufferManager<Policy>::~BasicBufferManager(){
+  if( !dump_path.empty() ){
+    try{
+      dumpResidentPages(dump_path);
+    }catch (IOErrorBufMgr &e){
+    }
+  }
   for (FrameId i = 0; i < BUF_SIZE; ++i) {
     if (frame_table[i].valid && frame_table[i].dirty) {
-      disk_mgr->writePage(frame_table[i].page_id, &buf_pool[i]);
+      _writePage(frame_table[i].page_id, &buf_pool[i]);
       frame_table[i].dirty = false;
     }
   }
-  delete replacement_pol;  // Don't forget to delete the replacement policy!
+  for (std::uint32_t i = 0; i < BM_BYPASS_SIZE; ++i) {
+    if (bypass_table[i].valid && bypass_table[i].dirty) {
+      _writePage(bypass_table[i].page_id, &bypass_pool[i]);
+    }
+  }
+  delete admission;
+  delete mapped;
+  delete ccache;
+  delete ssd_cache;
+  delete mrc;
 }
 
-  /**
+/**
  * @brief Allocates a Page for the file of given FileId. The Page is
  *    allocated both in the buffer pool, and on disk.
  *
@@ -99,15 +188,70 @@ BufferManager::~BufferManager(){
  *    pool.
  * @throw InsufficientSpaceDiskMgr If there is not enough space in the
  *    Unix file.
+ * @throw ReadOnlyFileBufMgr If the file is mapped, and so read-only.
  */
-std::pair<Page*, PageId> BufferManager::allocatePage(FileId file_id){
+template <class Policy>
+std::pair<Page*, PageId> BasicBufferManager<Policy>::allocatePage(
+    FileId file_id){
+  if( mapped != nullptr && mapped->contains(file_id) ){
+    throw ReadOnlyFileBufMgr(file_id);
+  }
+
+  policy.incrementGetAllocCount();
   BufferState state = getBufferState();
   if(state.unpinned == 0){
+    stats.add(StatPinWaits);
     throw InsufficientSpaceBufMgr();
   }
 
   PageId page_id = disk_mgr->allocatePage(file_id); 
-  FrameId frame_id = _allocateFrame();
+  return std::pair<Page*, PageId>(_install(page_id), page_id);
+}
+
+/**
+ * @brief Puts a Page the caller has just allocated on disk in the buffer
+ *    pool, pinned, without reading it from disk.
+ *
+ * @pre page_id was just allocated through the DiskManager and is not in the
+ *    buffer pool.
+ * @post A Frame holds the Page, with pin_count 1 and dirty false.
+ *
+ * @param page_id PageId of the allocated Page.
+ * @return Pointer to the Page in the buffer pool.
+ *
+ * @throw PageAlreadyLoadedBufMgr If the Page is in the buffer pool.
+ * @throw InsufficientSpaceBufMgr If there is not enough space in buffer
+ *    pool.
+ * @throw ReadOnlyFileBufMgr If the file is mapped, and so read-only.
+ */
+template <class Policy>
+Page* BasicBufferManager<Policy>::installPage(PageId page_id){
+  if( mapped != nullptr && mapped->contains(page_id.file_id) ){
+    throw ReadOnlyFileBufMgr(page_id.file_id);
+  }
+
+  policy.incrementGetAllocCount();
+  if( buf_map.contains(page_id) || bypass_map.contains(page_id) ){
+    throw PageAlreadyLoadedBufMgr(page_id);
+  }
+  BufferState state = getBufferState();
+  if(state.unpinned == 0){
+    stats.add(StatPinWaits);
+    throw InsufficientSpaceBufMgr();
+  }
+  return _install(page_id);
+}
+
+/**
+ * @brief Puts a page just allocated on disk in a Frame, pinned, without
+ *    reading it.
+ *
+ * @pre The buffer pool has an unpinned Frame, and page_id is not in it.
+ * @return Pointer to the Page in the buffer pool.
+ */
+template <class Policy>
+Page* BasicBufferManager<Policy>::_install(PageId page_id){
+  FrameId frame_id = _allocateFrame(page_id);
   
   Frame &frame = frame_table[frame_id];
   frame.page_id = page_id;
@@ -116,11 +260,12 @@ std::pair<Page*, PageId> BufferManager::allocatePage(FileId file_id){
   frame.dirty = false;
 
   buf_map.insert( page_id, frame_id );
-  replacement_pol->pin( frame_id );
-
-  Page *ptr = &(buf_pool[frame_id]);
+  policy.pin( frame_id );
+  if( tracer != nullptr ){
+    tracer->record(TraceAllocate, page_id);
+  }
 
-  return std::pair<Page*, PageId>(ptr, page_id);
+  return &(buf_pool[frame_id]);
 }
 
 
@@ -129,18 +274,30 @@ std::pair<Page*, PageId> BufferManager::allocatePage(FileId file_id){
  *
  * @pre None.
  * @post A FrameId of an available Frame is returned. If the Frame was
- *       previously valid (containing a Page), the corresponding entry in
- *       buf_map is removed. The Frame's valid, dirty, and pin_count fields
- *       are reset.
+ *       previously valid (containing a Page), the Page is written to disk
+ *       if it is dirty, put in the compressed and SSD caches that are on,
+ *       and the corresponding entry in buf_map is removed. The Frame's valid,
+ *       dirty, and pin_count fields are reset.
  *
+ * @param page_id PageId of the page the Frame is allocated for.
  * @return FrameId of the allocated Frame.
  */
-FrameId BufferManager:: _allocateFrame(){
-  FrameId frame_id = replacement_pol->replace();
+template <class Policy>
+FrameId BasicBufferManager<Policy>::_allocateFrame(PageId page_id){
+  FrameId frame_id = _replaceFor(page_id);
 
   Frame &tmp = frame_table[frame_id];
 
   if( tmp.valid ){
+    stats.add(tmp.dirty ? StatDirtyEvictions : StatCleanEvictions);
+  }
+  // a dirty victim is written back before its frame is reused, or the
+  // page's changes would be lost
+  if( tmp.valid && tmp.dirty ){
+    _writePage(tmp.page_id, &buf_pool[frame_id]);
+  }
+  if( tmp.valid ){
+    _cachePage(tmp.page_id, &buf_pool[frame_id]);
     buf_map.remove( tmp.page_id );
   }
 
@@ -169,7 +326,18 @@ FrameId BufferManager:: _allocateFrame(){
  * @throw InvalidFileIdDiskMgr if page_id.file_id is invalid
  *        (from DiskManager layer)
  */
-void BufferManager::deallocatePage(PageId page_id){
+template <class Policy>
+void BasicBufferManager<Policy>::deallocatePage(PageId page_id){
+
+  if( mapped != nullptr && mapped->contains(page_id.file_id) ){
+    mapped->deallocatePage(page_id);
+    return;
+  }
+
+  // pages in the bypass area are always pinned
+  if( bypass_map.contains( page_id ) ){
+    throw PagePinnedBufMgr(page_id);
+  }
   
   if( buf_map.contains( page_id ) ){
     FrameId frame_id = buf_map.get( page_id );
@@ -183,13 +351,97 @@ void BufferManager::deallocatePage(PageId page_id){
     frame.dirty = false;
     frame.pin_count = 0;
     buf_map.remove(page_id);
-    replacement_pol->freeFrame(frame_id);
+    policy.freeFrame(frame_id);
+  }
+  if( ccache != nullptr ){
+    ccache->remove(page_id);
+  }
+  if( ssd_cache != nullptr ){
+    ssd_cache->remove(page_id);
   }
   
   disk_mgr->deallocatePage(page_id);
  }
 
 
+/**
+ * @brief Reads a page rejected by the admission filter into a free slot of
+ *    the bypass area and hands the frame chosen for replacement back to the
+ *    replacement policy.
+ *
+ * @pre frame_id was just returned by the replacement policy and holds a
+ *    valid, unpinned page.
+ * @post If a slot is free, the page is pinned in it and a pointer to it is
+ *    returned, and frame_id is resident again in the replacement policy.
+ *    Else nullptr is returned and nothing changes.
+ *
+ * @param page_id PageId of the page to read.
+ * @param frame_id FrameId of the frame chosen for replacement.
+ * @return Pointer to the Page in the bypass area, or nullptr.
+ *
+ * @throw InvalidPageIdBufMgr If page_id is not valid.
+ */
+template <class Policy>
+Page* BasicBufferManager<Policy>::_getBypassPage(PageId page_id,
+    FrameId frame_id){
+  std::uint32_t slot = 0;
+  while( slot < BM_BYPASS_SIZE && bypass_table[slot].valid ){
+    slot++;
+  }
+  if( slot == BM_BYPASS_SIZE ){
+    return nullptr;
+  }
+
+  // the policy already let go of the victim: it is put back as it was, not
+  // counted as an access
+  policy.reinstate(frame_id);
+
+  try{
+    _readPage(page_id, &bypass_pool[slot]);
+  }catch (InvalidFileIdDiskMgr &e){
+    throw InvalidPageIdBufMgr(page_id);
+  }catch (InvalidPageNumDiskMgr &e) {
+    throw InvalidPageIdBufMgr(page_id);
+  }
+
+  bypass_table[slot].loadFrame(page_id);
+  bypass_map.insert(page_id, slot);
+  return &bypass_pool[slot];
+}
+
+
+/**
+ * @brief Unpins a page in the bypass area, and drops it, writing it to disk
+ *    first if it is dirty, when its pin count reaches 0.
+ *
+ * @pre page_id is in bypass_map.
+ * @post The pin count of the page is decremented.
+ *
+ * @param page_id PageId of the Page to be released.
+ * @param dirty true if the caller modified the Page.
+ */
+template <class Policy>
+void BasicBufferManager<Policy>::_releaseBypassPage(PageId page_id,
+    bool dirty){
+  std::uint32_t slot = bypass_map.get(page_id);
+  Frame &frame = bypass_table[slot];
+
+  if( dirty ){
+    frame.dirty = true;
+  }
+  frame.pin_count--;
+
+  if( frame.pin_count == 0 ){
+    if( frame.dirty ){
+      _writePage(page_id, &bypass_pool[slot]);
+    }
+    _cachePage(page_id, &bypass_pool[slot]);
+    bypass_map.remove(page_id);
+    frame.resetFrame();
+  }
+}
+
+
 /**
  * @brief Gets Page by page_id, pins the Page, and returns a pointer
  *    to the Page object.
@@ -198,49 +450,126 @@ void BufferManager::deallocatePage(PageId page_id){
  *    pool is not full of pinned pages.
  * @post If the page_id is in buf_map, the Page is pinned and its pointer is
  *    returned. Else, a Frame is allocated in the buffer pool according
- *    to the page replacement policy, the Page is read from disk_mgr into
- *    the buffer pool, and the page_id, pin count, and valid bit are set.
+ *    to the page replacement policy, the Page is read into the buffer pool
+ *    from the compressed or SSD cache if one holds the page, else from
+ *    disk_mgr, and the page_id, pin count, and valid bit are set.
  *    pin_count is incremented by a successful getPage. 
  *    Page* is returned.
  *
  * @param page_id A PageId corresponding to the pointer to be returned.
+ * @param hint How the page will be accessed, applied when the page is
+ *    unpinned unless releasePage gives another hint.
  * @return Pointer to the Page with page_id.
  *
  * @throw InvalidPageIdBufMgr If page_id is not valid.
  * @throw InsufficientSpaceBufMgr If buffer pool is full.
+ * @throw ReadOnlyFileBufMgr If the file is mapped, and so read-only: its
+ *    pages are read with getPageData. Nothing is pinned.
  *
  */
-Page* BufferManager::getPage(PageId page_id) {
+template <class Policy>
+Page* BasicBufferManager<Policy>::getPage(PageId page_id, AccessHint hint) {
+
+  // a Page* into the PROT_READ mapping would fault on the first write
+  if( mapped != nullptr && mapped->contains(page_id.file_id) ){
+    throw ReadOnlyFileBufMgr(page_id.file_id);
+  }
+
+  // whether a call hits is only known once it is timed, so getPage calls
+  // are sampled together, on the countdown of LatGetHit
+  bool timed = _sampleLatency(LatGetHit);
+  std::uint64_t start = timed ? bm_cycles() : 0;
+  policy.incrementGetAllocCount();
+  if( admission != nullptr ){
+    admission->recordAccess(page_id);
+  }
+  if( mrc != nullptr ){
+    mrc->recordAccess(page_id);
+  }
 
   if( buf_map.contains(page_id) ){
     FrameId tmp = buf_map.get(page_id);
     Frame &frame = frame_table[tmp];
+    stats.add(StatHits);
     frame.pin_count++;
+    if( frame.pin_count == 1 ){
+      policy.pin(tmp);
+    }
+    // NoHint keeps the hint of an earlier pinner, as in releasePage
+    if( hint != NoHint ){
+      frame_hint[tmp] = hint;
+    }
+    if( tracer != nullptr ){
+      tracer->record(TraceGet, page_id, true);
+    }
+    if( timed ){
+      latency[LatGetHit].record(bm_cycles() - start);
+    }
     return &buf_pool[tmp];
   }
 
+  if( bypass_map.contains(page_id) ){
+    std::uint32_t slot = bypass_map.get(page_id);
+    stats.add(StatHits);
+    bypass_table[slot].pin_count++;
+    if( tracer != nullptr ){
+      tracer->record(TraceGet, page_id, true);
+    }
+    if( timed ){
+      latency[LatGetHit].record(bm_cycles() - start);
+    }
+    return &bypass_pool[slot];
+  }
+
   BufferState state = getBufferState();
   if( state.unpinned == 0 ){
+    stats.add(StatPinWaits);
     throw InsufficientSpaceBufMgr();
   }
+  stats.add(StatMisses);
 
-  FrameId tmp = replacement_pol->replace();
+  FrameId tmp = _replaceFor(page_id);
   Frame &frame = frame_table[tmp];
 
+  // don't let a page accessed less often than the victim displace it
+  if( admission != nullptr && frame.valid &&
+      !admission->admit(page_id, frame.page_id) ){
+    Page *bypassed = _getBypassPage(page_id, tmp);
+    if( bypassed != nullptr ){
+      if( tracer != nullptr ){
+        tracer->record(TraceGet, page_id, false);
+      }
+      if( timed ){
+        latency[LatGetMiss].record(bm_cycles() - start);
+      }
+      return bypassed;
+    }
+  }
+
+  if( frame.valid ){
+    stats.add(frame.dirty ? StatDirtyEvictions : StatCleanEvictions);
+  }
   if( frame.valid && frame.dirty ) {
-      disk_mgr->writePage(frame.page_id, &buf_pool[tmp]);
+      _writePage(frame.page_id, &buf_pool[tmp]);
       frame.dirty = false;
   }
 
   if( frame.valid ){
+    _cachePage(frame.page_id, &buf_pool[tmp]);
     buf_map.remove(frame.page_id);
   }
 
+  // the old page is gone, so a failed read gives the frame back to the
+  // policy's free list instead of leaving it valid with a stale page_id
   try{
-    disk_mgr->readPage(page_id, &buf_pool[tmp]);
+    _readPage(page_id, &buf_pool[tmp]);
   }catch (InvalidFileIdDiskMgr &e){
+    frame.valid = false;
+    policy.freeFrame(tmp);
     throw InvalidPageIdBufMgr(page_id);
   }catch (InvalidPageNumDiskMgr &e) {
+    frame.valid = false;
+    policy.freeFrame(tmp);
     throw InvalidPageIdBufMgr(page_id);
   }
 
@@ -250,27 +579,77 @@ Page* BufferManager::getPage(PageId page_id) {
   frame.dirty = false;
 
   buf_map.insert(page_id, tmp);
-  replacement_pol->pin(tmp);
+  policy.pin(tmp);
+  frame_hint[tmp] = hint;
+  _countMiss();
+  if( tracer != nullptr ){
+    tracer->record(TraceGet, page_id, false);
+  }
 
+  if( timed ){
+    latency[LatGetMiss].record(bm_cycles() - start);
+  }
   return &buf_pool[tmp];  
 }
 
+/**
+ * @brief Gets the data of a Page by page_id for reading only, pins the Page,
+ *    and returns a pointer to its data. The same as getPage, except that
+ *    pages of mapped files are served too, in place in the read-only
+ *    mapping.
+ *
+ * @param page_id A PageId corresponding to the data to be returned.
+ * @param hint How the page will be accessed, as for getPage.
+ * @return Pointer to the PAGE_SIZE bytes of the Page with page_id.
+ *
+ * @throw InvalidPageIdBufMgr If page_id is not valid.
+ * @throw InsufficientSpaceBufMgr If buffer pool is full.
+ */
+template <class Policy>
+const char* BasicBufferManager<Policy>::getPageData(PageId page_id,
+    AccessHint hint){
+  if( mapped != nullptr && mapped->contains(page_id.file_id) ){
+    return mapped->getPage(page_id, hint);
+  }
+  return this->getPage(page_id, hint)->getData();
+}
+
 /**
  * @brief Unpins a Page in the buffer pool.
  *
  * @pre A PageId of a pinned Page is provided as input. The Page is in the
  *    buffer pool and is pinned by the executing thread/process.
  * @post The pin count of the Page is decremented. ref_bit is set to true.
- *    Dirty bit is set if the dirty parameter is true.
+ *    Dirty bit is set if the dirty parameter is true. If the pin count
+ *    reaches 0, the hint is applied: a page released with OnceHint leaves
+ *    the buffer pool, written to disk first if dirty, and other hints are
+ *    passed to the replacement policy.
  *
  * @param page_id PageId of the Page to be released.
+ * @param hint How the page will be accessed. NoHint keeps the hint given to
+ *    getPage.
  *
  * @throw PageNotPinnedBufMgr If Page is not pinned.
  *    (pin_count is 0).
  * @throw PageNotFoundBufMgr If page_id is not in buf_map.
+ * @throw ReadOnlyFileBufMgr If dirty is true and the file is mapped, and so
+ *    read-only. The page is unpinned first.
  */
-void BufferManager::releasePage(PageId page_id, bool dirty){
+template <class Policy>
+void BasicBufferManager<Policy>::releasePage(PageId page_id, bool dirty,
+    AccessHint hint){
   if( !buf_map.contains( page_id ) ){
+    if( bypass_map.contains( page_id ) ){
+      if( tracer != nullptr ){
+        tracer->record(TraceRelease, page_id, false, dirty);
+      }
+      _releaseBypassPage(page_id, dirty);
+      return;
+    }
+    if( mapped != nullptr && mapped->contains(page_id.file_id) ){
+      mapped->releasePage(page_id, dirty, hint);
+      return;
+    }
     throw PageNotFoundBufMgr(page_id);
   }
 
@@ -280,17 +659,154 @@ void BufferManager::releasePage(PageId page_id, bool dirty){
   if( frame->pin_count == 0 ){
     throw PageNotPinnedBufMgr(page_id);
   }
+  if( tracer != nullptr ){
+    tracer->record(TraceRelease, page_id, false, dirty);
+  }
 
   if( dirty ){
     frame->dirty = true;
   }
 
   frame->pin_count--;
-  
-  if( frame->pin_count == 0 ){
-    replacement_pol->unpin(tmp);
+
+  if( hint == NoHint ){
+    hint = frame_hint[tmp];
+  }
+  if( frame->pin_count > 0 ){
+    frame_hint[tmp] = hint;
+    return;
+  }
+
+  policy.unpin(tmp);
+  frame_hint[tmp] = NoHint;
+  if( hint == OnceHint ){
+    _dropPage(tmp);
+  }
+  else if( hint != NoHint ){
+    policy.hint(tmp, hint);
+  }
+}
+
+
+/**
+ * @brief Removes the unpinned page of a frame from the buffer pool, writing
+ *    it to disk first if it is dirty, and hands the frame back to the
+ *    replacement policy's free list.
+ *
+ * @pre frame_id holds a valid page with pin count 0.
+ * @post The frame is invalid and on the free list.
+ *
+ * @param frame_id FrameId of the frame to empty.
+ */
+template <class Policy>
+void BasicBufferManager<Policy>::_dropPage(FrameId frame_id){
+  Frame &frame = frame_table[frame_id];
+
+  stats.add(frame.dirty ? StatDirtyEvictions : StatCleanEvictions);
+  if( frame.dirty ){
+    _writePage(frame.page_id, &buf_pool[frame_id]);
+  }
+  buf_map.remove(frame.page_id);
+  frame.resetFrame();
+  policy.freeFrame(frame_id);
+}
+
+
+/**
+ * @brief Reads a page that is not in the buffer pool into page, from the
+ *    compressed cache, else the SSD cache, else the DiskManager. The caches
+ *    are exclusive, so a page read in leaves both.
+ *
+ * @param page_id PageId of the page to read.
+ * @param page Page to read it into.
+ *
+ * @throw InvalidFileIdDiskMgr If page_id.file_id is not valid.
+ * @throw InvalidPageNumDiskMgr If page_id.page_num is not valid.
+ */
+template <class Policy>
+void BasicBufferManager<Policy>::_readPage(PageId page_id, Page *page){
+  if( ccache != nullptr && ccache->fetch(page_id, page) ){
+    if( ssd_cache != nullptr ){
+      ssd_cache->remove(page_id);
+    }
+    return;
+  }
+  if( ssd_cache != nullptr && ssd_cache->fetch(page_id, page) ){
+    return;
+  }
+  if( _sampleLatency(LatRead) ){
+    std::uint64_t start = bm_cycles();
+    disk_mgr->readPage(page_id, page);
+    latency[LatRead].record(bm_cycles() - start);
+  }
+  else{
+    disk_mgr->readPage(page_id, page);
+  }
+  stats.add(StatReads);
+  stats.add(StatBytesRead, PAGE_SIZE);
+}
+
+
+/**
+ * @brief Writes a page to disk through the DiskManager and counts the write.
+ *
+ * @param page_id PageId of the page.
+ * @param page The page.
+ *
+ * @throw InvalidFileIdDiskMgr If page_id.file_id is not valid.
+ * @throw InvalidPageNumDiskMgr If page_id.page_num is not valid.
+ */
+template <class Policy>
+void BasicBufferManager<Policy>::_writePage(PageId page_id, Page *page){
+  if( _sampleLatency(LatWrite) ){
+    std::uint64_t start = bm_cycles();
+    disk_mgr->writePage(page_id, page);
+    latency[LatWrite].record(bm_cycles() - start);
   }
+  else{
+    disk_mgr->writePage(page_id, page);
+  }
+  stats.add(StatWrites);
+  stats.add(StatBytesWritten, PAGE_SIZE);
+}
+
+
+/**
+ * @brief Asks the replacement policy for a frame for page_id, timing the
+ *    call if it is sampled.
+ *
+ * @param page_id PageId of the page the frame is for.
+ * @return FrameId chosen by the replacement policy.
+ *
+ * @throw InsufficientSpaceBufMgr If every frame is pinned.
+ */
+template <class Policy>
+FrameId BasicBufferManager<Policy>::_replaceFor(PageId page_id){
+  if( !_sampleLatency(LatReplace) ){
+    return policy.replaceFor(page_id);
+  }
+  std::uint64_t start = bm_cycles();
+  FrameId frame_id = policy.replaceFor(page_id);
+  latency[LatReplace].record(bm_cycles() - start);
+  return frame_id;
+}
+
 
+/**
+ * @brief Puts a page leaving the buffer pool, as it is on disk, in the
+ *    compressed and SSD caches that are on.
+ *
+ * @param page_id PageId of the page.
+ * @param page The page, clean or just written back.
+ */
+template <class Policy>
+void BasicBufferManager<Policy>::_cachePage(PageId page_id, Page *page){
+  if( ccache != nullptr ){
+    ccache->insert(page_id, page);
+  }
+  if( ssd_cache != nullptr ){
+    ssd_cache->insert(page_id, page);
+  }
 }
 
 /**
@@ -302,10 +818,19 @@ void BufferManager::releasePage(PageId page_id, bool dirty){
  * @param page_id PageId of the Page to set dirty.
  *
  * @throw PageNotFoundBufMgr If page_id is not in the buffer pool.
+ * @throw ReadOnlyFileBufMgr If the file is mapped, and so read-only.
  */
-void BufferManager::setDirty(PageId page_id){
+template <class Policy>
+void BasicBufferManager<Policy>::setDirty(PageId page_id){
   
   if( !buf_map.contains( page_id ) ){
+    if( bypass_map.contains( page_id ) ){
+      bypass_table[bypass_map.get(page_id)].dirty = true;
+      return;
+    }
+    if( mapped != nullptr && mapped->contains(page_id.file_id) ){
+      throw ReadOnlyFileBufMgr(page_id.file_id);
+    }
     throw PageNotFoundBufMgr(page_id);
   }
 
@@ -328,9 +853,22 @@ void BufferManager::setDirty(PageId page_id){
  * @throw InvalidFileIdDiskMgr If page_id.file_id not valid.
  * @throw InvalidPageNumDiskMgr If page_id.page_num not valid.
  */
-void BufferManager::flushPage(PageId page_id){
-  
+template <class Policy>
+void BasicBufferManager<Policy>::flushPage(PageId page_id){
+
   if( !buf_map.contains( page_id ) ){
+    if( bypass_map.contains( page_id ) ){
+      std::uint32_t slot = bypass_map.get(page_id);
+      if( bypass_table[slot].dirty ){
+        _writePage(page_id, &bypass_pool[slot]);
+        bypass_table[slot].dirty = false;
+      }
+      return;
+    }
+    if( mapped != nullptr && mapped->contains(page_id.file_id) ){
+      mapped->flushPage(page_id);
+      return;
+    }
     throw PageNotFoundBufMgr(page_id);
   }
 
@@ -338,7 +876,7 @@ void BufferManager::flushPage(PageId page_id){
   Frame *frame = &frame_table[tmp];
 
   if( frame->dirty ){
-    disk_mgr->writePage(page_id, &buf_pool[tmp]);
+    _writePage(page_id, &buf_pool[tmp]);
     frame->dirty = false;
   }
 }
@@ -354,7 +892,8 @@ void BufferManager::flushPage(PageId page_id){
  *
  * @see DiskManager::createFile()
  */
-void BufferManager::createFile (FileId file_id){
+template <class Policy>
+void BasicBufferManager<Policy>::createFile(FileId file_id){
   return this->disk_mgr->createFile(file_id);
 }
 
@@ -366,8 +905,8 @@ void BufferManager::createFile (FileId file_id){
  * @pre A valid FileId is given as a parameter. None of the file's pages
  *    are pinned in the buffer pool.
  * @post If the file has pages in the buffer pool, the corresponding frames
- *    are reset and pages are removed from buf_map. The file is removed
- *    from disk via DiskManager->removeFile().
+ *    are reset and pages are removed from buf_map. If it is mapped, it is
+ *    unmapped. The file is removed from disk via DiskManager->removeFile().
  *
  * @param file_id FileId of the file to be removed.
  *
@@ -375,7 +914,25 @@ void BufferManager::createFile (FileId file_id){
  *
  * @see DiskManager::removeFile()
  */
-void BufferManager::removeFile(FileId file_id){
+template <class Policy>
+void BasicBufferManager<Policy>::removeFile(FileId file_id){
+
+  if( mapped != nullptr ){
+    mapped->unmap(file_id);
+  }
+  if( ccache != nullptr ){
+    ccache->removeFile(file_id);
+  }
+  if( ssd_cache != nullptr ){
+    ssd_cache->removeFile(file_id);
+  }
+
+  // pages in the bypass area are always pinned
+  for( std::uint32_t i = 0; i < BM_BYPASS_SIZE; i++ ){
+    if( bypass_table[i].valid && bypass_table[i].page_id.file_id == file_id ){
+      throw PagePinnedBufMgr(bypass_table[i].page_id);
+    }
+  }
   
   for( FrameId i = 0; i < BUF_SIZE; i++ ){
     Frame &frame = frame_table[i];
@@ -389,46 +946,604 @@ void BufferManager::removeFile(FileId file_id){
         frame.valid = false;
         frame.dirty = false;
         frame.pin_count = 0;
-        replacement_pol->freeFrame(i);
+        policy.freeFrame(i);
     }
   }
+  policy.removeFile(file_id);
 
   this->disk_mgr->removeFile(file_id);
 }
 
 
 /**
- * @brief THIS METHOD IS FOR DEBUGGING ONLY.
- *    Returns the current state of the buffer pool.
- * @see BufferState
+ * @brief Removes the file's pages from the buffer pool, writing the dirty
+ *    ones to disk, and leaves the file on disk. Nothing is removed if any
+ *    page of the file is pinned.
+ *
+ * @pre None of the file's pages are pinned in the buffer pool.
+ * @post None of the file's pages are in the buffer pool or the compressed
+ *    and SSD caches and every change to them is on disk.
+ *
+ * @param file_id FileId of the file to be evicted.
+ *
+ * @throw PagePinnedBufMgr If there are pinned pages of file_id.
  */
-BufferState BufferManager::getBufferState(){
-  Frame* cur_frame;
-  BufferState cur_buf = 
-     {BUF_SIZE, 0, 0, 0, 0, {INVALID_REP_TYPE, 0, 0, 0, 0, 0}};
+template <class Policy>
+void BasicBufferManager<Policy>::evictFile(FileId file_id){
 
-  //iterate through the buffer
-  for (FrameId i = 0; i < BUF_SIZE; i++){
-    cur_frame = &(this->frame_table[i]);
-    if (cur_frame->valid){
-      cur_buf.valid++;
+  // pages in the bypass area are always pinned
+  for( std::uint32_t i = 0; i < BM_BYPASS_SIZE; i++ ){
+    if( bypass_table[i].valid && bypass_table[i].page_id.file_id == file_id ){
+      throw PagePinnedBufMgr(bypass_table[i].page_id);
     }
-    if(cur_frame->pin_count >0){
-      cur_buf.pinned++;
+  }
+
+  // check every frame before dropping any, so a pinned page leaves the
+  // buffer pool as it was
+  for( FrameId i = 0; i < BUF_SIZE; i++ ){
+    Frame &frame = frame_table[i];
+    if( frame.valid && frame.page_id.file_id == file_id &&
+        frame.pin_count > 0 ){
+      throw PagePinnedBufMgr(frame.page_id);
     }
-    if (cur_frame->dirty){
-      cur_buf.dirty++;
+  }
+
+  for( FrameId i = 0; i < BUF_SIZE; i++ ){
+    if( frame_table[i].valid && frame_table[i].page_id.file_id == file_id ){
+      _dropPage(i);
     }
   }
-  replacement_pol->getRepStats(&(cur_buf.replace_stats));
-  cur_buf.unpinned = BUF_SIZE - cur_buf.pinned;
-  return cur_buf;
+  if( ccache != nullptr ){
+    ccache->removeFile(file_id);
+  }
+  if( ssd_cache != nullptr ){
+    ssd_cache->removeFile(file_id);
+  }
+}
+
+
+/**
+ * @brief Turns the TinyLFU admission filter on or off. While it is on, every
+ *    getPage is recorded in the filter, and a page read in on a miss that is
+ *    estimated to be accessed less often than the page chosen for
+ *    replacement is read into the bypass area instead. The page chosen for
+ *    replacement stays in the buffer pool. A bypassed page is dropped,
+ *    written back first if dirty, as soon as its pin count reaches 0.
+ *
+ * @pre None.
+ * @post Admission is on if enabled is true. Turning it off forgets the
+ *    frequency estimates. Pages already in the bypass area stay there until
+ *    they are released.
+ *
+ * @param enabled true to turn admission on.
+ */
+template <class Policy>
+void BasicBufferManager<Policy>::setAdmission(bool enabled){
+  if( enabled && admission == nullptr ){
+    admission = new TinyLfu(BUF_SIZE);
+  }
+  else if( !enabled ){
+    delete admission;
+    admission = nullptr;
+  }
+}
+
+
+/**
+ * @brief Turns the compressed cache of evicted pages on with the given
+ *    budget of bytes, or off if budget is 0. While it is on, a page evicted
+ *    from the buffer pool is compressed into the cache after it is written
+ *    back, and a miss is served from the cache before the DiskManager.
+ *
+ * @pre None.
+ * @post The cache is empty, with the given budget, or off.
+ *
+ * @param budget Number of bytes the cache may hold, or 0.
+ */
+template <class Policy>
+void BasicBufferManager<Policy>::setCompressedCache(std::size_t budget){
+  delete ccache;
+  ccache = nullptr;
+  if( budget > 0 ){
+    ccache = new CompressedCache(budget);
+  }
+}
+
+
+/**
+ * @brief Returns the counters of the compressed cache, all 0 if it is off.
+ */
+template <class Policy>
+CompressedCacheStats BasicBufferManager<Policy>::getCompressedCacheStats(){
+  if( ccache == nullptr ){
+    return CompressedCacheStats{0, 0, 0, 0, 0, 0, 0, 0, 0};
+  }
+  return ccache->getStats();
+}
+
+
+/**
+ * @brief Turns the SSD cache of evicted pages on with a cache file of
+ *    num_pages pages at path, or off if num_pages is 0. While it is on, a
+ *    page evicted from the buffer pool is queued to be written to the cache
+ *    file after it is written back, and a miss is looked up in the cache
+ *    before the DiskManager. Turning it off, or on with another file, drops
+ *    the pages of the old cache file, as the pages on disk may be written
+ *    while it is off. Only the destructor writes its index, so that the
+ *    cached pages survive a restart.
+ *
+ * @pre None.
+ * @post The cache is on with the given file, or off.
+ *
+ * @param path Path of the cache file, on fast local storage.
+ * @param num_pages Number of pages the cache file holds, or 0.
+ *
+ * @throw IOErrorBufMgr If the cache file cannot be opened or sized. The
+ *    cache is off.
+ */
+template <class Policy>
+void BasicBufferManager<Policy>::setSsdCache(const std::string &path,
+    std::uint32_t num_pages){
+  if( ssd_cache != nullptr ){
+    ssd_cache->discard();
+  }
+  delete ssd_cache;
+  ssd_cache = nullptr;
+  if( num_pages > 0 ){
+    ssd_cache = new SsdCache(path, num_pages);
+  }
+}
+
+
+/**
+ * @brief Returns the counters of the SSD cache, all 0 if it is off.
+ */
+template <class Policy>
+SsdCacheStats BasicBufferManager<Policy>::getSsdCacheStats(){
+  if( ssd_cache == nullptr ){
+    return SsdCacheStats{0, 0, 0, 0, 0, 0};
+  }
+  return ssd_cache->getStats();
+}
+
+
+/**
+ * @brief Chooses the replacement policy used for the pages of the given
+ *    file. Only supported by a policy that partitions the buffer pool by
+ *    file, like PerFile.
+ *
+ * @pre None.
+ * @post Pages of file_id read in from now on are replaced by rep_type.
+ *
+ * @param file_id FileId of the file.
+ * @param rep_type Replacement policy type for the pages of the file.
+ *
+ * @throw InvalidPolicyBufMgr If the policy does not support per-file
+ *    selection, or rep_type is not supported by it.
+ */
+template <class Policy>
+void BasicBufferManager<Policy>::setFilePolicy(FileId file_id,
+    PolicyType rep_type){
+  this->policy.setFilePolicy(file_id, rep_type);
+}
+
+
+/**
+ * @brief Returns true if the Page of the given PageId is in the buffer pool
+ *    or in the bypass area, without pinning it or counting an access.
+ *
+ * @param page_id PageId of the Page.
+ * @return bool indicating whether the Page is resident.
+ */
+template <class Policy>
+bool BasicBufferManager<Policy>::isResident(PageId page_id){
+  return buf_map.contains(page_id) || bypass_map.contains(page_id) ||
+         (mapped != nullptr && mapped->isResident(page_id));
+}
+
+
+/**
+ * @brief Serves the pages of the given file from a read-only MAP_SHARED
+ *    mapping of its Unix file instead of the buffer pool. The file's pages
+ *    are evicted from the buffer pool first, so that no page is in both.
+ *    Every write of the file goes through the DiskManager, so pages cannot
+ *    be allocated or dirtied while it is mapped.
+ *
+ * @pre None of the file's pages are pinned in the buffer pool.
+ * @post The file's pages are written to disk and evicted from the buffer
+ *    pool, and are served from the mapping from now on.
+ *
+ * @param file_id FileId of the file.
+ * @param path Path of the Unix file of file_id.
+ *
+ * @throw PagePinnedBufMgr If there are pinned pages of file_id.
+ * @throw IOErrorBufMgr If the file cannot be mapped, or its layout is not
+ *    the one expected.
+ */
+template <class Policy>
+void BasicBufferManager<Policy>::mapFile(FileId file_id,
+    const std::string &path){
+  evictFile(file_id);
+  if( mapped == nullptr ){
+    mapped = new MappedFiles(disk_mgr, BUF_SIZE);
+  }
+  mapped->map(file_id, path);
+}
+
+
+/**
+ * @brief Unmaps a mapped file. Does nothing if the file is not mapped.
+ *
+ * @param file_id FileId of the file.
+ *
+ * @throw PagePinnedBufMgr If there are pinned pages of file_id.
+ */
+template <class Policy>
+void BasicBufferManager<Policy>::unmapFile(FileId file_id){
+  if( mapped != nullptr ){
+    mapped->unmap(file_id);
+  }
+}
+
+
+/**
+ * @brief Returns the number of pages of a mapped file that the kernel holds
+ *    in memory, sampled with mincore, or 0 if the file is not mapped.
+ *
+ * @param file_id FileId of the file.
+ */
+template <class Policy>
+std::uint32_t BasicBufferManager<Policy>::sampleMappedPages(FileId file_id){
+  if( mapped == nullptr ){
+    return 0;
+  }
+  return mapped->sampleResident(file_id);
+}
+
+
+/**
+ * @brief Writes the PageIds of the pages in the buffer pool to a file, in
+ *    the order they should be read back in: pinned pages first, then the
+ *    others in the order of the replacement policy, the one it would replace
+ *    last first, then any valid frame the policy does not rank. Pages in the
+ *    bypass area and of mapped files are left out. The file is written aside
+ *    and renamed, so a crash while dumping leaves the previous dump.
+ *
+ * @pre None.
+ * @post path holds the PageIds of the resident pages. The buffer pool is
+ *    unchanged.
+ *
+ * @param path Path of the dump file.
+ * @return Number of PageIds written.
+ *
+ * @throw IOErrorBufMgr If the dump file cannot be written.
+ */
+template <class Policy>
+std::uint32_t BasicBufferManager<Policy>::dumpResidentPages(
+    const std::string &path){
+  std::vector<FrameId> ranked;
+  std::vector<FrameId> order;
+  std::vector<bool> listed(BUF_SIZE, false);
+
+  for (FrameId i = 0; i < BUF_SIZE; ++i) {
+    if (frame_table[i].valid && frame_table[i].pin_count > 0) {
+      ranked.push_back(i);
+    }
+  }
+  policy.rankFrames(&ranked);
+  for (FrameId i = 0; i < BUF_SIZE; ++i) {
+    ranked.push_back(i);
+  }
+  for (FrameId frame_id : ranked) {
+    if (frame_table[frame_id].valid && !listed[frame_id]) {
+      listed[frame_id] = true;
+      order.push_back(frame_id);
+    }
+  }
+
+  std::string tmp_path = path + ".tmp";
+  std::ofstream out(tmp_path);
+  out << BM_DUMP_MAGIC << " " << order.size() << "\n";
+  for (FrameId frame_id : order) {
+    out << frame_table[frame_id].page_id.file_id << " "
+      << frame_table[frame_id].page_id.page_num << "\n";
+  }
+  out.close();
+  if (!out || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    throw IOErrorBufMgr(path);
+  }
+  return order.size();
+}
+
+
+/**
+ * @brief Reads a dump written by dumpResidentPages and queues its first
+ *    BUF_SIZE pages to be read back in by warmUp, replacing any pages still
+ *    queued. A missing or damaged dump queues nothing, as after a first
+ *    start.
+ *
+ * @pre None.
+ * @post The pages of the dump are queued. The buffer pool is unchanged.
+ *
+ * @param path Path of the dump file.
+ * @return Number of pages queued.
+ */
+template <class Policy>
+std::uint32_t BasicBufferManager<Policy>::warmFromDump(
+    const std::string &path){
+  std::ifstream in(path);
+  std::string magic;
+  std::uint32_t count;
+
+  warm_queue.clear();
+  warm_next = 0;
+  if (!(in >> magic >> count) || magic != BM_DUMP_MAGIC) {
+    return 0;
+  }
+  for (std::uint32_t i = 0; i < count && warm_queue.size() < BUF_SIZE; ++i) {
+    PageId page_id;
+    if (!(in >> page_id.file_id >> page_id.page_num)) {
+      warm_queue.clear();
+      return 0;
+    }
+    warm_queue.push_back(page_id);
+  }
+  return warm_queue.size();
+}
+
+
+/**
+ * @brief Reads the next max_pages queued pages into free frames of the
+ *    buffer pool, unpinned. Each batch is read in PageId order, so the reads
+ *    of a file are sequential, and handed to the replacement policy hottest
+ *    last, so the policy sees the order of the dump. Warm-up never evicts a
+ *    page: pages already read in by getPage are skipped, and once the buffer
+ *    pool is full the rest of the queue is dropped. Pages that no longer
+ *    exist on disk are skipped.
+ *
+ * @pre None.
+ * @post Up to max_pages queued pages are in the buffer pool.
+ *
+ * @param max_pages Number of pages to read in at most.
+ * @return Number of pages still queued, 0 once warm-up is over.
+ */
+template <class Policy>
+std::uint32_t BasicBufferManager<Policy>::warmUp(std::uint32_t max_pages){
+  std::uint32_t free_frames = BUF_SIZE;
+  for (FrameId i = 0; i < BUF_SIZE; ++i) {
+    if (frame_table[i].valid) {
+      free_frames--;
+    }
+  }
+
+  // each page with its place in the dump
+  std::vector<std::pair<PageId, std::size_t>> batch;
+  while (warm_next < warm_queue.size() && batch.size() < max_pages &&
+         batch.size() < free_frames) {
+    PageId page_id = warm_queue[warm_next];
+    if (!isResident(page_id) &&
+        (mapped == nullptr || !mapped->contains(page_id.file_id))) {
+      batch.push_back(std::make_pair(page_id, warm_next));
+    }
+    warm_next++;
+  }
+  std::sort(batch.begin(), batch.end(),
+      [](const std::pair<PageId, std::size_t> &a,
+         const std::pair<PageId, std::size_t> &b){
+        return a.first.file_id < b.first.file_id ||
+               (a.first.file_id == b.first.file_id &&
+                a.first.page_num < b.first.page_num);
+      });
+
+  std::vector<std::pair<std::size_t, FrameId>> loaded;
+  for (auto &entry : batch) {
+    PageId page_id = entry.first;
+    if (buf_map.contains(page_id)) {
+      continue;
+    }
+    FrameId frame_id = policy.replaceFor(page_id);
+    try{
+      _readPage(page_id, &buf_pool[frame_id]);
+    }catch (InvalidFileIdDiskMgr &e){
+      policy.freeFrame(frame_id);
+      continue;
+    }catch (InvalidPageNumDiskMgr &e){
+      policy.freeFrame(frame_id);
+      continue;
+    }
+
+    Frame &frame = frame_table[frame_id];
+    frame.page_id = page_id;
+    frame.valid = true;
+    frame.pin_count = 1;
+    frame.dirty = false;
+    buf_map.insert(page_id, frame_id);
+    policy.pin(frame_id);
+    frame_hint[frame_id] = NoHint;
+    loaded.push_back(std::make_pair(entry.second, frame_id));
+  }
+
+  // coldest first, so the hottest page is the most recently unpinned
+  std::sort(loaded.rbegin(), loaded.rend());
+  for (auto &entry : loaded) {
+    frame_table[entry.second].pin_count = 0;
+    policy.unpin(entry.second);
+  }
+
+  if (loaded.size() == free_frames) {
+    warm_queue.clear();
+    warm_next = 0;
+  }
+  return warm_queue.size() - warm_next;
+}
+
+
+/**
+ * @brief Dumps the resident pages to path with dumpResidentPages when the
+ *    BufferManager is destroyed and, if interval is above 0, every interval
+ *    pages read into the buffer pool. An empty path turns automatic dumps
+ *    off.
+ *
+ * @pre None.
+ * @post Automatic dumps go to path, or are off.
+ *
+ * @param path Path of the dump file, or empty.
+ * @param interval Number of pages read in between dumps, or 0 to only dump
+ *    at destruction.
+ */
+template <class Policy>
+void BasicBufferManager<Policy>::setAutoDump(const std::string &path,
+    std::uint32_t interval){
+  dump_path = path;
+  dump_interval = path.empty() ? 0 : interval;
+  dump_misses = 0;
+}
+
+
+/**
+ * @brief Counts a page read into the buffer pool, and dumps the resident
+ *    pages to dump_path every dump_interval of them. A dump that fails is
+ *    skipped rather than failing the read.
+ */
+template <class Policy>
+void BasicBufferManager<Policy>::_countMiss(){
+  if (dump_interval == 0 || ++dump_misses < dump_interval) {
+    return;
+  }
+  dump_misses = 0;
+  try{
+    dumpResidentPages(dump_path);
+  }catch (IOErrorBufMgr &e){
+  }
+}
+
+
+/**
+ * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+ *    Returns the current state of the buffer pool.
+ * @see BufferState
+ */
+template <class Policy>
+BufferState BasicBufferManager<Policy>::getBufferState(){
+  Frame* cur_frame;
+  BufferState cur_buf = 
+     {BUF_SIZE, 0, 0, 0, 0, {INVALID_REP_TYPE, 0, 0, 0, 0, 0}};
+
+  //iterate through the buffer
+  for (FrameId i = 0; i < BUF_SIZE; i++){
+    cur_frame = &(this->frame_table[i]);
+    if (cur_frame->valid){
+      cur_buf.valid++;
+    }
+    if(cur_frame->pin_count >0){
+      cur_buf.pinned++;
+    }
+    if (cur_frame->dirty){
+      cur_buf.dirty++;
+    }
+  }
+  policy.getRepStats(&(cur_buf.replace_stats));
+  cur_buf.unpinned = BUF_SIZE - cur_buf.pinned;
+  return cur_buf;
+}
+
+/**
+ * @brief Returns the hit, miss, eviction and I/O counters of the buffer
+ *    pool, summed over the shards of the threads. May be called without the
+ *    latch of the buffer manager, but the counters then need not belong to
+ *    the same moment.
+ * @see BufferStats
+ */
+template <class Policy>
+BufferStats BasicBufferManager<Policy>::getBufferStats(){
+  return stats.snapshot();
+}
+
+/**
+ * @brief Times one in every `every` getPage calls, replacement policy calls,
+ *    page reads and page writes into log-bucketed histograms. 0 turns timing
+ *    off, and 1 times every operation. The histograms are kept.
+ *
+ * @param every Number of operations of each kind of which one is timed.
+ */
+template <class Policy>
+void BasicBufferManager<Policy>::setLatencySampling(std::uint32_t every){
+  this->latency_every = every;
+  for( std::uint32_t i = 0; i < BM_NUM_LATENCIES; i++ ){
+    this->latency_left[i] = every;
+  }
+}
+
+/**
+ * @brief Returns a copy of the latency histogram of the given kind of
+ *    operation.
+ * @see LatencyHistogram
+ */
+template <class Policy>
+LatencyHistogram BasicBufferManager<Policy>::getLatency(LatencyKind kind){
+  return this->latency[kind];
+}
+
+/**
+ * @brief Records the getPage, releasePage and allocatePage calls to tracer,
+ *    or stops recording if it is nullptr. The tracer is not owned.
+ *
+ * @param tracer TraceRecorder to record to, or nullptr.
+ */
+template <class Policy>
+void BasicBufferManager<Policy>::setTracer(TraceRecorder *tracer){
+  this->tracer = tracer;
+}
+
+/**
+ * @brief Turns the SHARDS estimate of the miss ratio curve on or off.
+ *
+ * @pre None.
+ * @post The estimate is on if enabled is true, starting from the next
+ *    getPage call if it was off. Turning it off forgets the estimate.
+ *
+ * @param enabled true to turn the estimate on.
+ */
+template <class Policy>
+void BasicBufferManager<Policy>::setMissRatioCurve(bool enabled){
+  if( enabled && mrc == nullptr ){
+    mrc = new MissRatioEstimator(BUF_SIZE);
+  }
+  else if( !enabled ){
+    delete mrc;
+    mrc = nullptr;
+  }
+}
+
+/**
+ * @brief Returns the predicted hit rates of the buffer pool at 0.5, 1, 2 and
+ *    4 times BUF_SIZE frames, all 0 if the estimate is off.
+ * @see MissRatioEstimator::getCurve()
+ */
+template <class Policy>
+MissRatioCurve BasicBufferManager<Policy>::getMissRatioCurve(){
+  if( mrc == nullptr ){
+    return MissRatioCurve{0, 0, 0, {0, 0, 0, 0}, {0, 0, 0, 0}};
+  }
+  return mrc->getCurve();
+}
+
+/**
+ * @brief Renders the state, counters and latency percentiles of the buffer
+ *    pool in the Prometheus text exposition format.
+ * @see bm_metrics_text()
+ */
+template <class Policy>
+std::string BasicBufferManager<Policy>::getMetrics(){
+  return bm_metrics_text(getBufferState(), getBufferStats(), this->latency);
 }
 
 /**
  * @brief Return the amount of unpinned pages in the buffer pool
  */
-std::uint32_t BufferManager::getNumUnpinned(){
+template <class Policy>
+std::uint32_t BasicBufferManager<Policy>::getNumUnpinned(){
 
   BufferState cur_buf = getBufferState();
   return cur_buf.unpinned;
@@ -439,7 +1554,8 @@ std::uint32_t BufferManager::getNumUnpinned(){
  *    pin count, valid bit, dirty bit, and ref_bit. If Page is valid,
  *    PageId is printed.
  */
-void BufferManager::printAllFrames(){
+template <class Policy>
+void BasicBufferManager<Policy>::printAllFrames(){
   for (FrameId i = 0; i < BUF_SIZE; i++){
     std::cout <<  "Frame " << i << ": \n";
     this->_printFrameHelper(i);
@@ -451,7 +1567,8 @@ void BufferManager::printAllFrames(){
  *    Prints frame state of every valid frame in the buffer pool,
  *    including PageId, pin count, valid bit, dirty bit, and ref_bit.
  */
-void BufferManager::printValidFrames(){
+template <class Policy>
+void BasicBufferManager<Policy>::printValidFrames(){
 
   Frame  *cur_frame;
 
@@ -470,7 +1587,8 @@ void BufferManager::printValidFrames(){
  *    valid bit, dirty bit, and ref_bit. If Page is valid, PageId is
  *    printed.
  */
-void BufferManager::printFrame(FrameId frame_id){
+template <class Policy>
+void BasicBufferManager<Policy>::printFrame(FrameId frame_id){
   this->_printFrameHelper(frame_id);
 }
 
@@ -483,7 +1601,8 @@ void BufferManager::printFrame(FrameId frame_id){
  * @pre: caller has obtained the buf_map_mtx lock
  * @post: caller still holds the buf_map_mtx lock
  */
-void BufferManager::_printFrameHelper(FrameId frame_id){
+template <class Policy>
+void BasicBufferManager<Policy>::_printFrameHelper(FrameId frame_id){
   Frame *cur_frame;
 
   cur_frame = &(this->frame_table[frame_id]);
@@ -493,7 +1612,7 @@ void BufferManager::_printFrameHelper(FrameId frame_id){
   }
   std::cout << "pin count: " << cur_frame->pin_count << ", " << "valid: " <<
       cur_frame->valid << ", " <<"dirty: " << cur_frame->dirty;
-  this->replacement_pol->printFrame(frame_id);
+  this->policy.printFrame(frame_id);
 }
 
 /**
@@ -502,7 +1621,8 @@ void BufferManager::_printFrameHelper(FrameId frame_id){
  *    valid bit, dirty bit, and ref_bit. If Page is not in the buffer map,
  *    prints "Page Not Found".
  */
-void BufferManager::printPage(PageId page_id){
+template <class Policy>
+void BasicBufferManager<Policy>::printPage(PageId page_id){
   Frame* cur_frame;
   FrameId frame_id;
   if (!this->buf_map.contains(page_id)){
@@ -514,7 +1634,7 @@ void BufferManager::printPage(PageId page_id){
   std::cout <<  "FrameId: " << frame_id << ", "  << "pin count: " <<
       cur_frame->pin_count << ", " << "valid: " << cur_frame->valid << ", "  <<
       "dirty: " << cur_frame->dirty;
-    this->replacement_pol->printFrame(frame_id);
+    this->policy.printFrame(frame_id);
 }
 
 /**
@@ -524,7 +1644,8 @@ void BufferManager::printPage(PageId page_id){
  *    number of pages whose ref bit is set and the current clock hand
  *    position.
  */
-void BufferManager::printBufferState(){
+template <class Policy>
+void BasicBufferManager<Policy>::printBufferState(){
   BufferState cur_buf = 
      {BUF_SIZE, 0, 0, 0, 0, {INVALID_REP_TYPE, 0, 0, 0, 0, 0}};
 
@@ -543,7 +1664,7 @@ void BufferManager::printBufferState(){
   std::cout << "Number of unpinned pages: " << cur_buf.unpinned << std::endl;
   std::cout << "Number of dirty pages: " << cur_buf.dirty <<std::endl;
   std::cout << "Replacement Policy: " << 
-    bm_rep_strs[cur_buf.replace_stats.rep_type] << std::endl;
+    bm_rep_str(cur_buf.replace_stats.rep_type) << std::endl;
   std::cout << "Number of calls to replacement policy: " << 
     cur_buf.replace_stats.rep_calls << std::endl;
   std::cout << "Average frames checked per call: " << 
@@ -552,15 +1673,531 @@ void BufferManager::printBufferState(){
     cur_buf.replace_stats.ref_bit << std::endl;
   std::cout << "Current clock hand position: " << 
     cur_buf.replace_stats.clock_hand <<std::endl;
+  bm_print_stats(this->stats.snapshot());
 }
 
 
 /**
  * @brief This method is for performance tests.
  *    Prints number of calls to replacment policy, average check on
- *    replacement calls, lru/mru queue/stack usage.
+ *    replacement calls, lru/mru queue/stack usage, the admission filter's,
+ *    compressed cache's and SSD cache's statistics if they are on, the
+ *    latency percentiles if timing is on, and the miss ratio curve if it is
+ *    estimated.
  */
-void BufferManager::printReplacementStats(){
-  this->replacement_pol->printStats();
+template <class Policy>
+void BasicBufferManager<Policy>::printReplacementStats(){
+  this->policy.printStats();
+  if(this->admission != nullptr){
+    this->admission->printStats();
+  }
+  if(this->ccache != nullptr){
+    this->ccache->printStats();
+  }
+  if(this->ssd_cache != nullptr){
+    this->ssd_cache->printStats();
+  }
+  if(this->latency_every != 0){
+    for( std::uint32_t i = 0; i < BM_NUM_LATENCIES; i++ ){
+      this->latency[i].print(bm_latency_str((LatencyKind)i));
+    }
+  }
+  if(this->mrc != nullptr){
+    bm_print_mrc(this->mrc->getCurve());
+  }
   std::cout << std::endl;
-}
\ No newline at end of file
+}
+
+
+/**
+ * Instantiations of BasicBufferManager for the policies BufferManager can be
+ * constructed with.
+ */
+template class BasicBufferManager<Clock>;
+template class BasicBufferManager<Random>;
+template class BasicBufferManager<GClock>;
+template class BasicBufferManager<ClockPro>;
+template class BasicBufferManager<Lirs>;
+template class BasicBufferManager<Sieve>;
+template class BasicBufferManager<S3Fifo>;
+template class BasicBufferManager<PerFile>;
+
+
+/**
+ * SwatDb BufferManager Class.
+ * BufferManager manages in memory space of DBMS at page level granularity.
+ * At higher level, pages of data could be allocated, deallocated, retrieved
+ * to memory and fliushed to disk, using various methods. Every method is
+ * forwarded to the BasicBufferManager of the policy chosen at construction.
+ */
+
+/**
+ * @brief BufferManager constructor. Creates the BasicBufferManager of the
+ *    replacement policy of the given type, which initializes the buf_pool
+ *    and frame_table, and stores a pointer to SwatDB's DiskManager.
+ *
+ * @pre disk_mgr points to an initialized DiskManager object.
+ * @post A BufferManager object will be initialized with an empty
+ *    buffer pool. disk_mgr is set to the given DiskManager* and
+ *    clock_hand is set to 0.
+ *
+ * @param disk_mgr A pointer to SwatDB's DiskManager object.
+ *    (DiskManager*).
+ *
+ * @throw InvalidPolicyBufMgr If the replacement policy type is invalid. 
+ */
+BufferManager::BufferManager(DiskManager *disk_mgr, PolicyType rep_type)
+  : BufferManager(disk_mgr, rep_type, -1){
+}
+
+/**
+ * @brief BufferManager constructor that maps the memory of the buffer pool,
+ *    in the memory of a NUMA node and on huge pages. If the node does not
+ *    exist or the system has no NUMA support, the memory is placed as usual.
+ *    Huge pages reserved with MAP_HUGETLB are tried first, then transparent
+ *    huge pages, then base pages. getPoolMemory() reports which was
+ *    obtained.
+ *
+ * @pre disk_mgr points to an initialized DiskManager object.
+ * @post A BufferManager object will be initialized with an empty buffer pool
+ *    whose frames prefer the memory of numa_node.
+ *
+ * @param disk_mgr A pointer to SwatDB's DiskManager object.
+ *    (DiskManager*).
+ * @param rep_type Replacement policy type.
+ * @param numa_node NUMA node to place the buffer pool on, or -1 to place it
+ *    as usual.
+ * @param huge_pages true to place the buffer pool on huge pages.
+ *
+ * @throw InvalidPolicyBufMgr If the replacement policy type is invalid.
+ * @throw std::bad_alloc If the memory of the buffer pool cannot be mapped.
+ */
+BufferManager::BufferManager(DiskManager *disk_mgr, PolicyType rep_type,
+    int numa_node, bool huge_pages){
+
+  this->pool_memory = HeapPool;
+  this->impl_size = 0;
+
+  switch(rep_type) {
+    case ClockT:{
+      this->impl = _create<Clock>(disk_mgr, numa_node, huge_pages);
+      break; }
+    case RandomT: {
+      this->impl = _create<Random>(disk_mgr, numa_node, huge_pages);
+      break; }
+    case GClockT: {
+      this->impl = _create<GClock>(disk_mgr, numa_node, huge_pages);
+      break; }
+    case ClockProT: {
+      this->impl = _create<ClockPro>(disk_mgr, numa_node, huge_pages);
+      break; }
+    case LirsT: {
+      this->impl = _create<Lirs>(disk_mgr, numa_node, huge_pages);
+      break; }
+    case SieveT: {
+      this->impl = _create<Sieve>(disk_mgr, numa_node, huge_pages);
+      break; }
+    case S3FifoT: {
+      this->impl = _create<S3Fifo>(disk_mgr, numa_node, huge_pages);
+      break; }
+    case PerFileT: {
+      this->impl = _create<PerFile>(disk_mgr, numa_node, huge_pages);
+      break; }
+
+
+    default:
+      throw InvalidPolicyBufMgr(); // no replacement policy defined
+  }
+}
+
+/**
+ * @brief Creates the BasicBufferManager of the given policy, with new or in
+ *    memory mapped by bm_pool_alloc if a NUMA node or huge pages are asked
+ *    for. The mapping is released if the constructor throws.
+ */
+template <class Policy>
+BufferManagerBase* BufferManager::_create(DiskManager *disk_mgr,
+    int numa_node, bool huge_pages){
+  if( numa_node < 0 && !huge_pages ){
+    return new BasicBufferManager<Policy>(disk_mgr);
+  }
+  this->impl_size = sizeof(BasicBufferManager<Policy>);
+  void *mem = bm_pool_alloc(this->impl_size, numa_node, huge_pages,
+                            &this->pool_memory);
+  try{
+    return new (mem) BasicBufferManager<Policy>(disk_mgr);
+  }catch (...){
+    // the destructor does not run when the constructor throws
+    bm_pool_free(mem, this->impl_size, this->pool_memory);
+    throw;
+  }
+}
+
+/**
+ * @brief BufferManager destructor.
+ *
+ * @pre None.
+ * @post Every valid and dirty Page in buffer pool and in the bypass area is
+ *    written to disk.
+ */
+BufferManager::~BufferManager(){
+  if( this->pool_memory == HeapPool ){
+    delete this->impl;
+  }
+  else{
+    this->impl->~BufferManagerBase();
+    bm_pool_free(this->impl, this->impl_size, this->pool_memory);
+  }
+}
+
+/**
+ * @brief Allocates a Page for the file of given FileId.
+ * @see BasicBufferManager::allocatePage()
+ */
+std::pair<Page*, PageId> BufferManager::allocatePage(FileId file_id){
+  return this->impl->allocatePage(file_id);
+}
+
+/**
+ * @brief Puts a Page the caller has just allocated on disk in the buffer
+ *    pool, pinned, without reading it from disk.
+ * @see BasicBufferManager::installPage()
+ */
+Page* BufferManager::installPage(PageId page_id){
+  return this->impl->installPage(page_id);
+}
+
+/**
+ * @brief Removes the Page of the given PageId from the buffer pool, and
+ *    deallocates the Page from disk.
+ * @see BasicBufferManager::deallocatePage()
+ */
+void BufferManager::deallocatePage(PageId page_id){
+  this->impl->deallocatePage(page_id);
+}
+
+/**
+ * @brief Gets Page by page_id, pins the Page, and returns a pointer to it.
+ * @see BasicBufferManager::getPage()
+ */
+Page* BufferManager::getPage(PageId page_id, AccessHint hint){
+  return this->impl->getPage(page_id, hint);
+}
+
+/**
+ * @brief Gets the data of a Page by page_id for reading only, pins the Page,
+ *    and returns a pointer to its data.
+ * @see BasicBufferManager::getPageData()
+ */
+const char* BufferManager::getPageData(PageId page_id, AccessHint hint){
+  return this->impl->getPageData(page_id, hint);
+}
+
+/**
+ * @brief Unpins a Page in the buffer pool.
+ * @see BasicBufferManager::releasePage()
+ */
+void BufferManager::releasePage(PageId page_id, bool dirty, AccessHint hint){
+  this->impl->releasePage(page_id, dirty, hint);
+}
+
+/**
+ * @brief Set the Page of the given PageId dirty.
+ * @see BasicBufferManager::setDirty()
+ */
+void BufferManager::setDirty(PageId page_id){
+  this->impl->setDirty(page_id);
+}
+
+/**
+ * @brief Flushes the Page of the given PageId to disk.
+ * @see BasicBufferManager::flushPage()
+ */
+void BufferManager::flushPage(PageId page_id){
+  this->impl->flushPage(page_id);
+}
+
+/**
+ * @brief Creates the Unix file that corresponds to the given FileId.
+ * @see BasicBufferManager::createFile()
+ */
+void BufferManager::createFile(FileId file_id){
+  this->impl->createFile(file_id);
+}
+
+/**
+ * @brief Removes the file's pages from the buffer pool and the file from
+ *    disk.
+ * @see BasicBufferManager::removeFile()
+ */
+void BufferManager::removeFile(FileId file_id){
+  this->impl->removeFile(file_id);
+}
+
+/**
+ * @brief Removes the file's pages from the buffer pool, writing the dirty
+ *    ones to disk.
+ * @see BasicBufferManager::evictFile()
+ */
+void BufferManager::evictFile(FileId file_id){
+  this->impl->evictFile(file_id);
+}
+
+/**
+ * @brief Turns the TinyLFU admission filter on or off.
+ * @see BasicBufferManager::setAdmission()
+ */
+void BufferManager::setAdmission(bool enabled){
+  this->impl->setAdmission(enabled);
+}
+
+/**
+ * @brief Chooses the replacement policy used for the pages of the given
+ *    file.
+ * @see BasicBufferManager::setFilePolicy()
+ */
+void BufferManager::setFilePolicy(FileId file_id, PolicyType rep_type){
+  this->impl->setFilePolicy(file_id, rep_type);
+}
+
+/**
+ * @brief Returns true if the Page of the given PageId is resident.
+ * @see BasicBufferManager::isResident()
+ */
+bool BufferManager::isResident(PageId page_id){
+  return this->impl->isResident(page_id);
+}
+
+/**
+ * @brief Turns the compressed cache of evicted pages on or off.
+ * @see BasicBufferManager::setCompressedCache()
+ */
+void BufferManager::setCompressedCache(std::size_t budget){
+  this->impl->setCompressedCache(budget);
+}
+
+/**
+ * @brief Returns the counters of the compressed cache.
+ * @see BasicBufferManager::getCompressedCacheStats()
+ */
+CompressedCacheStats BufferManager::getCompressedCacheStats(){
+  return this->impl->getCompressedCacheStats();
+}
+
+/**
+ * @brief Turns the SSD cache of evicted pages on or off.
+ * @see BasicBufferManager::setSsdCache()
+ */
+void BufferManager::setSsdCache(const std::string &path,
+    std::uint32_t num_pages){
+  this->impl->setSsdCache(path, num_pages);
+}
+
+/**
+ * @brief Returns the counters of the SSD cache.
+ * @see BasicBufferManager::getSsdCacheStats()
+ */
+SsdCacheStats BufferManager::getSsdCacheStats(){
+  return this->impl->getSsdCacheStats();
+}
+
+/**
+ * @brief Serves the pages of the given file from a mapping of its Unix file.
+ * @see BasicBufferManager::mapFile()
+ */
+void BufferManager::mapFile(FileId file_id, const std::string &path){
+  this->impl->mapFile(file_id, path);
+}
+
+/**
+ * @brief Unmaps a mapped file.
+ * @see BasicBufferManager::unmapFile()
+ */
+void BufferManager::unmapFile(FileId file_id){
+  this->impl->unmapFile(file_id);
+}
+
+/**
+ * @brief Returns the number of pages of a mapped file in memory.
+ * @see BasicBufferManager::sampleMappedPages()
+ */
+std::uint32_t BufferManager::sampleMappedPages(FileId file_id){
+  return this->impl->sampleMappedPages(file_id);
+}
+
+/**
+ * @brief Writes the PageIds of the resident pages to a file, hottest first.
+ * @see BasicBufferManager::dumpResidentPages()
+ */
+std::uint32_t BufferManager::dumpResidentPages(const std::string &path){
+  return this->impl->dumpResidentPages(path);
+}
+
+/**
+ * @brief Queues the pages of a dump to be read back in by warmUp.
+ * @see BasicBufferManager::warmFromDump()
+ */
+std::uint32_t BufferManager::warmFromDump(const std::string &path){
+  return this->impl->warmFromDump(path);
+}
+
+/**
+ * @brief Reads the next queued pages of a dump into free frames.
+ * @see BasicBufferManager::warmUp()
+ */
+std::uint32_t BufferManager::warmUp(std::uint32_t max_pages){
+  return this->impl->warmUp(max_pages);
+}
+
+/**
+ * @brief Turns automatic dumps of the resident pages on or off.
+ * @see BasicBufferManager::setAutoDump()
+ */
+void BufferManager::setAutoDump(const std::string &path,
+    std::uint32_t interval){
+  this->impl->setAutoDump(path, interval);
+}
+
+/**
+ * @brief Returns the kind of memory the buffer pool was placed in.
+ */
+PoolMemory BufferManager::getPoolMemory(){
+  return this->pool_memory;
+}
+
+/**
+ * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+ *    Returns the current state of the buffer pool.
+ * @see BufferState
+ */
+BufferState BufferManager::getBufferState(){
+  return this->impl->getBufferState();
+}
+
+/**
+ * @brief Returns the hit, miss, eviction and I/O counters of the buffer
+ *    pool.
+ * @see BasicBufferManager::getBufferStats()
+ */
+BufferStats BufferManager::getBufferStats(){
+  return this->impl->getBufferStats();
+}
+
+/**
+ * @brief Times one in every `every` operations of each kind into latency
+ *    histograms.
+ * @see BasicBufferManager::setLatencySampling()
+ */
+void BufferManager::setLatencySampling(std::uint32_t every){
+  this->impl->setLatencySampling(every);
+}
+
+/**
+ * @brief Returns a copy of the latency histogram of the given kind of
+ *    operation.
+ * @see BasicBufferManager::getLatency()
+ */
+LatencyHistogram BufferManager::getLatency(LatencyKind kind){
+  return this->impl->getLatency(kind);
+}
+
+/**
+ * @brief Records the getPage, releasePage and allocatePage calls to tracer,
+ *    or stops recording if it is nullptr.
+ * @see BasicBufferManager::setTracer()
+ */
+void BufferManager::setTracer(TraceRecorder *tracer){
+  this->impl->setTracer(tracer);
+}
+
+/**
+ * @brief Turns the SHARDS estimate of the miss ratio curve on or off.
+ * @see BasicBufferManager::setMissRatioCurve()
+ */
+void BufferManager::setMissRatioCurve(bool enabled){
+  this->impl->setMissRatioCurve(enabled);
+}
+
+/**
+ * @brief Returns the predicted hit rates of the buffer pool at 0.5, 1, 2 and
+ *    4 times BUF_SIZE frames.
+ * @see BasicBufferManager::getMissRatioCurve()
+ */
+MissRatioCurve BufferManager::getMissRatioCurve(){
+  return this->impl->getMissRatioCurve();
+}
+
+/**
+ * @brief Renders the state, counters and latency percentiles of the buffer
+ *    pool in the Prometheus text exposition format.
+ * @see BasicBufferManager::getMetrics()
+ */
+std::string BufferManager::getMetrics(){
+  return this->impl->getMetrics();
+}
+
+/**
+ * @brief Writes getMetrics to a file, written aside and renamed.
+ *
+ * @param path Path of the metrics file.
+ *
+ * @throw IOErrorBufMgr If the file cannot be written.
+ */
+void BufferManager::writeMetrics(const std::string &path){
+  bm_write_metrics(path, getMetrics());
+}
+
+/**
+ * @brief Return the amount of unpinned pages in the buffer pool
+ */
+std::uint32_t BufferManager::getNumUnpinned(){
+  return this->impl->getNumUnpinned();
+}
+
+/**
+ * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+ *    Prints frame state of every frame in the buffer pool.
+ */
+void BufferManager::printAllFrames(){
+  this->impl->printAllFrames();
+}
+
+/**
+ * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+ *    Prints frame state of every valid frame in the buffer pool.
+ */
+void BufferManager::printValidFrames(){
+  this->impl->printValidFrames();
+}
+
+/**
+ * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+ *    Prints frame state of given FrameId.
+ */
+void BufferManager::printFrame(FrameId frame_id){
+  this->impl->printFrame(frame_id);
+}
+
+/**
+ * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+ *    Prints frame state of given PageId.
+ */
+void BufferManager::printPage(PageId page_id){
+  this->impl->printPage(page_id);
+}
+
+/**
+ * @brief THIS METHOD IS FOR DEBUGGING ONLY.
+ *    Prints current buffer state.
+ */
+void BufferManager::printBufferState(){
+  this->impl->printBufferState();
+}
+
+/**
+ * @brief This method is for performance tests.
+ *    Prints the replacement policy's and admission filter's statistics.
+ */
+void BufferManager::printReplacementStats(){
+  this->impl->printReplacementStats();
+}
@@ -21,16 +21,26 @@
  */
 
 
+#include <atomic>
 #include <utility>
 #include <unordered_map>
 #include <mutex>
 #include <list>
 #include <queue>
+#include <string>
+#include <vector>
 
 #include "swatdb_types.h"
 #include "page.h"           // need for alignment of Page object
 #include "bm_buffermap.h"   // BufferMap class
 #include "bm_frame.h"       // Frame class
+#include "bm_tinylfu.h"     // TinyLfu class
+#include "bm_memory.h"      // PoolMemory
+#include "bm_ccache.h"      // CompressedCacheStats
+#include "bm_ssdcache.h"    // SsdCacheStats
+#include "bm_stats.h"       // StatCounters, BufferStats
+#include "bm_latency.h"     // LatencyHistogram
+#include "bm_mrc.h"         // MissRatioCurve
                             
 
 
@@ -38,6 +48,74 @@
 // (one shortcomming of #pragma once)
 class ReplacementPolicy;
 class DiskManager;
+class MappedFiles;
+class CompressedCache;
+class SsdCache;
+class TraceRecorder;
+
+
+/**
+ * Replacement policy of this buffer manager: a RepType of swatdb_types.h,
+ * which converts to it implicitly, or one of the policies declared below.
+ * These are numbered after INVALID_REP_TYPE so they never collide with a
+ * value of the library. That is beyond the range of RepType, so they are
+ * ints, and a RepType becomes a PolicyType where it enters this buffer
+ * manager, never the other way around.
+ */
+typedef int PolicyType;
+
+static const PolicyType GClockT = INVALID_REP_TYPE + 1;
+static const PolicyType ClockProT = INVALID_REP_TYPE + 2;
+static const PolicyType LirsT = INVALID_REP_TYPE + 3;
+static const PolicyType SieveT = INVALID_REP_TYPE + 4;
+static const PolicyType S3FifoT = INVALID_REP_TYPE + 5;
+static const PolicyType PerFileT = INVALID_REP_TYPE + 6;
+static const PolicyType LruKT = INVALID_REP_TYPE + 7;
+
+/**
+ * Cap of the usage count of each frame when BufferManager is constructed with
+ * GClockT. Can be changed at compile time with -DGCLOCK_MAX_WEIGHT=n.
+ */
+#ifndef GCLOCK_MAX_WEIGHT
+#define GCLOCK_MAX_WEIGHT 5
+#endif
+
+/**
+ * Number of most recent references remembered for each page of a file whose
+ * pages are replaced by LRU-K under PerFileT. Can be changed at compile time
+ * with -DLRU_K=n.
+ */
+#ifndef LRU_K
+#define LRU_K 2
+#endif
+
+/**
+ * Number of pages that can be held outside of the buffer pool when the
+ * admission filter refuses to let them replace a page of the pool. Can be
+ * changed at compile time with -DBM_BYPASS_SIZE=n.
+ */
+#ifndef BM_BYPASS_SIZE
+#define BM_BYPASS_SIZE 8
+#endif
+
+/**
+ * @brief Returns the printable name of a replacement policy type, including
+ *        the types declared above that bm_rep_strs does not know about.
+ */
+std::string bm_rep_str(PolicyType rep_type);
+
+/**
+ * What the caller of getPage or releasePage knows about how a page will be
+ * accessed. The hint of the last getPage or releasePage of a page is applied
+ * when its pin count drops to 0.
+ */
+enum AccessHint {
+  NoHint,          // nothing is known, the policy decides as usual
+  SequentialHint,  // part of a one-shot scan: placed at the cold end
+  RandomHint,      // a random probe: the policy decides as usual
+  OnceHint,        // not needed again: leaves the buffer pool when unpinned
+  KeepHotHint      // a hot page, e.g. of the catalog: placed at the hot end
+};
 
 
 /**
@@ -76,7 +154,7 @@ struct BufferState {
     /**
      * Which Replacement Policy has been called
      */
-    RepType rep_type;
+    PolicyType rep_type;
     /**
      * The number of times the replacement policy has been called.
      */
@@ -106,20 +184,456 @@ struct BufferState {
 
 };
 
+/**
+ * @brief Adds the page counts and replacement calls of state to total, for
+ *        buffer managers made of several BufferManagers. avg_frames_checked
+ *        is weighted by the replacement calls of both, and total keeps its
+ *        rep_type and clock_hand.
+ */
+void bm_add_state(BufferState *total, const BufferState &state);
+
+
+/**
+ * SwatDB BufferManagerBase Class.
+ * Interface of a buffer manager whose replacement policy is not known at
+ * compile time. BufferManager reaches the BasicBufferManager instantiated for
+ * the policy chosen at run time through it. Every method has the contract of
+ * the BufferManager method of the same name.
+ */
+class BufferManagerBase {
+
+  public:
+
+    /**
+     * @brief BufferManagerBase destructor.
+     */
+    virtual ~BufferManagerBase(){}
+
+    /**
+     * Page and file operations.
+     * @see BufferManager
+     */
+    virtual std::pair<Page*,PageId> allocatePage(FileId file_id) = 0;
+    virtual Page* installPage(PageId page_id) = 0;
+    virtual void deallocatePage(PageId page_id) = 0;
+    virtual Page* getPage(PageId page_id, AccessHint hint = NoHint) = 0;
+    virtual const char* getPageData(PageId page_id,
+                                    AccessHint hint = NoHint) = 0;
+    virtual void releasePage(PageId page_id, bool dirty,
+                             AccessHint hint = NoHint) = 0;
+    virtual void setDirty(PageId page_id) = 0;
+    virtual void flushPage(PageId page_id) = 0;
+    virtual void createFile(FileId file_id) = 0;
+    virtual void removeFile(FileId file_id) = 0;
+    virtual void evictFile(FileId file_id) = 0;
+    virtual void setAdmission(bool enabled) = 0;
+    virtual void setCompressedCache(std::size_t budget) = 0;
+    virtual CompressedCacheStats getCompressedCacheStats() = 0;
+    virtual void setSsdCache(const std::string &path,
+                             std::uint32_t num_pages) = 0;
+    virtual SsdCacheStats getSsdCacheStats() = 0;
+    virtual void setFilePolicy(FileId file_id, PolicyType rep_type) = 0;
+    virtual bool isResident(PageId page_id) = 0;
+    virtual void mapFile(FileId file_id, const std::string &path) = 0;
+    virtual void unmapFile(FileId file_id) = 0;
+    virtual std::uint32_t sampleMappedPages(FileId file_id) = 0;
+    virtual std::uint32_t dumpResidentPages(const std::string &path) = 0;
+    virtual std::uint32_t warmFromDump(const std::string &path) = 0;
+    virtual std::uint32_t warmUp(std::uint32_t max_pages) = 0;
+    virtual void setAutoDump(const std::string &path,
+                             std::uint32_t interval) = 0;
+
+    /**
+     * Debugging and statistics methods.
+     * @see BufferManager
+     */
+    virtual BufferState getBufferState() = 0;
+    virtual BufferStats getBufferStats() = 0;
+    virtual void setLatencySampling(std::uint32_t every) = 0;
+    virtual LatencyHistogram getLatency(LatencyKind kind) = 0;
+    virtual void setTracer(TraceRecorder *tracer) = 0;
+    virtual void setMissRatioCurve(bool enabled) = 0;
+    virtual MissRatioCurve getMissRatioCurve() = 0;
+    virtual std::string getMetrics() = 0;
+    virtual std::uint32_t getNumUnpinned() = 0;
+    virtual void printAllFrames() = 0;
+    virtual void printValidFrames() = 0;
+    virtual void printFrame(FrameId frame_id) = 0;
+    virtual void printPage(PageId page_id) = 0;
+    virtual void printBufferState() = 0;
+    virtual void printReplacementStats() = 0;
+};
+
+
+/**
+ * SwatDB BasicBufferManager Class.
+ * Buffer manager whose replacement policy is fixed at compile time. Policy is
+ * one of the ReplacementPolicy classes of bm_policies.h, held by value, so
+ * the pin and unpin hooks on the hit path of getPage and releasePage are
+ * called directly and inlined, and a hook with an empty body, like
+ * Sieve::unpin, costs nothing. Instantiated in bufmgr.cpp for every policy
+ * BufferManager can be constructed with. Every method has the contract of the
+ * BufferManager method of the same name.
+ */
+template <class Policy>
+class BasicBufferManager final : public BufferManagerBase {
+
+  public:
+
+    /**
+     * @brief BasicBufferManager constructor. Initializes the buf_pool,
+     *        frame_table and replacement policy, and stores a pointer to
+     *        SwatDB's DiskManager.
+     *
+     * @pre disk_mgr points to an initialized DiskManager object.
+     * @post A BasicBufferManager object will be initialized with an empty
+     *       buffer pool.
+     *
+     * @param disk_mgr A pointer to SwatDB's DiskManager object.
+     *    (DiskManager*).
+     */
+    BasicBufferManager(DiskManager *disk_mgr);
+
+    /**
+     * @brief BasicBufferManager destructor.
+     *
+     * @pre None.
+     * @post Every valid and dirty Page in buffer pool and in the bypass area
+     *       is written to disk.
+     */
+    ~BasicBufferManager();
+
+    /**
+     * Page and file operations.
+     * @see BufferManager
+     */
+    std::pair<Page*,PageId> allocatePage(FileId file_id) override;
+    Page* installPage(PageId page_id) override;
+    void deallocatePage(PageId page_id) override;
+    Page* getPage(PageId page_id, AccessHint hint = NoHint) override;
+    const char* getPageData(PageId page_id,
+                            AccessHint hint = NoHint) override;
+    void releasePage(PageId page_id, bool dirty,
+                     AccessHint hint = NoHint) override;
+    void setDirty(PageId page_id) override;
+    void flushPage(PageId page_id) override;
+    void createFile(FileId file_id) override;
+    void removeFile(FileId file_id) override;
+    void evictFile(FileId file_id) override;
+    void setAdmission(bool enabled) override;
+    void setCompressedCache(std::size_t budget) override;
+    CompressedCacheStats getCompressedCacheStats() override;
+    void setSsdCache(const std::string &path,
+                     std::uint32_t num_pages) override;
+    SsdCacheStats getSsdCacheStats() override;
+    void setFilePolicy(FileId file_id, PolicyType rep_type) override;
+    bool isResident(PageId page_id) override;
+    void mapFile(FileId file_id, const std::string &path) override;
+    void unmapFile(FileId file_id) override;
+    std::uint32_t sampleMappedPages(FileId file_id) override;
+    std::uint32_t dumpResidentPages(const std::string &path) override;
+    std::uint32_t warmFromDump(const std::string &path) override;
+    std::uint32_t warmUp(std::uint32_t max_pages) override;
+    void setAutoDump(const std::string &path,
+                     std::uint32_t interval) override;
+
+    /**
+     * Debugging and statistics methods.
+     * @see BufferManager
+     */
+    BufferState getBufferState() override;
+    BufferStats getBufferStats() override;
+    void setLatencySampling(std::uint32_t every) override;
+    LatencyHistogram getLatency(LatencyKind kind) override;
+    void setTracer(TraceRecorder *tracer) override;
+    void setMissRatioCurve(bool enabled) override;
+    MissRatioCurve getMissRatioCurve() override;
+    std::string getMetrics() override;
+    std::uint32_t getNumUnpinned() override;
+    void printAllFrames() override;
+    void printValidFrames() override;
+    void printFrame(FrameId frame_id) override;
+    void printPage(PageId page_id) override;
+    void printBufferState() override;
+    void printReplacementStats() override;
+
+    /**
+     * @brief Returns the replacement policy, so that tests can check its
+     *        state.
+     */
+    Policy& getPolicy(){
+      return this->policy;
+    }
+
+  private:
+    /**
+     * A wrapper for std::unordered_map<PageId, FrameId> that maps PageIds to
+     * Frame indices in buf_pool. Has different methods from
+     * std::unordered_map.  Have get(), contains(), insert(), and remove()
+     * methods.
+     */
+    BufferMap buf_map;
+
+    /**
+     * Array of Frame objects. Frames store metadata about each Page in the
+     * buffer pool.
+     */
+    Frame frame_table[BUF_SIZE];
+
+    /**
+     * Array of Page objects. Represents the buffer pool.
+     */
+    Page buf_pool[BUF_SIZE];
+
+    /**
+     * Pointer to SwatDB's DiskManager. Used for reading, writing, allocating,
+     * and deallocating pages to disk.
+     */
+    DiskManager* disk_mgr;
+
+    /**
+     * Replacement policy. Used for determining which frame to remove. Must
+     * be declared after frame_table, which it is constructed with.
+     */
+    Policy policy;
+
+    /**
+     * Parallel array to the frame_table which stores the hint of the last
+     * getPage or releasePage of the page of each frame, until it is applied
+     * when the pin count drops to 0.
+     */
+    AccessHint frame_hint[BUF_SIZE];
+
+    /**
+     * Pointer to the TinyLFU admission filter, nullptr while admission is
+     * off.
+     */
+    TinyLfu *admission;
+
+    /**
+     * Maps the PageIds of the pages in the bypass area to their slot.
+     */
+    BufferMap bypass_map;
+
+    /**
+     * Metadata of the pages in the bypass area. A slot is in use while its
+     * Frame is valid, and its page is always pinned.
+     */
+    Frame bypass_table[BM_BYPASS_SIZE];
+
+    /**
+     * Pages read in without being admitted to the buffer pool.
+     */
+    Page bypass_pool[BM_BYPASS_SIZE];
+
+    /**
+     * Pointer to the files whose pages are served from a mapping of their
+     * Unix file instead of the buffer pool, nullptr until a file is mapped.
+     */
+    MappedFiles *mapped;
+
+    /**
+     * Pointer to the compressed cache of pages evicted from the buffer pool,
+     * nullptr while it is off.
+     */
+    CompressedCache *ccache;
+
+    /**
+     * Pointer to the SSD cache of pages evicted from the buffer pool,
+     * nullptr while it is off.
+     */
+    SsdCache *ssd_cache;
+
+    /**
+     * PageIds read from a dump by warmFromDump, hottest first, and the index
+     * of the next one warmUp reads in.
+     */
+    std::vector<PageId> warm_queue;
+    std::size_t warm_next;
+
+    /**
+     * Path the resident pages are dumped to at destruction and every
+     * dump_interval misses, empty while automatic dumps are off.
+     */
+    std::string dump_path;
+    std::uint32_t dump_interval;
+
+    /**
+     * Number of pages read into the buffer pool since the last automatic
+     * dump.
+     */
+    std::uint32_t dump_misses;
+
+    /**
+     * Hit, miss, eviction and I/O counters.
+     */
+    StatCounters stats;
+
+    /**
+     * Latency histograms, indexed by LatencyKind, the number of operations
+     * of which one is timed, 0 for none, and the number of operations of
+     * each kind left until the next timed one.
+     */
+    LatencyHistogram latency[BM_NUM_LATENCIES];
+    std::uint32_t latency_every;
+    std::atomic<std::uint32_t> latency_left[BM_NUM_LATENCIES];
+
+    /**
+     * TraceRecorder the page accesses are recorded to, or nullptr.
+     */
+    TraceRecorder *tracer;
+
+    /**
+     * Pointer to the SHARDS estimator of the miss ratio curve, nullptr while
+     * it is off.
+     */
+    MissRatioEstimator *mrc;
+
+    /**
+     * @brief Returns true if this operation of the given kind is to be
+     *        timed.
+     */
+    bool _sampleLatency(LatencyKind kind){
+      if( latency_every == 0 ||
+          latency_left[kind].fetch_sub(1, std::memory_order_relaxed) != 1 ){
+        return false;
+      }
+      // a thread counting past 0 before the reset only skips a sample
+      latency_left[kind].store(latency_every, std::memory_order_relaxed);
+      return true;
+    }
+
+    /**
+     * @brief Asks the replacement policy for a frame for page_id, timing
+     *        the call if it is sampled.
+     */
+    FrameId _replaceFor(PageId page_id);
+
+    /**
+     * @brief Allocates a free Frame using the current replacement policy.
+     *
+     * @pre None.
+     * @post A FrameId of an available Frame is returned. If the Frame was
+     *       previously valid (containing a Page), the Page is written to
+     *       disk if it is dirty, put in the compressed and SSD caches that
+     *       are on, and the corresponding entry in buf_map is removed. The
+     *       Frame's valid, dirty, and pin_count fields are reset.
+     *
+     * @param page_id PageId of the page the Frame is allocated for.
+     * @return FrameId of the allocated Frame.
+     */
+    FrameId _allocateFrame(PageId page_id);
+
+    /**
+     * @brief Puts a page just allocated on disk in a Frame, pinned, without
+     *        reading it.
+     *
+     * @pre The buffer pool has an unpinned Frame, and page_id is not in it.
+     * @return Pointer to the Page in the buffer pool.
+     */
+    Page* _install(PageId page_id);
+
+    /**
+     * @brief Reads a page rejected by the admission filter into a free slot
+     *        of the bypass area and hands the frame chosen for replacement
+     *        back to the replacement policy.
+     *
+     * @pre frame_id was just returned by the replacement policy and holds a
+     *      valid, unpinned page.
+     * @post If a slot is free, the page is pinned in it and a pointer to it
+     *       is returned, and frame_id is resident again in the replacement
+     *       policy. Else nullptr is returned and nothing changes.
+     *
+     * @param page_id PageId of the page to read.
+     * @param frame_id FrameId of the frame chosen for replacement.
+     * @return Pointer to the Page in the bypass area, or nullptr.
+     *
+     * @throw InvalidPageIdBufMgr If page_id is not valid.
+     */
+    Page* _getBypassPage(PageId page_id, FrameId frame_id);
+
+    /**
+     * @brief Unpins a page in the bypass area, and drops it, writing it to
+     *        disk first if it is dirty, when its pin count reaches 0.
+     *
+     * @pre page_id is in bypass_map.
+     * @post The pin count of the page is decremented.
+     *
+     * @param page_id PageId of the Page to be released.
+     * @param dirty true if the caller modified the Page.
+     */
+    void _releaseBypassPage(PageId page_id, bool dirty);
+
+    /**
+     * @brief Removes the unpinned page of a frame from the buffer pool,
+     *        writing it to disk first if it is dirty, and hands the frame
+     *        back to the replacement policy's free list.
+     *
+     * @pre frame_id holds a valid page with pin count 0.
+     * @post The frame is invalid and on the free list.
+     *
+     * @param frame_id FrameId of the frame to empty.
+     */
+    void _dropPage(FrameId frame_id);
+
+    /**
+     * @brief Reads a page that is not in the buffer pool into page, from the
+     *        compressed cache, else the SSD cache, else the DiskManager. The
+     *        caches are exclusive, so a page read in leaves both.
+     *
+     * @throw InvalidFileIdDiskMgr If page_id.file_id is not valid.
+     * @throw InvalidPageNumDiskMgr If page_id.page_num is not valid.
+     */
+    void _readPage(PageId page_id, Page *page);
+
+    /**
+     * @brief Puts a page leaving the buffer pool, as it is on disk, in the
+     *        compressed and SSD caches that are on.
+     */
+    void _cachePage(PageId page_id, Page *page);
+
+    /**
+     * @brief Writes a page to disk through the DiskManager and counts the
+     *        write.
+     */
+    void _writePage(PageId page_id, Page *page);
+
+    /**
+     * @brief Counts a page read into the buffer pool, and dumps the resident
+     *        pages to dump_path every dump_interval of them.
+     */
+    void _countMiss();
+
+
+    /**
+     * @brief this is a helper method to print one frame
+     *        Prints frame state of given FrameId, including pin count, valid
+     *        bit, dirty bit, and ref_bit. If Page is valid, PageId is printed.
+     */
+    void _printFrameHelper(FrameId frame_id);
+
+
+};
+
 
 /**
  * SwatDb BufferManager Class.
  * BufferManager manages in memory space of DBMS at page level granularity.
  * At higher level, pages of data could be allocated, deallocated, retrieved
- * to memory and fliushed to disk, using various methods.
+ * to memory and fliushed to disk, using various methods. The replacement
+ * policy is chosen at run time by its PolicyType, and every method is forwarded
+ * to the BasicBufferManager of that policy. Code that knows its policy at
+ * compile time can use BasicBufferManager directly and skip the indirection.
  */
 class BufferManager {
 
   public:
 
     /**
-     * @brief BufferManager constructor. Initializes the buf_pool and
-     *    frame_table, and stores a pointer to SwatDB's DiskManager.
+     * @brief BufferManager constructor. Creates the BasicBufferManager of
+     *    the replacement policy of the given type, which initializes the
+     *    buf_pool and frame_table, and stores a pointer to SwatDB's
+     *    DiskManager.
      *
      * @pre disk_mgr points to an initialized DiskManager object.
      * @post A BufferManager object will be initialized with an empty
@@ -131,7 +645,32 @@ class BufferManager {
      *
      * @throw InvalidPolicyBufMgr If the replacement policy type is invalid.
      */
-    BufferManager(DiskManager *disk_mgr, RepType rep_type);
+    BufferManager(DiskManager *disk_mgr, PolicyType rep_type);
+
+    /**
+     * @brief BufferManager constructor that maps the memory of the buffer
+     *        pool, in the memory of a NUMA node and on huge pages. If the
+     *        node does not exist or the system has no NUMA support, the
+     *        memory is placed as usual. Huge pages reserved with MAP_HUGETLB
+     *        are tried first, then transparent huge pages, then base pages.
+     *        getPoolMemory() reports which was obtained.
+     *
+     * @pre disk_mgr points to an initialized DiskManager object.
+     * @post A BufferManager object will be initialized with an empty
+     *    buffer pool whose frames prefer the memory of numa_node.
+     *
+     * @param disk_mgr A pointer to SwatDB's DiskManager object.
+     *    (DiskManager*).
+     * @param rep_type Replacement policy type.
+     * @param numa_node NUMA node to place the buffer pool on, or -1 to place
+     *    it as usual.
+     * @param huge_pages true to place the buffer pool on huge pages.
+     *
+     * @throw InvalidPolicyBufMgr If the replacement policy type is invalid.
+     * @throw std::bad_alloc If the memory of the buffer pool cannot be mapped.
+     */
+    BufferManager(DiskManager *disk_mgr, PolicyType rep_type, int numa_node,
+                  bool huge_pages = false);
 
     /**
      * @brief BufferManager destructor.
@@ -165,6 +704,26 @@ class BufferManager {
      */
     std::pair<Page*,PageId> allocatePage(FileId file_id);
 
+    /**
+     * @brief Puts a Page the caller has just allocated on disk in the buffer
+     *        pool, pinned, without reading it from disk, as allocatePage
+     *        does for the Page it allocates. For buffer managers made of
+     *        several BufferManagers, which only know the BufferManager a
+     *        Page belongs to once the disk has chosen its PageId.
+     *
+     * @pre page_id was just allocated through the DiskManager and is not in
+     *      the buffer pool.
+     * @post A Frame holds the Page, with pin_count 1 and dirty false.
+     *
+     * @param page_id PageId of the allocated Page.
+     * @return Pointer to the Page in the buffer pool.
+     *
+     * @throw PageAlreadyLoadedBufMgr If the Page is in the buffer pool.
+     * @throw InsufficientSpaceBufMgr If there is not enough space in buffer
+     *        pool.
+     */
+    Page* installPage(PageId page_id);
+
     /**
      * @brief Removes the Page of the given PageId from the buffer pool,
      *    and deallocates the Page from the appopriate file on disk.
@@ -193,22 +752,43 @@ class BufferManager {
      *      pool is not full of pinned pages.
      * @post If the page_id is in buf_map, the Page is pinned and its pointer
      *       is returned. Else, a Frame is allocated in the buffer pool
-     *       according to the page replacement policy, the Page is read from
-     *       disk_mgr into the buffer pool, and the page_id, pin count, and
-     *       valid bit are set.  pin_count is incremented by a successful
-     *       getPage.  Page* is returned.
+     *       according to the page replacement policy, the Page is read into
+     *       the buffer pool from the compressed or SSD cache if one holds
+     *       the page, else from disk_mgr, and the page_id, pin count, and
+     *       valid bit are set.  pin_count is incremented by a successful getPage.
+     *       Page* is returned.
      *
      * @param page_id A PageId corresponding to the pointer to be returned.
+     * @param hint How the page will be accessed, applied when the page is
+     *        unpinned unless releasePage gives another hint.
      * @return Pointer to the Page with page_id.
      *
      * @throw InvalidPageIdBufMgr If page_id is not valid.
      * @throw InsufficientSpaceBufMgr If buffer pool is full.
+     * @throw ReadOnlyFileBufMgr If the file is mapped, and so read-only:
+     *        its pages are read with getPageData. Nothing is pinned.
      *
      * @throw InvalidFileIdDiskMgr from DiskManager if page_id.file_id invalid
      * @throw InvalidPageNumDiskMgr from DiskManger if page_id.page_num invalid
      * @throw DiskErrorDiskMgr frome DiskManager if file operation fails.
      */
-    Page* getPage(PageId page_id);
+    Page* getPage(PageId page_id, AccessHint hint = NoHint);
+
+    /**
+     * @brief Gets the data of a Page by page_id for reading only, pins the
+     *        Page, and returns a pointer to its data. The same as getPage,
+     *        except that pages of mapped files are served too, in place in
+     *        the read-only mapping. The Page is unpinned with releasePage,
+     *        not dirty.
+     *
+     * @param page_id A PageId corresponding to the data to be returned.
+     * @param hint How the page will be accessed, as for getPage.
+     * @return Pointer to the PAGE_SIZE bytes of the Page with page_id.
+     *
+     * @throw InvalidPageIdBufMgr If page_id is not valid.
+     * @throw InsufficientSpaceBufMgr If buffer pool is full.
+     */
+    const char* getPageData(PageId page_id, AccessHint hint = NoHint);
 
     /**
      * @brief Unpins a Page in the buffer pool.
@@ -216,14 +796,20 @@ class BufferManager {
      * @pre A PageId of a pinned Page is provided as input. The Page is in the
      *      buffer pool and is pinned by the executing thread/process.
      * @post The pin count of the Page is decremented. ref_bit is set to true.
-     *       Dirty bit is set if the dirty parameter is true.
+     *       Dirty bit is set if the dirty parameter is true. If the pin count
+     *       reaches 0, the hint is applied: a page released with OnceHint
+     *       leaves the buffer pool, written to disk first if dirty, and the
+     *       replacement policy places a page released with SequentialHint at
+     *       its cold end and one released with KeepHotHint at its hot end.
      *
      * @param page_id PageId of the Page to be released.
+     * @param hint How the page will be accessed. NoHint keeps the hint given
+     *        to getPage.
      *
      * @throw PageNotPinnedBufMgr If Page is not pinned. (pin_count is 0).
      * @throw PageNotFoundBufMgr If page_id is not in buf_map.
      */
-    void releasePage(PageId page_id, bool dirty);
+    void releasePage(PageId page_id, bool dirty, AccessHint hint = NoHint);
 
     /**
      * @brief Set the Page of the given PageId dirty.
@@ -284,6 +870,263 @@ class BufferManager {
      */
     void removeFile(FileId file_id);
 
+    /**
+     * @brief Removes the file's pages from the buffer pool, writing the dirty
+     *        ones to disk, and leaves the file on disk. Nothing is removed if
+     *        any page of the file is pinned.
+     *
+     * @pre None of the file's pages are pinned in the buffer pool.
+     * @post None of the file's pages are in the buffer pool or the
+     *       compressed and SSD caches and every change to them is on disk.
+     *
+     * @param file_id FileId of the file to be evicted.
+     *
+     * @throw PagePinnedBufMgr If there are pinned pages of file_id.
+     */
+    void evictFile(FileId file_id);
+
+    /**
+     * @brief Turns the TinyLFU admission filter on or off. While it is on,
+     *        every getPage is recorded in the filter, and a page read in on
+     *        a miss that is estimated to be accessed less often than the page
+     *        chosen for replacement is read into the bypass area instead.
+     *        The page chosen for replacement stays in the buffer pool. A
+     *        bypassed page is dropped, written back first if dirty, as soon
+     *        as its pin count reaches 0.
+     *
+     * @pre None.
+     * @post Admission is on if enabled is true. Turning it off forgets the
+     *       frequency estimates. Pages already in the bypass area stay there
+     *       until they are released.
+     *
+     * @param enabled true to turn admission on.
+     */
+    void setAdmission(bool enabled);
+
+    /**
+     * @brief Turns the compressed cache of evicted pages on with the given
+     *        budget of bytes, or off if budget is 0. While it is on, a page
+     *        evicted from the buffer pool is compressed into the cache after
+     *        it is written back, and a miss is served by decompressing it
+     *        from the cache before asking the DiskManager. The cache is
+     *        exclusive: a page leaves it when it is read back in. Pages that
+     *        compress to more than 7/8 of PAGE_SIZE are not stored, and the
+     *        pages stored longest ago are dropped to stay within the budget.
+     *        Deallocating a page, or removing or evicting its file, drops it
+     *        from the cache.
+     *
+     * @pre None.
+     * @post The cache is empty, with the given budget, or off.
+     *
+     * @param budget Number of bytes the cache may hold, counting
+     *        CompressedCache::BM_CCACHE_OVERHEAD bytes per page, or 0.
+     */
+    void setCompressedCache(std::size_t budget);
+
+    /**
+     * @brief Returns the hits, misses, compression ratio and use of the
+     *        budget of the compressed cache, all 0 if it is off.
+     * @see CompressedCacheStats
+     */
+    CompressedCacheStats getCompressedCacheStats();
+
+    /**
+     * @brief Turns the SSD cache of evicted pages on with a cache file of
+     *        num_pages pages at path, or off if num_pages is 0. The cache
+     *        file is meant for fast local storage in front of slower
+     *        storage holding the database files. While it is on, a page
+     *        evicted from the buffer pool is written to the cache file by a
+     *        writer thread after it is written back, so dirty pages are
+     *        always written through to the DiskManager, and a miss is looked
+     *        up in the cache before the DiskManager reads it. A page leaves
+     *        the cache when it is read back in, and the slots of the cache
+     *        file are reused oldest first. Deallocating a page, or removing
+     *        or evicting its file, drops it from the cache.
+     *
+     *        Destroying the BufferManager writes the index of the cache
+     *        file next to it, so the cached pages are found again when a
+     *        BufferManager turns it on with the same file and size. The
+     *        pages are only valid if the database files are changed only
+     *        through buffer managers using the cache in the meantime.
+     *        Turning the cache off, or on with another file, drops its
+     *        pages, since the database files may be written while it is
+     *        off.
+     *
+     * @pre None.
+     * @post The cache is on with the given file, or off.
+     *
+     * @param path Path of the cache file.
+     * @param num_pages Number of pages the cache file holds, or 0.
+     *
+     * @throw IOErrorBufMgr If the cache file cannot be opened or sized.
+     *        The cache is off.
+     */
+    void setSsdCache(const std::string &path, std::uint32_t num_pages);
+
+    /**
+     * @brief Returns the hits, misses, writes and use of the SSD cache, all
+     *        0 if it is off.
+     * @see SsdCacheStats
+     */
+    SsdCacheStats getSsdCacheStats();
+
+    /**
+     * @brief Chooses the replacement policy used for the pages of the given
+     *        file. Only a BufferManager constructed with PerFileT supports it.
+     *        The buffer pool is split into one partition per policy in use,
+     *        each with an equal share of the frames, and a page read in on a
+     *        miss goes to the partition of its file. ClockT, MruT and LruKT
+     *        are available, files without a policy use ClockT.
+     *
+     * @pre None.
+     * @post Pages of file_id read in from now on are replaced by rep_type.
+     *       Pages already in the buffer pool stay in their partition until
+     *       they are replaced.
+     *
+     * @param file_id FileId of the file.
+     * @param rep_type Replacement policy type for the pages of the file.
+     *
+     * @throw InvalidPolicyBufMgr If the BufferManager was not constructed
+     *        with PerFileT, or rep_type is not ClockT, MruT or LruKT.
+     */
+    void setFilePolicy(FileId file_id, PolicyType rep_type);
+
+    /**
+     * @brief Returns true if the Page of the given PageId is in the buffer
+     *        pool or in the bypass area, without pinning it or counting an
+     *        access.
+     *
+     * @param page_id PageId of the Page.
+     * @return bool indicating whether the Page is resident.
+     */
+    bool isResident(PageId page_id);
+
+    /**
+     * @brief Serves the pages of the given file from a read-only
+     *        MAP_SHARED mapping of its Unix file instead of the buffer pool.
+     *        getPageData returns a pointer into the mapping, so a page is
+     *        never copied by the DiskManager, and pin counts and exceptions
+     *        work as for the buffer pool. Pages are prefetched with
+     *        MADV_WILLNEED when they are pinned, and at most BUF_SIZE
+     *        unpinned pages of the mapped files stay mapped in; the least
+     *        recently unpinned one is dropped from the mapping and the page
+     *        cache. Meant for large read-only files, like immutable tables.
+     *
+     *        The pages of the file must be stored contiguously at the end of
+     *        its Unix file, after a header of any size, and the DiskManager
+     *        must not buffer the file. The layout is checked against the
+     *        first and the last pages read through the DiskManager. Writes
+     *        go through the DiskManager only: while the file is mapped,
+     *        getPage, allocatePage, installPage, setDirty and a dirty
+     *        releasePage of its pages throw ReadOnlyFileBufMgr.
+     *
+     * @pre None of the file's pages are pinned in the buffer pool.
+     * @post The file's pages are written to disk and evicted from the buffer
+     *       pool, and are served from the mapping from now on.
+     *
+     * @param file_id FileId of the file.
+     * @param path Path of the Unix file of file_id.
+     *
+     * @throw PagePinnedBufMgr If there are pinned pages of file_id.
+     * @throw IOErrorBufMgr If the file cannot be mapped, or its layout is
+     *        not the one above.
+     */
+    void mapFile(FileId file_id, const std::string &path);
+
+    /**
+     * @brief Unmaps a mapped file. Its pages are read into the buffer pool
+     *        again from now on, and can be written again.
+     *        Does nothing if the file is not mapped.
+     *
+     * @param file_id FileId of the file.
+     *
+     * @throw PagePinnedBufMgr If there are pinned pages of file_id. The file
+     *        stays mapped.
+     */
+    void unmapFile(FileId file_id);
+
+    /**
+     * @brief Returns the number of pages of a mapped file that the kernel
+     *        holds in memory, sampled with mincore, or 0 if the file is not
+     *        mapped.
+     *
+     * @param file_id FileId of the file.
+     */
+    std::uint32_t sampleMappedPages(FileId file_id);
+
+    /**
+     * @brief Writes the PageIds of the pages in the buffer pool to a file,
+     *        in the order they should be read back in: pinned pages first,
+     *        then the others in the order of the replacement policy, the one
+     *        it would replace last first. Pages in the bypass area and of
+     *        mapped files are left out. The file is written aside and
+     *        renamed, so a crash while dumping leaves the previous dump.
+     *
+     * @pre None.
+     * @post path holds the PageIds of the resident pages. The buffer pool
+     *       is unchanged.
+     *
+     * @param path Path of the dump file.
+     * @return Number of PageIds written.
+     *
+     * @throw IOErrorBufMgr If the dump file cannot be written.
+     */
+    std::uint32_t dumpResidentPages(const std::string &path);
+
+    /**
+     * @brief Reads a dump written by dumpResidentPages and queues its first
+     *        BUF_SIZE pages to be read back in by warmUp, replacing any
+     *        pages still queued. A missing or damaged dump queues nothing,
+     *        as after a first start.
+     *
+     * @pre None.
+     * @post The pages of the dump are queued. The buffer pool is unchanged.
+     *
+     * @param path Path of the dump file.
+     * @return Number of pages queued.
+     */
+    std::uint32_t warmFromDump(const std::string &path);
+
+    /**
+     * @brief Reads the next max_pages queued pages into free frames of the
+     *        buffer pool, unpinned. Each batch is read in PageId order, so
+     *        the reads of a file are sequential, and handed to the
+     *        replacement policy hottest last, so the policy sees the order of
+     *        the dump. Warm-up never evicts a page: pages already read in by
+     *        getPage are skipped, and once the buffer pool is full the rest
+     *        of the queue is dropped. Pages that no longer exist on disk are
+     *        skipped. Calling it in small batches between foreground calls
+     *        lets getPage misses go first.
+     *
+     * @pre None.
+     * @post Up to max_pages queued pages are in the buffer pool.
+     *
+     * @param max_pages Number of pages to read in at most.
+     * @return Number of pages still queued, 0 once warm-up is over.
+     */
+    std::uint32_t warmUp(std::uint32_t max_pages);
+
+    /**
+     * @brief Dumps the resident pages to path with dumpResidentPages when
+     *        the BufferManager is destroyed and, if interval is above 0,
+     *        every interval pages read into the buffer pool, so that a dump
+     *        is at hand after a crash. A dump that fails while pages are read
+     *        in is skipped. An empty path turns automatic dumps off.
+     *
+     * @pre None.
+     * @post Automatic dumps go to path, or are off.
+     *
+     * @param path Path of the dump file, or empty.
+     * @param interval Number of pages read in between dumps, or 0 to only
+     *        dump at destruction.
+     */
+    void setAutoDump(const std::string &path, std::uint32_t interval);
+
+    /**
+     * @brief Returns the kind of memory the buffer pool was placed in.
+     */
+    PoolMemory getPoolMemory();
+
 
     /**
      * @brief THIS METHOD IS FOR DEBUGGING ONLY.
@@ -292,6 +1135,98 @@ class BufferManager {
      */
     BufferState getBufferState();
 
+    /**
+     * @brief Returns the hit, miss, eviction and I/O counters of the buffer
+     *        pool. The counters are always on and sharded per thread, so
+     *        they cost an uncontended add on the hit path. They may be read
+     *        from any thread, but form a snapshot between two operations,
+     *        where for instance hits + misses is the number of getPage calls
+     *        that returned so far, only when read under the latch of the
+     *        BufferManager or while no operation runs. getPage calls that
+     *        found every page pinned count as pin waits, not misses, and
+     *        pages of mapped files are not counted.
+     * @see BufferStats
+     */
+    BufferStats getBufferStats();
+
+    /**
+     * @brief Times one in every `every` getPage hits, getPage misses,
+     *        replacement policy calls, page reads and page writes into
+     *        log-bucketed histograms, with a cycle counter. 0, the default,
+     *        turns timing off, and 1 times every operation. Timing costs two
+     *        reads of the cycle counter per timed operation, so sampling
+     *        keeps it off the hit path in production.
+     *
+     * @param every Number of operations of each kind of which one is timed.
+     */
+    void setLatencySampling(std::uint32_t every);
+
+    /**
+     * @brief Returns a copy of the latency histogram of the given kind of
+     *        operation, whose percentileNs gives its p50, p99 and p999.
+     *        Only sampled operations are in it, and getPage calls that throw
+     *        are not. The histograms are also printed by
+     *        printReplacementStats.
+     * @see LatencyHistogram
+     */
+    LatencyHistogram getLatency(LatencyKind kind);
+
+    /**
+     * @brief Records every getPage, releasePage and allocatePage call,
+     *        with whether getPage hit, to tracer, or stops recording if it
+     *        is nullptr. Several buffer managers may record to the same
+     *        tracer. Recording is off by default and costs a test of tracer
+     *        per call when off. Pages of mapped files are not recorded.
+     *
+     * @pre tracer, if not nullptr, outlives its use by this BufferManager.
+     *
+     * @param tracer TraceRecorder to record to, or nullptr.
+     * @see TraceRecorder
+     */
+    void setTracer(TraceRecorder *tracer);
+
+    /**
+     * @brief Turns the online estimate of the miss ratio curve on or off.
+     *        While it is on, the reuse distances of a hash-chosen sample of
+     *        the pages given to getPage are measured (SHARDS), in bounded
+     *        memory, to predict the hit rate of the buffer pool at 0.5, 1,
+     *        2 and 4 times BUF_SIZE frames. Off by default; when on, a
+     *        getPage call of a page not sampled costs a hash and a compare.
+     *        Turning it off forgets the estimate.
+     *
+     * @param enabled true to turn the estimate on.
+     * @see MissRatioEstimator
+     */
+    void setMissRatioCurve(bool enabled);
+
+    /**
+     * @brief Returns the predicted hit rates of the buffer pool at 0.5, 1, 2
+     *        and 4 times BUF_SIZE frames, all 0 if the estimate is off.
+     *        Pages of mapped files are not counted.
+     * @see MissRatioCurve
+     */
+    MissRatioCurve getMissRatioCurve();
+
+    /**
+     * @brief Renders the state of the buffer pool, the statistics of the
+     *        replacement policy, the hit, miss, eviction and I/O counters
+     *        and the latency percentiles in the Prometheus text exposition
+     *        format, for a scraper or a log. Costs one pass over the frame
+     *        table, like getBufferState.
+     * @see bm_metrics_text()
+     */
+    std::string getMetrics();
+
+    /**
+     * @brief Writes getMetrics to a file, written aside and renamed, e.g.
+     *        for the textfile collector of the node exporter.
+     *
+     * @param path Path of the metrics file.
+     *
+     * @throw IOErrorBufMgr If the file cannot be written.
+     */
+    void writeMetrics(const std::string &path);
+
    /**
     * @brief Return the amount of unpinned pages in the buffer pool
     */
@@ -340,62 +1275,38 @@ class BufferManager {
     /**
      * @brief This method is for performance tests.
      *        Prints number of calls to replacment policy, average check on
-     *        replacement calls, lru/mru queue/stack usage.
+     *        replacement calls, lru/mru queue/stack usage, and the admission
+     *        filter's, compressed cache's and SSD cache's statistics if
+     *        they are on.
      */
     void printReplacementStats();
 
   private:
     /**
-     * A wrapper for std::unordered_map<PageId, FrameId> that maps PageIds to
-     * Frame indices in buf_pool. Has different methods from
-     * std::unordered_map.  Have get(), contains(), insert(), and remove()
-     * methods.
+     * Pointer to the BasicBufferManager of the chosen replacement policy.
      */
-    BufferMap buf_map;
+    BufferManagerBase *impl;
 
     /**
-     * Array of Frame objects. Frames store metadata about each Page in the
-     * buffer pool.
+     * Kind of memory impl was placed in, HeapPool if it was allocated with
+     * new.
      */
-    Frame frame_table[BUF_SIZE];
+    PoolMemory pool_memory;
 
     /**
-     * Array of Page objects. Represents the buffer pool.
+     * Size of the memory mapped for impl, unless it was allocated with new.
      */
-    Page buf_pool[BUF_SIZE];
-
-    /**
-     * Pointer to SwatDB's DiskManager. Used for reading, writing, allocating,
-     * and deallocating pages to disk.
-     */
-    DiskManager* disk_mgr;
+    std::size_t impl_size;
 
     /**
-     * Pointer to SwatDB's Replacement Policy. Used for determining which
-     * frame to remove.
+     * @brief Creates the BasicBufferManager of the given policy, with new or
+     *        in memory mapped by bm_pool_alloc if a NUMA node or huge pages
+     *        are asked for. The mapping is released if the constructor
+     *        throws.
      */
-    ReplacementPolicy *replacement_pol;
-
-      /**
-     * @brief Allocates a free Frame using the current replacement policy.
-     *
-     * @pre None.
-     * @post A FrameId of an available Frame is returned. If the Frame was
-     *       previously valid (containing a Page), the corresponding entry in
-     *       buf_map is removed. The Frame's valid, dirty, and pin_count fields
-     *       are reset.
-     *
-     * @return FrameId of the allocated Frame.
-     */
-    FrameId _allocateFrame();
-
-
-    /**
-     * @brief this is a helper method to print one frame
-     *        Prints frame state of given FrameId, including pin count, valid
-     *        bit, dirty bit, and ref_bit. If Page is valid, PageId is printed.
-     */
-    void _printFrameHelper(FrameId frame_id);
+    template <class Policy>
+    BufferManagerBase* _create(DiskManager *disk_mgr, int numa_node,
+                               bool huge_pages);
 
 
 };
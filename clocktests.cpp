@@ -135,6 +135,21 @@ class TestFixture{
 
 
 
+/*
+ * TestFixture that replaces the Clock buffer manager of TestFixture with one
+ * that uses the GClock replacement policy.
+ */
+class GClockFixture : public TestFixture {
+
+  public:
+    GClockFixture(){
+      delete this->buf_mgr;
+      this->buf_mgr = new BufferManager(disk_mgr, GClockT);
+    }
+};
+
+
+
 SUITE(clockTests){
   /**
    * Pins every page in the buffer pool and then unpins some of those pages.
@@ -309,7 +324,44 @@ SUITE(clockTests){
 
 #ifdef BMGR_DEBUG
     printBufferState();
-#endif 
+#endif
+  }
+
+
+  /*
+   * Fills the buffer pool and unpins only the last frame and frame 1, so the
+   * clock hand has to sweep past long runs of pinned frames. Checks that the
+   * referenced frames are given their second chance in clock hand order,
+   * that the frame found while the hand wraps around is replaced, and that
+   * the buffer pool throws once every frame is pinned again.
+   */
+  TEST_FIXTURE(TestFixture, pinnedSweepTest){
+    std::vector<Page*> page_data;
+    Page* temp_page;
+
+    PRINT("TEST: fills buffer pool, unpins frame 1 and the last frame\n");
+    PRINT("      checks replacement across long runs of pinned frames\n");
+    std::vector<PageId> allocated_pages = this->fillBufferPool(3, &page_data);
+
+    this->buf_mgr->releasePage(allocated_pages.at(BUF_SIZE-1), false);
+    this->buf_mgr->releasePage(allocated_pages.at(1), false);
+
+    // both frames have ref_bit set, the hand clears frame 1 then the last
+    // frame, and wraps around to replace frame 1
+    temp_page = this->buf_mgr->getPage(allocated_pages.at(BUF_SIZE));
+    CHECK_EQUAL(page_data.at(1), temp_page);
+
+    // the last frame had its ref_bit cleared on the previous sweep
+    temp_page = this->buf_mgr->getPage(allocated_pages.at(BUF_SIZE+1));
+    CHECK_EQUAL(page_data.at(BUF_SIZE-1), temp_page);
+
+    CHECK_THROW(this->buf_mgr->getPage(allocated_pages.at(BUF_SIZE+2)),
+        InsufficientSpaceBufMgr);
+    checkBufferState(BUF_SIZE, BUF_SIZE, 0);
+
+#ifdef BMGR_DEBUG
+    printBufferState();
+#endif
   }
 
 }
@@ -317,13 +369,59 @@ SUITE(clockTests){
 
 
 
+SUITE(gclockTests){
+
+  /*
+   * Fills the buffer pool and releases every page, then gets and releases
+   * the page in frame 0 enough times for its usage count to reach the
+   * default max weight. Scans 3*BUF_SIZE/2 pages that are not in the buffer
+   * pool, which is enough for Clock to evict frame 0, and checks that GClock
+   * kept the hot page resident because its usage count was only decremented
+   * once per sweep of the clock hand.
+   */
+  TEST_FIXTURE(GClockFixture, hotPageTest){
+    std::vector<Page*> page_data;
+    Page* temp_page;
+
+    PRINT("TEST: hot page survives a scan of 3*BUF_SIZE/2 cold pages\n");
+    std::vector<PageId> allocated_pages =
+      this->fillBufferPool(3 * BUF_SIZE / 2, &page_data);
+    for(std::uint32_t i = 0; i < BUF_SIZE; i++){
+      this->buf_mgr->releasePage(allocated_pages.at(i), false);
+    }
+    for(std::uint32_t i = 1; i < GCLOCK_MAX_WEIGHT; i++){
+      this->buf_mgr->getPage(allocated_pages.at(0));
+      this->buf_mgr->releasePage(allocated_pages.at(0), false);
+    }
+
+    for(std::uint32_t i = BUF_SIZE; i < BUF_SIZE + 3 * BUF_SIZE / 2; i++){
+      temp_page = this->buf_mgr->getPage(allocated_pages.at(i));
+      CHECK(temp_page != page_data.at(0));
+      this->buf_mgr->releasePage(allocated_pages.at(i), false);
+    }
+
+    // still resident: same frame and the contents written by fillBufferPool
+    temp_page = this->buf_mgr->getPage(allocated_pages.at(0));
+    CHECK_EQUAL(page_data.at(0), temp_page);
+    CHECK_EQUAL(std::to_string(allocated_pages.at(0).page_num) + " ",
+        std::string(temp_page->getData()));
+    this->buf_mgr->releasePage(allocated_pages.at(0), false);
+
+#ifdef BMGR_DEBUG
+    printBufferState();
+#endif
+  }
+
+}
+
+
 /*
  * Prints usage
  */
 void usage(){
   std::cout << "Usage: ./unittests -s <suite_name> -h help\n";
   std::cout << "Available Suites: " <<
-      "clockTests" << std::endl;
+      "clockTests, gclockTests" << std::endl;
 }
 /*
  * The main program either run all tests or tests a specific SUITE, given its
@@ -0,0 +1,322 @@
+/*
+ * microbench: Google Benchmark microbenchmarks of the hot primitives of the
+ * buffer manager: BufferMap lookups, inserts and removes at 1K to 4M pages,
+ * Frame load/reset transitions, Clock::replace with a share of the frames
+ * pinned, and releasePage. Prints JSON unless another format is asked for,
+ * so that runs of two commits can be compared with compare.py of Google
+ * Benchmark:
+ *
+ *   ./microbench --benchmark_out=before.json
+ *   compare.py benchmarks before.json after.json
+ *
+ * Every random draw comes from a generator seeded with MICRO_SEED, and the
+ * benchmarks run on one thread pinned to --cpu=<n>, CPU 0 by default, so
+ * that runs see the same accesses on the same core. The frame table, Clock
+ * and the BufferManager are sized by BUF_SIZE, a constant of SwatDB, so only
+ * the BufferMap benchmarks sweep the number of pages.
+ */
+
+#include <string>
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <memory>
+#include <sched.h>
+
+#include <benchmark/benchmark.h>
+
+#include "swatdb_types.h"
+#include "swatdb_exceptions.h"
+#include "diskmgr.h"
+#include "bufmgr.h"
+#include "bm_buffermap.h"
+#include "bm_frame.h"
+#include "bm_policies.h"
+#include "page.h"
+#include "catalog.h"
+#include "file.h"
+
+/*
+ * Seed of every random number generator.
+ */
+static const std::uint32_t MICRO_SEED = 42;
+
+/*
+ * Number of distinct files the pages of the BufferMap benchmarks are spread
+ * over.
+ */
+static const std::uint32_t MICRO_FILES = 8;
+
+/*
+ * Name of the relation file of the releasePage benchmarks.
+ */
+static const char MICRO_FILE[] = "microbench.rel";
+
+
+/*
+ * Returns n PageIds spread over MICRO_FILES files, in a random order.
+ */
+static std::vector<PageId> makePages(std::uint32_t n, std::uint32_t first){
+  std::vector<PageId> pages(n);
+  for (std::uint32_t i = 0; i < n; i++){
+    pages[i].file_id = (first + i) % MICRO_FILES;
+    pages[i].page_num = (first + i) / MICRO_FILES;
+  }
+  std::mt19937 rng(MICRO_SEED);
+  std::shuffle(pages.begin(), pages.end(), rng);
+  return pages;
+}
+
+/*
+ * Returns a BufferMap of the pages, page i mapped to frame i.
+ */
+static std::unique_ptr<BufferMap> makeMap(const std::vector<PageId> &pages){
+  std::unique_ptr<BufferMap> map(new BufferMap());
+  for (std::uint32_t i = 0; i < pages.size(); i++){
+    map->insert(pages[i], i);
+  }
+  return map;
+}
+
+/*
+ * BufferMap::get of a resident page, the lookup of every getPage hit.
+ */
+static void BM_BufferMapGet(benchmark::State &state){
+  std::vector<PageId> pages = makePages(state.range(0), 0);
+  std::unique_ptr<BufferMap> map = makeMap(pages);
+  std::size_t next = 0;
+  for (auto _ : state){
+    benchmark::DoNotOptimize(map->get(pages[next]));
+    next = (next + 1 == pages.size()) ? 0 : next + 1;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/*
+ * BufferMap::contains of a page that is not resident, the lookup of every
+ * getPage miss.
+ */
+static void BM_BufferMapContainsMiss(benchmark::State &state){
+  std::vector<PageId> pages = makePages(state.range(0), 0);
+  std::vector<PageId> absent = makePages(state.range(0), state.range(0));
+  std::unique_ptr<BufferMap> map = makeMap(pages);
+  std::size_t next = 0;
+  for (auto _ : state){
+    benchmark::DoNotOptimize(map->contains(absent[next]));
+    next = (next + 1 == absent.size()) ? 0 : next + 1;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/*
+ * BufferMap::remove of a resident page then BufferMap::insert of a new one
+ * in its frame, what replacing a page does to the map. The map keeps its
+ * size.
+ */
+static void BM_BufferMapRemoveInsert(benchmark::State &state){
+  std::uint32_t n = state.range(0);
+  std::vector<PageId> pages = makePages(2 * n, 0);
+  std::unique_ptr<BufferMap> map =
+    makeMap(std::vector<PageId>(pages.begin(), pages.begin() + n));
+  std::size_t out = 0;
+  std::size_t in = n;
+  for (auto _ : state){
+    map->remove(pages[out]);
+    map->insert(pages[in], out % n);
+    out = (out + 1 == pages.size()) ? 0 : out + 1;
+    in = (in + 1 == pages.size()) ? 0 : in + 1;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/*
+ * Frame::loadFrame then Frame::resetFrame, a frame taking in a page and
+ * being freed, over a frame table of BUF_SIZE frames.
+ */
+static void BM_FrameLoadReset(benchmark::State &state){
+  std::unique_ptr<Frame[]> frames(new Frame[BUF_SIZE]);
+  std::vector<PageId> pages = makePages(BUF_SIZE, 0);
+  FrameId next = 0;
+  for (auto _ : state){
+    frames[next].loadFrame(pages[next]);
+    frames[next].resetFrame();
+    benchmark::ClobberMemory();
+    next = (next + 1 == BUF_SIZE) ? 0 : next + 1;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/*
+ * Clock::replace on a full pool with state.range(0) percent of the frames
+ * pinned, at random, followed by the pin and unpin of the frame chosen, as
+ * on a getPage miss. At least one frame is left unpinned.
+ */
+static void BM_ClockReplace(benchmark::State &state){
+  std::unique_ptr<Frame[]> frames(new Frame[BUF_SIZE]);
+  std::vector<PageId> pages = makePages(BUF_SIZE, 0);
+  for (FrameId i = 0; i < BUF_SIZE; i++){
+    frames[i].loadFrame(pages[i]);
+  }
+  Clock clock(frames.get());
+
+  std::vector<FrameId> order(BUF_SIZE);
+  for (FrameId i = 0; i < BUF_SIZE; i++){
+    order[i] = i;
+  }
+  std::mt19937 rng(MICRO_SEED);
+  std::shuffle(order.begin(), order.end(), rng);
+  std::uint32_t num_pinned = std::min<std::uint32_t>(
+      (std::uint64_t)state.range(0) * BUF_SIZE / 100, BUF_SIZE - 1);
+  for (std::uint32_t i = 0; i < num_pinned; i++){
+    clock.pin(order[i]);
+  }
+
+  for (auto _ : state){
+    FrameId frame_id = clock.replace();
+    clock.pin(frame_id);
+    clock.unpin(frame_id);
+    benchmark::DoNotOptimize(frame_id);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["frames"] = BUF_SIZE;
+  state.counters["pinned"] = num_pinned;
+}
+
+/*
+ * Fixture of the releasePage benchmarks: a BufferManager of the policy
+ * state.range(0) with every frame holding a page of MICRO_FILE.
+ */
+class ReleaseFixture : public benchmark::Fixture {
+
+  public:
+
+    Catalog *catalog;
+    DiskManager *disk_mgr;
+    BufferManager *buf_mgr;
+    std::vector<PageId> pages;
+
+    void SetUp(const benchmark::State &state) override {
+      this->catalog = new Catalog();
+      this->disk_mgr = new DiskManager(this->catalog);
+      this->buf_mgr = new BufferManager(this->disk_mgr,
+          (PolicyType)state.range(0));
+      FileId file_id = this->catalog->addEntry(MICRO_FILE, nullptr, nullptr,
+          nullptr, HeapFileT, INVALID_FILE_ID, MICRO_FILE);
+      this->buf_mgr->createFile(file_id);
+      this->pages.clear();
+      for (std::uint32_t i = 0; i < BUF_SIZE; i++){
+        this->pages.push_back(this->buf_mgr->allocatePage(file_id).second);
+        this->buf_mgr->releasePage(this->pages.back(), false);
+      }
+      std::mt19937 rng(MICRO_SEED);
+      std::shuffle(this->pages.begin(), this->pages.end(), rng);
+    }
+
+    void TearDown(const benchmark::State &state) override {
+      delete this->buf_mgr;
+      delete this->disk_mgr;
+      delete this->catalog;
+      std::remove(MICRO_FILE);
+    }
+};
+
+/*
+ * releasePage of a resident page pinned once, so that its pin count drops
+ * to 0 and the unpin hook of the policy runs. The pages are pinned a pool
+ * at a time with the timer paused.
+ */
+BENCHMARK_DEFINE_F(ReleaseFixture, BM_ReleasePage)(benchmark::State &state){
+  bool dirty = state.range(1);
+  while (state.KeepRunningBatch(BUF_SIZE)){
+    state.PauseTiming();
+    for (PageId page_id : this->pages){
+      this->buf_mgr->getPage(page_id);
+    }
+    state.ResumeTiming();
+    for (PageId page_id : this->pages){
+      this->buf_mgr->releasePage(page_id, dirty);
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetLabel(bm_rep_str((PolicyType)state.range(0)));
+}
+
+/*
+ * getPage then releasePage of a resident page, the whole hit path.
+ */
+BENCHMARK_DEFINE_F(ReleaseFixture, BM_GetReleasePage)(benchmark::State &state){
+  std::size_t next = 0;
+  for (auto _ : state){
+    benchmark::DoNotOptimize(this->buf_mgr->getPage(this->pages[next]));
+    this->buf_mgr->releasePage(this->pages[next], false);
+    next = (next + 1 == this->pages.size()) ? 0 : next + 1;
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetLabel(bm_rep_str((PolicyType)state.range(0)));
+}
+
+BENCHMARK(BM_BufferMapGet)->RangeMultiplier(4)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_BufferMapContainsMiss)
+  ->RangeMultiplier(4)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_BufferMapRemoveInsert)
+  ->RangeMultiplier(4)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_FrameLoadReset);
+BENCHMARK(BM_ClockReplace)->Arg(0)->Arg(50)->Arg(90)->Arg(99);
+BENCHMARK_REGISTER_F(ReleaseFixture, BM_ReleasePage)
+  ->Args({ClockT, false})->Args({ClockT, true})->Args({SieveT, false});
+BENCHMARK_REGISTER_F(ReleaseFixture, BM_GetReleasePage)
+  ->Arg(ClockT)->Arg(SieveT);
+
+
+/*
+ * Pins the calling thread to cpu. Returns false if it cannot be.
+ */
+bool pinToCpu(int cpu){
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+/*
+ * Takes --cpu=<n> out of the options, pins the thread, and runs the
+ * benchmarks with the options of Google Benchmark left, JSON output first so
+ * that --benchmark_format overrides it.
+ */
+int main(int argc, char** argv){
+  std::vector<char *> args;
+  std::string json = "--benchmark_format=json";
+  int cpu = 0;
+
+  args.push_back(argv[0]);
+  args.push_back(&json[0]);
+  for (int i = 1; i < argc; i++){
+    if (std::strncmp(argv[i], "--cpu=", 6) == 0){
+      cpu = atoi(argv[i] + 6);
+    }
+    else{
+      args.push_back(argv[i]);
+    }
+  }
+  if (!pinToCpu(cpu)){
+    std::cerr << "cannot pin to CPU " << cpu << std::endl;
+    exit(1);
+  }
+
+  int num_args = args.size();
+  benchmark::Initialize(&num_args, args.data());
+  if (benchmark::ReportUnrecognizedArguments(num_args, args.data())){
+    return 1;
+  }
+  benchmark::AddCustomContext("cpu", std::to_string(cpu));
+  benchmark::AddCustomContext("seed", std::to_string(MICRO_SEED));
+  benchmark::AddCustomContext("buf_size", std::to_string(BUF_SIZE));
+  benchmark::AddCustomContext("page_size", std::to_string(PAGE_SIZE));
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -5,6 +5,11 @@
 #include <cstring>
 #include <unistd.h>
 #include <vector>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <random>
 
 #include <UnitTest++/UnitTest++.h>
 #include <UnitTest++/TestReporterStdout.h>
@@ -13,6 +18,8 @@
 #include "swatdb_exceptions.h"
 #include "diskmgr.h"
 #include "bufmgr.h"
+#include "bm_policies.h"
+#include "bm_workload.h"
 #include "page.h"
 #include "catalog.h"
 #include "file.h"
@@ -23,6 +30,19 @@
 
 static int TOTAL_SCANS = 50;
 
+/*
+ * Number of getPage/releasePage pairs timed by the hit throughput test for
+ * each thread count.
+ */
+static std::uint32_t HIT_OPS = 2000000;
+
+/*
+ * Number of accesses of each workload run by the workload test, and the
+ * fraction of them that are writes.
+ */
+static std::uint64_t WORKLOAD_OPS = 200000;
+static double WORKLOAD_WRITES = 0.1;
+
 /*
  * TestFixture Class for initializing and cleaning up objects. Any test called
  * with this class as TEST_FIXTURE has access to any public and protected data
@@ -47,6 +67,8 @@ class TestFixture{
     BufferManager* buf_mgr;
     std::string file_name;
     FileId file_id;
+    // when true, initialize turns on the TinyLFU admission filter
+    bool admission;
 
     TestFixture(){
 
@@ -59,6 +81,7 @@ class TestFixture{
       this->disk_mgr = nullptr;
       this->buf_mgr = nullptr;
       this->file_name = "";
+      this->admission = false;
       // file_id = catalog->addEntry(file_name, nullptr, nullptr, HeapFileT,
       //     file_name);
       // buf_mgr->createFile(file_id);
@@ -75,10 +98,11 @@ class TestFixture{
      * Acts as pseudo constructor for creating individual policy buf managers
      * within functions
      */
-    void initialize(RepType rep_type){
+    void initialize(PolicyType rep_type){
       this->catalog = new Catalog();
       this->disk_mgr = new DiskManager(this->catalog);
       this->buf_mgr = new BufferManager(this->disk_mgr, rep_type);
+      this->buf_mgr->setAdmission(this->admission);
       this->file_name = "testrel1.rel";
       this->file_id = catalog->addEntry(this->file_name, nullptr, nullptr, 
           nullptr, HeapFileT, INVALID_FILE_ID, this->file_name);
@@ -116,6 +140,22 @@ class TestFixture{
       return allocated_pages;
     }
 
+    /*
+     * Helper function returning the number of calls to the replacement
+     * policy so far, i.e. the misses once the buffer pool is full.
+     */
+    std::uint64_t repCalls(){
+      return this->buf_mgr->getBufferState().replace_stats.rep_calls;
+    }
+
+    /*
+     * Helper function printing the percentage of accesses that were hits.
+     */
+    void printHitRate(std::uint64_t accesses, std::uint64_t misses){
+      std::cout << "Hit rate: " << 100 * (double)(accesses - misses) / accesses
+        << "% of " << accesses << " accesses" << std::endl;
+    }
+
       /** START OF TEST FUNCTIONS */
 
 
@@ -125,7 +165,7 @@ class TestFixture{
      * other state variables are either constant or may change depending on the
      * implementation details
      */
-    void sequentialScanTest(RepType rep_type){
+    void sequentialScanTest(PolicyType rep_type){
 
       std::cout << std::endl << "Straight Sequential Scan Test: " << std::endl;
       this->initialize(rep_type);
@@ -155,7 +195,7 @@ class TestFixture{
      * order. Then repins every other frame. This will stress MRU and LRU which
      * will have to search their stack/queue to remove these frames.
      */
-    void repinTest(RepType rep_type){
+    void repinTest(PolicyType rep_type){
       std::cout << "Repin Test: " << std::endl;
       this->initialize(rep_type);
       // fills buffer pool and creates BUF_SIZE - 1 extra pages that can 
@@ -177,7 +217,7 @@ class TestFixture{
      * randomly determined frames out of BUF_SIZE * 2 options. Gets and
      * releases page immediately.
      */
-    void independentRandomTest(RepType rep_type){
+    void independentRandomTest(PolicyType rep_type){
       this->initialize(rep_type);
       std::cout <<  "Independent Random Test: " << std::endl;
       std::vector<PageId> allocated_pages;
@@ -202,7 +242,7 @@ class TestFixture{
      * selected frames. Then pin and unpin BUF_SIZE /2 new pages. All policies
      * will be called the same amount of times but can compare overhead usage
      */
-     void pinnedTest(RepType rep_type){
+     void pinnedTest(PolicyType rep_type){
        this->initialize(rep_type);
        std::cout <<  "Pinned Test: " <<  std::endl;
        std::vector<PageId> allocated_pages;
@@ -248,7 +288,7 @@ class TestFixture{
       * test. Imitates getting leaf pages from a B+ tree, where the higher
       * branch nodes are called more often.
       */
-    void hierarchicalTest(RepType rep_type){
+    void hierarchicalTest(PolicyType rep_type){
       this->initialize(rep_type);
 
       std::cout <<  "Hierarchical Test: " <<  std::endl;
@@ -286,6 +326,264 @@ class TestFixture{
 
     }
 
+    /**
+     * Cycles TOTAL_SCANS times through a loop of pages slightly larger than
+     * the buffer pool, like a nested loop join whose inner relation does not
+     * quite fit. LRU and Clock replace each page just before it is reused and
+     * hit almost never, LIRS keeps most of the loop resident. Prints the hit
+     * rate, counting every access that did not call the replacement policy.
+     */
+    void loopTest(PolicyType rep_type){
+      this->initialize(rep_type);
+
+      std::cout <<  "Loop Test: " <<  std::endl;
+      std::uint32_t loop_size = BUF_SIZE + BUF_SIZE / 10 + 1;
+      std::vector<PageId> allocated_pages;
+      allocated_pages = this->fillBufferPool(loop_size - BUF_SIZE);
+
+      std::uint64_t misses = this->repCalls();
+      for(int scan_num = 1; scan_num < TOTAL_SCANS + 1; scan_num++){
+        for(std::uint32_t i = 0; i < loop_size; i++){
+          this->buf_mgr->getPage(allocated_pages.at(i));
+          this->buf_mgr->releasePage(allocated_pages.at(i), false);
+        }
+      }
+      misses = this->repCalls() - misses;
+
+      this->buf_mgr->printReplacementStats();
+      std::cout << "Loop of " << loop_size << " pages" << std::endl;
+      this->printHitRate((std::uint64_t)TOTAL_SCANS * loop_size, misses);
+      this->terminate();
+
+    }
+
+    /**
+     * Randomly accesses a hot set of BUF_SIZE / 2 pages, with every other
+     * access going to the next page of a sequential scan over 4 * BUF_SIZE
+     * pages that are not reused before they would have to be replaced.
+     * Imitates index lookups running next to a table scan. Policies that let
+     * scan pages leave before the hot set keep most of the hot set resident.
+     * Prints the hit rate.
+     */
+    void scanResistanceTest(PolicyType rep_type){
+      this->initialize(rep_type);
+
+      std::cout <<  "Scan Resistance Test: " <<  std::endl;
+      std::vector<PageId> allocated_pages;
+      allocated_pages = this->fillBufferPool(BUF_SIZE * 4);
+
+      std::srand(time(nullptr));
+      std::uint32_t scan_pos = 0;
+      std::uint64_t accesses = 0;
+      std::uint64_t misses = this->repCalls();
+      for(std::uint32_t i = 0; i < BUF_SIZE * TOTAL_SCANS; i++){
+        std::uint32_t page = std::rand() % (BUF_SIZE / 2);
+        if(i % 2){
+          page = BUF_SIZE + scan_pos;
+          scan_pos = (scan_pos + 1) % (BUF_SIZE * 4);
+        }
+        this->buf_mgr->getPage(allocated_pages.at(page));
+        this->buf_mgr->releasePage(allocated_pages.at(page), false);
+        accesses++;
+      }
+      misses = this->repCalls() - misses;
+
+      this->buf_mgr->printReplacementStats();
+      this->printHitRate(accesses, misses);
+      this->terminate();
+    }
+
+    /**
+     * Fills the buffer pool, then times HIT_OPS getPage/releasePage pairs on
+     * resident pages split between 1, 2, 4 and 8 threads, each thread using
+     * its own block of pages. Only the hit path runs, but it still reads the
+     * buffer map and updates the frame and the replacement policy, so every
+     * pair is serialized on one mutex, the same for every policy. Prints
+     * ops/sec for each thread count.
+     */
+    void hitThroughputTest(PolicyType rep_type){
+      this->initialize(rep_type);
+
+      std::cout <<  "Hit Throughput Test: " <<  std::endl;
+      std::vector<PageId> allocated_pages = this->fillBufferPool(0);
+      std::mutex hit_mtx;
+
+      for(std::uint32_t threads = 1; threads <= 8 && threads <= BUF_SIZE;
+          threads *= 2){
+        std::vector<std::thread> workers;
+        std::chrono::steady_clock::time_point start =
+          std::chrono::steady_clock::now();
+
+        for(std::uint32_t t = 0; t < threads; t++){
+          workers.push_back(std::thread([&, t, threads](){
+            std::uint32_t owned = BUF_SIZE / threads;
+            for(std::uint32_t k = 0; k < HIT_OPS / threads; k++){
+              // a contiguous block of pages per thread, so that threads do
+              // not share the cache lines of their frames
+              PageId page_id = allocated_pages.at(t * owned + k % owned);
+              std::lock_guard<std::mutex> guard(hit_mtx);
+              this->buf_mgr->getPage(page_id);
+              this->buf_mgr->releasePage(page_id, false);
+            }
+          }));
+        }
+        for(std::uint32_t t = 0; t < threads; t++){
+          workers.at(t).join();
+        }
+
+        std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+        std::cout << threads << " thread(s): "
+          << (std::uint64_t)(HIT_OPS / elapsed.count()) << " ops/sec"
+          << std::endl;
+      }
+      this->terminate();
+    }
+
+    /*
+     * Helper function timing HIT_OPS getPage/releasePage pairs on the given
+     * resident pages of mgr. Returns the average time of a pair in ns.
+     */
+    template <class Manager>
+    double hitNanosPerOp(Manager *mgr, std::vector<PageId> &pages){
+      std::uint32_t next = 0;
+      std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+      for(std::uint32_t k = 0; k < HIT_OPS; k++){
+        mgr->getPage(pages[next]);
+        mgr->releasePage(pages[next], false);
+        next = (next + 1 == pages.size()) ? 0 : next + 1;
+      }
+      std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+      return elapsed.count() / HIT_OPS;
+    }
+
+    /**
+     * Fills the buffer pool, then times the hit path, a getPage/releasePage
+     * pair on a resident page, through a BufferManager constructed with
+     * rep_type, and through a BasicBufferManager<Policy> over the same file,
+     * which calls the policy's hooks directly instead of through
+     * BufferManagerBase and ReplacementPolicy. Prints ns/op of both.
+     */
+    template <class Policy>
+    void dispatchTest(PolicyType rep_type){
+      this->initialize(rep_type);
+
+      std::cout <<  "Hit Path Dispatch Test: " <<  std::endl;
+      std::vector<PageId> allocated_pages = this->fillBufferPool(0);
+      BasicBufferManager<Policy> *basic =
+        new BasicBufferManager<Policy>(this->disk_mgr);
+      for(std::uint32_t i = 0; i < BUF_SIZE; i++){
+        basic->getPage(allocated_pages.at(i));
+        basic->releasePage(allocated_pages.at(i), false);
+      }
+
+      double front = this->hitNanosPerOp(this->buf_mgr, allocated_pages);
+      double direct = this->hitNanosPerOp(basic, allocated_pages);
+      std::cout << "BufferManager(" << bm_rep_str(rep_type) << "): " << front
+        << " ns/op" << std::endl;
+      std::cout << "BasicBufferManager<" << bm_rep_str(rep_type) << ">: "
+        << direct << " ns/op" << std::endl;
+
+      // every page stays resident: the hit path never calls replace
+      CHECK_EQUAL(0, basic->getBufferState().replace_stats.rep_calls);
+      delete basic;
+      this->terminate();
+    }
+
+    /*
+     * Helper function timing HIT_OPS getPage/releasePage pairs on the given
+     * resident pages of mgr in a random order, reading a byte of every page
+     * so that each probe reaches buf_pool. Returns the average time of a
+     * pair in ns.
+     */
+    double probeNanosPerOp(BufferManager *mgr, std::vector<PageId> pages){
+      std::mt19937 rng(44);
+      // volatile, so that the reads of page data are not optimized away
+      volatile std::uint64_t sum = 0;
+      std::shuffle(pages.begin(), pages.end(), rng);
+      std::uint32_t next = 0;
+      std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+      for(std::uint32_t k = 0; k < HIT_OPS; k++){
+        Page *page = mgr->getPage(pages[next]);
+        sum = sum + page->getData()[(k * 64) % PAGE_SIZE];
+        mgr->releasePage(pages[next], false);
+        next = (next + 1 == pages.size()) ? 0 : next + 1;
+      }
+      std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+      return elapsed.count() / HIT_OPS;
+    }
+
+    /**
+     * Fills the buffer pool of a BufferManager allocated with new and of one
+     * asked for huge pages, then times random probes of resident pages on
+     * both. Prints the kind of memory each got and ns/op.
+     */
+    void hugePageTest(PolicyType rep_type){
+      this->initialize(rep_type);
+
+      std::cout <<  "Huge Page Probe Test: " <<  std::endl;
+      std::vector<PageId> allocated_pages = this->fillBufferPool(0);
+      BufferManager *huge = new BufferManager(this->disk_mgr, rep_type, -1,
+                                              true);
+      for(std::uint32_t i = 0; i < BUF_SIZE; i++){
+        huge->getPage(allocated_pages.at(i));
+        huge->releasePage(allocated_pages.at(i), false);
+      }
+
+      double base = this->probeNanosPerOp(this->buf_mgr, allocated_pages);
+      double hugepage = this->probeNanosPerOp(huge, allocated_pages);
+      std::cout << bm_pool_mem_str(this->buf_mgr->getPoolMemory()) << ": "
+        << base << " ns/op" << std::endl;
+      std::cout << bm_pool_mem_str(huge->getPoolMemory()) << ": "
+        << hugepage << " ns/op" << std::endl;
+
+      delete huge;
+      this->terminate();
+    }
+
+    /**
+     * Runs every pattern of bm_workload.h, with the default parameters and
+     * WORKLOAD_WRITES of the accesses writes, over two files of BUF_SIZE
+     * pages each, through a BufferManager constructed with rep_type. Prints
+     * the hit rate, I/O and throughput of each.
+     */
+    void workloadTest(PolicyType rep_type){
+      this->initialize(rep_type);
+
+      std::cout <<  "Workload Test (" << bm_rep_str(rep_type) << "): " <<
+        std::endl;
+      std::string file_name2 = "testrel2.rel";
+      FileId fid2 = catalog->addEntry(file_name2, nullptr, nullptr, nullptr,
+          HeapFileT, INVALID_FILE_ID, file_name2);
+      this->buf_mgr->createFile(fid2);
+      std::vector<std::vector<PageId>> files(2);
+      for (std::uint32_t i = 0; i < BUF_SIZE; i++){
+        files[0].push_back(this->disk_mgr->allocatePage(this->file_id));
+        files[1].push_back(this->disk_mgr->allocatePage(fid2));
+      }
+
+      for (int type = 0; type < BM_NUM_WORKLOADS; type++){
+        WorkloadConfig config = bm_default_workload((WorkloadType)type);
+        config.write_fraction = WORKLOAD_WRITES;
+        Workload workload(config, files);
+        WorkloadResult result = bm_run_workload(this->buf_mgr, workload,
+            WORKLOAD_OPS);
+        CHECK_EQUAL(WORKLOAD_OPS, result.stats.hits + result.stats.misses);
+        std::cout << bm_workload_str((WorkloadType)type) << ": ";
+        this->printHitRate(WORKLOAD_OPS, result.stats.misses);
+        std::cout << "  " << result.stats.reads << " reads, " <<
+          result.stats.writes << " writes, " <<
+          (std::uint64_t)(result.ops / result.seconds) << " ops/s" << std::endl;
+      }
+
+      this->terminate();
+      remove(file_name2.data());
+    }
+
 };
 
 
@@ -309,6 +607,15 @@ SUITE(clockTests){
   TEST_FIXTURE(TestFixture, clockHierarchical){
     this->hierarchicalTest(ClockT);
   }
+  TEST_FIXTURE(TestFixture, clockLoop){
+    this->loopTest(ClockT);
+  }
+  TEST_FIXTURE(TestFixture, clockScanResistance){
+    this->scanResistanceTest(ClockT);
+  }
+  TEST_FIXTURE(TestFixture, clockHitThroughput){
+    this->hitThroughputTest(ClockT);
+  }
 }
 
 SUITE(randomTests){
@@ -330,7 +637,226 @@ SUITE(randomTests){
   TEST_FIXTURE(TestFixture, randomHierarchical){
     this->hierarchicalTest(RandomT);
   }
+  TEST_FIXTURE(TestFixture, randomLoop){
+    this->loopTest(RandomT);
+  }
+  TEST_FIXTURE(TestFixture, randomScanResistance){
+    this->scanResistanceTest(RandomT);
+  }
+
+}
+
+SUITE(gclockTests){
+
+  TEST_FIXTURE(TestFixture, gclockSmallSequentialScan){
+    std::cout << std::endl << "GCLOCK SUITE TESTS: " << std::endl;
+    // straight sequential scan is performed 5 times
+    this->sequentialScanTest(GClockT);
+  }
+  TEST_FIXTURE(TestFixture, gclockRepin){
+    this->repinTest(GClockT);
+  }
+  TEST_FIXTURE(TestFixture, gclockIndependentRandom){
+    this->independentRandomTest(GClockT);
+  }
+  TEST_FIXTURE(TestFixture, gclockPinned){
+    this->pinnedTest(GClockT);
+  }
+  TEST_FIXTURE(TestFixture, gclockHierarchical){
+    this->hierarchicalTest(GClockT);
+  }
+  TEST_FIXTURE(TestFixture, gclockLoop){
+    this->loopTest(GClockT);
+  }
+  TEST_FIXTURE(TestFixture, gclockScanResistance){
+    this->scanResistanceTest(GClockT);
+  }
+}
+
+SUITE(clockProTests){
+
+  TEST_FIXTURE(TestFixture, clockProSmallSequentialScan){
+    std::cout << std::endl << "CLOCK-PRO SUITE TESTS: " << std::endl;
+    // straight sequential scan is performed 5 times
+    this->sequentialScanTest(ClockProT);
+  }
+  TEST_FIXTURE(TestFixture, clockProRepin){
+    this->repinTest(ClockProT);
+  }
+  TEST_FIXTURE(TestFixture, clockProIndependentRandom){
+    this->independentRandomTest(ClockProT);
+  }
+  TEST_FIXTURE(TestFixture, clockProPinned){
+    this->pinnedTest(ClockProT);
+  }
+  TEST_FIXTURE(TestFixture, clockProHierarchical){
+    this->hierarchicalTest(ClockProT);
+  }
+  TEST_FIXTURE(TestFixture, clockProLoop){
+    this->loopTest(ClockProT);
+  }
+  TEST_FIXTURE(TestFixture, clockProScanResistance){
+    this->scanResistanceTest(ClockProT);
+  }
+}
+
+SUITE(lirsTests){
+
+  TEST_FIXTURE(TestFixture, lirsSmallSequentialScan){
+    std::cout << std::endl << "LIRS SUITE TESTS: " << std::endl;
+    // straight sequential scan is performed 5 times
+    this->sequentialScanTest(LirsT);
+  }
+  TEST_FIXTURE(TestFixture, lirsRepin){
+    this->repinTest(LirsT);
+  }
+  TEST_FIXTURE(TestFixture, lirsIndependentRandom){
+    this->independentRandomTest(LirsT);
+  }
+  TEST_FIXTURE(TestFixture, lirsPinned){
+    this->pinnedTest(LirsT);
+  }
+  TEST_FIXTURE(TestFixture, lirsHierarchical){
+    this->hierarchicalTest(LirsT);
+  }
+  TEST_FIXTURE(TestFixture, lirsLoop){
+    this->loopTest(LirsT);
+  }
+  TEST_FIXTURE(TestFixture, lirsScanResistance){
+    this->scanResistanceTest(LirsT);
+  }
+}
+
+SUITE(sieveTests){
+
+  TEST_FIXTURE(TestFixture, sieveSmallSequentialScan){
+    std::cout << std::endl << "SIEVE SUITE TESTS: " << std::endl;
+    // straight sequential scan is performed 5 times
+    this->sequentialScanTest(SieveT);
+  }
+  TEST_FIXTURE(TestFixture, sieveRepin){
+    this->repinTest(SieveT);
+  }
+  TEST_FIXTURE(TestFixture, sieveIndependentRandom){
+    this->independentRandomTest(SieveT);
+  }
+  TEST_FIXTURE(TestFixture, sievePinned){
+    this->pinnedTest(SieveT);
+  }
+  TEST_FIXTURE(TestFixture, sieveHierarchical){
+    this->hierarchicalTest(SieveT);
+  }
+  TEST_FIXTURE(TestFixture, sieveLoop){
+    this->loopTest(SieveT);
+  }
+  TEST_FIXTURE(TestFixture, sieveScanResistance){
+    this->scanResistanceTest(SieveT);
+  }
+  TEST_FIXTURE(TestFixture, sieveHitThroughput){
+    this->hitThroughputTest(SieveT);
+  }
+}
+
+SUITE(s3fifoTests){
+
+  TEST_FIXTURE(TestFixture, s3fifoSmallSequentialScan){
+    std::cout << std::endl << "S3-FIFO SUITE TESTS: " << std::endl;
+    // straight sequential scan is performed 5 times
+    this->sequentialScanTest(S3FifoT);
+  }
+  TEST_FIXTURE(TestFixture, s3fifoRepin){
+    this->repinTest(S3FifoT);
+  }
+  TEST_FIXTURE(TestFixture, s3fifoIndependentRandom){
+    this->independentRandomTest(S3FifoT);
+  }
+  TEST_FIXTURE(TestFixture, s3fifoPinned){
+    this->pinnedTest(S3FifoT);
+  }
+  TEST_FIXTURE(TestFixture, s3fifoHierarchical){
+    this->hierarchicalTest(S3FifoT);
+  }
+  TEST_FIXTURE(TestFixture, s3fifoLoop){
+    this->loopTest(S3FifoT);
+  }
+  TEST_FIXTURE(TestFixture, s3fifoScanResistance){
+    this->scanResistanceTest(S3FifoT);
+  }
+  TEST_FIXTURE(TestFixture, s3fifoHitThroughput){
+    this->hitThroughputTest(S3FifoT);
+  }
+}
+
+SUITE(admissionTests){
+
+  TEST_FIXTURE(TestFixture, admissionSmallSequentialScan){
+    std::cout << std::endl << "CLOCK WITH TINYLFU ADMISSION SUITE TESTS: "
+      << std::endl;
+    this->admission = true;
+    // straight sequential scan is performed 5 times
+    this->sequentialScanTest(ClockT);
+  }
+  TEST_FIXTURE(TestFixture, admissionIndependentRandom){
+    this->admission = true;
+    this->independentRandomTest(ClockT);
+  }
+  TEST_FIXTURE(TestFixture, admissionHierarchical){
+    this->admission = true;
+    this->hierarchicalTest(ClockT);
+  }
+  TEST_FIXTURE(TestFixture, admissionLoop){
+    this->admission = true;
+    this->loopTest(ClockT);
+  }
+  TEST_FIXTURE(TestFixture, admissionScanResistance){
+    this->admission = true;
+    this->scanResistanceTest(ClockT);
+  }
+}
+
+SUITE(dispatchTests){
+
+  TEST_FIXTURE(TestFixture, clockDispatch){
+    std::cout << std::endl << "POLICY DISPATCH SUITE TESTS: " << std::endl;
+    this->dispatchTest<Clock>(ClockT);
+  }
+  TEST_FIXTURE(TestFixture, sieveDispatch){
+    this->dispatchTest<Sieve>(SieveT);
+  }
+}
 
+SUITE(memoryTests){
+
+  TEST_FIXTURE(TestFixture, clockHugePages){
+    std::cout << std::endl << "POOL MEMORY SUITE TESTS: " << std::endl;
+    this->hugePageTest(ClockT);
+  }
+}
+
+SUITE(workloadTests){
+
+  TEST_FIXTURE(TestFixture, clockWorkloads){
+    std::cout << std::endl << "WORKLOAD SUITE TESTS: " << std::endl;
+    this->workloadTest(ClockT);
+  }
+  TEST_FIXTURE(TestFixture, randomWorkloads){
+    this->workloadTest(RandomT);
+  }
+  TEST_FIXTURE(TestFixture, gclockWorkloads){
+    this->workloadTest(GClockT);
+  }
+  TEST_FIXTURE(TestFixture, clockProWorkloads){
+    this->workloadTest(ClockProT);
+  }
+  TEST_FIXTURE(TestFixture, lirsWorkloads){
+    this->workloadTest(LirsT);
+  }
+  TEST_FIXTURE(TestFixture, sieveWorkloads){
+    this->workloadTest(SieveT);
+  }
+  TEST_FIXTURE(TestFixture, s3fifoWorkloads){
+    this->workloadTest(S3FifoT);
+  }
 }
 
 /*
@@ -339,7 +865,10 @@ SUITE(randomTests){
 void usage(){
   std::cout << "Usage: ./unittests -s <suite_name> -h help\n";
 
-  std::cout << "Available Suites: " << "clockTests, randomTests" << std::endl;
+  std::cout << "Available Suites: " << "clockTests, randomTests, "
+    << "gclockTests, clockProTests, lirsTests, sieveTests, s3fifoTests, "
+    << "admissionTests, dispatchTests, memoryTests, workloadTests"
+    << std::endl;
 
 }
 
@@ -16,6 +16,7 @@
 #include "page.h"
 #include "catalog.h"
 #include "file.h"
+#include "bm_policies.h"
 
 // uncomment BMGR_DEBUG definition to print out a summary of each test
 #define BMGR_DEBUG 1
@@ -408,6 +409,706 @@ TEST_FIXTURE(TestFixture, exceptionTest){
 
 
 
+/*
+ * TestFixture for the PerFile policy. Replaces the buffer manager of
+ * TestFixture with one constructed with PerFileT, and adds a second file
+ * whose pages are replaced by MRU.
+ */
+class PerFileFixture : public TestFixture {
+
+  public:
+    std::string scan_name;
+    FileId scan_id;
+
+    PerFileFixture(){
+      delete this->buf_mgr;
+      this->buf_mgr = new BufferManager(disk_mgr, PerFileT);
+      scan_name = "testrel2.rel";
+      scan_id = catalog->addEntry(scan_name, nullptr, nullptr, nullptr,
+          HeapFileT, INVALID_FILE_ID, scan_name);
+      this->buf_mgr->createFile(scan_id);
+      this->buf_mgr->setFilePolicy(scan_id, MruT);
+    }
+
+    ~PerFileFixture(){
+      remove(scan_name.data());
+    }
+};
+
+
+SUITE(perFileTests){
+
+  /*
+   * Fills half the buffer pool with pages of a Clock file, then scans twice
+   * as many pages of an MRU file as the pool holds. Checks that the scan
+   * replaces only its own pages, so the Clock pages are all still resident.
+   */
+  TEST_FIXTURE(PerFileFixture, mruScanTest){
+    std::vector<PageId> hot_pages;
+
+    PRINT("TEST: half of the pool is a Clock file, scan an MRU file twice\n");
+    PRINT("      the size of the pool, check the Clock pages stay.\n");
+
+    for(std::uint32_t i = 0; i < BUF_SIZE / 2; i++){
+      hot_pages.push_back(disk_mgr->allocatePage(file_id));
+      this->buf_mgr->getPage(hot_pages.at(i));
+      this->buf_mgr->releasePage(hot_pages.at(i), false);
+    }
+    for(std::uint32_t i = 0; i < 2 * BUF_SIZE; i++){
+      PageId scan_page = disk_mgr->allocatePage(scan_id);
+      this->buf_mgr->getPage(scan_page);
+      this->buf_mgr->releasePage(scan_page, false);
+    }
+
+    std::uint64_t rep_calls =
+      this->buf_mgr->getBufferState().replace_stats.rep_calls;
+    for(std::uint32_t i = 0; i < hot_pages.size(); i++){
+      this->buf_mgr->getPage(hot_pages.at(i));
+      this->buf_mgr->releasePage(hot_pages.at(i), false);
+    }
+    CHECK_EQUAL(rep_calls,
+        this->buf_mgr->getBufferState().replace_stats.rep_calls);
+    checkBufferState(BUF_SIZE, 0, 0);
+#ifdef BMGR_DEBUG
+    printBufferState();
+#endif
+  }
+
+  /*
+   * Pins the MRU file's share of the pool and fills the rest with pages of
+   * the Clock file. Checks that one more MRU page is still read in, by
+   * replacing a Clock page, since the MRU partition has run dry.
+   */
+  TEST_FIXTURE(PerFileFixture, globalVictimTest){
+    std::uint32_t share = BUF_SIZE / 2;
+
+    PRINT("TEST: pin the MRU share of the pool, fill the rest with Clock\n");
+    PRINT("      pages, check another MRU page replaces a Clock page.\n");
+
+    for(std::uint32_t i = 0; i < share; i++){
+      this->buf_mgr->getPage(disk_mgr->allocatePage(scan_id));
+    }
+    for(std::uint32_t i = share; i < BUF_SIZE; i++){
+      PageId page_id = disk_mgr->allocatePage(file_id);
+      this->buf_mgr->getPage(page_id);
+      this->buf_mgr->releasePage(page_id, false);
+    }
+
+    this->buf_mgr->getPage(disk_mgr->allocatePage(scan_id));
+    checkBufferState(BUF_SIZE, share + 1, 0);
+#ifdef BMGR_DEBUG
+    printBufferState();
+#endif
+  }
+
+  /*
+   * Checks that only ClockT, MruT and LruKT can be chosen for a file, and
+   * only on a buffer manager constructed with PerFileT.
+   */
+  TEST_FIXTURE(PerFileFixture, invalidFilePolicyTest){
+    PRINT("TEST: setFilePolicy with an unsupported policy or buffer\n");
+    PRINT("      manager throws InvalidPolicyBufMgr.\n");
+
+    CHECK_THROW(this->buf_mgr->setFilePolicy(file_id, RandomT),
+        InvalidPolicyBufMgr);
+    this->buf_mgr->setFilePolicy(file_id, LruKT);
+
+    BufferManager clock_mgr(disk_mgr, ClockT);
+    CHECK_THROW(clock_mgr.setFilePolicy(file_id, MruT), InvalidPolicyBufMgr);
+  }
+
+}
+
+
+/*
+ * TestFixture for a policy that is not a PolicyType of BufferManager. Adds a
+ * BasicBufferManager<Policy> over the file of TestFixture, whose policy can
+ * be checked after each page access.
+ */
+template <class Policy>
+class PolicyFixture : public TestFixture {
+
+  public:
+    BasicBufferManager<Policy> *mgr;
+
+    PolicyFixture(){
+      mgr = new BasicBufferManager<Policy>(disk_mgr);
+    }
+
+    ~PolicyFixture(){
+      delete mgr;
+    }
+
+    Policy& policy(){
+      return mgr->getPolicy();
+    }
+
+    /*
+     * Allocates num_pages pages of the file on disk.
+     */
+    std::vector<PageId> allocatePages(std::uint32_t num_pages){
+      std::vector<PageId> pages;
+      for(std::uint32_t i = 0; i < num_pages; i++){
+        pages.push_back(disk_mgr->allocatePage(file_id));
+      }
+      return pages;
+    }
+
+    /*
+     * Gets and releases each page in [first, last) of pages.
+     */
+    void access(std::vector<PageId> &pages, std::uint32_t first,
+        std::uint32_t last){
+      access(mgr, pages, first, last);
+    }
+
+    /*
+     * Gets and releases each page in [first, last) of pages through
+     * buf_mgr.
+     */
+    template <class Manager>
+    void access(Manager *buf_mgr, std::vector<PageId> &pages,
+        std::uint32_t first, std::uint32_t last){
+      for(std::uint32_t i = first; i < last; i++){
+        buf_mgr->getPage(pages.at(i));
+        buf_mgr->releasePage(pages.at(i), false);
+      }
+    }
+
+    /*
+     * Turns admission on and reads in each page in [first, last) of pages,
+     * getting it three times before releasing it, so that the admission
+     * filter counts three accesses and the policy a single one.
+     */
+    void accessPinned(std::vector<PageId> &pages, std::uint32_t first,
+        std::uint32_t last){
+      mgr->setAdmission(true);
+      for(std::uint32_t i = first; i < last; i++){
+        for(int pin = 0; pin < 3; pin++){
+          mgr->getPage(pages.at(i));
+        }
+        for(int pin = 0; pin < 3; pin++){
+          mgr->releasePage(pages.at(i), false);
+        }
+      }
+    }
+
+    /*
+     * Returns the frames in the order the policy would replace them, last
+     * first.
+     */
+    std::vector<FrameId> rankFrames(){
+      std::vector<FrameId> ranked;
+      policy().rankFrames(&ranked);
+      return ranked;
+    }
+};
+
+typedef PolicyFixture<ClockPro> ClockProFixture;
+typedef PolicyFixture<Lirs> LirsFixture;
+typedef PolicyFixture<Sieve> SieveFixture;
+typedef PolicyFixture<S3Fifo> S3FifoFixture;
+typedef PolicyFixture<PerFile> PerFilePolicyFixture;
+
+
+SUITE(clockProTests){
+
+  /*
+   * Fills the pool with cold pages in their test period and references one
+   * of them again. Checks that the cold hand promotes it to hot, and that it
+   * then outlives a scan of twice the pool, which evicts the other pages.
+   */
+  TEST_FIXTURE(ClockProFixture, clockProPromoteTest){
+    std::vector<PageId> pages = allocatePages(3 * BUF_SIZE);
+
+    PRINT("TEST: a cold page referenced in its test period turns hot\n");
+    PRINT("      and stays resident through a scan.\n");
+
+    access(pages, 0, BUF_SIZE);
+    CHECK_EQUAL(0u, policy().getHotCount());
+    CHECK_EQUAL(BUF_SIZE, policy().getColdCount());
+
+    access(pages, 0, 1);
+    access(pages, BUF_SIZE, 3 * BUF_SIZE);
+    CHECK_EQUAL(1u, policy().getHotCount());
+    CHECK_EQUAL(BUF_SIZE - 1, policy().getColdCount());
+    CHECK(mgr->isResident(pages.at(0)));
+    CHECK(!mgr->isResident(pages.at(1)));
+  }
+
+  /*
+   * Evicts a page in its test period and reads it back in. Checks that it
+   * comes back hot and grows the cold target, and that a scan long enough
+   * to expire the test periods of the pages it evicts shrinks the cold
+   * target back.
+   */
+  TEST_FIXTURE(ClockProFixture, clockProColdTargetTest){
+    std::vector<PageId> pages = allocatePages(3 * BUF_SIZE + 1);
+
+    PRINT("TEST: a miss on a test page grows the cold target, expired\n");
+    PRINT("      test pages shrink it.\n");
+
+    access(pages, 0, BUF_SIZE + 1);
+    CHECK_EQUAL(1u, policy().getColdTarget());
+    CHECK_EQUAL(1u, policy().getNonresidentCount());
+
+    std::uint32_t victim = 0;
+    while(mgr->isResident(pages.at(victim))){
+      victim++;
+    }
+    access(pages, victim, victim + 1);
+    CHECK_EQUAL(2u, policy().getColdTarget());
+    CHECK_EQUAL(1u, policy().getHotCount());
+
+    access(pages, BUF_SIZE + 1, 3 * BUF_SIZE + 1);
+    CHECK_EQUAL(1u, policy().getColdTarget());
+    CHECK(policy().getNonresidentCount() <= BUF_SIZE);
+  }
+
+  /*
+   * Promotes a page and leaves non-resident test pages behind a scan, then
+   * deallocates the promoted page and removes the file. Checks that no page
+   * is counted any more, and that the pages of the file created again with
+   * the same FileId start cold, though they have the PageIds of the pages
+   * left in their test period.
+   */
+  TEST_FIXTURE(ClockProFixture, clockProFreeTest){
+    std::vector<PageId> pages = allocatePages(2 * BUF_SIZE);
+
+    PRINT("TEST: freeFrame and removeFile leave no hot, cold or\n");
+    PRINT("      non-resident pages behind.\n");
+
+    access(pages, 0, BUF_SIZE);
+    access(pages, 0, 1);
+    access(pages, BUF_SIZE, 2 * BUF_SIZE);
+    CHECK_EQUAL(1u, policy().getHotCount());
+    CHECK(policy().getNonresidentCount() > 0);
+    std::uint32_t cold_target = policy().getColdTarget();
+
+    mgr->deallocatePage(pages.at(0));
+    CHECK_EQUAL(0u, policy().getHotCount());
+    CHECK_EQUAL(BUF_SIZE - 1, policy().getColdCount());
+
+    mgr->removeFile(file_id);
+    CHECK_EQUAL(0u, policy().getColdCount());
+    CHECK_EQUAL(0u, policy().getNonresidentCount());
+
+    mgr->createFile(file_id);
+    pages = allocatePages(BUF_SIZE);
+    access(pages, 0, BUF_SIZE);
+    CHECK_EQUAL(0u, policy().getHotCount());
+    CHECK_EQUAL(BUF_SIZE, policy().getColdCount());
+    CHECK_EQUAL(cold_target, policy().getColdTarget());
+  }
+
+  /*
+   * Fills the pool with pages the admission filter has seen three times,
+   * then gets a page seen once, which bypasses the pool. Checks that the
+   * victim chosen for it is resident and cold as before, not made hot as a
+   * miss on a page in its test period.
+   */
+  TEST_FIXTURE(ClockProFixture, clockProBypassTest){
+    std::vector<PageId> pages = allocatePages(BUF_SIZE + 1);
+
+    PRINT("TEST: a page that bypasses the pool leaves the CLOCK-Pro\n");
+    PRINT("      state unchanged.\n");
+
+    accessPinned(pages, 0, BUF_SIZE);
+    std::vector<FrameId> ranked = rankFrames();
+    std::uint32_t cold_target = policy().getColdTarget();
+
+    access(pages, BUF_SIZE, BUF_SIZE + 1);
+    CHECK(!mgr->isResident(pages.at(BUF_SIZE)));
+    CHECK(ranked == rankFrames());
+    CHECK_EQUAL(0u, policy().getHotCount());
+    CHECK_EQUAL(BUF_SIZE, policy().getColdCount());
+    CHECK_EQUAL(cold_target, policy().getColdTarget());
+    CHECK_EQUAL(0u, policy().getNonresidentCount());
+  }
+
+}
+
+
+SUITE(lirsTests){
+
+  /*
+   * Loops 10 times over a tenth more pages than the pool holds, with LIRS
+   * and with Clock. Checks that LIRS keeps its LIR pages resident, so that
+   * most accesses after the first loop hit, while Clock evicts every page
+   * just before it is needed again and never hits.
+   */
+  TEST_FIXTURE(LirsFixture, lirsLoopTest){
+    std::uint32_t loop = BUF_SIZE + BUF_SIZE / 10 + 1;
+    std::uint32_t loops = 10;
+    std::vector<PageId> pages = allocatePages(loop);
+    BasicBufferManager<Clock> *clock = new BasicBufferManager<Clock>(disk_mgr);
+
+    PRINT("TEST: LIRS hits on most of a loop slightly larger than the\n");
+    PRINT("      pool, Clock on none.\n");
+
+    access(pages, 0, loop);
+    access(clock, pages, 0, loop);
+    for(std::uint32_t i = 1; i < loops; i++){
+      access(pages, 0, loop);
+      access(clock, pages, 0, loop);
+    }
+
+    std::uint64_t accesses = (std::uint64_t)(loops - 1) * loop;
+    CHECK(mgr->getBufferStats().hits >= accesses / 2);
+    CHECK(mgr->getBufferStats().hits >=
+        (loops - 1) * (std::uint64_t)(policy().getLirCount() - 1));
+    CHECK_EQUAL(0u, clock->getBufferStats().hits);
+    delete clock;
+  }
+
+  /*
+   * Fills the pool, so that the last pages are HIR, and references the last
+   * HIR page again while it is on the stack. Checks that it turns LIR, so
+   * that it outlives as many misses as there are HIR frames, which evict the
+   * LIR page demoted in its place. Then misses on a page evicted while on
+   * the stack, and checks that it comes back LIR the same way.
+   */
+  TEST_FIXTURE(LirsFixture, lirsHirPromoteTest){
+    PRINT("TEST: HIR pages referenced again while on the stack turn\n");
+    PRINT("      LIR.\n");
+
+    std::vector<PageId> pages = allocatePages(BUF_SIZE);
+    access(pages, 0, BUF_SIZE);
+    std::uint32_t lir_target = policy().getLirCount();
+    std::uint32_t hir_frames = BUF_SIZE - lir_target;
+    CHECK_EQUAL(hir_frames, policy().getHirCount());
+    std::vector<PageId> more = allocatePages(2 * hir_frames + 1);
+    PageId hir = pages.at(BUF_SIZE - 1);
+
+    access(pages, BUF_SIZE - 1, BUF_SIZE);
+    CHECK_EQUAL(lir_target, policy().getLirCount());
+    access(more, 0, hir_frames);
+    CHECK(mgr->isResident(hir));
+    // the bottom LIR page was demoted, and evicted off the stack
+    CHECK(!mgr->isResident(pages.at(0)));
+    CHECK_EQUAL(hir_frames - 1, policy().getNonresidentCount());
+
+    // the oldest resident HIR page goes, but stays on the stack
+    PageId evicted = more.at(0);
+    access(more, hir_frames, hir_frames + 1);
+    CHECK(!mgr->isResident(evicted));
+    CHECK_EQUAL(hir_frames, policy().getNonresidentCount());
+
+    // reading it back evicts another HIR page, which stays on the stack in
+    // its place
+    access(more, 0, 1);
+    CHECK_EQUAL(hir_frames, policy().getNonresidentCount());
+    CHECK_EQUAL(lir_target, policy().getLirCount());
+    access(more, hir_frames + 1, 2 * hir_frames + 1);
+    CHECK(mgr->isResident(evicted));
+  }
+
+  /*
+   * Leaves HIR entries between the LIR pages on the stack, then references
+   * the LIR page at the bottom. Checks that the stack is pruned down to the
+   * next LIR page, dropping the HIR entries below it.
+   */
+  TEST_FIXTURE(LirsFixture, lirsPruneTest){
+    std::uint32_t extra = 5;
+    std::vector<PageId> pages = allocatePages(BUF_SIZE + extra);
+
+    PRINT("TEST: stack pruning leaves an LIR page at the bottom.\n");
+
+    access(pages, 0, BUF_SIZE);
+    std::uint32_t lir_count = policy().getLirCount();
+    access(pages, BUF_SIZE, BUF_SIZE + extra);
+    CHECK(policy().getNonresidentCount() > 0);
+
+    // the LIR pages but the first go above the HIR entries
+    access(pages, 1, lir_count);
+    CHECK(policy().getStackBottom().lir);
+    CHECK(policy().getStackBottom().page_id == pages.at(0));
+    CHECK(policy().getStackSize() > lir_count);
+
+    access(pages, 0, 1);
+    CHECK(policy().getStackBottom().lir);
+    CHECK(policy().getStackBottom().page_id == pages.at(1));
+    CHECK_EQUAL(lir_count, policy().getStackSize());
+    CHECK_EQUAL(0u, policy().getNonresidentCount());
+  }
+
+  /*
+   * Fills the pool with pages of a second file, which take the LIR pages,
+   * then leaves non-resident HIR pages of the file of TestFixture on the
+   * stack above them and removes that file. Checks that the pages of the
+   * file created again with the same FileId do not come back LIR as misses
+   * on those entries, which would demote and evict LIR pages of the second
+   * file.
+   */
+  TEST_FIXTURE(LirsFixture, lirsRemoveFileTest){
+    std::string other_name = "testrel2.rel";
+    FileId other_id = catalog->addEntry(other_name, nullptr, nullptr,
+        nullptr, HeapFileT, INVALID_FILE_ID, other_name);
+    std::vector<PageId> others;
+
+    PRINT("TEST: removeFile leaves no non-resident HIR pages behind.\n");
+
+    mgr->createFile(other_id);
+    for(std::uint32_t i = 0; i < BUF_SIZE; i++){
+      others.push_back(disk_mgr->allocatePage(other_id));
+    }
+    access(others, 0, BUF_SIZE);
+    std::uint32_t lir_count = policy().getLirCount();
+
+    // the HIR pages of the second file are evicted first, then half the
+    // pages read in
+    std::vector<PageId> pages = allocatePages(BUF_SIZE / 2);
+    access(pages, 0, BUF_SIZE / 2);
+    CHECK_EQUAL(BUF_SIZE / 2, policy().getNonresidentCount());
+    mgr->removeFile(file_id);
+    CHECK_EQUAL(BUF_SIZE - lir_count, policy().getNonresidentCount());
+    CHECK_EQUAL(lir_count, policy().getLirCount());
+
+    mgr->createFile(file_id);
+    pages = allocatePages(BUF_SIZE / 2);
+    access(pages, 0, BUF_SIZE / 2);
+    for(std::uint32_t i = 0; i < lir_count; i++){
+      CHECK(mgr->isResident(others.at(i)));
+    }
+
+    mgr->removeFile(other_id);
+  }
+
+  /*
+   * Fills the pool with pages the admission filter has seen three times,
+   * then gets a page seen once, which bypasses the pool. Checks that the HIR
+   * victim chosen for it is back in the queue and on the stack, not made
+   * LIR as a miss on a non-resident HIR page.
+   */
+  TEST_FIXTURE(LirsFixture, lirsBypassTest){
+    std::vector<PageId> pages = allocatePages(BUF_SIZE + 1);
+
+    PRINT("TEST: a page that bypasses the pool leaves the LIRS state\n");
+    PRINT("      unchanged.\n");
+
+    accessPinned(pages, 0, BUF_SIZE);
+    std::vector<FrameId> ranked = rankFrames();
+    std::uint32_t lir_count = policy().getLirCount();
+    std::uint32_t stack_size = policy().getStackSize();
+
+    access(pages, BUF_SIZE, BUF_SIZE + 1);
+    CHECK(!mgr->isResident(pages.at(BUF_SIZE)));
+    CHECK(ranked == rankFrames());
+    CHECK_EQUAL(lir_count, policy().getLirCount());
+    CHECK_EQUAL(BUF_SIZE - lir_count, policy().getHirCount());
+    CHECK_EQUAL(stack_size, policy().getStackSize());
+    CHECK_EQUAL(0u, policy().getNonresidentCount());
+  }
+
+}
+
+
+
+SUITE(sieveTests){
+
+  /*
+   * Fills the pool and gets its oldest page again, then reads in one page
+   * less than the pool holds. Checks that the hand clears the visited bit of
+   * the oldest page and passes over it, replacing every other page of the
+   * pool instead.
+   */
+  TEST_FIXTURE(SieveFixture, sieveVisitedTest){
+    std::vector<PageId> pages = allocatePages(2 * BUF_SIZE - 1);
+
+    PRINT("TEST: a visited page survives a pass of the SIEVE hand.\n");
+
+    access(pages, 0, BUF_SIZE);
+    access(pages, 0, 1);
+    access(pages, BUF_SIZE, BUF_SIZE + 1);
+    CHECK(mgr->isResident(pages.at(0)));
+    CHECK(!mgr->isResident(pages.at(1)));
+
+    access(pages, BUF_SIZE + 1, 2 * BUF_SIZE - 1);
+    CHECK(mgr->isResident(pages.at(0)));
+    for(std::uint32_t i = 1; i < BUF_SIZE; i++){
+      CHECK(!mgr->isResident(pages.at(i)));
+    }
+  }
+
+  /*
+   * Fills the pool with pages the admission filter has seen three times,
+   * then gets a page seen once, which bypasses the pool. Checks that the
+   * victim chosen for it is back in its place in the queue.
+   */
+  TEST_FIXTURE(SieveFixture, sieveBypassTest){
+    std::vector<PageId> pages = allocatePages(BUF_SIZE + 1);
+
+    PRINT("TEST: a page that bypasses the pool leaves the SIEVE state\n");
+    PRINT("      unchanged.\n");
+
+    accessPinned(pages, 0, BUF_SIZE);
+    std::vector<FrameId> ranked = rankFrames();
+
+    access(pages, BUF_SIZE, BUF_SIZE + 1);
+    CHECK(!mgr->isResident(pages.at(BUF_SIZE)));
+    CHECK(ranked == rankFrames());
+  }
+
+}
+
+
+SUITE(s3FifoTests){
+
+  /*
+   * Fills the pool, which puts every page in small, and gets its second
+   * page again. Checks that the next page read in replaces the oldest page,
+   * which goes to ghost and not to main, and that the one after it moves
+   * the visited second page to main before replacing the third.
+   */
+  TEST_FIXTURE(S3FifoFixture, s3FifoSmallTest){
+    std::vector<PageId> pages = allocatePages(BUF_SIZE + 2);
+
+    PRINT("TEST: a page accessed once leaves small without entering\n");
+    PRINT("      main, a visited one moves to main.\n");
+
+    access(pages, 0, BUF_SIZE);
+    CHECK_EQUAL(BUF_SIZE, policy().getSmallCount());
+    access(pages, 1, 2);
+
+    access(pages, BUF_SIZE, BUF_SIZE + 1);
+    CHECK(!mgr->isResident(pages.at(0)));
+    CHECK_EQUAL(0u, policy().getMainCount());
+    CHECK_EQUAL(1u, policy().getGhostCount());
+
+    access(pages, BUF_SIZE + 1, BUF_SIZE + 2);
+    CHECK(mgr->isResident(pages.at(1)));
+    CHECK(!mgr->isResident(pages.at(2)));
+    CHECK_EQUAL(1u, policy().getMainCount());
+    CHECK_EQUAL(2u, policy().getGhostCount());
+  }
+
+  /*
+   * Fills the pool and reads in one more page, which leaves the PageId of
+   * the oldest page in ghost, then reads the oldest page back in. Checks
+   * that it skips small and goes to main.
+   */
+  TEST_FIXTURE(S3FifoFixture, s3FifoGhostTest){
+    std::vector<PageId> pages = allocatePages(BUF_SIZE + 1);
+
+    PRINT("TEST: a page read in while in ghost goes to main.\n");
+
+    access(pages, 0, BUF_SIZE + 1);
+    CHECK(!mgr->isResident(pages.at(0)));
+    CHECK_EQUAL(1u, policy().getGhostCount());
+
+    access(pages, 0, 1);
+    CHECK(mgr->isResident(pages.at(0)));
+    CHECK_EQUAL(1u, policy().getMainCount());
+    CHECK_EQUAL(BUF_SIZE - 1, policy().getSmallCount());
+    // the page replaced to make room for it is in ghost instead
+    CHECK_EQUAL(1u, policy().getGhostCount());
+  }
+
+  /*
+   * Fills the pool with pages the admission filter has seen three times,
+   * then gets a page seen once, which bypasses the pool. Checks that the
+   * victim chosen for it is back at the tail of small and not in ghost,
+   * where a miss on it would have moved it to main.
+   */
+  TEST_FIXTURE(S3FifoFixture, s3FifoBypassTest){
+    std::vector<PageId> pages = allocatePages(BUF_SIZE + 1);
+
+    PRINT("TEST: a page that bypasses the pool leaves the S3-FIFO\n");
+    PRINT("      state unchanged.\n");
+
+    accessPinned(pages, 0, BUF_SIZE);
+    std::vector<FrameId> ranked = rankFrames();
+
+    access(pages, BUF_SIZE, BUF_SIZE + 1);
+    CHECK(!mgr->isResident(pages.at(BUF_SIZE)));
+    CHECK(ranked == rankFrames());
+    CHECK_EQUAL(BUF_SIZE, policy().getSmallCount());
+    CHECK_EQUAL(0u, policy().getMainCount());
+    CHECK_EQUAL(0u, policy().getGhostCount());
+  }
+
+  /*
+   * Fills the pool and reads in half as many pages again, which leaves the
+   * PageIds of the pages they replace in ghost, then removes the file.
+   * Checks that ghost is empty, and that the pages of the file created
+   * again with the same FileId start in small, though they have the PageIds
+   * that were in ghost.
+   */
+  TEST_FIXTURE(S3FifoFixture, s3FifoRemoveFileTest){
+    std::vector<PageId> pages = allocatePages(BUF_SIZE + BUF_SIZE / 2);
+
+    PRINT("TEST: removeFile leaves no PageIds in ghost.\n");
+
+    access(pages, 0, BUF_SIZE + BUF_SIZE / 2);
+    CHECK_EQUAL(BUF_SIZE / 2, policy().getGhostCount());
+    mgr->removeFile(file_id);
+    CHECK_EQUAL(0u, policy().getGhostCount());
+
+    mgr->createFile(file_id);
+    pages = allocatePages(BUF_SIZE / 2);
+    access(pages, 0, BUF_SIZE / 2);
+    CHECK_EQUAL(BUF_SIZE / 2, policy().getSmallCount());
+    CHECK_EQUAL(0u, policy().getMainCount());
+  }
+
+}
+
+SUITE(perFileRankTests){
+
+  /*
+   * Fills one half of the pool with pages of an LRU-K file and the other
+   * half with pages of an MRU file, each read once in order. Checks that
+   * rankFrames lists the MRU stack and the LRU-K candidates in the order
+   * each partition replaces them, merged by taking the next victim from the
+   * partition furthest above its share, the MRU one on a tie.
+   */
+  TEST_FIXTURE(PerFilePolicyFixture, perFileRankTest){
+    std::uint32_t half = BUF_SIZE / 2;
+    std::string scan_name = "testrel2.rel";
+    FileId scan_id = catalog->addEntry(scan_name, nullptr, nullptr, nullptr,
+        HeapFileT, INVALID_FILE_ID, scan_name);
+    mgr->createFile(scan_id);
+    mgr->setFilePolicy(file_id, LruKT);
+    mgr->setFilePolicy(scan_id, MruT);
+
+    PRINT("TEST: PerFile ranks the frames of an LRU-K and an MRU file\n");
+    PRINT("      by merging the orders of the two partitions.\n");
+
+    std::vector<PageId> pages = allocatePages(half);
+    for(std::uint32_t i = 0; i < half; i++){
+      pages.push_back(disk_mgr->allocatePage(scan_id));
+    }
+    access(pages, 0, 2 * half);
+
+    // frame i holds page i; the MRU partition replaces its newest page
+    // first, the LRU-K one its oldest
+    std::vector<FrameId> victims;
+    for(std::uint32_t i = 0; i < half; i++){
+      victims.push_back(2 * half - 1 - i);
+      victims.push_back(i);
+    }
+    std::vector<FrameId> ranked = rankFrames();
+    CHECK(std::vector<FrameId>(victims.rbegin(), victims.rend()) == ranked);
+
+    // a pinned page is left out, but still counts toward its partition
+    mgr->getPage(pages.at(0));
+    victims.clear();
+    for(std::uint32_t i = 0; i < half; i++){
+      victims.push_back(2 * half - 1 - i);
+      if(i + 1 < half){
+        victims.push_back(i + 1);
+      }
+    }
+    ranked = rankFrames();
+    CHECK(std::vector<FrameId>(victims.rbegin(), victims.rend()) == ranked);
+    mgr->releasePage(pages.at(0), false);
+
+    remove(scan_name.data());
+  }
+
+}
+
+
 /*
  * Prints usage
  */
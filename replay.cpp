@@ -0,0 +1,178 @@
+/*
+ * replay: replays a page access trace recorded by a TraceRecorder through
+ * replacement policies and buffer pool sizes, in parallel, and prints what
+ * each would have cost.
+ *
+ *   ./replay -t trace.bin -p Clock,Lirs,S3Fifo -s 1024,4096 -j 8
+ *
+ * Sizes are in frames, or in bytes with a K, M or G suffix. Sizes above
+ * BUF_SIZE frames need the buffer manager built with a larger BUF_SIZE.
+ */
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <unistd.h>
+#include <vector>
+#include <thread>
+
+#include "swatdb_types.h"
+#include "bufmgr.h"
+#include "bm_trace.h"
+#include "bm_replay.h"
+#include "page.h"
+
+/*
+ * Policies replayed when -p is not given.
+ */
+static const PolicyType DEFAULT_POLICIES[] = {ClockT, RandomT, GClockT,
+  ClockProT, LirsT, SieveT, S3FifoT};
+
+/*
+ * Prints usage
+ */
+void usage(){
+  std::cout << "Usage: ./replay -t <trace_file> [-p <policies>] " <<
+      "[-s <sizes>] [-j <threads>] -h help\n";
+  std::cout << "  -p  comma separated policies, default all of them: ";
+  for (PolicyType rep_type : DEFAULT_POLICIES){
+    std::cout << bm_rep_str(rep_type) << " ";
+  }
+  std::cout << "\n  -s  comma separated buffer pool sizes, in frames, or in " <<
+      "bytes with a\n      K, M or G suffix, default " << BUF_SIZE / 4 <<
+      "," << BUF_SIZE / 2 << "," << BUF_SIZE << " (BUF_SIZE = " <<
+      BUF_SIZE << ")\n";
+  std::cout << "  -j  number of replays run at once, default the number " <<
+      "of CPUs" << std::endl;
+}
+
+/*
+ * Splits a comma separated list.
+ */
+std::vector<std::string> split(const std::string &list){
+  std::vector<std::string> items;
+  std::stringstream in(list);
+  std::string item;
+  while (std::getline(in, item, ',')){
+    if (!item.empty()){
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+/*
+ * Returns the PolicyType named name, or INVALID_REP_TYPE.
+ */
+PolicyType parsePolicy(const std::string &name){
+  for (PolicyType i = 0; i <= LruKT; i++){
+    if (i != INVALID_REP_TYPE && bm_rep_str(i) == name){
+      return i;
+    }
+  }
+  return INVALID_REP_TYPE;
+}
+
+/*
+ * Returns the number of frames of a size in frames, or in bytes with a K,
+ * M or G suffix, or 0 if it is not a size.
+ */
+std::uint32_t parseSize(const std::string &size){
+  char *end;
+  unsigned long long n = strtoull(size.c_str(), &end, 10);
+  std::string suffix(end);
+  if (end == size.c_str()){
+    return 0;
+  }
+  if (suffix.empty()){
+    return n;
+  }
+  if (suffix == "K" || suffix == "k"){
+    n <<= 10;
+  }
+  else if (suffix == "M" || suffix == "m"){
+    n <<= 20;
+  }
+  else if (suffix == "G" || suffix == "g"){
+    n <<= 30;
+  }
+  else {
+    return 0;
+  }
+  return n / PAGE_SIZE;
+}
+
+/*
+ * Reads the trace, replays it with every policy and size asked for, and
+ * prints the comparison table.
+ */
+int main(int argc, char** argv){
+  std::string trace_path;
+  std::vector<PolicyType> policies(std::begin(DEFAULT_POLICIES),
+      std::end(DEFAULT_POLICIES));
+  std::vector<std::uint32_t> sizes = {BUF_SIZE / 4, BUF_SIZE / 2, BUF_SIZE};
+  std::uint32_t num_threads = std::thread::hardware_concurrency();
+  int c;
+
+  while ((c = getopt (argc, argv, "ht:p:s:j:")) != -1){
+    switch(c) {
+      case 'h': usage();
+                exit(1);
+      case 't': trace_path = optarg;
+                break;
+      case 'p': policies.clear();
+                for (std::string &name : split(optarg)){
+                  PolicyType rep_type = parsePolicy(name);
+                  if (rep_type == INVALID_REP_TYPE){
+                    std::cerr << "unknown policy: " << name << std::endl;
+                    exit(1);
+                  }
+                  policies.push_back(rep_type);
+                }
+                break;
+      case 's': sizes.clear();
+                for (std::string &size : split(optarg)){
+                  std::uint32_t frames = parseSize(size);
+                  if (frames == 0){
+                    std::cerr << "bad size: " << size << std::endl;
+                    exit(1);
+                  }
+                  sizes.push_back(frames);
+                }
+                break;
+      case 'j': num_threads = atoi(optarg);
+                break;
+      default: usage();
+               exit(1);
+    }
+  }
+  if (trace_path.empty()){
+    usage();
+    exit(1);
+  }
+  if (num_threads == 0){
+    num_threads = 1;
+  }
+
+  std::vector<TraceEvent> events;
+  if (!bm_read_trace(trace_path, &events)){
+    if (events.empty()){
+      std::cerr << "cannot read trace: " << trace_path << std::endl;
+      exit(1);
+    }
+    std::cerr << "trace is cut short, replaying its first " <<
+        events.size() << " events" << std::endl;
+  }
+
+  std::vector<ReplayConfig> configs;
+  for (PolicyType rep_type : policies){
+    for (std::uint32_t size : sizes){
+      configs.push_back(ReplayConfig{rep_type, size});
+    }
+  }
+  std::cout << "Replaying " << events.size() << " events of " << trace_path <<
+      " with " << configs.size() << " configurations" << std::endl;
+  bm_print_replay(bm_replay_all(events, configs, num_threads));
+  return 0;
+}
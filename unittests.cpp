@@ -4,15 +4,29 @@
 #include <cstdio>
 #include <cstring>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 #include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
 
 #include <UnitTest++/UnitTest++.h>
 #include <UnitTest++/TestReporterStdout.h>
 #include <UnitTest++/TestRunner.h>
 
 #include "swatdb_exceptions.h"
+#include "bm_exceptions.h"
 #include "diskmgr.h"
 #include "bufmgr.h"
+#include "bm_partitioned.h"
+#include "bm_numa.h"
+#include "bm_ccache.h"
+#include "bm_trace.h"
+#include "bm_replay.h"
+#include "bm_mrc.h"
+#include "bm_workload.h"
 #include "page.h"
 #include "catalog.h"
 #include "file.h"
@@ -663,6 +677,1691 @@ SUITE(removeFile){
 }
 
 
+/*
+ * Tests the TinyLFU admission filter and the bypass area.
+ */
+SUITE(admission){
+
+  /*
+   * Turns admission on and fills the buffer pool with BUF_SIZE pages that are
+   * each accessed 3 times. Gets a page that is not in the buffer pool: it is
+   * read into the bypass area, so the buffer pool is unchanged and writes to
+   * it reach the disk when it is released. Getting it repeatedly raises its
+   * estimated frequency above the victim's until it is admitted, after which
+   * getting it again does not call the replacement policy.
+   */
+  TEST_FIXTURE(TestFixture,bypassTest){
+    std::vector<PageId> allocated_pages;
+    Page *temp_page = nullptr;
+    char *temp_data = nullptr;
+
+    PRINT("TEST: bypassTest: cold page bypasses a pool of hot pages\n");
+    this->buf_mgr->setAdmission(true);
+    for (std::uint32_t i = 0; i < BUF_SIZE + 1; i++){
+      allocated_pages.push_back(disk_mgr->allocatePage(file_id));
+    }
+    for (int access = 0; access < 3; access++){
+      for (std::uint32_t i = 0; i < BUF_SIZE; i++){
+        this->buf_mgr->getPage(allocated_pages.at(i));
+        this->buf_mgr->releasePage(allocated_pages.at(i), false);
+      }
+    }
+
+    PageId cold = allocated_pages.at(BUF_SIZE);
+    temp_page = this->buf_mgr->getPage(cold);
+    memset(temp_page->getData(), 'b', PAGE_SIZE);
+    // the bypassed page is pinned but takes no frame of the buffer pool
+    checkBufferState(BUF_SIZE, 0, 0);
+    CHECK_EQUAL(temp_page, this->buf_mgr->getPage(cold));
+    this->buf_mgr->releasePage(cold, false);
+    this->buf_mgr->releasePage(cold, true);
+    // dropped once unpinned
+    CHECK_THROW(this->buf_mgr->releasePage(cold, false), PageNotFoundBufMgr);
+
+    // every hot page is still resident
+    std::uint64_t rep_calls =
+      this->buf_mgr->getBufferState().replace_stats.rep_calls;
+    for (std::uint32_t i = 0; i < BUF_SIZE; i++){
+      this->buf_mgr->getPage(allocated_pages.at(i));
+      this->buf_mgr->releasePage(allocated_pages.at(i), false);
+    }
+    CHECK_EQUAL(rep_calls,
+        this->buf_mgr->getBufferState().replace_stats.rep_calls);
+
+    // the write to the bypassed page was not lost
+    temp_data = new char[PAGE_SIZE];
+    memset(temp_data, 'b', PAGE_SIZE);
+    temp_page = this->buf_mgr->getPage(cold);
+    CHECK(!memcmp(temp_data, temp_page->getData(), PAGE_SIZE));
+    this->buf_mgr->releasePage(cold, false);
+
+    // repeated accesses get the page admitted
+    bool admitted = false;
+    for (int access = 0; access < 10 && !admitted; access++){
+      rep_calls = this->buf_mgr->getBufferState().replace_stats.rep_calls;
+      this->buf_mgr->getPage(cold);
+      this->buf_mgr->releasePage(cold, false);
+      admitted = rep_calls ==
+        this->buf_mgr->getBufferState().replace_stats.rep_calls;
+    }
+    CHECK(admitted);
+    checkBufferState(BUF_SIZE, 0, 0);
+#ifdef BMGR_DEBUG
+    printBufferState();
+#endif
+
+    delete []temp_data;
+  }
+}
+
+
+/*
+ * Tests the AccessHint argument of getPage and releasePage.
+ */
+SUITE(accessHints){
+
+  /*
+   * Gets a page with OnceHint and writes to it. Checks that it leaves the
+   * buffer pool when released, that the write reached the disk, and that a
+   * hint given to releasePage overrides the one given to getPage.
+   */
+  TEST_FIXTURE(TestFixture,onceHintTest){
+    PageId page_id = disk_mgr->allocatePage(file_id);
+    char *temp_data = new char[PAGE_SIZE];
+
+    PRINT("TEST: onceHintTest: page got with OnceHint leaves when released\n");
+    Page *temp_page = this->buf_mgr->getPage(page_id, OnceHint);
+    memset(temp_page->getData(), 'o', PAGE_SIZE);
+    this->buf_mgr->releasePage(page_id, true);
+    checkBufferState(0, 0, 0);
+    CHECK_THROW(this->buf_mgr->releasePage(page_id, false),
+        PageNotFoundBufMgr);
+
+    memset(temp_data, 'o', PAGE_SIZE);
+    temp_page = this->buf_mgr->getPage(page_id, OnceHint);
+    CHECK(!memcmp(temp_data, temp_page->getData(), PAGE_SIZE));
+    this->buf_mgr->releasePage(page_id, false, KeepHotHint);
+    checkBufferState(1, 0, 0);
+
+    delete []temp_data;
+  }
+
+  /*
+   * Pins a page with OnceHint, then again with NoHint. Checks that the
+   * second pin keeps the hint of the first, so the page still leaves the
+   * buffer pool once both pins are released.
+   */
+  TEST_FIXTURE(TestFixture,noHintKeepsHintTest){
+    PageId page_id = disk_mgr->allocatePage(file_id);
+
+    PRINT("TEST: noHintKeepsHintTest: NoHint pin keeps an earlier hint\n");
+    this->buf_mgr->getPage(page_id, OnceHint);
+    this->buf_mgr->getPage(page_id);
+    this->buf_mgr->releasePage(page_id, false);
+    checkBufferState(1, 1, 0);
+    this->buf_mgr->releasePage(page_id, false);
+    checkBufferState(0, 0, 0);
+  }
+
+  /*
+   * Fills the buffer pool, then gets one of its pages again with
+   * SequentialHint. Checks that the next page read in replaces it.
+   */
+  TEST_FIXTURE(TestFixture,sequentialHintTest){
+    std::vector<PageId> allocated_pages;
+
+    PRINT("TEST: sequentialHintTest: scan page is replaced first\n");
+    for (std::uint32_t i = 0; i < BUF_SIZE + 1; i++){
+      allocated_pages.push_back(disk_mgr->allocatePage(file_id));
+    }
+    for (std::uint32_t i = 0; i < BUF_SIZE; i++){
+      this->buf_mgr->getPage(allocated_pages.at(i));
+      this->buf_mgr->releasePage(allocated_pages.at(i), false);
+    }
+
+    PageId scanned = allocated_pages.at(BUF_SIZE / 2);
+    Page *scan_page = this->buf_mgr->getPage(scanned, SequentialHint);
+    this->buf_mgr->releasePage(scanned, false);
+
+    CHECK_EQUAL(scan_page,
+        this->buf_mgr->getPage(allocated_pages.at(BUF_SIZE)));
+    checkBufferState(BUF_SIZE, 1, 0);
+  }
+
+  /*
+   * Under GClock, fills the buffer pool and releases one page with
+   * KeepHotHint. Checks that it is still resident after as many new pages as
+   * the pool holds have been read in.
+   */
+  TEST_FIXTURE(TestFixture,keepHotHintTest){
+    std::vector<PageId> allocated_pages;
+    BufferManager gclock_mgr(disk_mgr, GClockT);
+
+    PRINT("TEST: keepHotHintTest: hot page survives a pool of new pages\n");
+    for (std::uint32_t i = 0; i < 2 * BUF_SIZE; i++){
+      allocated_pages.push_back(disk_mgr->allocatePage(file_id));
+    }
+    for (std::uint32_t i = 0; i < BUF_SIZE; i++){
+      gclock_mgr.getPage(allocated_pages.at(i));
+      gclock_mgr.releasePage(allocated_pages.at(i), false,
+          i == 0 ? KeepHotHint : NoHint);
+    }
+    for (std::uint32_t i = BUF_SIZE; i < 2 * BUF_SIZE; i++){
+      gclock_mgr.getPage(allocated_pages.at(i));
+      gclock_mgr.releasePage(allocated_pages.at(i), false);
+    }
+
+    std::uint64_t rep_calls =
+      gclock_mgr.getBufferState().replace_stats.rep_calls;
+    gclock_mgr.getPage(allocated_pages.at(0));
+    gclock_mgr.releasePage(allocated_pages.at(0), false);
+    CHECK_EQUAL(rep_calls, gclock_mgr.getBufferState().replace_stats.rep_calls);
+  }
+}
+
+
+/*
+ * Tests PartitionedBufferManager.
+ */
+SUITE(partitioned){
+
+  /*
+   * Reads as many pages as one shard holds into 4 shards. Checks that the
+   * pages are spread over the shards, that the state is summed over the
+   * shards, and that getting the pages again does not call the replacement
+   * policy. Checks that a pool of 0 shards is refused.
+   */
+  TEST_FIXTURE(TestFixture,shardStateTest){
+    PartitionedBufferManager part_mgr(disk_mgr, rep_pol, 4);
+    std::vector<PageId> allocated_pages;
+    std::vector<Page*> pages;
+    std::uint32_t per_shard[4] = {0, 0, 0, 0};
+
+    PRINT("TEST: shardStateTest: pages spread over the shards\n");
+    CHECK_THROW(PartitionedBufferManager(disk_mgr, rep_pol, 0),
+        InvalidArgumentBufMgr);
+    for (std::uint32_t i = 0; i < BUF_SIZE; i++){
+      allocated_pages.push_back(disk_mgr->allocatePage(file_id));
+      per_shard[part_mgr.getShard(allocated_pages.at(i))]++;
+    }
+    CHECK_EQUAL(4u, part_mgr.getNumShards());
+    // BUF_SIZE pages all fit in one shard, so this only fails if the hash
+    // keeps every page in the same shard
+    for (std::uint32_t s = 0; s < 4; s++){
+      CHECK(per_shard[s] < BUF_SIZE);
+    }
+
+    for (std::uint32_t i = 0; i < BUF_SIZE; i++){
+      pages.push_back(part_mgr.getPage(allocated_pages.at(i)));
+    }
+    BufferState cur_buf = part_mgr.getBufferState();
+    CHECK_EQUAL(4 * BUF_SIZE, cur_buf.total);
+    CHECK_EQUAL(BUF_SIZE, cur_buf.valid);
+    CHECK_EQUAL(BUF_SIZE, cur_buf.pinned);
+    CHECK_EQUAL(3 * BUF_SIZE, cur_buf.unpinned);
+    CHECK_EQUAL(3 * BUF_SIZE, part_mgr.getNumUnpinned());
+
+    std::uint64_t rep_calls = cur_buf.replace_stats.rep_calls;
+    for (std::uint32_t i = 0; i < BUF_SIZE; i++){
+      part_mgr.releasePage(allocated_pages.at(i), i % 2 == 0);
+      CHECK_EQUAL(pages.at(i), part_mgr.getPage(allocated_pages.at(i)));
+      part_mgr.releasePage(allocated_pages.at(i), false);
+    }
+    cur_buf = part_mgr.getBufferState();
+    CHECK_EQUAL(rep_calls, cur_buf.replace_stats.rep_calls);
+    CHECK_EQUAL(0u, cur_buf.pinned);
+    CHECK_EQUAL((BUF_SIZE + 1) / 2, cur_buf.dirty);
+  }
+
+  /*
+   * Allocates pages through 4 shards. Checks that each lands in the buffer
+   * pool without being read back from disk or counted as a miss, and
+   * that installPage refuses a page that is already resident.
+   */
+  TEST_FIXTURE(TestFixture,allocateInstallTest){
+    PartitionedBufferManager part_mgr(disk_mgr, rep_pol, 4);
+
+    PRINT("TEST: allocateInstallTest: allocated pages are not read back\n");
+    for (std::uint32_t i = 0; i < BUF_SIZE; i++){
+      PageId page_id = part_mgr.allocatePage(file_id).second;
+      part_mgr.releasePage(page_id, false);
+    }
+    BufferStats stats = part_mgr.getBufferStats();
+    CHECK_EQUAL(0u, stats.misses);
+    CHECK_EQUAL(0u, stats.reads);
+    CHECK_EQUAL(BUF_SIZE, part_mgr.getBufferState().valid);
+    CHECK_EQUAL(0u, part_mgr.getBufferState().pinned);
+
+    PageId page_id = disk_mgr->allocatePage(file_id);
+    this->buf_mgr->installPage(page_id);
+    CHECK_THROW(this->buf_mgr->installPage(page_id), PageAlreadyLoadedBufMgr);
+    this->buf_mgr->releasePage(page_id, false);
+    CHECK_EQUAL(0u, this->buf_mgr->getBufferStats().reads);
+  }
+
+  /*
+   * Pins every frame of one shard. Checks that another page of that shard
+   * cannot be read in while pages of the other shard still can.
+   */
+  TEST_FIXTURE(TestFixture,fullShardTest){
+    PartitionedBufferManager part_mgr(disk_mgr, rep_pol, 2);
+    std::vector<PageId> shard_pages[2];
+
+    PRINT("TEST: fullShardTest: a full shard does not borrow frames\n");
+    while (shard_pages[0].size() < BUF_SIZE + 1 || shard_pages[1].empty()){
+      PageId page_id = disk_mgr->allocatePage(file_id);
+      shard_pages[part_mgr.getShard(page_id)].push_back(page_id);
+    }
+    for (std::uint32_t i = 0; i < BUF_SIZE; i++){
+      part_mgr.getPage(shard_pages[0].at(i));
+    }
+    CHECK_THROW(part_mgr.getPage(shard_pages[0].at(BUF_SIZE)),
+        InsufficientSpaceBufMgr);
+    part_mgr.getPage(shard_pages[1].at(0));
+    CHECK_EQUAL(BUF_SIZE + 1, part_mgr.getBufferState().pinned);
+
+    part_mgr.releasePage(shard_pages[0].at(0), false);
+    part_mgr.getPage(shard_pages[0].at(BUF_SIZE));
+    CHECK_EQUAL(BUF_SIZE + 1, part_mgr.getBufferState().pinned);
+  }
+
+  /*
+   * Allocates pages through the shards and writes to them. Checks that
+   * removeFile fails while one is pinned and leaves the written data on
+   * disk, then empties every shard once they are released.
+   */
+  TEST_FIXTURE(TestFixture,allocateRemoveTest){
+    PartitionedBufferManager part_mgr(disk_mgr, rep_pol, 4);
+    std::vector<PageId> allocated_pages;
+    char *temp_data = new char[PAGE_SIZE];
+    Page *temp_page;
+
+    PRINT("TEST: allocateRemoveTest: allocate and remove across shards\n");
+    for (std::uint32_t i = 0; i < 8; i++){
+      std::pair<Page*, PageId> new_page = part_mgr.allocatePage(file_id);
+      memset(new_page.first->getData(), 'a' + i, PAGE_SIZE);
+      allocated_pages.push_back(new_page.second);
+    }
+    CHECK_EQUAL(8u, part_mgr.getBufferState().pinned);
+    for (std::uint32_t i = 1; i < 8; i++){
+      part_mgr.releasePage(allocated_pages.at(i), true);
+    }
+
+    CHECK_THROW(part_mgr.removeFile(file_id), PagePinnedBufMgr);
+    part_mgr.releasePage(allocated_pages.at(0), true);
+    for (std::uint32_t i = 0; i < 8; i++){
+      memset(temp_data, 'a' + i, PAGE_SIZE);
+      temp_page = part_mgr.getPage(allocated_pages.at(i));
+      CHECK(!memcmp(temp_data, temp_page->getData(), PAGE_SIZE));
+      part_mgr.releasePage(allocated_pages.at(i), false);
+    }
+
+    part_mgr.removeFile(file_id);
+    BufferState cur_buf = part_mgr.getBufferState();
+    CHECK_EQUAL(0u, cur_buf.valid);
+    CHECK_EQUAL(0u, cur_buf.dirty);
+
+    delete []temp_data;
+  }
+}
+
+
+/*
+ * Tests NumaBufferManager. Only the node of the test thread is known, so
+ * remote accesses are made by filling that node with pinned pages.
+ */
+SUITE(numa){
+
+  /*
+   * With one node, reads a pool of pages and gets them again. Checks that
+   * every access is counted as local.
+   */
+  TEST_FIXTURE(TestFixture,singleNodeTest){
+    NumaBufferManager numa_mgr(disk_mgr, rep_pol, 1);
+    std::vector<PageId> allocated_pages;
+
+    PRINT("TEST: singleNodeTest: one node serves every access locally\n");
+    CHECK_EQUAL(1u, numa_mgr.getNumNodes());
+    CHECK_EQUAL(0u, numa_mgr.getCurrentNode());
+    for (std::uint32_t i = 0; i < BUF_SIZE; i++){
+      allocated_pages.push_back(disk_mgr->allocatePage(file_id));
+      numa_mgr.getPage(allocated_pages.at(i));
+      numa_mgr.releasePage(allocated_pages.at(i), false);
+    }
+    for (std::uint32_t i = 0; i < BUF_SIZE; i++){
+      numa_mgr.getPage(allocated_pages.at(i));
+      numa_mgr.releasePage(allocated_pages.at(i), true);
+    }
+
+    NumaNodeStats stats = numa_mgr.getNodeStats(0);
+    CHECK_EQUAL(BUF_SIZE, stats.local_loads);
+    CHECK_EQUAL(BUF_SIZE, stats.local_hits);
+    CHECK_EQUAL(0u, stats.remote_loads);
+    CHECK_EQUAL(0u, stats.remote_hits);
+    BufferState cur_buf = numa_mgr.getBufferState();
+    CHECK_EQUAL(BUF_SIZE, cur_buf.total);
+    CHECK_EQUAL(BUF_SIZE, cur_buf.valid);
+    CHECK_EQUAL(BUF_SIZE, cur_buf.dirty);
+  }
+
+  /*
+   * With two nodes, pins a pool of pages, which fills the node of the test
+   * thread. Checks that the next page is read into the other node, that
+   * getting it again is a remote hit there, and that a released page of the
+   * local node is not read in a second time.
+   */
+  TEST_FIXTURE(TestFixture,remoteNodeTest){
+    NumaBufferManager numa_mgr(disk_mgr, rep_pol, 2);
+    std::vector<PageId> allocated_pages;
+    std::uint32_t local = numa_mgr.getCurrentNode();
+    std::uint32_t remote = 1 - local;
+
+    PRINT("TEST: remoteNodeTest: a full node spills to the other node\n");
+    for (std::uint32_t i = 0; i < BUF_SIZE + 1; i++){
+      allocated_pages.push_back(disk_mgr->allocatePage(file_id));
+      numa_mgr.getPage(allocated_pages.at(i));
+    }
+    CHECK_EQUAL(BUF_SIZE, numa_mgr.getNodeStats(local).local_loads);
+    CHECK_EQUAL(1u, numa_mgr.getNodeStats(remote).remote_loads);
+
+    Page *spilled = numa_mgr.getPage(allocated_pages.at(BUF_SIZE));
+    numa_mgr.releasePage(allocated_pages.at(BUF_SIZE), false);
+    numa_mgr.releasePage(allocated_pages.at(BUF_SIZE), false);
+    CHECK_EQUAL(1u, numa_mgr.getNodeStats(remote).remote_hits);
+
+    numa_mgr.releasePage(allocated_pages.at(0), true);
+    CHECK_EQUAL(spilled, numa_mgr.getPage(allocated_pages.at(BUF_SIZE)));
+    numa_mgr.getPage(allocated_pages.at(0));
+    CHECK_EQUAL(1u, numa_mgr.getNodeStats(local).local_hits);
+    CHECK_EQUAL(BUF_SIZE, numa_mgr.getNodeStats(local).local_loads);
+
+    BufferState cur_buf = numa_mgr.getBufferState();
+    CHECK_EQUAL(2 * BUF_SIZE, cur_buf.total);
+    CHECK_EQUAL(BUF_SIZE + 1, cur_buf.valid);
+    CHECK_EQUAL(BUF_SIZE + 1, cur_buf.pinned);
+    CHECK_EQUAL(1u, cur_buf.dirty);
+  }
+
+  /*
+   * With two nodes, has four threads get and release more pages than both
+   * nodes hold, each thread bumping its own counter in every page it gets.
+   * Checks that no update is lost, as it would be if a page were read into
+   * two nodes at once, and that every access is counted.
+   */
+  TEST_FIXTURE(TestFixture,concurrentTest){
+    NumaBufferManager numa_mgr(disk_mgr, rep_pol, 2);
+    std::vector<PageId> allocated_pages;
+    std::uint32_t num_pages = 3 * BUF_SIZE;
+    std::uint32_t num_threads = 4;
+    std::uint32_t per_thread = 20 * num_pages;
+
+    PRINT("TEST: concurrentTest: threads share the nodes\n");
+    for (std::uint32_t i = 0; i < num_pages; i++){
+      allocated_pages.push_back(disk_mgr->allocatePage(file_id));
+      Page *page = numa_mgr.getPage(allocated_pages.at(i));
+      memset(page->getData(), 0, PAGE_SIZE);
+      numa_mgr.releasePage(allocated_pages.at(i), true);
+    }
+
+    auto work = [&](std::uint32_t thread){
+      for (std::uint32_t i = 0; i < per_thread; i++){
+        PageId page_id = allocated_pages.at((i * 7 + thread) % num_pages);
+        Page *page = numa_mgr.getPage(page_id);
+        ((std::uint32_t*)page->getData())[thread]++;
+        numa_mgr.releasePage(page_id, true);
+      }
+    };
+    std::vector<std::thread> threads;
+    for (std::uint32_t t = 0; t < num_threads; t++){
+      threads.push_back(std::thread(work, t));
+    }
+    for (std::thread &thread : threads){
+      thread.join();
+    }
+
+    std::vector<std::uint32_t> bumps(num_threads, 0);
+    for (PageId page_id : allocated_pages){
+      Page *page = numa_mgr.getPage(page_id);
+      for (std::uint32_t t = 0; t < num_threads; t++){
+        bumps[t] += ((std::uint32_t*)page->getData())[t];
+      }
+      numa_mgr.releasePage(page_id, false);
+    }
+    std::uint64_t accesses = 0;
+    for (std::uint32_t t = 0; t < num_threads; t++){
+      CHECK_EQUAL(per_thread, bumps[t]);
+    }
+    for (std::uint32_t node = 0; node < 2; node++){
+      NumaNodeStats stats = numa_mgr.getNodeStats(node);
+      accesses += stats.local_hits + stats.remote_hits + stats.local_loads +
+                  stats.remote_loads;
+    }
+    CHECK_EQUAL((std::uint64_t)(num_threads * per_thread + 2 * num_pages),
+                accesses);
+    CHECK_EQUAL(0u, numa_mgr.getBufferState().pinned);
+  }
+}
+
+
+/*
+ * Tests the placement of the buffer pool in mapped memory.
+ */
+SUITE(poolMemory){
+
+  /*
+   * Asks for huge pages. Checks that the buffer pool is mapped, on whatever
+   * kind of page the system provides, and that pages written through it
+   * reach the disk.
+   */
+  TEST_FIXTURE(TestFixture,hugePageTest){
+    std::vector<PageId> allocated_pages;
+    char *temp_data = new char[PAGE_SIZE];
+
+    PRINT("TEST: hugePageTest: buffer pool mapped on huge pages\n");
+    CHECK_EQUAL(HeapPool, this->buf_mgr->getPoolMemory());
+    {
+      BufferManager huge_mgr(disk_mgr, rep_pol, -1, true);
+      CHECK(huge_mgr.getPoolMemory() != HeapPool);
+      PRINT("pool memory: " << bm_pool_mem_str(huge_mgr.getPoolMemory())
+          << "\n");
+      for (std::uint32_t i = 0; i < BUF_SIZE; i++){
+        std::pair<Page*, PageId> new_page = huge_mgr.allocatePage(file_id);
+        memset(new_page.first->getData(), 'h' + i % 8, PAGE_SIZE);
+        huge_mgr.releasePage(new_page.second, true);
+        allocated_pages.push_back(new_page.second);
+      }
+    }
+
+    for (std::uint32_t i = 0; i < BUF_SIZE; i++){
+      memset(temp_data, 'h' + i % 8, PAGE_SIZE);
+      Page *temp_page = this->buf_mgr->getPage(allocated_pages.at(i));
+      CHECK(!memcmp(temp_data, temp_page->getData(), PAGE_SIZE));
+      this->buf_mgr->releasePage(allocated_pages.at(i), false);
+    }
+
+    delete []temp_data;
+  }
+}
+
+
+SUITE(mappedFiles){
+
+  /*
+   * Maps the file after writing its pages through the buffer pool. Checks
+   * that the pages are read in place from the mapping, that more of them
+   * than the buffer pool holds can be pinned at once, that pin counts and
+   * exceptions work as for the buffer pool, that a writable getPage is
+   * refused and a dirty release is refused but unpins the page, and that
+   * pages written through the buffer pool after unmapping are read from the
+   * mapping when the file is mapped again. Skipped if the DiskManager stores
+   * the file in a layout that cannot be mapped.
+   */
+  TEST_FIXTURE(TestFixture,mappedPageTest){
+    std::vector<PageId> allocated_pages;
+    std::vector<const char*> mapped_pages;
+    char *temp_data = new char[PAGE_SIZE];
+    std::uint32_t num_pages = 2 * BUF_SIZE;
+
+    PRINT("TEST: mappedPageTest: pages served from a mapped file\n");
+    for (std::uint32_t i = 0; i < num_pages; i++){
+      std::pair<Page*, PageId> new_page = this->buf_mgr->allocatePage(file_id);
+      memset(new_page.first->getData(), 'a' + i % 26, PAGE_SIZE);
+      this->buf_mgr->releasePage(new_page.second, true);
+      allocated_pages.push_back(new_page.second);
+    }
+
+    try{
+      this->buf_mgr->mapFile(file_id, file_name);
+    }catch(IOErrorBufMgr &e){
+      PRINT("file layout cannot be mapped, skipped\n");
+      delete []temp_data;
+      return;
+    }
+    CHECK_EQUAL(0u, this->buf_mgr->getBufferState().valid);
+
+    // every page pinned at once, though the buffer pool has BUF_SIZE frames
+    for (std::uint32_t i = 0; i < num_pages; i++){
+      memset(temp_data, 'a' + i % 26, PAGE_SIZE);
+      const char *data = this->buf_mgr->getPageData(allocated_pages.at(i));
+      CHECK(!memcmp(temp_data, data, PAGE_SIZE));
+      CHECK(this->buf_mgr->isResident(allocated_pages.at(i)));
+      mapped_pages.push_back(data);
+    }
+    CHECK_EQUAL(0u, this->buf_mgr->getBufferState().valid);
+    CHECK(this->buf_mgr->sampleMappedPages(file_id) <= num_pages);
+
+    // a second pin returns the same address
+    CHECK_EQUAL(mapped_pages.at(0),
+        this->buf_mgr->getPageData(allocated_pages.at(0)));
+    this->buf_mgr->releasePage(allocated_pages.at(0), false);
+
+    CHECK_THROW(this->buf_mgr->removeFile(file_id), PagePinnedBufMgr);
+    CHECK_THROW(this->buf_mgr->deallocatePage(allocated_pages.at(0)),
+        PagePinnedBufMgr);
+    CHECK_THROW(
+        this->buf_mgr->getPageData(PageId{file_id, num_pages + 100}),
+        InvalidPageIdBufMgr);
+
+    // the mapping is read-only; the refused dirty release gives up its pin
+    CHECK_THROW(this->buf_mgr->getPage(allocated_pages.at(0)),
+        ReadOnlyFileBufMgr);
+    this->buf_mgr->getPageData(allocated_pages.at(0));
+    CHECK_THROW(this->buf_mgr->releasePage(allocated_pages.at(0), true),
+        ReadOnlyFileBufMgr);
+    CHECK_THROW(this->buf_mgr->setDirty(allocated_pages.at(0)),
+        ReadOnlyFileBufMgr);
+    CHECK_THROW(this->buf_mgr->allocatePage(file_id), ReadOnlyFileBufMgr);
+    for (std::uint32_t i = 0; i < num_pages; i++){
+      this->buf_mgr->releasePage(allocated_pages.at(i), false);
+    }
+    CHECK_THROW(this->buf_mgr->releasePage(allocated_pages.at(0), false),
+        PageNotPinnedBufMgr);
+    // at most BUF_SIZE unpinned pages stay mapped in
+    CHECK(!this->buf_mgr->isResident(allocated_pages.at(0)));
+    CHECK(this->buf_mgr->isResident(allocated_pages.at(num_pages - 1)));
+
+    this->buf_mgr->unmapFile(file_id);
+    for (std::uint32_t i = 0; i < num_pages; i++){
+      Page *temp_page = this->buf_mgr->getPage(allocated_pages.at(i));
+      memset(temp_page->getData(), 'A' + i % 26, PAGE_SIZE);
+      this->buf_mgr->releasePage(allocated_pages.at(i), true);
+    }
+    this->buf_mgr->mapFile(file_id, file_name);
+    for (std::uint32_t i = 0; i < num_pages; i++){
+      memset(temp_data, 'A' + i % 26, PAGE_SIZE);
+      const char *data = this->buf_mgr->getPageData(allocated_pages.at(i));
+      CHECK(!memcmp(temp_data, data, PAGE_SIZE));
+      this->buf_mgr->releasePage(allocated_pages.at(i), false);
+    }
+    this->buf_mgr->unmapFile(file_id);
+
+    delete []temp_data;
+  }
+
+  /*
+   * Pins and deallocates pages of a mapped file. Checks that a page is
+   * pinned in the mapping, that a page released with OnceHint is dropped
+   * from the mapping and the page cache, that no page can be allocated
+   * while the file is mapped, and that a deallocated page can no longer be
+   * pinned.
+   */
+  TEST_FIXTURE(TestFixture,mappedAllocateTest){
+    PRINT("TEST: mappedAllocateTest: allocating pages of a mapped file\n");
+    std::pair<Page*, PageId> first = this->buf_mgr->allocatePage(file_id);
+    this->buf_mgr->releasePage(first.second, true);
+    std::pair<Page*, PageId> new_page = this->buf_mgr->allocatePage(file_id);
+    memset(new_page.first->getData(), 'm', PAGE_SIZE);
+    this->buf_mgr->releasePage(new_page.second, true);
+    // the kernel only drops clean pages from the page cache
+    this->buf_mgr->flushPage(first.second);
+    this->buf_mgr->flushPage(new_page.second);
+    int fd = open(file_name.c_str(), O_RDONLY);
+    fsync(fd);
+    close(fd);
+
+    try{
+      this->buf_mgr->mapFile(file_id, file_name);
+    }catch(IOErrorBufMgr &e){
+      PRINT("file layout cannot be mapped, skipped\n");
+      return;
+    }
+    CHECK_THROW(this->buf_mgr->allocatePage(file_id), ReadOnlyFileBufMgr);
+
+    const char *data = this->buf_mgr->getPageData(new_page.second);
+    CHECK(!this->buf_mgr->isResident(first.second));
+    CHECK(this->buf_mgr->isResident(new_page.second));
+    CHECK_EQUAL(0u, this->buf_mgr->getBufferState().valid);
+    CHECK_EQUAL('m', data[PAGE_SIZE - 1]);
+    this->buf_mgr->flushPage(new_page.second);
+    this->buf_mgr->releasePage(new_page.second, false, OnceHint);
+    CHECK(!this->buf_mgr->isResident(new_page.second));
+    // dropped from the page cache too, not only from the mapping
+    CHECK_EQUAL(0u, this->buf_mgr->sampleMappedPages(file_id));
+
+    this->buf_mgr->deallocatePage(new_page.second);
+    CHECK_THROW(this->buf_mgr->getPageData(new_page.second),
+        InvalidPageIdBufMgr);
+    CHECK_THROW(this->buf_mgr->flushPage(new_page.second),
+        PageNotFoundBufMgr);
+  }
+}
+
+SUITE(compressedCache){
+
+  /*
+   * Compresses pages of zeros, of repeated records, of random bytes and of
+   * a mix of them. Checks that each decompresses to what was compressed,
+   * that random bytes do not fit in 7/8 of a page, and that a truncated
+   * block is rejected.
+   */
+  TEST_FIXTURE(TestFixture,compressRoundTripTest){
+    char *page = new char[PAGE_SIZE];
+    char *compressed = new char[2 * PAGE_SIZE];
+    char *restored = new char[PAGE_SIZE];
+    std::size_t size;
+
+    PRINT("TEST: compressRoundTripTest: compressing and decompressing\n");
+    for (std::uint32_t kind = 0; kind < 4; kind++){
+      std::srand(kind);
+      for (std::uint32_t i = 0; i < PAGE_SIZE; i++){
+        switch(kind){
+          case 0: page[i] = 0; break;
+          case 1: page[i] = "record #"[i % 8] + (i / 64) % 3; break;
+          case 2: page[i] = std::rand(); break;
+          default: page[i] = i < PAGE_SIZE / 2 ? std::rand() : 'x'; break;
+        }
+      }
+      size = bm_lz_compress(page, PAGE_SIZE, compressed, 2 * PAGE_SIZE);
+      CHECK(size > 0);
+      CHECK(bm_lz_decompress(compressed, size, restored, PAGE_SIZE));
+      CHECK(!memcmp(page, restored, PAGE_SIZE));
+      if( kind < 2 ){
+        CHECK(size < PAGE_SIZE / 8);
+      }
+      if( kind == 2 ){
+        CHECK_EQUAL(0u, bm_lz_compress(page, PAGE_SIZE, compressed,
+              PAGE_SIZE / 8 * 7));
+      }
+      CHECK(!bm_lz_decompress(compressed, size - 1, restored, PAGE_SIZE));
+    }
+
+    delete []page;
+    delete []compressed;
+    delete []restored;
+  }
+
+  /*
+   * Reads back twice as many compressible pages as the buffer pool holds,
+   * with a compressed cache large enough for all of them. Checks that the
+   * misses are served by the cache with the right data, and that a page
+   * deallocated while it is in the cache cannot be read back.
+   */
+  TEST_FIXTURE(TestFixture,compressedHitTest){
+    std::vector<PageId> allocated_pages;
+    char *temp_data = new char[PAGE_SIZE];
+    std::uint32_t num_pages = 2 * BUF_SIZE;
+
+    PRINT("TEST: compressedHitTest: misses served by the compressed cache\n");
+    this->buf_mgr->setCompressedCache(num_pages * PAGE_SIZE);
+    for (std::uint32_t i = 0; i < num_pages; i++){
+      std::pair<Page*, PageId> new_page = this->buf_mgr->allocatePage(file_id);
+      memset(new_page.first->getData(), 'a' + i % 26, PAGE_SIZE);
+      memcpy(new_page.first->getData(), &i, sizeof(i));
+      this->buf_mgr->releasePage(new_page.second, true);
+      allocated_pages.push_back(new_page.second);
+    }
+
+    for (std::uint32_t i = 0; i < num_pages; i++){
+      memset(temp_data, 'a' + i % 26, PAGE_SIZE);
+      memcpy(temp_data, &i, sizeof(i));
+      Page *temp_page = this->buf_mgr->getPage(allocated_pages.at(i));
+      CHECK(!memcmp(temp_data, temp_page->getData(), PAGE_SIZE));
+      this->buf_mgr->releasePage(allocated_pages.at(i), false);
+    }
+
+    CompressedCacheStats stats = this->buf_mgr->getCompressedCacheStats();
+    PRINT("hits: " << stats.hits << " ratio: "
+        << (double)stats.raw_bytes / stats.stored_bytes << "\n");
+    // pages evicted while allocating went to the cache too
+    CHECK_EQUAL((std::uint64_t)num_pages, stats.hits);
+    CHECK_EQUAL(0u, stats.evictions);
+    CHECK(stats.stored_bytes * 4 < stats.raw_bytes);
+    CHECK(stats.used_bytes <= num_pages * PAGE_SIZE);
+
+    // the first BUF_SIZE pages were evicted again, into the cache
+    this->buf_mgr->deallocatePage(allocated_pages.at(0));
+    CHECK_THROW(this->buf_mgr->getPage(allocated_pages.at(0)),
+        InvalidPageIdBufMgr);
+
+    this->buf_mgr->setCompressedCache(0);
+    CHECK_EQUAL(0u, this->buf_mgr->getCompressedCacheStats().entries);
+    delete []temp_data;
+  }
+}
+
+SUITE(ssdCache){
+
+  /*
+   * Reads back twice as many pages as the buffer pool holds, with an SSD
+   * cache file in another directory large enough for all of them. Checks
+   * that the misses are served by the cache with the right data, that a
+   * page deallocated while it is in the cache cannot be read back, and that
+   * a cache file in a missing directory is refused.
+   */
+  TEST_FIXTURE(TestFixture,ssdHitTest){
+    std::vector<PageId> allocated_pages;
+    char *temp_data = new char[PAGE_SIZE];
+    std::uint32_t num_pages = 2 * BUF_SIZE;
+    std::string cache_dir = "ssd_cache_test";
+    std::string cache_path = cache_dir + "/pages.cache";
+
+    PRINT("TEST: ssdHitTest: misses served by the SSD cache\n");
+    mkdir(cache_dir.data(), 0755);
+    this->buf_mgr->setSsdCache(cache_path, 2 * num_pages);
+    for (std::uint32_t i = 0; i < num_pages; i++){
+      std::pair<Page*, PageId> new_page = this->buf_mgr->allocatePage(file_id);
+      memset(new_page.first->getData(), 'a' + i % 26, PAGE_SIZE);
+      this->buf_mgr->releasePage(new_page.second, true);
+      allocated_pages.push_back(new_page.second);
+    }
+
+    for (std::uint32_t i = 0; i < num_pages; i++){
+      memset(temp_data, 'a' + i % 26, PAGE_SIZE);
+      Page *temp_page = this->buf_mgr->getPage(allocated_pages.at(i));
+      CHECK(!memcmp(temp_data, temp_page->getData(), PAGE_SIZE));
+      this->buf_mgr->releasePage(allocated_pages.at(i), false);
+    }
+
+    // pages evicted while allocating went to the cache too
+    SsdCacheStats stats = this->buf_mgr->getSsdCacheStats();
+    CHECK_EQUAL((std::uint64_t)num_pages, stats.hits);
+    CHECK_EQUAL(0u, stats.dropped);
+
+    this->buf_mgr->deallocatePage(allocated_pages.at(0));
+    CHECK_THROW(this->buf_mgr->getPage(allocated_pages.at(0)),
+        InvalidPageIdBufMgr);
+
+    this->buf_mgr->setSsdCache(cache_path, 0);
+    remove(cache_path.data());
+    remove((cache_path + ".idx").data());
+    rmdir(cache_dir.data());
+    CHECK_THROW(this->buf_mgr->setSsdCache(cache_path, num_pages),
+        IOErrorBufMgr);
+    CHECK_EQUAL(0u, this->buf_mgr->getSsdCacheStats().hits);
+    delete []temp_data;
+  }
+
+  /*
+   * Destroys the BufferManager and turns the SSD cache on with the same
+   * file in a new one. Checks that the pages it held are found again
+   * through its index.
+   */
+  TEST_FIXTURE(TestFixture,ssdRestartTest){
+    std::vector<PageId> allocated_pages;
+    char *temp_data = new char[PAGE_SIZE];
+    std::uint32_t num_pages = 2 * BUF_SIZE;
+    std::string cache_path = "ssd_restart_test.cache";
+
+    PRINT("TEST: ssdRestartTest: SSD cache found again after a restart\n");
+    this->buf_mgr->setSsdCache(cache_path, 2 * num_pages);
+    for (std::uint32_t i = 0; i < num_pages; i++){
+      std::pair<Page*, PageId> new_page = this->buf_mgr->allocatePage(file_id);
+      memset(new_page.first->getData(), 'A' + i % 26, PAGE_SIZE);
+      this->buf_mgr->releasePage(new_page.second, true);
+      allocated_pages.push_back(new_page.second);
+    }
+
+    delete this->buf_mgr;
+    this->buf_mgr = new BufferManager(this->disk_mgr, rep_pol);
+    this->buf_mgr->setSsdCache(cache_path, 2 * num_pages);
+    CHECK_EQUAL(BUF_SIZE, this->buf_mgr->getSsdCacheStats().resident);
+
+    // the first BUF_SIZE pages were evicted to the cache
+    for (std::uint32_t i = 0; i < BUF_SIZE; i++){
+      memset(temp_data, 'A' + i % 26, PAGE_SIZE);
+      Page *temp_page = this->buf_mgr->getPage(allocated_pages.at(i));
+      CHECK(!memcmp(temp_data, temp_page->getData(), PAGE_SIZE));
+      this->buf_mgr->releasePage(allocated_pages.at(i), false);
+    }
+    CHECK_EQUAL((std::uint64_t)BUF_SIZE,
+        this->buf_mgr->getSsdCacheStats().hits);
+
+    this->buf_mgr->setSsdCache(cache_path, 0);
+    remove(cache_path.data());
+    remove((cache_path + ".idx").data());
+    delete []temp_data;
+  }
+
+  /*
+   * Turns the SSD cache off, rewrites a page it held while it is off, and
+   * turns it on again with the same file. Checks that the page is read
+   * back as rewritten, not as the cache held it.
+   */
+  TEST_FIXTURE(TestFixture,ssdOffWriteOnTest){
+    std::vector<PageId> allocated_pages;
+    char *temp_data = new char[PAGE_SIZE];
+    std::uint32_t num_pages = 2 * BUF_SIZE;
+    std::string cache_path = "ssd_off_test.cache";
+
+    PRINT("TEST: ssdOffWriteOnTest: no stale pages after the cache is off\n");
+    this->buf_mgr->setSsdCache(cache_path, 2 * num_pages);
+    for (std::uint32_t i = 0; i < num_pages; i++){
+      std::pair<Page*, PageId> new_page = this->buf_mgr->allocatePage(file_id);
+      memset(new_page.first->getData(), 'A', PAGE_SIZE);
+      this->buf_mgr->releasePage(new_page.second, true);
+      allocated_pages.push_back(new_page.second);
+    }
+    PageId page_id = allocated_pages.at(0);
+
+    this->buf_mgr->setSsdCache(cache_path, 0);
+    Page *temp_page = this->buf_mgr->getPage(page_id);
+    memset(temp_page->getData(), 'B', PAGE_SIZE);
+    this->buf_mgr->releasePage(page_id, true);
+    this->buf_mgr->evictFile(file_id);
+
+    this->buf_mgr->setSsdCache(cache_path, 2 * num_pages);
+    CHECK_EQUAL(0u, this->buf_mgr->getSsdCacheStats().resident);
+    memset(temp_data, 'B', PAGE_SIZE);
+    temp_page = this->buf_mgr->getPage(page_id);
+    CHECK(!memcmp(temp_data, temp_page->getData(), PAGE_SIZE));
+    this->buf_mgr->releasePage(page_id, false);
+
+    this->buf_mgr->setSsdCache(cache_path, 0);
+    remove(cache_path.data());
+    remove((cache_path + ".idx").data());
+    delete []temp_data;
+  }
+}
+
+SUITE(warmUp){
+
+  /*
+   * Dumps a full buffer pool with one page pinned, evicts every page, and
+   * reads the dump back in. Checks that the pinned page is dumped first,
+   * that a dump to a missing directory is refused, and that every page
+   * comes back with its data.
+   */
+  TEST_FIXTURE(TestFixture,dumpWarmTest){
+    std::vector<PageId> allocated_pages;
+    char *temp_data = new char[PAGE_SIZE];
+    std::string dump_path = "warm_test.dump";
+
+    PRINT("TEST: dumpWarmTest: the dumped pages are read back in\n");
+    for (std::uint32_t i = 0; i < BUF_SIZE; i++){
+      std::pair<Page*, PageId> new_page = this->buf_mgr->allocatePage(file_id);
+      memset(new_page.first->getData(), 'a' + i % 26, PAGE_SIZE);
+      this->buf_mgr->releasePage(new_page.second, true);
+      allocated_pages.push_back(new_page.second);
+    }
+
+    PageId pinned = allocated_pages.at(BUF_SIZE / 2);
+    this->buf_mgr->getPage(pinned);
+    CHECK_EQUAL(BUF_SIZE, this->buf_mgr->dumpResidentPages(dump_path));
+    this->buf_mgr->releasePage(pinned, false);
+    CHECK_THROW(this->buf_mgr->dumpResidentPages("no_such_dir/warm.dump"),
+        IOErrorBufMgr);
+
+    std::ifstream dump(dump_path);
+    std::string magic;
+    std::uint32_t count;
+    PageId first;
+    dump >> magic >> count >> first.file_id >> first.page_num;
+    CHECK_EQUAL(BUF_SIZE, count);
+    CHECK(first == pinned);
+    dump.close();
+
+    this->buf_mgr->evictFile(file_id);
+    checkBufferState(0, 0, 0);
+
+    CHECK_EQUAL(BUF_SIZE, this->buf_mgr->warmFromDump(dump_path));
+    std::uint32_t batches = 0;
+    while (this->buf_mgr->warmUp(BUF_SIZE / 4 + 1) > 0){
+      batches++;
+    }
+    CHECK(batches > 0);
+    checkBufferState(BUF_SIZE, 0, 0);
+
+    for (std::uint32_t i = 0; i < BUF_SIZE; i++){
+      CHECK(this->buf_mgr->isResident(allocated_pages.at(i)));
+      memset(temp_data, 'a' + i % 26, PAGE_SIZE);
+      Page *temp_page = this->buf_mgr->getPage(allocated_pages.at(i));
+      CHECK(!memcmp(temp_data, temp_page->getData(), PAGE_SIZE));
+      this->buf_mgr->releasePage(allocated_pages.at(i), false);
+    }
+
+    CHECK_EQUAL(0u, this->buf_mgr->warmFromDump("no_such_file.dump"));
+    remove(dump_path.data());
+    delete []temp_data;
+  }
+
+  /*
+   * Reads pages in with getPage before a dump is read back in. Checks that
+   * warm-up only fills the free frames, so none of those pages is evicted,
+   * and skips a page deallocated since the dump. Then turns automatic dumps
+   * on and checks that a miss writes a dump.
+   */
+  TEST_FIXTURE(TestFixture,warmPriorityTest){
+    std::vector<PageId> dumped;
+    std::vector<PageId> others;
+    std::string dump_path = "warm_priority.dump";
+
+    PRINT("TEST: warmPriorityTest: warm-up never evicts a page\n");
+    for (std::uint32_t i = 0; i < 2 * BUF_SIZE; i++){
+      std::pair<Page*, PageId> new_page = this->buf_mgr->allocatePage(file_id);
+      this->buf_mgr->releasePage(new_page.second, true);
+    }
+    for (PageNum i = 0; i < 2 * BUF_SIZE; i++){
+      PageId page_id = {file_id, i};
+      if (this->buf_mgr->isResident(page_id)){
+        dumped.push_back(page_id);
+      }
+      else{
+        others.push_back(page_id);
+      }
+    }
+    CHECK_EQUAL(BUF_SIZE, this->buf_mgr->dumpResidentPages(dump_path));
+    this->buf_mgr->evictFile(file_id);
+    this->buf_mgr->deallocatePage(dumped.at(0));
+
+    std::uint32_t foreground = BUF_SIZE / 2;
+    for (std::uint32_t i = 0; i < foreground; i++){
+      this->buf_mgr->getPage(others.at(i));
+      this->buf_mgr->releasePage(others.at(i), false);
+    }
+
+    CHECK_EQUAL(BUF_SIZE, this->buf_mgr->warmFromDump(dump_path));
+    while (this->buf_mgr->warmUp(2) > 0){
+    }
+    checkBufferState(BUF_SIZE, 0, 0);
+    for (std::uint32_t i = 0; i < foreground; i++){
+      CHECK(this->buf_mgr->isResident(others.at(i)));
+    }
+    CHECK(!this->buf_mgr->isResident(dumped.at(0)));
+
+    remove(dump_path.data());
+    this->buf_mgr->setAutoDump(dump_path, 1);
+    this->buf_mgr->getPage(others.at(foreground));
+    this->buf_mgr->releasePage(others.at(foreground), false);
+    this->buf_mgr->setAutoDump("", 0);
+    CHECK_EQUAL(BUF_SIZE, this->buf_mgr->warmFromDump(dump_path));
+
+    remove(dump_path.data());
+  }
+}
+
+SUITE(bufferStats){
+
+  /*
+   * Reads back more pages than the buffer pool holds, and pins every frame.
+   * Checks that hits and misses add up to the getPage calls, that every miss
+   * and every dirty eviction is one page of I/O, and that a getPage turned
+   * away for lack of an unpinned frame is a pin wait.
+   */
+  TEST_FIXTURE(TestFixture,countersTest){
+    std::vector<PageId> allocated_pages;
+    std::uint32_t num_pages = BUF_SIZE + 1;
+
+    PRINT("TEST: countersTest: hits, misses, evictions and I/O counted\n");
+    for (std::uint32_t i = 0; i < num_pages; i++){
+      std::pair<Page*, PageId> new_page = this->buf_mgr->allocatePage(file_id);
+      this->buf_mgr->releasePage(new_page.second, true);
+      allocated_pages.push_back(new_page.second);
+    }
+    BufferStats stats = this->buf_mgr->getBufferStats();
+    CHECK_EQUAL(0u, stats.hits + stats.misses);
+    CHECK_EQUAL(1u, stats.dirty_evictions);
+    CHECK_EQUAL(1u, stats.writes);
+
+    for (std::uint32_t i = 0; i < num_pages; i++){
+      this->buf_mgr->getPage(allocated_pages.at(i));
+      this->buf_mgr->releasePage(allocated_pages.at(i), false);
+    }
+    stats = this->buf_mgr->getBufferStats();
+    CHECK_EQUAL((std::uint64_t)num_pages, stats.hits + stats.misses);
+    CHECK(stats.misses >= 1);
+    CHECK_EQUAL(stats.misses, stats.reads);
+    CHECK_EQUAL(stats.misses,
+        stats.clean_evictions + stats.dirty_evictions - 1);
+    CHECK_EQUAL(stats.dirty_evictions, stats.writes);
+    CHECK_EQUAL(stats.reads * PAGE_SIZE, stats.bytes_read);
+    CHECK_EQUAL(stats.writes * PAGE_SIZE, stats.bytes_written);
+    CHECK_EQUAL(0u, stats.pin_waits);
+
+    std::vector<PageId> pinned;
+    for (std::uint32_t i = 0; i < num_pages; i++){
+      if (this->buf_mgr->isResident(allocated_pages.at(i))){
+        this->buf_mgr->getPage(allocated_pages.at(i));
+        pinned.push_back(allocated_pages.at(i));
+      }
+    }
+    for (std::uint32_t i = 0; i < num_pages; i++){
+      if (!this->buf_mgr->isResident(allocated_pages.at(i))){
+        CHECK_THROW(this->buf_mgr->getPage(allocated_pages.at(i)),
+            InsufficientSpaceBufMgr);
+      }
+    }
+    CHECK_EQUAL(1u, this->buf_mgr->getBufferStats().pin_waits);
+    for (PageId page_id : pinned){
+      this->buf_mgr->releasePage(page_id, false);
+    }
+  }
+
+  /*
+   * Takes snapshots from another thread, without the latch, while pages are
+   * read in. The counters of a snapshot need not belong to the same moment,
+   * but checks that they never go back and that no increment is lost.
+   */
+  TEST_FIXTURE(TestFixture,snapshotTest){
+    std::vector<PageId> allocated_pages;
+    std::atomic<bool> done(false);
+    std::uint64_t backwards = 0;
+
+    PRINT("TEST: snapshotTest: unlatched snapshots never go back\n");
+    for (std::uint32_t i = 0; i < 2 * BUF_SIZE; i++){
+      std::pair<Page*, PageId> new_page = this->buf_mgr->allocatePage(file_id);
+      this->buf_mgr->releasePage(new_page.second, false);
+      allocated_pages.push_back(new_page.second);
+    }
+
+    std::thread reader([&](){
+      std::uint64_t last = 0;
+      while (!done.load()){
+        BufferStats stats = this->buf_mgr->getBufferStats();
+        if (stats.hits + stats.misses < last){
+          backwards++;
+        }
+        last = stats.hits + stats.misses;
+      }
+    });
+    for (std::uint32_t round = 0; round < 20; round++){
+      for (std::uint32_t i = 0; i < 2 * BUF_SIZE; i++){
+        this->buf_mgr->getPage(allocated_pages.at(i));
+        this->buf_mgr->releasePage(allocated_pages.at(i), false);
+      }
+    }
+    done.store(true);
+    reader.join();
+
+    CHECK_EQUAL(0u, backwards);
+    BufferStats stats = this->buf_mgr->getBufferStats();
+    CHECK_EQUAL((std::uint64_t)40 * BUF_SIZE, stats.hits + stats.misses);
+  }
+}
+
+SUITE(latency){
+
+  /*
+   * Records the latencies 1 to 1000 cycles. Checks that percentiles are
+   * within the 1/16 precision of the buckets and never above the largest
+   * latency, and that merging two histograms adds their counts and sums.
+   */
+  TEST_FIXTURE(TestFixture,histogramTest){
+    LatencyHistogram hist;
+
+    PRINT("TEST: histogramTest: percentiles of log-bucketed latencies\n");
+    CHECK_EQUAL(0u, hist.percentile(0.5));
+    for (std::uint64_t i = 1; i <= 1000; i++){
+      hist.record(i);
+    }
+    CHECK_EQUAL(1000u, hist.count());
+    CHECK_EQUAL(500500u, hist.sum());
+    CHECK(hist.percentile(0.5) >= 500);
+    CHECK(hist.percentile(0.5) <= 500 + 500 / 16);
+    CHECK(hist.percentile(0.99) >= 990);
+    CHECK(hist.percentile(0.99) <= 990 + 990 / 16);
+    CHECK(hist.percentile(0.999) <= 1000);
+    CHECK_EQUAL(1000u, hist.percentile(1.0));
+    CHECK_EQUAL(1u, hist.percentile(0.0));
+
+    LatencyHistogram copy(hist);
+    copy.merge(hist);
+    CHECK_EQUAL(2000u, copy.count());
+    CHECK_EQUAL(2 * hist.sum(), copy.sum());
+    CHECK_EQUAL(hist.percentile(0.5), copy.percentile(0.5));
+  }
+
+  /*
+   * Times every operation, then one in four. Checks that every getPage, page
+   * read and page write is in its histogram when every operation is timed,
+   * that the percentiles are ordered, and that sampling times one getPage
+   * call in four.
+   */
+  TEST_FIXTURE(TestFixture,samplingTest){
+    std::vector<PageId> allocated_pages;
+    std::uint32_t num_pages = BUF_SIZE + 1;
+
+    PRINT("TEST: samplingTest: operations timed into histograms\n");
+    this->buf_mgr->setLatencySampling(1);
+    for (std::uint32_t i = 0; i < num_pages; i++){
+      std::pair<Page*, PageId> new_page = this->buf_mgr->allocatePage(file_id);
+      this->buf_mgr->releasePage(new_page.second, true);
+      allocated_pages.push_back(new_page.second);
+    }
+    for (std::uint32_t i = 0; i < num_pages; i++){
+      this->buf_mgr->getPage(allocated_pages.at(i));
+      this->buf_mgr->releasePage(allocated_pages.at(i), false);
+    }
+
+    BufferStats stats = this->buf_mgr->getBufferStats();
+    LatencyHistogram hits = this->buf_mgr->getLatency(LatGetHit);
+    LatencyHistogram misses = this->buf_mgr->getLatency(LatGetMiss);
+    CHECK_EQUAL(stats.hits, hits.count());
+    CHECK_EQUAL(stats.misses, misses.count());
+    CHECK_EQUAL(stats.reads, this->buf_mgr->getLatency(LatRead).count());
+    CHECK_EQUAL(stats.writes, this->buf_mgr->getLatency(LatWrite).count());
+    CHECK(this->buf_mgr->getLatency(LatReplace).count() >= num_pages);
+    CHECK(misses.percentile(0.5) > 0);
+    CHECK(misses.percentile(0.5) <= misses.percentile(0.99));
+    CHECK(misses.percentile(0.99) <= misses.percentile(0.999));
+    CHECK(misses.percentileNs(0.999) <= misses.maxNs());
+
+    std::uint64_t timed = hits.count() + misses.count();
+    this->buf_mgr->setLatencySampling(4);
+    for (std::uint32_t i = 0; i < 40; i++){
+      this->buf_mgr->getPage(allocated_pages.at(i % num_pages));
+      this->buf_mgr->releasePage(allocated_pages.at(i % num_pages), false);
+    }
+    CHECK_EQUAL(timed + 10, this->buf_mgr->getLatency(LatGetHit).count() +
+        this->buf_mgr->getLatency(LatGetMiss).count());
+    this->buf_mgr->setLatencySampling(0);
+  }
+}
+
+SUITE(metrics){
+
+  /*
+   * Reads pages back with timing on, and renders the metrics. Checks that
+   * the counters and page states are in them as in getBufferStats and
+   * getBufferState, that latencies are only there when sampled, that
+   * writeMetrics writes the same text, and that it refuses a file in a
+   * missing directory.
+   */
+  TEST_FIXTURE(TestFixture,prometheusTest){
+    std::vector<PageId> allocated_pages;
+    std::string path = "metrics_test.prom";
+
+    PRINT("TEST: prometheusTest: metrics in the Prometheus text format\n");
+    for (std::uint32_t i = 0; i < BUF_SIZE + 1; i++){
+      std::pair<Page*, PageId> new_page = this->buf_mgr->allocatePage(file_id);
+      this->buf_mgr->releasePage(new_page.second, true);
+      allocated_pages.push_back(new_page.second);
+    }
+    std::string text = this->buf_mgr->getMetrics();
+    CHECK(text.find("# TYPE swatdb_buffer_hits_total counter\n") !=
+        std::string::npos);
+    CHECK(text.find("swatdb_buffer_latency_seconds") == std::string::npos);
+
+    this->buf_mgr->setLatencySampling(1);
+    for (PageId page_id : allocated_pages){
+      this->buf_mgr->getPage(page_id);
+      this->buf_mgr->releasePage(page_id, false);
+    }
+    this->buf_mgr->getPage(allocated_pages.at(0));
+    BufferStats stats = this->buf_mgr->getBufferStats();
+    text = this->buf_mgr->getMetrics();
+    CHECK(text.find("\nswatdb_buffer_frames " + std::to_string(BUF_SIZE) +
+        "\n") != std::string::npos);
+    CHECK(text.find("\nswatdb_buffer_pages{state=\"pinned\"} 1\n") !=
+        std::string::npos);
+    CHECK(text.find("\nswatdb_buffer_hits_total " +
+        std::to_string(stats.hits) + "\n") != std::string::npos);
+    CHECK(text.find("\nswatdb_buffer_misses_total " +
+        std::to_string(stats.misses) + "\n") != std::string::npos);
+    CHECK(text.find("\nswatdb_buffer_read_bytes_total " +
+        std::to_string(stats.bytes_read) + "\n") != std::string::npos);
+    CHECK(text.find("\nswatdb_buffer_latency_seconds_count{op=\"get_miss\"}"
+        " " + std::to_string(stats.misses) + "\n") != std::string::npos);
+    CHECK(text.find("swatdb_buffer_latency_seconds{op=\"get_miss\","
+        "quantile=\"0.99\"} ") != std::string::npos);
+    CHECK(text.find("\nswatdb_buffer_latency_seconds_sum{op=\"get_miss\"} ")
+        != std::string::npos);
+
+    this->buf_mgr->writeMetrics(path);
+    std::ifstream in(path);
+    std::string written((std::istreambuf_iterator<char>(in)),
+        std::istreambuf_iterator<char>());
+    CHECK(written == this->buf_mgr->getMetrics());
+    std::remove(path.c_str());
+    CHECK_THROW(this->buf_mgr->writeMetrics("no_such_dir/" + path),
+        IOErrorBufMgr);
+    this->buf_mgr->releasePage(allocated_pages.at(0), false);
+    this->buf_mgr->setLatencySampling(0);
+  }
+}
+
+SUITE(trace){
+
+  /*
+   * Records allocating, reading back and releasing more pages than the
+   * buffer pool holds. Checks that the trace read back has every call in
+   * order, with the hits and dirty flags the buffer manager saw, and that a
+   * trace file in a missing directory is refused.
+   */
+  TEST_FIXTURE(TestFixture,recordTest){
+    std::vector<PageId> allocated_pages;
+    std::vector<TraceEvent> events;
+    std::string path = "trace_test.bin";
+    std::uint32_t num_pages = BUF_SIZE + 1;
+
+    PRINT("TEST: recordTest: page accesses recorded and read back\n");
+    CHECK_THROW(TraceRecorder("no_such_dir/" + path), IOErrorBufMgr);
+    TraceRecorder tracer(path);
+    this->buf_mgr->setTracer(&tracer);
+    for (std::uint32_t i = 0; i < num_pages; i++){
+      std::pair<Page*, PageId> new_page = this->buf_mgr->allocatePage(file_id);
+      this->buf_mgr->releasePage(new_page.second, true);
+      allocated_pages.push_back(new_page.second);
+    }
+    BufferStats before = this->buf_mgr->getBufferStats();
+    for (std::uint32_t i = 0; i < num_pages; i++){
+      this->buf_mgr->getPage(allocated_pages.at(i));
+      this->buf_mgr->releasePage(allocated_pages.at(i), false);
+    }
+    BufferStats after = this->buf_mgr->getBufferStats();
+    this->buf_mgr->setTracer(nullptr);
+    this->buf_mgr->getPage(allocated_pages.at(0));
+    this->buf_mgr->releasePage(allocated_pages.at(0), false);
+    CHECK(tracer.close());
+    CHECK_EQUAL((std::uint64_t)4 * num_pages, tracer.getNumEvents());
+
+    CHECK(bm_read_trace(path, &events));
+    CHECK_EQUAL((std::size_t)4 * num_pages, events.size());
+    std::uint64_t hits = 0;
+    for (std::uint32_t i = 0; i < events.size(); i++){
+      TraceEvent &event = events.at(i);
+      std::uint32_t page = (i / 2) % num_pages;
+      bool allocating = i < 2 * num_pages;
+      CHECK(event.page_id == allocated_pages.at(page));
+      CHECK_EQUAL(0u, event.thread);
+      if (i % 2 == 0){
+        CHECK_EQUAL(allocating ? TraceAllocate : TraceGet, event.op);
+        hits += event.hit ? 1 : 0;
+      }
+      else{
+        CHECK_EQUAL(TraceRelease, event.op);
+        CHECK_EQUAL(allocating, event.dirty);
+      }
+      if (i > 0){
+        CHECK(event.time >= events.at(i - 1).time);
+      }
+    }
+    CHECK_EQUAL(after.hits - before.hits, hits);
+    std::remove(path.c_str());
+  }
+
+  /*
+   * Records from two threads at once, each more events than fit in its
+   * buffer. Checks that each thread's events are read back in its order,
+   * and that sequential pages take a few bytes an event.
+   */
+  TEST_FIXTURE(TestFixture,threadsTest){
+    std::vector<TraceEvent> events;
+    std::string path = "trace_threads_test.bin";
+    std::uint32_t per_thread = 3 * BM_TRACE_BUFFER + 1;
+
+    PRINT("TEST: threadsTest: per-thread buffers merged by time\n");
+    {
+      TraceRecorder tracer(path);
+      auto work = [&](FileId file){
+        for (std::uint32_t i = 0; i < per_thread; i++){
+          tracer.record(TraceGet, PageId{file, i}, i % 2 == 0);
+        }
+      };
+      std::thread first(work, 1);
+      std::thread second(work, 2);
+      first.join();
+      second.join();
+    }
+
+    CHECK(bm_read_trace(path, &events));
+    CHECK_EQUAL((std::size_t)2 * per_thread, events.size());
+    PageNum next[3] = {0, 0, 0};
+    for (TraceEvent &event : events){
+      FileId file = event.page_id.file_id;
+      CHECK(file == 1 || file == 2);
+      if (file == 1 || file == 2){
+        CHECK_EQUAL(next[file], event.page_id.page_num);
+        CHECK_EQUAL(next[file] % 2 == 0, event.hit);
+        next[file] = event.page_id.page_num + 1;
+      }
+    }
+    CHECK_EQUAL(per_thread, next[1]);
+    CHECK_EQUAL(per_thread, next[2]);
+
+    struct stat info;
+    CHECK_EQUAL(0, stat(path.c_str(), &info));
+    CHECK(info.st_size < (off_t)(2 * per_thread * 8));
+    std::remove(path.c_str());
+  }
+}
+
+SUITE(replay){
+
+  /*
+   * Replays three rounds of reading and writing more pages than fit in a
+   * small pool. Checks that the whole pool only misses each page once, and
+   * that Clock on a pool smaller than the loop misses every time and writes
+   * back each dirty page it evicts.
+   */
+  TEST_FIXTURE(TestFixture,replayTest){
+    std::vector<TraceEvent> events;
+    std::uint32_t num_pages = BUF_SIZE / 2;
+
+    PRINT("TEST: replayTest: trace replayed through a policy\n");
+    for (std::uint32_t round = 0; round < 3; round++){
+      for (std::uint32_t i = 0; i < num_pages; i++){
+        PageId page_id = PageId{file_id, i};
+        events.push_back(TraceEvent{0, page_id, 0, TraceGet, false, false});
+        events.push_back(TraceEvent{0, page_id, 0, TraceRelease, false,
+            true});
+      }
+    }
+
+    ReplayResult whole = bm_replay(events, ReplayConfig{ClockT, BUF_SIZE});
+    CHECK(whole.valid);
+    CHECK_EQUAL((std::uint64_t)3 * num_pages, whole.gets);
+    CHECK_EQUAL((std::uint64_t)num_pages, whole.misses);
+    CHECK_EQUAL((std::uint64_t)2 * num_pages, whole.hits);
+    CHECK_EQUAL(whole.misses, whole.reads);
+    CHECK_EQUAL(0u, whole.evictions);
+    CHECK_EQUAL(0u, whole.writes);
+
+    ReplayResult small = bm_replay(events,
+        ReplayConfig{ClockT, num_pages - 1});
+    CHECK_EQUAL((std::uint64_t)3 * num_pages, small.misses);
+    CHECK_EQUAL(0u, small.hits);
+    CHECK_EQUAL(small.misses - (num_pages - 1), small.evictions);
+    CHECK_EQUAL(small.evictions, small.writes);
+    CHECK_EQUAL(0u, small.pin_waits);
+
+    CHECK_THROW(bm_replay(events, ReplayConfig{ClockT, BUF_SIZE + 1}),
+        InvalidPolicyBufMgr);
+    CHECK_THROW(bm_replay(events, ReplayConfig{ClockT, 0}),
+        InvalidPolicyBufMgr);
+  }
+
+  /*
+   * Replays a trace with several policies and sizes at once. Checks that
+   * the results are in the order of the configs, match replaying each
+   * config alone, and that a policy with no implementation, or sized to
+   * BUF_SIZE and given fewer frames, is reported as not valid.
+   */
+  TEST_FIXTURE(TestFixture,replayAllTest){
+    std::vector<TraceEvent> events;
+    std::vector<ReplayConfig> configs;
+    PolicyType policies[] = {ClockT, GClockT, ClockProT, LirsT, SieveT,
+        S3FifoT};
+
+    PRINT("TEST: replayAllTest: configurations replayed in parallel\n");
+    for (std::uint32_t i = 0; i < 20 * BUF_SIZE; i++){
+      PageId page_id = PageId{file_id, (i * 7) % (2 * BUF_SIZE)};
+      if (i % 3 == 0){
+        page_id.page_num = i % 4;
+      }
+      events.push_back(TraceEvent{i, page_id, 0, TraceGet, false, false});
+      events.push_back(TraceEvent{i, page_id, 0, TraceRelease, false,
+          i % 5 == 0});
+    }
+    for (PolicyType rep_type : policies){
+      configs.push_back(ReplayConfig{rep_type, BUF_SIZE / 2});
+      configs.push_back(ReplayConfig{rep_type, BUF_SIZE});
+    }
+    configs.push_back(ReplayConfig{LruT, BUF_SIZE});
+
+    std::vector<ReplayResult> results = bm_replay_all(events, configs, 4);
+    CHECK_EQUAL(configs.size(), results.size());
+    for (std::uint32_t i = 0; i + 1 < configs.size(); i++){
+      CHECK_EQUAL(configs.at(i).rep_type, results.at(i).config.rep_type);
+      CHECK_EQUAL(configs.at(i).pool_size, results.at(i).config.pool_size);
+      if (configs.at(i).pool_size < BUF_SIZE &&
+          bm_replay_sized(configs.at(i).rep_type)){
+        CHECK(!results.at(i).valid);
+        CHECK_THROW(bm_replay(events, configs.at(i)), InvalidPolicyBufMgr);
+        continue;
+      }
+      ReplayResult alone = bm_replay(events, configs.at(i));
+      CHECK(results.at(i).valid);
+      CHECK_EQUAL(alone.hits, results.at(i).hits);
+      CHECK_EQUAL(alone.writes, results.at(i).writes);
+      CHECK_EQUAL((std::uint64_t)20 * BUF_SIZE,
+          results.at(i).hits + results.at(i).misses);
+    }
+    CHECK(!results.back().valid);
+  }
+}
+
+SUITE(missRatioCurve){
+
+  /*
+   * Loops over one and a half times as many pages as the buffer pool holds,
+   * ten times. Every page is sampled while so few are accessed, so the
+   * prediction is exact: each access after the first loop has a reuse
+   * distance of 1.5 * BUF_SIZE - 1, and hits at 2 and 4 times BUF_SIZE
+   * frames only.
+   */
+  TEST_FIXTURE(TestFixture,loopTest){
+    std::vector<PageId> allocated_pages;
+    std::uint32_t num_pages = BUF_SIZE + BUF_SIZE / 2;
+
+    PRINT("TEST: loopTest: hit rates predicted for a looping scan\n");
+    for (std::uint32_t i = 0; i < num_pages; i++){
+      std::pair<Page*, PageId> new_page = this->buf_mgr->allocatePage(file_id);
+      this->buf_mgr->releasePage(new_page.second, false);
+      allocated_pages.push_back(new_page.second);
+    }
+    MissRatioCurve curve = this->buf_mgr->getMissRatioCurve();
+    CHECK_EQUAL(0u, curve.accesses);
+
+    this->buf_mgr->setMissRatioCurve(true);
+    for (std::uint32_t loop = 0; loop < 10; loop++){
+      for (std::uint32_t i = 0; i < num_pages; i++){
+        this->buf_mgr->getPage(allocated_pages.at(i));
+        this->buf_mgr->releasePage(allocated_pages.at(i), false);
+      }
+    }
+    curve = this->buf_mgr->getMissRatioCurve();
+    CHECK_EQUAL(10u * num_pages, curve.accesses);
+    CHECK_EQUAL(curve.accesses, curve.samples);
+    CHECK_EQUAL(1.0, curve.rate);
+    CHECK_EQUAL(BUF_SIZE, curve.sizes[1]);
+    CHECK_EQUAL(4 * BUF_SIZE, curve.sizes[3]);
+    CHECK_EQUAL(0.0, curve.hit_rates[0]);
+    CHECK_EQUAL(0.0, curve.hit_rates[1]);
+    CHECK_CLOSE(0.9, curve.hit_rates[2], 1e-9);
+    CHECK_CLOSE(0.9, curve.hit_rates[3], 1e-9);
+
+    this->buf_mgr->setMissRatioCurve(false);
+    CHECK_EQUAL(0u, this->buf_mgr->getMissRatioCurve().accesses);
+  }
+
+  /*
+   * Loops over 15000 pages with a pool of 10000 frames and room to track
+   * 1024 pages. Checks that the sampling rate drops to keep the pages tracked
+   * bounded, that the scaled reuse distances still predict hits at 2 and 4
+   * times the pool only, and that a curve merged with itself is the curve
+   * of a pool twice as large.
+   */
+  TEST_FIXTURE(TestFixture,samplingTest){
+    MissRatioEstimator estimator(10000, 1024);
+    PageId page_id;
+
+    PRINT("TEST: samplingTest: sampled reuse distances scaled to the pool\n");
+    page_id.file_id = 1;
+    for (std::uint32_t loop = 0; loop < 10; loop++){
+      for (std::uint32_t i = 0; i < 15000; i++){
+        page_id.page_num = i;
+        estimator.recordAccess(page_id);
+      }
+    }
+    MissRatioCurve curve = estimator.getCurve();
+    CHECK_EQUAL(150000u, curve.accesses);
+    CHECK(curve.rate < 1024.0 / 15000 * 1.5);
+    CHECK(curve.samples < curve.accesses / 5);
+    CHECK(curve.hit_rates[0] < 0.05);
+    CHECK(curve.hit_rates[1] < 0.05);
+    CHECK_CLOSE(0.9, curve.hit_rates[2], 0.05);
+    CHECK_CLOSE(0.9, curve.hit_rates[3], 0.05);
+
+    MissRatioCurve total = curve;
+    bm_add_mrc(&total, curve);
+    CHECK_EQUAL(2 * curve.accesses, total.accesses);
+    CHECK_EQUAL(20000u, total.sizes[1]);
+    CHECK_CLOSE(curve.hit_rates[2], total.hit_rates[2], 1e-9);
+  }
+}
+
+SUITE(workload){
+
+  /*
+   * Draws from Zipf workloads over 1000 pages. Checks that every access is
+   * in the page space, that theta 0.99 puts about 1 / zeta(1000, 0.99) of
+   * the accesses on the hottest page and most of them on a tenth of the
+   * pages, that theta 0 is close to uniform, and that copies with the same
+   * seed draw the same accesses.
+   */
+  TEST_FIXTURE(TestFixture,zipfTest){
+    std::vector<PageId> pages;
+    PageId page_id;
+
+    PRINT("TEST: zipfTest: skew of Zipf draws over 1000 pages\n");
+    page_id.file_id = 1;
+    for (std::uint32_t i = 0; i < 1000; i++){
+      page_id.page_num = i;
+      pages.push_back(page_id);
+    }
+    double zeta = 0;
+    for (std::uint32_t i = 1; i <= 1000; i++){
+      zeta += 1.0 / std::pow((double)i, 0.99);
+    }
+
+    WorkloadConfig config = bm_default_workload(WorkloadZipf);
+    Workload zipf(config, {pages});
+    CHECK_EQUAL(1000u, zipf.getNumPages());
+    std::vector<std::uint32_t> counts(1000, 0);
+    for (std::uint32_t i = 0; i < 100000; i++){
+      WorkloadAccess access = zipf.next();
+      CHECK_EQUAL(1u, access.page_id.file_id);
+      CHECK(access.page_id.page_num < 1000);
+      CHECK(!access.write);
+      counts[access.page_id.page_num]++;
+    }
+    std::sort(counts.begin(), counts.end(), std::greater<std::uint32_t>());
+    CHECK_CLOSE(1.0 / zeta, counts[0] / 100000.0, 0.01);
+    std::uint32_t top = 0;
+    for (std::uint32_t i = 0; i < 100; i++){
+      top += counts[i];
+    }
+    CHECK(top > 60000);
+
+    config.theta = 0;
+    Workload uniform(config, {pages});
+    counts.assign(1000, 0);
+    for (std::uint32_t i = 0; i < 100000; i++){
+      counts[uniform.next().page_id.page_num]++;
+    }
+    CHECK(*std::max_element(counts.begin(), counts.end()) < 200);
+
+    Workload copy = zipf;
+    for (std::uint32_t i = 0; i < 100; i++){
+      CHECK(copy.next().page_id == zipf.next().page_id);
+    }
+    copy.reseed(2);
+    std::uint32_t same = 0;
+    for (std::uint32_t i = 0; i < 100; i++){
+      same += copy.next().page_id == zipf.next().page_id;
+    }
+    CHECK(same < 50);
+  }
+
+  /*
+   * Checks the order of the loop and scan patterns, that latest favours the
+   * pages at the end of the space and hotspot its hot pages, and that bad
+   * parameters and specs are rejected.
+   */
+  TEST_FIXTURE(TestFixture,patternTest){
+    std::vector<PageId> pages;
+    PageId page_id;
+
+    PRINT("TEST: patternTest: loop, scan, latest and hotspot patterns\n");
+    page_id.file_id = 1;
+    for (std::uint32_t i = 0; i < 100; i++){
+      page_id.page_num = i;
+      pages.push_back(page_id);
+    }
+
+    Workload loop(bm_default_workload(WorkloadLoop), {pages});
+    for (std::uint32_t i = 0; i < 250; i++){
+      CHECK_EQUAL(i % 100, loop.next().page_id.page_num);
+    }
+
+    WorkloadConfig config;
+    CHECK(bm_parse_workload("scan:1:5", &config));
+    CHECK_EQUAL(WorkloadScanMix, config.type);
+    CHECK_EQUAL(5u, config.scan_length);
+    Workload scan(config, {pages});
+    for (std::uint32_t i = 0; i < 20; i++){
+      std::uint32_t start = scan.next().page_id.page_num;
+      for (std::uint32_t j = 1; j < 5; j++){
+        CHECK_EQUAL((start + j) % 100, scan.next().page_id.page_num);
+      }
+    }
+
+    Workload latest(bm_default_workload(WorkloadLatest), {pages});
+    std::uint32_t last_tenth = 0;
+    for (std::uint32_t i = 0; i < 10000; i++){
+      last_tenth += latest.next().page_id.page_num >= 90;
+    }
+    CHECK(last_tenth > 5000);
+
+    CHECK(bm_parse_workload("hotspot:0.1:0.9", &config));
+    Workload hotspot(config, {pages});
+    std::uint32_t hot = 0;
+    for (std::uint32_t i = 0; i < 10000; i++){
+      hot += hotspot.next().page_id.page_num < 10;
+    }
+    CHECK_CLOSE(0.9, hot / 10000.0, 0.02);
+
+    CHECK(bm_parse_workload("uniform", &config));
+    CHECK(!bm_parse_workload("uniform:1", &config));
+    CHECK(!bm_parse_workload("zipf:x", &config));
+    CHECK(!bm_parse_workload("mru", &config));
+    config = bm_default_workload(WorkloadZipf);
+    config.theta = 1;
+    CHECK_THROW(Workload(config, {pages}), InvalidArgumentBufMgr);
+    CHECK_THROW(Workload(bm_default_workload(WorkloadUniform), {}),
+        InvalidArgumentBufMgr);
+  }
+
+  /*
+   * Runs a Zipf workload with half of its accesses writes over two files,
+   * twice as many pages as the buffer pool holds. Checks that both files are
+   * accessed, that the counters cover exactly the run, and that dirty pages
+   * are written back.
+   */
+  TEST_FIXTURE(TestFixture,runTest){
+    std::string file_name2 = "testrel2.rel";
+    FileId fid2 = catalog->addEntry(file_name2, nullptr, nullptr, nullptr,
+        HeapFileT, INVALID_FILE_ID, file_name2);
+    std::vector<std::vector<PageId>> files(2);
+
+    PRINT("TEST: runTest: zipf workload with writes over two files\n");
+    this->buf_mgr->createFile(fid2);
+    for (std::uint32_t i = 0; i < BUF_SIZE; i++){
+      files[0].push_back(this->buf_mgr->allocatePage(file_id).second);
+      this->buf_mgr->releasePage(files[0].back(), false);
+      files[1].push_back(this->buf_mgr->allocatePage(fid2).second);
+      this->buf_mgr->releasePage(files[1].back(), false);
+    }
+
+    WorkloadConfig config = bm_default_workload(WorkloadZipf);
+    config.write_fraction = 0.5;
+    Workload workload(config, files);
+    CHECK_EQUAL(2 * BUF_SIZE, workload.getNumPages());
+    Workload copy = workload;
+    std::uint32_t writes = 0;
+    std::uint32_t second_file = 0;
+    for (std::uint32_t i = 0; i < 2000; i++){
+      WorkloadAccess access = copy.next();
+      writes += access.write;
+      second_file += access.page_id.file_id == fid2;
+    }
+    CHECK_CLOSE(0.5, writes / 2000.0, 0.05);
+    CHECK(second_file > 0 && second_file < 2000);
+
+    WorkloadResult result = bm_run_workload(this->buf_mgr, workload, 2000);
+    CHECK_EQUAL(2000u, result.ops);
+    CHECK_EQUAL(2000u, result.stats.hits + result.stats.misses);
+    CHECK_EQUAL(result.stats.misses, result.stats.reads);
+    CHECK(result.stats.hits > 0);
+    CHECK(result.stats.dirty_evictions > 0);
+    CHECK(result.seconds > 0);
+    CHECK_EQUAL(0u, this->buf_mgr->getBufferState().pinned);
+
+    this->buf_mgr->removeFile(fid2);
+    remove(file_name2.data());
+  }
+}
+
 /*
  * An empty SUITE for students to add additional tests. Students may add tests
  * to other existing SUITE as well.
@@ -679,7 +2378,11 @@ void usage(){
   std::cout << "Usage: ./unittests -s <suite_name> -h help\n";
   std::cout << "Available Suites: " <<
       "allocatePage, deallocatePage, releasePage, setDirtyAndFlushPage,\n"<<
-      "getPage, removeFile, studentTests" << std::endl;
+      "getPage, removeFile, admission, accessHints, partitioned, numa,\n" <<
+      "poolMemory, mappedFiles, compressedCache, ssdCache, warmUp,\n" <<
+      "bufferStats, latency, metrics, trace, replay, missRatioCurve,\n" <<
+      "workload, studentTests" <<
+      std::endl;
 }
 
 /*